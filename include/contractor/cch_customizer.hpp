@@ -0,0 +1,38 @@
+#ifndef OSRM_CONTRACTOR_CCH_CUSTOMIZER_HPP
+#define OSRM_CONTRACTOR_CCH_CUSTOMIZER_HPP
+
+#include "contractor/cch_topology.hpp"
+#include "contractor/query_edge.hpp"
+#include "contractor/query_graph.hpp"
+
+#include "extractor/edge_based_edge.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Applies the weights of the edge-based graph to the CCH topology and returns the
+// resulting hierarchy as edges of the CH query graph. Only edges between nodes that are
+// allowed by the node filter are used. Loops are only added if they are cheaper than
+// the node weight, the same as the CH contractor does.
+std::vector<QueryEdge> customizeCCH(const CCHTopology &topology,
+                                    const std::vector<extractor::EdgeBasedEdge> &edges,
+                                    const std::vector<EdgeWeight> &node_weights,
+                                    const std::vector<bool> &node_filter);
+
+// Customizes the topology once per exclude filter and merges the results
+std::tuple<QueryGraph, std::vector<std::vector<bool>>>
+customizeExcludableCCH(const CCHTopology &topology,
+                       const std::vector<extractor::EdgeBasedEdge> &edges,
+                       const std::vector<EdgeWeight> &node_weights,
+                       const std::vector<std::vector<bool>> &node_filters);
+}
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef OSRM_CONTRACTOR_CCH_TOPOLOGY_HPP
+#define OSRM_CONTRACTOR_CCH_TOPOLOGY_HPP
+
+#include "partitioner/multi_level_partition.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+/**
+ * Metric-independent part of a Customizable Contraction Hierarchy.
+ *
+ * All nodes are contracted in a fixed order and every fill-in arc is kept, which makes the
+ * upward graph chordal: the upper neighbours of every node form a clique. This means any
+ * metric can be applied afterwards by a customization pass that only needs to enumerate
+ * the lower triangles of every arc, without a single witness search.
+ *
+ * Nodes are referred to by their rank in the order, arcs are stored at their lower endpoint.
+ */
+struct CCHTopology
+{
+    CCHTopology() = default;
+
+    // Derives the downward adjacency and the customization levels from the upward graph
+    CCHTopology(std::vector<NodeID> order_,
+                std::vector<EdgeID> first_out_,
+                std::vector<NodeID> head_);
+
+    std::size_t GetNumberOfNodes() const { return order.size(); }
+
+    std::size_t GetNumberOfArcs() const { return head.size(); }
+
+    auto GetUpwardArcs(const NodeID node) const
+    {
+        return util::irange<EdgeID>(first_out[node], first_out[node + 1]);
+    }
+
+    auto GetDownwardArcs(const NodeID node) const
+    {
+        return util::irange<EdgeID>(first_in[node], first_in[node + 1]);
+    }
+
+    // Returns the arc lower -> upper or SPECIAL_EDGEID
+    EdgeID FindArc(const NodeID lower, const NodeID upper) const
+    {
+        BOOST_ASSERT(lower < upper);
+        const auto begin = head.begin() + first_out[lower];
+        const auto end = head.begin() + first_out[lower + 1];
+        const auto iter = std::lower_bound(begin, end, upper);
+        if (iter == end || *iter != upper)
+            return SPECIAL_EDGEID;
+        return std::distance(head.begin(), iter);
+    }
+
+    // rank -> node ID
+    std::vector<NodeID> order;
+    // node ID -> rank
+    std::vector<NodeID> rank;
+
+    // upward arcs sorted by the rank of their head
+    std::vector<EdgeID> first_out;
+    std::vector<NodeID> head;
+
+    // downward arcs, referring to the upward arc IDs
+    std::vector<EdgeID> first_in;
+    std::vector<NodeID> tail;
+    std::vector<EdgeID> in_arc;
+
+    // nodes grouped by their customization level. All lower neighbours of a node are
+    // on a smaller level, so all nodes of the same level can be customized in parallel.
+    std::vector<std::size_t> level_offsets;
+    std::vector<NodeID> level_nodes;
+};
+
+// Computes a nested dissection order from the multi-level partition. Nodes that separate cells
+// on a higher level get a higher rank, nodes within the same cell are kept close together.
+std::vector<NodeID>
+computeNestedDissectionOrder(const partitioner::MultiLevelPartition &mlp,
+                             const NodeID number_of_nodes,
+                             const std::vector<std::pair<NodeID, NodeID>> &edges);
+
+// Contracts the nodes in the given order and returns the chordal upward graph
+CCHTopology buildCCHTopology(std::vector<NodeID> order,
+                             const std::vector<std::pair<NodeID, NodeID>> &edges);
+}
+}
+
+#endif
@@ -44,9 +44,15 @@ struct ContractorConfig final : storage::IOConfig
 {
     ContractorConfig()
         : IOConfig({".osrm.ebg", ".osrm.ebg_nodes", ".osrm.properties"},
-                   {},
-                   {".osrm.hsgr", ".osrm.enw"}),
-          requested_num_threads(0)
+                   {".osrm.partition"},
+                   {".osrm.hsgr",
+                    ".osrm.enw",
+                    ".osrm.shortcuts",
+                    ".osrm.cch",
+                    ".osrm.hub_labels",
+                    ".osrm.tnr"}),
+          requested_num_threads(0), unpack_shortcuts_min_edges(0), use_cch(false),
+          use_hub_labels(false), transit_nodes(0)
     {
     }
 
@@ -72,6 +78,25 @@ struct ContractorConfig final : storage::IOConfig
     // The remaining vertices form the core of the hierarchy
     //(e.g. 0.8 contracts 80 percent of the hierarchy, leaving a core of 20%)
     double core_factor;
+
+    // Shortcuts that unpack to at least this many original edges are stored fully unpacked
+    // in the .osrm.shortcuts file, so the query does not need to expand them recursively.
+    // A value of 0 disables the precomputation.
+    unsigned unpack_shortcuts_min_edges;
+
+    // Contract in a metric-independent order derived from .osrm.partition and keep all fill-in
+    // edges (Customizable Contraction Hierarchies). The topology is cached in .osrm.cch so
+    // subsequent runs with new weights only need to customize it.
+    bool use_cch;
+
+    // Compute pruned hub labels from the contracted graph and store them in .osrm.hub_labels.
+    // They answer weight and duration queries of the table plugin without a graph search.
+    bool use_hub_labels;
+
+    // Number of the highest nodes of the hierarchy that are used as transit nodes. The distance
+    // table between them and the access nodes of all nodes are stored in .osrm.tnr.
+    // A value of 0 disables transit node routing.
+    unsigned transit_nodes;
 };
 }
 }
@@ -4,6 +4,7 @@
 #include "contractor/serialization.hpp"
 
 #include <unordered_map>
+#include <vector>
 
 namespace osrm
 {
@@ -52,6 +53,193 @@ inline void writeGraph(const boost::filesystem::path &path,
         serialization::write(writer, "/ch/metrics/" + pair.first, pair.second);
     }
 }
+
+// reads .osrm.cch file
+inline void readCCHTopology(const boost::filesystem::path &path,
+                            CCHTopology &topology,
+                            std::uint32_t &connectivity_checksum)
+{
+    const auto fingerprint = storage::tar::FileReader::VerifyFingerprint;
+    storage::tar::FileReader reader{path, fingerprint};
+
+    reader.ReadInto("/cch/connectivity_checksum", connectivity_checksum);
+    serialization::read(reader, "/cch/topology", topology);
+}
+
+// writes .osrm.cch file
+inline void writeCCHTopology(const boost::filesystem::path &path,
+                             const CCHTopology &topology,
+                             const std::uint32_t connectivity_checksum)
+{
+    const auto fingerprint = storage::tar::FileWriter::GenerateFingerprint;
+    storage::tar::FileWriter writer{path, fingerprint};
+
+    writer.WriteElementCount64("/cch/connectivity_checksum", 1);
+    writer.WriteFrom("/cch/connectivity_checksum", connectivity_checksum);
+    serialization::write(writer, "/cch/topology", topology);
+}
+
+// reads .osrm.shortcuts file
+template <typename UnpackedShortcutsT>
+inline void
+readUnpackedShortcuts(const boost::filesystem::path &path,
+                      std::unordered_map<std::string, std::vector<UnpackedShortcutsT>> &metrics,
+                      std::uint32_t &connectivity_checksum)
+{
+    static_assert(std::is_same<UnpackedShortcuts, UnpackedShortcutsT>::value ||
+                      std::is_same<UnpackedShortcutsView, UnpackedShortcutsT>::value,
+                  "shortcuts must be of type UnpackedShortcuts<>");
+
+    const auto fingerprint = storage::tar::FileReader::VerifyFingerprint;
+    storage::tar::FileReader reader{path, fingerprint};
+
+    reader.ReadInto("/ch/connectivity_checksum", connectivity_checksum);
+
+    for (auto &pair : metrics)
+    {
+        const auto prefix = "/ch/metrics/" + pair.first + "/unpacked_shortcuts";
+        pair.second.resize(reader.ReadElementCount64(prefix));
+        for (const auto index : util::irange<std::size_t>(0, pair.second.size()))
+        {
+            serialization::read(reader, prefix + "/" + std::to_string(index), pair.second[index]);
+        }
+    }
+}
+
+// writes .osrm.shortcuts file
+template <typename UnpackedShortcutsT>
+inline void writeUnpackedShortcuts(
+    const boost::filesystem::path &path,
+    const std::unordered_map<std::string, std::vector<UnpackedShortcutsT>> &metrics,
+    const std::uint32_t connectivity_checksum)
+{
+    static_assert(std::is_same<UnpackedShortcuts, UnpackedShortcutsT>::value ||
+                      std::is_same<UnpackedShortcutsView, UnpackedShortcutsT>::value,
+                  "shortcuts must be of type UnpackedShortcuts<>");
+
+    const auto fingerprint = storage::tar::FileWriter::GenerateFingerprint;
+    storage::tar::FileWriter writer{path, fingerprint};
+
+    writer.WriteElementCount64("/ch/connectivity_checksum", 1);
+    writer.WriteFrom("/ch/connectivity_checksum", connectivity_checksum);
+
+    for (const auto &pair : metrics)
+    {
+        const auto prefix = "/ch/metrics/" + pair.first + "/unpacked_shortcuts";
+        writer.WriteElementCount64(prefix, pair.second.size());
+        for (const auto index : util::irange<std::size_t>(0, pair.second.size()))
+        {
+            serialization::write(writer, prefix + "/" + std::to_string(index), pair.second[index]);
+        }
+    }
+}
+
+// reads .osrm.hub_labels file
+template <typename HubLabelsT>
+inline void readHubLabels(const boost::filesystem::path &path,
+                          std::unordered_map<std::string, std::vector<HubLabelsT>> &metrics,
+                          std::uint32_t &connectivity_checksum)
+{
+    static_assert(std::is_same<HubLabels, HubLabelsT>::value ||
+                      std::is_same<HubLabelsView, HubLabelsT>::value,
+                  "labels must be of type HubLabels<>");
+
+    const auto fingerprint = storage::tar::FileReader::VerifyFingerprint;
+    storage::tar::FileReader reader{path, fingerprint};
+
+    reader.ReadInto("/ch/connectivity_checksum", connectivity_checksum);
+
+    for (auto &pair : metrics)
+    {
+        const auto prefix = "/ch/metrics/" + pair.first + "/hub_labels";
+        pair.second.resize(reader.ReadElementCount64(prefix));
+        for (const auto index : util::irange<std::size_t>(0, pair.second.size()))
+        {
+            serialization::read(reader, prefix + "/" + std::to_string(index), pair.second[index]);
+        }
+    }
+}
+
+// writes .osrm.hub_labels file
+template <typename HubLabelsT>
+inline void writeHubLabels(const boost::filesystem::path &path,
+                           const std::unordered_map<std::string, std::vector<HubLabelsT>> &metrics,
+                           const std::uint32_t connectivity_checksum)
+{
+    static_assert(std::is_same<HubLabels, HubLabelsT>::value ||
+                      std::is_same<HubLabelsView, HubLabelsT>::value,
+                  "labels must be of type HubLabels<>");
+
+    const auto fingerprint = storage::tar::FileWriter::GenerateFingerprint;
+    storage::tar::FileWriter writer{path, fingerprint};
+
+    writer.WriteElementCount64("/ch/connectivity_checksum", 1);
+    writer.WriteFrom("/ch/connectivity_checksum", connectivity_checksum);
+
+    for (const auto &pair : metrics)
+    {
+        const auto prefix = "/ch/metrics/" + pair.first + "/hub_labels";
+        writer.WriteElementCount64(prefix, pair.second.size());
+        for (const auto index : util::irange<std::size_t>(0, pair.second.size()))
+        {
+            serialization::write(writer, prefix + "/" + std::to_string(index), pair.second[index]);
+        }
+    }
+}
+
+// reads .osrm.tnr file
+template <typename TransitNodesT>
+inline void readTransitNodes(const boost::filesystem::path &path,
+                             std::unordered_map<std::string, std::vector<TransitNodesT>> &metrics,
+                             std::uint32_t &connectivity_checksum)
+{
+    static_assert(std::is_same<TransitNodes, TransitNodesT>::value ||
+                      std::is_same<TransitNodesView, TransitNodesT>::value,
+                  "transit nodes must be of type TransitNodes<>");
+
+    const auto fingerprint = storage::tar::FileReader::VerifyFingerprint;
+    storage::tar::FileReader reader{path, fingerprint};
+
+    reader.ReadInto("/ch/connectivity_checksum", connectivity_checksum);
+
+    for (auto &pair : metrics)
+    {
+        const auto prefix = "/ch/metrics/" + pair.first + "/transit_nodes";
+        pair.second.resize(reader.ReadElementCount64(prefix));
+        for (const auto index : util::irange<std::size_t>(0, pair.second.size()))
+        {
+            serialization::read(reader, prefix + "/" + std::to_string(index), pair.second[index]);
+        }
+    }
+}
+
+// writes .osrm.tnr file
+template <typename TransitNodesT>
+inline void
+writeTransitNodes(const boost::filesystem::path &path,
+                  const std::unordered_map<std::string, std::vector<TransitNodesT>> &metrics,
+                  const std::uint32_t connectivity_checksum)
+{
+    static_assert(std::is_same<TransitNodes, TransitNodesT>::value ||
+                      std::is_same<TransitNodesView, TransitNodesT>::value,
+                  "transit nodes must be of type TransitNodes<>");
+
+    const auto fingerprint = storage::tar::FileWriter::GenerateFingerprint;
+    storage::tar::FileWriter writer{path, fingerprint};
+
+    writer.WriteElementCount64("/ch/connectivity_checksum", 1);
+    writer.WriteFrom("/ch/connectivity_checksum", connectivity_checksum);
+
+    for (const auto &pair : metrics)
+    {
+        const auto prefix = "/ch/metrics/" + pair.first + "/transit_nodes";
+        writer.WriteElementCount64(prefix, pair.second.size());
+        for (const auto index : util::irange<std::size_t>(0, pair.second.size()))
+        {
+            serialization::write(writer, prefix + "/" + std::to_string(index), pair.second[index]);
+        }
+    }
+}
 }
 }
 }
@@ -0,0 +1,20 @@
+#ifndef OSRM_CONTRACTOR_HIERARCHY_LEVELS_HPP
+#define OSRM_CONTRACTOR_HIERARCHY_LEVELS_HPP
+
+#include "contractor/query_graph.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Groups the nodes of the filtered CH graph so that all upward neighbours of a node are in an
+// earlier group. The first group contains all nodes without upward edges.
+std::vector<std::vector<NodeID>> computeHierarchyLevels(const QueryGraph &graph,
+                                                        const std::vector<bool> &edge_filter);
+}
+}
+
+#endif
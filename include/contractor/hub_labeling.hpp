@@ -0,0 +1,22 @@
+#ifndef OSRM_CONTRACTOR_HUB_LABELING_HPP
+#define OSRM_CONTRACTOR_HUB_LABELING_HPP
+
+#include "contractor/hub_labels.hpp"
+#include "contractor/query_graph.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Computes pruned hub labels from the upward search spaces of the filtered CH graph.
+//
+// Labels are built top-down: the label of a node is the union of the labels of its upward
+// neighbours and every hub that is already covered by a better path over another hub is pruned.
+HubLabels computeHubLabels(const QueryGraph &graph, const std::vector<bool> &edge_filter);
+}
+}
+
+#endif
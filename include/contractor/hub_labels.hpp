@@ -0,0 +1,226 @@
+#ifndef OSRM_CONTRACTOR_HUB_LABELS_HPP
+#define OSRM_CONTRACTOR_HUB_LABELS_HPP
+
+#include "storage/shared_memory_ownership.hpp"
+#include "storage/tar_fwd.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+
+namespace osrm
+{
+namespace contractor
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class HubLabelsImpl;
+}
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::tar::FileReader &reader,
+                 const std::string &name,
+                 detail::HubLabelsImpl<Ownership> &labels);
+
+template <storage::Ownership Ownership>
+inline void write(storage::tar::FileWriter &writer,
+                  const std::string &name,
+                  const detail::HubLabelsImpl<Ownership> &labels);
+}
+
+struct HubLabelEntry
+{
+    NodeID hub;
+    EdgeWeight weight;
+    EdgeDuration duration;
+};
+
+namespace detail
+{
+// Stores a forward and a backward hub label for every node of the CH graph.
+//
+// The forward label of a node contains the shortest weight from the node to each of its hubs,
+// the backward label the shortest weight from each hub to the node. For any two nodes the
+// shortest path passes a hub that is in the forward label of the source and the backward label
+// of the target, so a query is a merge of two sorted lists.
+//
+// Hub IDs are sorted ascending and stored as variable length deltas, which makes up most of the
+// savings since labels of nearby nodes share most of their (high ranked) hubs.
+template <storage::Ownership Ownership> class HubLabelsImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    HubLabelsImpl() = default;
+
+    HubLabelsImpl(Vector<std::uint64_t> entry_offsets_,
+                  Vector<std::uint64_t> byte_offsets_,
+                  Vector<std::uint8_t> hubs_,
+                  Vector<EdgeWeight> weights_,
+                  Vector<EdgeDuration> durations_)
+        : entry_offsets(std::move(entry_offsets_)), byte_offsets(std::move(byte_offsets_)),
+          hubs(std::move(hubs_)), weights(std::move(weights_)), durations(std::move(durations_))
+    {
+        BOOST_ASSERT(entry_offsets.size() == byte_offsets.size());
+        BOOST_ASSERT(entry_offsets.empty() || entry_offsets.size() % 2 == 1);
+        BOOST_ASSERT(weights.size() == durations.size());
+    }
+
+    // Appends the next label. Labels are added in the order forward and backward label of node
+    // 0, forward and backward label of node 1 and so on. Entries need to be sorted by hub.
+    template <typename EntryIter> void Add(EntryIter begin, EntryIter end)
+    {
+        static_assert(Ownership == storage::Ownership::Container, "Only containers can be built");
+        if (entry_offsets.empty())
+        {
+            entry_offsets.push_back(0);
+            byte_offsets.push_back(0);
+        }
+
+        NodeID last_hub = 0;
+        for (auto entry = begin; entry != end; ++entry)
+        {
+            BOOST_ASSERT(entry == begin || last_hub < entry->hub);
+            auto delta = entry->hub - last_hub;
+            last_hub = entry->hub;
+            while (delta >= 0x80)
+            {
+                hubs.push_back(static_cast<std::uint8_t>(delta | 0x80));
+                delta >>= 7;
+            }
+            hubs.push_back(static_cast<std::uint8_t>(delta));
+
+            weights.push_back(entry->weight);
+            durations.push_back(entry->duration);
+        }
+
+        entry_offsets.push_back(weights.size());
+        byte_offsets.push_back(hubs.size());
+    }
+
+    bool Empty() const { return entry_offsets.empty(); }
+
+    std::size_t GetNumberOfNodes() const
+    {
+        return entry_offsets.empty() ? 0 : (entry_offsets.size() - 1) / 2;
+    }
+
+    std::size_t GetNumberOfEntries() const { return weights.size(); }
+
+    std::size_t GetNumberOfHubBytes() const { return hubs.size(); }
+
+    // Calls callback(hub, weight, duration) for all hubs of the forward label (paths starting
+    // at the node) or the backward label (paths ending at the node) in ascending hub order
+    template <typename Callback>
+    void ForEachHub(const NodeID node, const bool forward, Callback &&callback) const
+    {
+        const auto label = GetLabelIndex(node, forward);
+        auto byte = byte_offsets[label];
+        NodeID hub = 0;
+        for (auto entry = entry_offsets[label]; entry < entry_offsets[label + 1]; ++entry)
+        {
+            hub += DecodeDelta(byte);
+            callback(hub, weights[entry], durations[entry]);
+        }
+    }
+
+    // Returns the shortest weight and its duration from source to target,
+    // INVALID_EDGE_WEIGHT if the target can't be reached
+    std::pair<EdgeWeight, EdgeDuration> Query(const NodeID source, const NodeID target) const
+    {
+        const auto source_label = GetLabelIndex(source, true);
+        const auto target_label = GetLabelIndex(target, false);
+
+        auto source_entry = entry_offsets[source_label];
+        auto target_entry = entry_offsets[target_label];
+        const auto source_end = entry_offsets[source_label + 1];
+        const auto target_end = entry_offsets[target_label + 1];
+        auto source_byte = byte_offsets[source_label];
+        auto target_byte = byte_offsets[target_label];
+
+        std::pair<EdgeWeight, EdgeDuration> best{INVALID_EDGE_WEIGHT, MAXIMAL_EDGE_DURATION};
+        if (source_entry == source_end || target_entry == target_end)
+            return best;
+
+        NodeID source_hub = DecodeDelta(source_byte);
+        NodeID target_hub = DecodeDelta(target_byte);
+        while (true)
+        {
+            if (source_hub == target_hub)
+            {
+                const std::pair<EdgeWeight, EdgeDuration> candidate{
+                    weights[source_entry] + weights[target_entry],
+                    durations[source_entry] + durations[target_entry]};
+                best = std::min(best, candidate);
+            }
+
+            if (source_hub <= target_hub)
+            {
+                if (++source_entry == source_end)
+                    break;
+                source_hub += DecodeDelta(source_byte);
+            }
+            else
+            {
+                if (++target_entry == target_end)
+                    break;
+                target_hub += DecodeDelta(target_byte);
+            }
+        }
+
+        return best;
+    }
+
+    friend void serialization::read<Ownership>(storage::tar::FileReader &reader,
+                                               const std::string &name,
+                                               HubLabelsImpl &labels);
+    friend void serialization::write<Ownership>(storage::tar::FileWriter &writer,
+                                                const std::string &name,
+                                                const HubLabelsImpl &labels);
+
+  private:
+    std::size_t GetLabelIndex(const NodeID node, const bool forward) const
+    {
+        BOOST_ASSERT(node < GetNumberOfNodes());
+        return 2 * static_cast<std::size_t>(node) + (forward ? 0 : 1);
+    }
+
+    NodeID DecodeDelta(std::uint64_t &byte) const
+    {
+        NodeID delta = 0;
+        unsigned shift = 0;
+        std::uint8_t value;
+        do
+        {
+            value = hubs[byte++];
+            delta |= static_cast<NodeID>(value & 0x7f) << shift;
+            shift += 7;
+        } while (value & 0x80);
+        return delta;
+    }
+
+    // index into weights and durations, per label
+    Vector<std::uint64_t> entry_offsets;
+    // index into the encoded hubs, per label
+    Vector<std::uint64_t> byte_offsets;
+    Vector<std::uint8_t> hubs;
+    Vector<EdgeWeight> weights;
+    Vector<EdgeDuration> durations;
+};
+}
+
+using HubLabels = detail::HubLabelsImpl<storage::Ownership::Container>;
+using HubLabelsView = detail::HubLabelsImpl<storage::Ownership::View>;
+}
+}
+
+#endif
@@ -1,7 +1,11 @@
 #ifndef OSRM_CONTRACTOR_SERIALIZATION_HPP
 #define OSRM_CONTRACTOR_SERIALIZATION_HPP
 
+#include "contractor/cch_topology.hpp"
 #include "contractor/contracted_metric.hpp"
+#include "contractor/hub_labels.hpp"
+#include "contractor/transit_nodes.hpp"
+#include "contractor/unpacked_shortcuts.hpp"
 
 #include "util/serialization.hpp"
 
@@ -46,6 +50,102 @@ void read(storage::tar::FileReader &reader,
                                      metric.edge_filter[index]);
     }
 }
+
+inline void
+write(storage::tar::FileWriter &writer, const std::string &name, const CCHTopology &topology)
+{
+    storage::serialization::write(writer, name + "/order", topology.order);
+    storage::serialization::write(writer, name + "/first_out", topology.first_out);
+    storage::serialization::write(writer, name + "/head", topology.head);
+}
+
+inline void read(storage::tar::FileReader &reader, const std::string &name, CCHTopology &topology)
+{
+    std::vector<NodeID> order;
+    std::vector<EdgeID> first_out;
+    std::vector<NodeID> head;
+    storage::serialization::read(reader, name + "/order", order);
+    storage::serialization::read(reader, name + "/first_out", first_out);
+    storage::serialization::read(reader, name + "/head", head);
+    topology = CCHTopology{std::move(order), std::move(first_out), std::move(head)};
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::tar::FileWriter &writer,
+                  const std::string &name,
+                  const detail::UnpackedShortcutsImpl<Ownership> &shortcuts)
+{
+    storage::serialization::write(writer, name + "/keys", shortcuts.keys);
+    storage::serialization::write(writer, name + "/offsets", shortcuts.offsets);
+    storage::serialization::write(writer, name + "/nodes", shortcuts.nodes);
+    storage::serialization::write(writer, name + "/edges", shortcuts.edges);
+}
+
+template <storage::Ownership Ownership>
+inline void read(storage::tar::FileReader &reader,
+                 const std::string &name,
+                 detail::UnpackedShortcutsImpl<Ownership> &shortcuts)
+{
+    storage::serialization::read(reader, name + "/keys", shortcuts.keys);
+    storage::serialization::read(reader, name + "/offsets", shortcuts.offsets);
+    storage::serialization::read(reader, name + "/nodes", shortcuts.nodes);
+    storage::serialization::read(reader, name + "/edges", shortcuts.edges);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::tar::FileWriter &writer,
+                  const std::string &name,
+                  const detail::HubLabelsImpl<Ownership> &labels)
+{
+    storage::serialization::write(writer, name + "/entry_offsets", labels.entry_offsets);
+    storage::serialization::write(writer, name + "/byte_offsets", labels.byte_offsets);
+    storage::serialization::write(writer, name + "/hubs", labels.hubs);
+    storage::serialization::write(writer, name + "/weights", labels.weights);
+    storage::serialization::write(writer, name + "/durations", labels.durations);
+}
+
+template <storage::Ownership Ownership>
+inline void read(storage::tar::FileReader &reader,
+                 const std::string &name,
+                 detail::HubLabelsImpl<Ownership> &labels)
+{
+    storage::serialization::read(reader, name + "/entry_offsets", labels.entry_offsets);
+    storage::serialization::read(reader, name + "/byte_offsets", labels.byte_offsets);
+    storage::serialization::read(reader, name + "/hubs", labels.hubs);
+    storage::serialization::read(reader, name + "/weights", labels.weights);
+    storage::serialization::read(reader, name + "/durations", labels.durations);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::tar::FileWriter &writer,
+                  const std::string &name,
+                  const detail::TransitNodesImpl<Ownership> &transit_nodes)
+{
+    storage::serialization::write(writer, name + "/transit_nodes", transit_nodes.transit_nodes);
+    storage::serialization::write(writer, name + "/table_weights", transit_nodes.table_weights);
+    storage::serialization::write(
+        writer, name + "/table_durations", transit_nodes.table_durations);
+    storage::serialization::write(writer, name + "/access_offsets", transit_nodes.access_offsets);
+    storage::serialization::write(writer, name + "/access_nodes", transit_nodes.access_nodes);
+    storage::serialization::write(writer, name + "/access_weights", transit_nodes.access_weights);
+    storage::serialization::write(
+        writer, name + "/access_durations", transit_nodes.access_durations);
+}
+
+template <storage::Ownership Ownership>
+inline void read(storage::tar::FileReader &reader,
+                 const std::string &name,
+                 detail::TransitNodesImpl<Ownership> &transit_nodes)
+{
+    storage::serialization::read(reader, name + "/transit_nodes", transit_nodes.transit_nodes);
+    storage::serialization::read(reader, name + "/table_weights", transit_nodes.table_weights);
+    storage::serialization::read(reader, name + "/table_durations", transit_nodes.table_durations);
+    storage::serialization::read(reader, name + "/access_offsets", transit_nodes.access_offsets);
+    storage::serialization::read(reader, name + "/access_nodes", transit_nodes.access_nodes);
+    storage::serialization::read(reader, name + "/access_weights", transit_nodes.access_weights);
+    storage::serialization::read(
+        reader, name + "/access_durations", transit_nodes.access_durations);
+}
 }
 }
 }
@@ -0,0 +1,23 @@
+#ifndef OSRM_CONTRACTOR_TRANSIT_NODE_ROUTING_HPP
+#define OSRM_CONTRACTOR_TRANSIT_NODE_ROUTING_HPP
+
+#include "contractor/query_graph.hpp"
+#include "contractor/transit_nodes.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Selects up to number_of_transit_nodes of the highest nodes of the filtered CH graph and
+// computes the table between them and the access nodes of all nodes.
+TransitNodes computeTransitNodes(const QueryGraph &graph,
+                                 const std::vector<bool> &edge_filter,
+                                 const std::size_t number_of_transit_nodes);
+}
+}
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef OSRM_CONTRACTOR_TRANSIT_NODES_HPP
+#define OSRM_CONTRACTOR_TRANSIT_NODES_HPP
+
+#include "storage/shared_memory_ownership.hpp"
+#include "storage/tar_fwd.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace osrm
+{
+namespace contractor
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class TransitNodesImpl;
+}
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::tar::FileReader &reader,
+                 const std::string &name,
+                 detail::TransitNodesImpl<Ownership> &transit_nodes);
+
+template <storage::Ownership Ownership>
+inline void write(storage::tar::FileWriter &writer,
+                  const std::string &name,
+                  const detail::TransitNodesImpl<Ownership> &transit_nodes);
+}
+
+namespace detail
+{
+// Transit node routing on top of the contraction hierarchy.
+//
+// The transit nodes are the most important nodes of the hierarchy. They are closed upwards:
+// every node that can be reached by an upward edge from a transit node is a transit node, too.
+// The shortest weights between all pairs of transit nodes are stored in a table. Each node
+// stores its forward and backward access nodes, the first transit nodes that are settled by an
+// upward search that does not continue at transit nodes.
+//
+// Every shortest path that passes a transit node leaves the search space of the source through a
+// forward access node and enters the one of the target through a backward access node, so its
+// weight is the minimum over all pairs of access nodes. Paths that stay below the transit nodes
+// are not covered, callers need to detect these local queries and fall back to a CH search:
+// the highest node of such a path is reached from both ends by upward edges without passing a
+// transit node.
+template <storage::Ownership Ownership> class TransitNodesImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    TransitNodesImpl() = default;
+
+    TransitNodesImpl(Vector<NodeID> transit_nodes_,
+                     Vector<EdgeWeight> table_weights_,
+                     Vector<EdgeDuration> table_durations_,
+                     Vector<std::uint64_t> access_offsets_,
+                     Vector<std::uint32_t> access_nodes_,
+                     Vector<EdgeWeight> access_weights_,
+                     Vector<EdgeDuration> access_durations_)
+        : transit_nodes(std::move(transit_nodes_)), table_weights(std::move(table_weights_)),
+          table_durations(std::move(table_durations_)), access_offsets(std::move(access_offsets_)),
+          access_nodes(std::move(access_nodes_)), access_weights(std::move(access_weights_)),
+          access_durations(std::move(access_durations_))
+    {
+        BOOST_ASSERT(table_weights.size() == transit_nodes.size() * transit_nodes.size());
+        BOOST_ASSERT(table_weights.size() == table_durations.size());
+        BOOST_ASSERT(access_offsets.empty() || access_offsets.size() % 2 == 1);
+        BOOST_ASSERT(access_nodes.size() == access_weights.size());
+        BOOST_ASSERT(access_nodes.size() == access_durations.size());
+    }
+
+    bool Empty() const { return access_offsets.empty(); }
+
+    std::size_t GetNumberOfNodes() const
+    {
+        return access_offsets.empty() ? 0 : (access_offsets.size() - 1) / 2;
+    }
+
+    std::size_t GetNumberOfTransitNodes() const { return transit_nodes.size(); }
+
+    std::size_t GetNumberOfAccessNodes() const { return access_nodes.size(); }
+
+    NodeID GetTransitNode(const std::uint32_t transit_index) const
+    {
+        return transit_nodes[transit_index];
+    }
+
+    // Transit nodes are their own and only access node
+    bool IsTransitNode(const NodeID node) const
+    {
+        BOOST_ASSERT(node < GetNumberOfNodes());
+        const auto index = 2 * static_cast<std::size_t>(node);
+        return access_offsets[index + 1] - access_offsets[index] == 1 &&
+               transit_nodes[access_nodes[access_offsets[index]]] == node;
+    }
+
+    // Shortest weight and duration between two transit nodes given by their index,
+    // INVALID_EDGE_WEIGHT if the second one can't be reached
+    std::pair<EdgeWeight, EdgeDuration> GetTableEntry(const std::uint32_t from_index,
+                                                      const std::uint32_t to_index) const
+    {
+        BOOST_ASSERT(from_index < transit_nodes.size() && to_index < transit_nodes.size());
+        const auto index = from_index * transit_nodes.size() + to_index;
+        return std::make_pair(table_weights[index], table_durations[index]);
+    }
+
+    // Calls callback(transit_index, weight, duration) for all forward access nodes (paths
+    // starting at the node) or backward access nodes (paths ending at the node)
+    template <typename Callback>
+    void ForEachAccessNode(const NodeID node, const bool forward, Callback &&callback) const
+    {
+        BOOST_ASSERT(node < GetNumberOfNodes());
+        const auto index = 2 * static_cast<std::size_t>(node) + (forward ? 0 : 1);
+        for (auto entry = access_offsets[index]; entry < access_offsets[index + 1]; ++entry)
+        {
+            callback(access_nodes[entry], access_weights[entry], access_durations[entry]);
+        }
+    }
+
+    // Returns the shortest weight and its duration of all paths from source to target that
+    // pass a transit node, INVALID_EDGE_WEIGHT if there is no such path
+    std::pair<EdgeWeight, EdgeDuration> Query(const NodeID source, const NodeID target) const
+    {
+        BOOST_ASSERT(source < GetNumberOfNodes() && target < GetNumberOfNodes());
+        const auto source_index = 2 * static_cast<std::size_t>(source);
+        const auto target_index = 2 * static_cast<std::size_t>(target) + 1;
+
+        std::pair<EdgeWeight, EdgeDuration> best{INVALID_EDGE_WEIGHT, MAXIMAL_EDGE_DURATION};
+        for (auto source_entry = access_offsets[source_index];
+             source_entry < access_offsets[source_index + 1];
+             ++source_entry)
+        {
+            for (auto target_entry = access_offsets[target_index];
+                 target_entry < access_offsets[target_index + 1];
+                 ++target_entry)
+            {
+                const auto entry =
+                    GetTableEntry(access_nodes[source_entry], access_nodes[target_entry]);
+                if (entry.first == INVALID_EDGE_WEIGHT)
+                    continue;
+
+                best = std::min(
+                    best,
+                    std::make_pair(
+                        access_weights[source_entry] + entry.first + access_weights[target_entry],
+                        access_durations[source_entry] + entry.second +
+                            access_durations[target_entry]));
+            }
+        }
+        return best;
+    }
+
+    friend void serialization::read<Ownership>(storage::tar::FileReader &reader,
+                                               const std::string &name,
+                                               TransitNodesImpl &transit_nodes);
+    friend void serialization::write<Ownership>(storage::tar::FileWriter &writer,
+                                                const std::string &name,
+                                                const TransitNodesImpl &transit_nodes);
+
+  private:
+    Vector<NodeID> transit_nodes;
+    // row-major tables over the transit node indices
+    Vector<EdgeWeight> table_weights;
+    Vector<EdgeDuration> table_durations;
+    // index into the access node entries, forward and backward range per node
+    Vector<std::uint64_t> access_offsets;
+    // transit node index of every access node entry
+    Vector<std::uint32_t> access_nodes;
+    Vector<EdgeWeight> access_weights;
+    Vector<EdgeDuration> access_durations;
+};
+}
+
+using TransitNodes = detail::TransitNodesImpl<storage::Ownership::Container>;
+using TransitNodesView = detail::TransitNodesImpl<storage::Ownership::View>;
+}
+}
+
+#endif
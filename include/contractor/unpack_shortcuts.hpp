@@ -0,0 +1,153 @@
+#ifndef OSRM_CONTRACTOR_UNPACK_SHORTCUTS_HPP
+#define OSRM_CONTRACTOR_UNPACK_SHORTCUTS_HPP
+
+#include "contractor/query_graph.hpp"
+#include "contractor/unpacked_shortcuts.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <stack>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace detail
+{
+// Same edge selection as FilteredGraphView::FindSmallestEdge used by the query
+inline EdgeID findSmallestEdge(const contractor::QueryGraph &graph,
+                               const std::vector<bool> &edge_filter,
+                               const NodeID from,
+                               const NodeID to,
+                               const bool forward)
+{
+    EdgeID smallest_edge = SPECIAL_EDGEID;
+    EdgeWeight smallest_weight = INVALID_EDGE_WEIGHT;
+    for (const auto edge : graph.GetAdjacentEdgeRange(from))
+    {
+        if (!edge_filter[edge])
+            continue;
+
+        const auto &data = graph.GetEdgeData(edge);
+        if (graph.GetTarget(edge) == to && data.weight < smallest_weight &&
+            (forward ? data.forward : data.backward))
+        {
+            smallest_edge = edge;
+            smallest_weight = data.weight;
+        }
+    }
+    return smallest_edge;
+}
+
+// Resolves a node pair of a packed path the way ch::unpackPath does
+inline std::pair<EdgeID, bool> findPathEdge(const contractor::QueryGraph &graph,
+                                            const std::vector<bool> &edge_filter,
+                                            const NodeID first,
+                                            const NodeID second)
+{
+    const auto forward_edge = findSmallestEdge(graph, edge_filter, first, second, true);
+    if (forward_edge != SPECIAL_EDGEID)
+        return std::make_pair(forward_edge, false);
+    return std::make_pair(findSmallestEdge(graph, edge_filter, second, first, false), true);
+}
+
+// Expands the node pair first -> second into the targets and edge IDs of its original edges
+inline void unpackNodePair(const contractor::QueryGraph &graph,
+                           const std::vector<bool> &edge_filter,
+                           const NodeID first,
+                           const NodeID second,
+                           std::vector<NodeID> &unpacked_nodes,
+                           std::vector<EdgeID> &unpacked_edges)
+{
+    std::stack<std::pair<NodeID, NodeID>> recursion_stack;
+    recursion_stack.emplace(first, second);
+
+    while (!recursion_stack.empty())
+    {
+        const auto node_pair = recursion_stack.top();
+        recursion_stack.pop();
+
+        const auto edge = findPathEdge(graph, edge_filter, node_pair.first, node_pair.second).first;
+        BOOST_ASSERT(edge != SPECIAL_EDGEID);
+
+        const auto &data = graph.GetEdgeData(edge);
+        if (data.shortcut)
+        {
+            recursion_stack.emplace(data.turn_id, node_pair.second);
+            recursion_stack.emplace(node_pair.first, data.turn_id);
+        }
+        else
+        {
+            unpacked_nodes.push_back(node_pair.second);
+            unpacked_edges.push_back(edge);
+        }
+    }
+}
+}
+
+// Precomputes the unpacking of all shortcuts of the filtered graph that consist of at least
+// `min_original_edges` original edges. A shortcut is only stored for the direction in which
+// the query would actually pick it when unpacking a node pair.
+inline UnpackedShortcuts unpackShortcuts(const QueryGraph &graph,
+                                         const std::vector<bool> &edge_filter,
+                                         const std::size_t min_original_edges)
+{
+    BOOST_ASSERT(edge_filter.size() == graph.GetNumberOfEdges());
+
+    UnpackedShortcuts shortcuts;
+    std::vector<NodeID> unpacked_nodes;
+    std::vector<EdgeID> unpacked_edges;
+
+    const auto add_shortcut = [&](const EdgeID edge,
+                                  const bool reverse,
+                                  const NodeID first,
+                                  const NodeID second) {
+        unpacked_nodes.clear();
+        unpacked_edges.clear();
+        detail::unpackNodePair(graph, edge_filter, first, second, unpacked_nodes, unpacked_edges);
+        if (unpacked_edges.size() >= min_original_edges)
+        {
+            shortcuts.Add(edge,
+                          reverse,
+                          unpacked_nodes.begin(),
+                          unpacked_nodes.end(),
+                          unpacked_edges.begin());
+        }
+    };
+
+    for (const auto node : util::irange<NodeID>(0, graph.GetNumberOfNodes()))
+    {
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            if (!edge_filter[edge] || !data.shortcut)
+                continue;
+
+            const auto target = graph.GetTarget(edge);
+            const auto forward_key = std::make_pair(edge, false);
+            const auto backward_key = std::make_pair(edge, true);
+            if (data.forward &&
+                detail::findPathEdge(graph, edge_filter, node, target) == forward_key)
+            {
+                add_shortcut(edge, false, node, target);
+            }
+            if (data.backward &&
+                detail::findPathEdge(graph, edge_filter, target, node) == backward_key)
+            {
+                add_shortcut(edge, true, target, node);
+            }
+        }
+    }
+
+    return shortcuts;
+}
+}
+}
+
+#endif
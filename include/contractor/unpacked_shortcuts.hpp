@@ -0,0 +1,144 @@
+#ifndef OSRM_CONTRACTOR_UNPACKED_SHORTCUTS_HPP
+#define OSRM_CONTRACTOR_UNPACKED_SHORTCUTS_HPP
+
+#include "storage/shared_memory_ownership.hpp"
+#include "storage/tar_fwd.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+
+namespace osrm
+{
+namespace contractor
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class UnpackedShortcutsImpl;
+}
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::tar::FileReader &reader,
+                 const std::string &name,
+                 detail::UnpackedShortcutsImpl<Ownership> &shortcuts);
+
+template <storage::Ownership Ownership>
+inline void write(storage::tar::FileWriter &writer,
+                  const std::string &name,
+                  const detail::UnpackedShortcutsImpl<Ownership> &shortcuts);
+}
+
+namespace detail
+{
+// Stores the fully unpacked original edges of selected CH shortcuts.
+//
+// A shortcut is identified by its edge ID and by the direction in which the query unpacking
+// resolves it: either as a forward edge of the first node of a node pair, or as a backward edge
+// stored at the second node. For every shortcut we save the target node and the CH edge ID of
+// every original edge in path order, so unpacking it does not need any adjacency scans.
+template <storage::Ownership Ownership> class UnpackedShortcutsImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    using ShortcutKey = std::uint64_t;
+    static constexpr std::size_t INVALID_SHORTCUT = std::numeric_limits<std::size_t>::max();
+
+    static ShortcutKey MakeKey(const EdgeID edge, const bool reverse)
+    {
+        return (static_cast<ShortcutKey>(edge) << 1) | (reverse ? 1 : 0);
+    }
+
+    UnpackedShortcutsImpl() = default;
+
+    UnpackedShortcutsImpl(Vector<ShortcutKey> keys_,
+                          Vector<std::uint64_t> offsets_,
+                          Vector<NodeID> nodes_,
+                          Vector<EdgeID> edges_)
+        : keys(std::move(keys_)), offsets(std::move(offsets_)), nodes(std::move(nodes_)),
+          edges(std::move(edges_))
+    {
+        BOOST_ASSERT(offsets.empty() ? keys.empty() : offsets.size() == keys.size() + 1);
+        BOOST_ASSERT(nodes.size() == edges.size());
+        BOOST_ASSERT(std::is_sorted(keys.begin(), keys.end()));
+    }
+
+    // Appends a shortcut, shortcuts need to be added in ascending key order
+    template <typename NodeIter, typename EdgeIter>
+    void Add(const EdgeID edge,
+             const bool reverse,
+             NodeIter nodes_begin,
+             NodeIter nodes_end,
+             EdgeIter edges_begin)
+    {
+        static_assert(Ownership == storage::Ownership::Container, "Only containers can be built");
+        const auto key = MakeKey(edge, reverse);
+        BOOST_ASSERT(keys.empty() || keys.back() < key);
+        if (offsets.empty())
+            offsets.push_back(0);
+        keys.push_back(key);
+        nodes.insert(nodes.end(), nodes_begin, nodes_end);
+        edges.insert(edges.end(), edges_begin, edges_begin + std::distance(nodes_begin, nodes_end));
+        offsets.push_back(nodes.size());
+    }
+
+    bool Empty() const { return keys.empty(); }
+
+    std::size_t GetNumberOfShortcuts() const { return keys.size(); }
+
+    std::size_t GetNumberOfOriginalEdges() const { return edges.size(); }
+
+    // Returns the index of the unpacked shortcut or INVALID_SHORTCUT if it was not precomputed
+    std::size_t Find(const EdgeID edge, const bool reverse) const
+    {
+        const auto key = MakeKey(edge, reverse);
+        const auto iter = std::lower_bound(keys.begin(), keys.end(), key);
+        if (iter == keys.end() || *iter != key)
+            return INVALID_SHORTCUT;
+        return std::distance(keys.begin(), iter);
+    }
+
+    // Calls callback(target_node, original_edge) for all original edges of the shortcut
+    template <typename Callback>
+    void ForEachEdge(const std::size_t shortcut, Callback &&callback) const
+    {
+        BOOST_ASSERT(shortcut < keys.size());
+        for (auto index = offsets[shortcut]; index < offsets[shortcut + 1]; ++index)
+        {
+            callback(nodes[index], edges[index]);
+        }
+    }
+
+    friend void serialization::read<Ownership>(storage::tar::FileReader &reader,
+                                               const std::string &name,
+                                               UnpackedShortcutsImpl &shortcuts);
+    friend void serialization::write<Ownership>(storage::tar::FileWriter &writer,
+                                                const std::string &name,
+                                                const UnpackedShortcutsImpl &shortcuts);
+
+  private:
+    Vector<ShortcutKey> keys;
+    Vector<std::uint64_t> offsets;
+    Vector<NodeID> nodes;
+    Vector<EdgeID> edges;
+};
+
+template <storage::Ownership Ownership>
+constexpr std::size_t UnpackedShortcutsImpl<Ownership>::INVALID_SHORTCUT;
+}
+
+using UnpackedShortcuts = detail::UnpackedShortcutsImpl<storage::Ownership::Container>;
+using UnpackedShortcutsView = detail::UnpackedShortcutsImpl<storage::Ownership::View>;
+}
+}
+
+#endif
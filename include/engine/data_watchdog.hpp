@@ -3,7 +3,9 @@
 
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 #include "engine/datafacade/shared_memory_allocator.hpp"
+#include "engine/datafacade/validate_index.hpp"
 #include "engine/datafacade_factory.hpp"
+#include "engine/replicated_datafacade_factory.hpp"
 
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
@@ -14,6 +16,8 @@
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <exception>
+#include <functional>
 #include <memory>
 #include <thread>
 
@@ -36,9 +40,20 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
     using Facade = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    DataWatchdogImpl(const std::string &dataset_name) : dataset_name(dataset_name), active(true)
+    using FacadeFactory =
+        ReplicatedDataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT>;
+    // Called with the facades of a new dataset before they serve any request
+    using WarmupFunction = std::function<void(const FacadeFactory &)>;
+
+    DataWatchdogImpl(const std::string &dataset_name,
+                     const bool replicate_numa = false,
+                     const bool prefault = false,
+                     WarmupFunction warmup = {})
+        : dataset_name(dataset_name), replicate_numa(replicate_numa), prefault(prefault),
+          warmup(std::move(warmup)), active(true)
     {
         // create the initial facade before launching the watchdog thread
+        std::shared_ptr<datafacade::SharedMemoryAllocator> allocator;
         {
             boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
@@ -56,12 +71,13 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
             static_region = *static_shared_region;
             updatable_region = *updatable_shared_region;
 
-            facade_factory =
-                DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT>(
-                    std::make_shared<datafacade::SharedMemoryAllocator>(
-                        std::vector<storage::SharedRegionRegister::ShmKey>{
-                            static_region.shm_key, updatable_region.shm_key}));
+            allocator = std::make_shared<datafacade::SharedMemoryAllocator>(
+                std::vector<storage::SharedRegionRegister::ShmKey>{static_region.shm_key,
+                                                                   updatable_region.shm_key});
         }
+        datafacade::validateIndex(allocator->GetIndex());
+        facade_factory =
+            std::make_shared<const FacadeFactory>(std::move(allocator), replicate_numa, prefault);
 
         watcher = std::thread(&DataWatchdogImpl::Run, this);
     }
@@ -73,22 +89,32 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
         watcher.join();
     }
 
+    // The facades keep their allocator and with it the regions of their dataset alive, so
+    // requests finish on the dataset they started with while a new one is published.
     std::shared_ptr<const Facade> Get(const api::BaseParameters &params) const
     {
-        return facade_factory.Get(params);
+        return std::atomic_load(&facade_factory)->Get(params);
     }
     std::shared_ptr<const Facade> Get(const api::TileParameters &params) const
     {
-        return facade_factory.Get(params);
+        return std::atomic_load(&facade_factory)->Get(params);
     }
 
   private:
     void Run()
     {
+        bool retry_on_notification = false;
         while (active)
         {
             boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
+            // a failed update is tried again on the next notification, not right away
+            if (retry_on_notification)
+            {
+                barrier.wait(current_region_lock);
+                retry_on_notification = false;
+            }
+
             while (active && static_region.timestamp == static_shared_region->timestamp &&
                    updatable_region.timestamp == updatable_shared_region->timestamp)
             {
@@ -98,30 +124,52 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
             if (!active)
                 break;
 
-            if (static_region.timestamp != static_shared_region->timestamp)
+            // the current regions are only replaced once the new ones are published
+            const auto new_static_region = *static_shared_region;
+            const auto new_updatable_region = *updatable_shared_region;
+
+            util::Log() << "updating facade to regions " << (int)new_static_region.shm_key
+                        << " and " << (int)new_updatable_region.shm_key << " with timestamps "
+                        << new_static_region.timestamp << " and "
+                        << new_updatable_region.timestamp;
+
+            // The regions are attached while holding the lock, so they can not be removed in
+            // between. Preparing the facades can take a while and does not block osrm-datastore.
+            auto allocator = std::make_shared<datafacade::SharedMemoryAllocator>(
+                std::vector<storage::SharedRegionRegister::ShmKey>{new_static_region.shm_key,
+                                                                   new_updatable_region.shm_key});
+            current_region_lock.unlock();
+
+            // The new dataset is validated, prepared and warmed up before it is published. If
+            // that fails the current dataset keeps serving requests.
+            try
             {
-                static_region = *static_shared_region;
+                datafacade::validateIndex(allocator->GetIndex());
+                auto new_facade_factory = std::make_shared<const FacadeFactory>(
+                    std::move(allocator), replicate_numa, prefault);
+                if (warmup)
+                {
+                    warmup(*new_facade_factory);
+                }
+                std::atomic_store(&facade_factory, std::move(new_facade_factory));
+                static_region = new_static_region;
+                updatable_region = new_updatable_region;
             }
-            if (updatable_region.timestamp != updatable_shared_region->timestamp)
+            catch (const std::exception &e)
             {
-                updatable_region = *updatable_shared_region;
+                util::Log(logERROR) << "Could not update the facade, keeping the current dataset: "
+                                    << e.what();
+                retry_on_notification = true;
             }
-
-            util::Log() << "updated facade to regions " << (int)static_region.shm_key << " and "
-                        << (int)updatable_region.shm_key << " with timestamps "
-                        << static_region.timestamp << " and " << updatable_region.timestamp;
-
-            facade_factory =
-                DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT>(
-                    std::make_shared<datafacade::SharedMemoryAllocator>(
-                        std::vector<storage::SharedRegionRegister::ShmKey>{
-                            static_region.shm_key, updatable_region.shm_key}));
         }
 
         util::Log() << "DataWatchdog thread stopped";
     }
 
     const std::string dataset_name;
+    const bool replicate_numa;
+    const bool prefault;
+    const WarmupFunction warmup;
     storage::SharedMonitor<storage::SharedRegionRegister> barrier;
     std::thread watcher;
     bool active;
@@ -129,7 +177,8 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
     storage::SharedRegion updatable_region;
     storage::SharedRegion *static_shared_region;
     storage::SharedRegion *updatable_shared_region;
-    DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT> facade_factory;
+    // replaced atomically, readers take a reference for the duration of a request
+    std::shared_ptr<const FacadeFactory> facade_factory;
 };
 }
 
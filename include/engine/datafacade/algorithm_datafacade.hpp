@@ -1,7 +1,10 @@
 #ifndef OSRM_ENGINE_DATAFACADE_ALGORITHM_DATAFACADE_HPP
 #define OSRM_ENGINE_DATAFACADE_ALGORITHM_DATAFACADE_HPP
 
+#include "contractor/hub_labels.hpp"
 #include "contractor/query_edge.hpp"
+#include "contractor/transit_nodes.hpp"
+#include "contractor/unpacked_shortcuts.hpp"
 #include "customizer/edge_based_graph.hpp"
 #include "extractor/edge_based_edge.hpp"
 #include "engine/algorithm.hpp"
@@ -55,6 +58,15 @@ template <> class AlgorithmDataFacade<CH>
     virtual EdgeID FindSmallestEdge(const NodeID from,
                                     const NodeID to,
                                     const std::function<bool(EdgeData)> filter) const = 0;
+
+    // precomputed unpacking of shortcuts, empty if .osrm.shortcuts was not generated
+    virtual const contractor::UnpackedShortcutsView &GetUnpackedShortcuts() const = 0;
+
+    // hub labels of all nodes, empty if .osrm.hub_labels was not generated
+    virtual const contractor::HubLabelsView &GetHubLabels() const = 0;
+
+    // transit nodes with their table and access nodes, empty if .osrm.tnr was not generated
+    virtual const contractor::TransitNodesView &GetTransitNodes() const = 0;
 };
 
 template <> class AlgorithmDataFacade<MLD>
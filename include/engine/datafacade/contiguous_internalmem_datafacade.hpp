@@ -20,6 +20,7 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <iterator>
 #include <limits>
@@ -35,6 +36,15 @@ namespace engine
 namespace datafacade
 {
 
+namespace detail
+{
+inline std::uint64_t nextFacadeGeneration()
+{
+    static std::atomic<std::uint64_t> generation{0};
+    return ++generation;
+}
+}
+
 template <typename AlgorithmT> class ContiguousInternalMemoryAlgorithmDataFacade;
 
 template <>
@@ -46,6 +56,9 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     using GraphEdge = QueryGraph::EdgeArrayEntry;
 
     QueryGraph m_query_graph;
+    contractor::UnpackedShortcutsView m_unpacked_shortcuts;
+    contractor::HubLabelsView m_hub_labels;
+    contractor::TransitNodesView m_transit_nodes;
 
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
@@ -66,6 +79,27 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     {
         m_query_graph =
             make_filtered_graph_view(index, "/ch/metrics/" + metric_name, exclude_index);
+
+        const auto shortcuts_prefix = "/ch/metrics/" + metric_name + "/unpacked_shortcuts/" +
+                                      std::to_string(exclude_index);
+        if (index.HasBlock(shortcuts_prefix + "/keys"))
+        {
+            m_unpacked_shortcuts = make_unpacked_shortcuts_view(index, shortcuts_prefix);
+        }
+
+        const auto labels_prefix =
+            "/ch/metrics/" + metric_name + "/hub_labels/" + std::to_string(exclude_index);
+        if (index.HasBlock(labels_prefix + "/entry_offsets"))
+        {
+            m_hub_labels = make_hub_labels_view(index, labels_prefix);
+        }
+
+        const auto transit_prefix =
+            "/ch/metrics/" + metric_name + "/transit_nodes/" + std::to_string(exclude_index);
+        if (index.HasBlock(transit_prefix + "/access_offsets"))
+        {
+            m_transit_nodes = make_transit_nodes_view(index, transit_prefix);
+        }
     }
 
     // search graph access
@@ -113,6 +147,18 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     {
         return m_query_graph.FindSmallestEdge(from, to, filter);
     }
+
+    const contractor::UnpackedShortcutsView &GetUnpackedShortcuts() const override final
+    {
+        return m_unpacked_shortcuts;
+    }
+
+    const contractor::HubLabelsView &GetHubLabels() const override final { return m_hub_labels; }
+
+    const contractor::TransitNodesView &GetTransitNodes() const override final
+    {
+        return m_transit_nodes;
+    }
 };
 
 /**
@@ -132,6 +178,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     using SharedGeospatialQuery = GeospatialQuery<SharedRTree, BaseDataFacade>;
     using RTreeNode = SharedRTree::TreeNode;
 
+    std::uint64_t m_generation;
     extractor::ClassData exclude_mask;
     extractor::ProfileProperties *m_profile_properties;
     extractor::Datasources *m_datasources;
@@ -188,7 +235,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
         m_static_rtree = make_search_tree_view(index, "/common/rtree");
         m_geospatial_query.reset(
-            new SharedGeospatialQuery(m_static_rtree, m_coordinate_list, *this));
+            new SharedGeospatialQuery(m_static_rtree, m_coordinate_list, *this, exclude_mask));
 
         edge_based_node_data = make_ebn_data_view(index, "/common/ebg_node_data");
 
@@ -222,7 +269,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     ContiguousInternalMemoryDataFacadeBase(std::shared_ptr<ContiguousBlockAllocator> allocator_,
                                            const std::string &metric_name,
                                            const std::size_t exclude_index)
-        : allocator(std::move(allocator_))
+        : m_generation(detail::nextFacadeGeneration()), allocator(std::move(allocator_))
     {
         InitializeInternalPointers(allocator->GetIndex(), metric_name, exclude_index);
     }
@@ -428,8 +475,27 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             input_coordinate, bearing, bearing_range, approach);
     }
 
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<PhantomNodeQuery> &queries) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodesInRange(queries);
+    }
+
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<PhantomNodeQuery> &queries) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodesWithAlternativeFromBigComponent(queries);
+    }
+
     std::uint32_t GetCheckSum() const override final { return m_check_sum; }
 
+    std::uint64_t GetGeneration() const override final { return m_generation; }
+
     GeometryID GetGeometryIndex(const NodeID id) const override final
     {
         return edge_based_node_data.GetGeometryID(id);
@@ -5,6 +5,7 @@
 
 #include "engine/approach.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/phantom_node_query.hpp"
 
 #include "contractor/query_edge.hpp"
 
@@ -74,6 +75,10 @@ class BaseDataFacade
 
     virtual std::uint32_t GetCheckSum() const = 0;
 
+    // Unique identifier of this facade: a new facade is created for every dataset,
+    // metric and exclude combination, so this can be used to key data derived from it.
+    virtual std::uint64_t GetGeneration() const = 0;
+
     // node and edge information access
     virtual util::Coordinate GetCoordinateOfNode(const NodeID id) const = 0;
 
@@ -174,6 +179,13 @@ class BaseDataFacade
                                                       const int bearing_range,
                                                       const Approach approach) const = 0;
 
+    // Batched versions of the lookups above, the results are in the order of the queries
+    virtual std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<PhantomNodeQuery> &queries) const = 0;
+    virtual std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<PhantomNodeQuery> &queries) const = 0;
+
     virtual bool HasLaneData(const EdgeID id) const = 0;
     virtual util::guidance::LaneTupleIdPair GetLaneData(const EdgeID id) const = 0;
     virtual extractor::TurnLaneDescription
@@ -0,0 +1,58 @@
+#ifndef OSRM_ENGINE_DATAFACADE_HOT_BLOCKS_HPP_
+#define OSRM_ENGINE_DATAFACADE_HOT_BLOCKS_HPP_
+
+#include "storage/shared_data_index.hpp"
+
+#include "util/prefault.hpp"
+
+#include <boost/function_output_iterator.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+// The blocks that are read by every query: the query graph, the cell metrics, the coordinates
+// and the R-tree. The hub labels of a CH metric are only read by table requests and are much
+// larger than the graph, so they are left out.
+inline bool isHotBlock(const std::string &name)
+{
+    static const std::array<std::string, 8> prefixes = {{"/ch/metrics/",
+                                                         "/mld/metrics/",
+                                                         "/mld/multilevelgraph/",
+                                                         "/mld/multilevelpartition/",
+                                                         "/mld/cellstorage/",
+                                                         "/common/nbn_data/coordinates",
+                                                         "/common/rtree/",
+                                                         "/common/ebg_node_data/"}};
+    if (name.find("/hub_labels/") != std::string::npos)
+        return false;
+    return std::any_of(prefixes.begin(), prefixes.end(), [&](const auto &prefix) {
+        return name.compare(0, prefix.size(), prefix) == 0;
+    });
+}
+
+// Brings the pages of all hot blocks into memory, so the first queries do not wait on page
+// faults
+inline void prefaultHotBlocks(const storage::SharedDataIndex &index)
+{
+    index.List("", boost::make_function_output_iterator([&](const auto &name) {
+                   if (isHotBlock(name))
+                   {
+                       util::PrefaultMemory(index.GetBlockPtr<char>(name),
+                                            index.GetBlockSize(name));
+                   }
+               }));
+}
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_HOT_BLOCKS_HPP_
@@ -0,0 +1,47 @@
+#ifndef OSRM_ENGINE_DATAFACADE_MMAP_TAR_ALLOCATOR_HPP_
+#define OSRM_ENGINE_DATAFACADE_MMAP_TAR_ALLOCATOR_HPP_
+
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include "storage/storage_config.hpp"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This allocator maps the .osrm files into memory and points every block directly at its data in
+ * the mapped file, nothing is copied. The data of every file in a tar archive starts at a multiple
+ * of 512 bytes, which satisfies the alignment of the blocks. The files are mapped copy-on-write,
+ * so the pages are shared with every other process that maps the same files. Compressed files
+ * are decompressed into process memory.
+ */
+class MMapTarAllocator : public ContiguousBlockAllocator
+{
+  public:
+    explicit MMapTarAllocator(const storage::StorageConfig &config);
+    ~MMapTarAllocator() override final;
+
+    // interface to give access to the datafacades
+    const storage::SharedDataIndex &GetIndex() override final;
+
+  private:
+    storage::SharedDataIndex index;
+    std::vector<boost::iostreams::mapped_file> mapped_files;
+    std::unique_ptr<char[]> file_index_path_memory;
+    std::vector<std::unique_ptr<char[]>> decompressed_blocks;
+};
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_MMAP_TAR_ALLOCATOR_HPP_
@@ -0,0 +1,44 @@
+#ifndef OSRM_ENGINE_DATAFACADE_NUMA_REPLICA_ALLOCATOR_HPP_
+#define OSRM_ENGINE_DATAFACADE_NUMA_REPLICA_ALLOCATOR_HPP_
+
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This allocator copies the blocks that are read on every query (the query graph, the cell
+ * metrics, the coordinates and the R-tree) of another allocator into memory of one NUMA node.
+ * The copy is made by a thread pinned to the CPUs of the node, so the pages are placed on that
+ * node by the kernel. All other blocks are shared with the other allocator, which is kept alive.
+ */
+class NUMAReplicaAllocator : public ContiguousBlockAllocator
+{
+  public:
+    NUMAReplicaAllocator(std::shared_ptr<ContiguousBlockAllocator> allocator,
+                         const std::size_t node,
+                         const std::vector<unsigned> &node_cpus);
+    ~NUMAReplicaAllocator() override final;
+
+    // interface to give access to the datafacades
+    const storage::SharedDataIndex &GetIndex() override final;
+
+  private:
+    std::shared_ptr<ContiguousBlockAllocator> allocator;
+    std::unique_ptr<char[]> replica_memory;
+    storage::SharedDataIndex index;
+};
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_NUMA_REPLICA_ALLOCATOR_HPP_
@@ -5,6 +5,7 @@
 #include "engine/datafacade/contiguous_block_allocator.hpp"
 
 #include <memory>
+#include <vector>
 
 namespace osrm
 {
@@ -17,8 +18,9 @@ namespace datafacade
  * This allocator uses a process-local memory block to load
  * data into.  The structure and layout is the same as when using
  * shared memory.
- * This class holds a unique_ptr to the memory block, so it
- * is auto-freed upon destruction.
+ * This class holds a shared_ptr to the memory blocks, so they
+ * are auto-freed upon destruction. The names and nodes are
+ * shared with other datasets of the process if they are identical.
  */
 class ProcessMemoryAllocator : public ContiguousBlockAllocator
 {
@@ -31,7 +33,8 @@ class ProcessMemoryAllocator : public ContiguousBlockAllocator
 
   private:
     storage::SharedDataIndex index;
-    std::unique_ptr<char[]> internal_memory;
+    std::shared_ptr<char> internal_memory;
+    std::vector<std::shared_ptr<char>> shared_memory;
 };
 
 } // namespace datafacade
@@ -0,0 +1,32 @@
+#ifndef OSRM_ENGINE_DATAFACADE_SHARED_BLOCKS_HPP_
+#define OSRM_ENGINE_DATAFACADE_SHARED_BLOCKS_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+// The blocks that only depend on the extract and are often identical for all profiles: the names
+// and the coordinates and OSM ids of the nodes
+bool isShareableBlock(const std::string &name);
+
+// Returns the memory of a block with the same name and content that was loaded by another
+// dataset of this process and is still in use. Otherwise the given memory is registered for
+// other datasets and returned. The memory holds the block of byte_size bytes at data. The block
+// is compared after it was loaded, so the duplicate takes memory until it is freed.
+std::shared_ptr<char> shareBlock(const std::string &name,
+                                 std::shared_ptr<char> memory,
+                                 const char *data,
+                                 const std::size_t byte_size);
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_SHARED_BLOCKS_HPP_
@@ -0,0 +1,78 @@
+#ifndef OSRM_ENGINE_DATAFACADE_VALIDATE_INDEX_HPP_
+#define OSRM_ENGINE_DATAFACADE_VALIDATE_INDEX_HPP_
+
+#include "storage/shared_data_index.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/static_rtree.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+namespace detail
+{
+inline void checkConnectivityChecksum(const storage::SharedDataIndex &index,
+                                      const std::string &name)
+{
+    if (!index.HasBlock(name))
+        return;
+
+    const auto turns_connectivity_checksum =
+        *index.GetBlockPtr<std::uint32_t>("/common/connectivity_checksum");
+    const auto graph_connectivity_checksum = *index.GetBlockPtr<std::uint32_t>(name);
+    if (turns_connectivity_checksum != graph_connectivity_checksum)
+    {
+        throw util::exception("Connectivity checksum " +
+                              std::to_string(graph_connectivity_checksum) + " of " + name +
+                              " does not equal to checksum " +
+                              std::to_string(turns_connectivity_checksum) +
+                              " of /common/connectivity_checksum");
+    }
+}
+
+inline void checkRTreeFormat(const storage::SharedDataIndex &index)
+{
+    const auto format_version = *index.GetBlockPtr<std::uint32_t>("/common/rtree/format_version");
+    if (format_version != util::RTREE_FORMAT_VERSION)
+    {
+        throw util::exception("The R-tree has format version " + std::to_string(format_version) +
+                              " but this version of OSRM reads version " +
+                              std::to_string(util::RTREE_FORMAT_VERSION) +
+                              ", the dataset needs to be extracted again" + SOURCE_REF);
+    }
+}
+}
+
+// Checks that the blocks every facade reads are present, that the graphs were built for the
+// same turns and that the R-tree has the current layout. Throws if the data can not be served.
+inline void validateIndex(const storage::SharedDataIndex &index)
+{
+    static const std::array<std::string, 3> required_blocks = {
+        {"/common/properties", "/common/connectivity_checksum", "/common/rtree/format_version"}};
+    for (const auto &name : required_blocks)
+    {
+        if (!index.HasBlock(name))
+        {
+            throw util::exception("Dataset is missing the block " + name + SOURCE_REF);
+        }
+    }
+
+    detail::checkConnectivityChecksum(index, "/ch/connectivity_checksum");
+    detail::checkConnectivityChecksum(index, "/mld/connectivity_checksum");
+    detail::checkRTreeFormat(index);
+}
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_VALIDATE_INDEX_HPP_
@@ -5,8 +5,10 @@
 #include "engine/datafacade.hpp"
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 #include "engine/datafacade/mmap_memory_allocator.hpp"
+#include "engine/datafacade/mmap_tar_allocator.hpp"
 #include "engine/datafacade/process_memory_allocator.hpp"
 #include "engine/datafacade_factory.hpp"
+#include "engine/replicated_datafacade_factory.hpp"
 
 namespace osrm
 {
@@ -33,8 +35,12 @@ class ExternalProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
     using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
 
     ExternalProvider(const storage::StorageConfig &config,
-                     const boost::filesystem::path &memory_file)
-        : facade_factory(std::make_shared<datafacade::MMapMemoryAllocator>(config, memory_file))
+                     const boost::filesystem::path &memory_file,
+                     const bool replicate_numa = false,
+                     const bool prefault = false)
+        : facade_factory(std::make_shared<datafacade::MMapMemoryAllocator>(config, memory_file),
+                         replicate_numa,
+                         prefault)
     {
     }
 
@@ -48,7 +54,34 @@ class ExternalProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
     }
 
   private:
-    DataFacadeFactory<FacadeT, AlgorithmT> facade_factory;
+    ReplicatedDataFacadeFactory<FacadeT, AlgorithmT> facade_factory;
+};
+
+template <typename AlgorithmT, template <typename A> class FacadeT>
+class MappedProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
+{
+  public:
+    using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
+
+    MappedProvider(const storage::StorageConfig &config,
+                   const bool replicate_numa = false,
+                   const bool prefault = false)
+        : facade_factory(
+              std::make_shared<datafacade::MMapTarAllocator>(config), replicate_numa, prefault)
+    {
+    }
+
+    std::shared_ptr<const Facade> Get(const api::TileParameters &params) const override final
+    {
+        return facade_factory.Get(params);
+    }
+    std::shared_ptr<const Facade> Get(const api::BaseParameters &params) const override final
+    {
+        return facade_factory.Get(params);
+    }
+
+  private:
+    ReplicatedDataFacadeFactory<FacadeT, AlgorithmT> facade_factory;
 };
 
 template <typename AlgorithmT, template <typename A> class FacadeT>
@@ -57,8 +90,12 @@ class ImmutableProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
   public:
     using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
 
-    ImmutableProvider(const storage::StorageConfig &config)
-        : facade_factory(std::make_shared<datafacade::ProcessMemoryAllocator>(config))
+    ImmutableProvider(const storage::StorageConfig &config,
+                      const bool replicate_numa = false,
+                      const bool prefault = false)
+        : facade_factory(std::make_shared<datafacade::ProcessMemoryAllocator>(config),
+                         replicate_numa,
+                         prefault)
     {
     }
 
@@ -72,7 +109,7 @@ class ImmutableProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
     }
 
   private:
-    DataFacadeFactory<FacadeT, AlgorithmT> facade_factory;
+    ReplicatedDataFacadeFactory<FacadeT, AlgorithmT> facade_factory;
 };
 
 template <typename AlgorithmT, template <typename A> class FacadeT>
@@ -82,8 +119,15 @@ class WatchingProvider : public DataFacadeProvider<AlgorithmT, FacadeT>
 
   public:
     using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
+    using WarmupFunction = typename DataWatchdog<AlgorithmT, FacadeT>::WarmupFunction;
 
-    WatchingProvider(const std::string &dataset_name) : watchdog(dataset_name) {}
+    WatchingProvider(const std::string &dataset_name,
+                     const bool replicate_numa = false,
+                     const bool prefault = false,
+                     WarmupFunction warmup = {})
+        : watchdog(dataset_name, replicate_numa, prefault, std::move(warmup))
+    {
+    }
 
     std::shared_ptr<const Facade> Get(const api::TileParameters &params) const override final
     {
@@ -104,6 +148,8 @@ template <typename AlgorithmT>
 using ImmutableProvider = detail::ImmutableProvider<AlgorithmT, DataFacade>;
 template <typename AlgorithmT>
 using ExternalProvider = detail::ExternalProvider<AlgorithmT, DataFacade>;
+template <typename AlgorithmT>
+using MappedProvider = detail::MappedProvider<AlgorithmT, DataFacade>;
 }
 }
 
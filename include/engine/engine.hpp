@@ -16,10 +16,14 @@
 #include "engine/plugins/trip.hpp"
 #include "engine/plugins/viaroute.hpp"
 #include "engine/routing_algorithms.hpp"
+#include "engine/snapping_cache.hpp"
 #include "engine/status.hpp"
 
 #include "util/json_container.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -49,32 +53,61 @@ template <typename Algorithm> class Engine final : public EngineInterface
 {
   public:
     explicit Engine(const EngineConfig &config)
-        : route_plugin(config.max_locations_viaroute, config.max_alternatives),            //
+        : warmup(config.warmup),                                                           //
+          heaps(config),                                                                   //
+          route_plugin(config.max_locations_viaroute, config.max_alternatives),            //
           table_plugin(config.max_locations_distance_table),                               //
           nearest_plugin(config.max_results_nearest),                                      //
-          trip_plugin(config.max_locations_trip),                                          //
-          match_plugin(config.max_locations_map_matching, config.max_radius_map_matching), //
-          tile_plugin()                                                                    //
+          trip_plugin(config.max_locations_trip, config.trip_local_search_time),           //
+          match_plugin(config.max_locations_map_matching,                                  //
+                       config.max_radius_map_matching,                                     //
+                       config.map_matching_window,                                         //
+                       config.max_matching_sessions),                                      //
+          tile_plugin(),                                                                   //
+          snapping_cache(config.snapping_cache_size, config.snapping_cache_precision)      //
 
     {
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with name \"" << config.dataset_name
                                 << "\" with algorithm " << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<WatchingProvider<Algorithm>>(config.dataset_name);
+            facade_provider = std::make_unique<WatchingProvider<Algorithm>>(
+                config.dataset_name,
+                config.use_numa_replicas,
+                config.prefault_data,
+                [this](const auto &facade_factory) { WarmUp(facade_factory); });
         }
         else if (!config.memory_file.empty())
         {
             util::Log(logDEBUG) << "Using memory mapped filed at " << config.memory_file
                                 << " with algorithm " << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<ExternalProvider<Algorithm>>(config.storage_config,
-                                                                            config.memory_file);
+            facade_provider =
+                std::make_unique<ExternalProvider<Algorithm>>(config.storage_config,
+                                                              config.memory_file,
+                                                              config.use_numa_replicas,
+                                                              config.prefault_data);
+        }
+        else if (config.use_mmap)
+        {
+            util::Log(logDEBUG) << "Using data files mapped into memory with algorithm "
+                                << routing_algorithms::name<Algorithm>();
+            facade_provider = std::make_unique<MappedProvider<Algorithm>>(
+                config.storage_config, config.use_numa_replicas, config.prefault_data);
         }
         else
         {
             util::Log(logDEBUG) << "Using internal memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(config.storage_config);
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                config.storage_config, config.use_numa_replicas, config.prefault_data);
+        }
+
+        if (warmup)
+        {
+            TIMER_START(warmup);
+            warmup(*this);
+            TIMER_STOP(warmup);
+            util::Log() << "Warmed up in " << TIMER_SEC(warmup) << " seconds";
         }
     }
 
@@ -83,7 +116,8 @@ template <typename Algorithm> class Engine final : public EngineInterface
 
     Engine(const Engine &) = delete;
     Engine &operator=(const Engine &) = delete;
-    virtual ~Engine() = default;
+    // the provider needs to go first, its watchdog thread might still warm up a new dataset
+    virtual ~Engine() { facade_provider.reset(); }
 
     Status Route(const api::RouteParameters &params,
                  util::json::Object &result) const override final
@@ -120,10 +154,83 @@ template <typename Algorithm> class Engine final : public EngineInterface
     }
 
   private:
+    // Answers queries with the facades of a dataset that does not serve requests yet
+    template <typename FacadeFactoryT> class WarmupEngine final : public EngineInterface
+    {
+      public:
+        WarmupEngine(const Engine &engine, const FacadeFactoryT &facade_factory)
+            : engine(engine), facade_factory(facade_factory)
+        {
+        }
+
+        Status Route(const api::RouteParameters &params,
+                     util::json::Object &result) const override final
+        {
+            return engine.route_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        }
+
+        Status Table(const api::TableParameters &params,
+                     util::json::Object &result) const override final
+        {
+            return engine.table_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        }
+
+        Status Nearest(const api::NearestParameters &params,
+                       util::json::Object &result) const override final
+        {
+            return engine.nearest_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        }
+
+        Status Trip(const api::TripParameters &params,
+                    util::json::Object &result) const override final
+        {
+            return engine.trip_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        }
+
+        Status Match(const api::MatchParameters &params,
+                     util::json::Object &result) const override final
+        {
+            return engine.match_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        }
+
+        Status Tile(const api::TileParameters &params, std::string &result) const override final
+        {
+            return engine.tile_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        }
+
+      private:
+        template <typename ParametersT> auto GetAlgorithms(const ParametersT &params) const
+        {
+            return RoutingAlgorithms<Algorithm>{
+                engine.heaps, facade_factory.Get(params), engine.snapping_cache};
+        }
+
+        const Engine &engine;
+        const FacadeFactoryT &facade_factory;
+    };
+
+    template <typename FacadeFactoryT> void WarmUp(const FacadeFactoryT &facade_factory) const
+    {
+        // heaps sized for the new dataset are ready before the first request uses it
+        heaps.PrepareHeaps(*facade_factory.Get(api::BaseParameters{}));
+        heaps.ResetCaches();
+
+        if (warmup)
+        {
+            const WarmupThreadScope warmup_thread;
+            TIMER_START(warmup);
+            warmup(WarmupEngine<FacadeFactoryT>(*this, facade_factory));
+            TIMER_STOP(warmup);
+            util::Log() << "Warmed up new dataset in " << TIMER_SEC(warmup) << " seconds";
+        }
+    }
+
     template <typename ParametersT> auto GetAlgorithms(const ParametersT &params) const
     {
-        return RoutingAlgorithms<Algorithm>{heaps, facade_provider->Get(params)};
+        return RoutingAlgorithms<Algorithm>{heaps, facade_provider->Get(params), snapping_cache};
     }
+
+    const std::function<void(const EngineInterface &)> warmup;
     std::unique_ptr<DataFacadeProvider<Algorithm>> facade_provider;
     mutable SearchEngineData<Algorithm> heaps;
 
@@ -133,6 +240,9 @@ template <typename Algorithm> class Engine final : public EngineInterface
     const plugins::TripPlugin trip_plugin;
     const plugins::MatchPlugin match_plugin;
     const plugins::TilePlugin tile_plugin;
+
+    // shared by all requests, entries of other facades are never found
+    mutable SnappingCache snapping_cache;
 };
 }
 }
@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/filesystem/path.hpp>
 
+#include <functional>
 #include <string>
 
 namespace osrm
@@ -40,6 +41,8 @@ namespace osrm
 namespace engine
 {
 
+class EngineInterface;
+
 /**
  * Configures an OSRM instance.
  *
@@ -55,6 +58,43 @@ namespace engine
  *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
  *
+ * For MLD the unpacked paths of frequently used overlay shortcuts can be cached
+ * by setting mld_unpacking_cache_size to the maximal number of cached shortcuts (0 disables).
+ *
+ * For CH datasets with hub labels, use_hub_labels answers duration tables by merging the labels of
+ * the sources and targets. Tables with distances still search the graph.
+ *
+ * For CH datasets with transit nodes, use_transit_nodes answers duration tables from the transit
+ * node table, pairs whose paths may stay below the transit nodes are searched in the graph.
+ *
+ * Map matching traces with more than map_matching_window locations are matched in consecutive
+ * windows of that size to bound the memory per request (0 disables).
+ *
+ * Match requests with a session id reuse the candidates and transitions of the previous request
+ * of the session. At most max_matching_sessions sessions are kept (0 disables).
+ *
+ * Trips with more locations than brute force can handle are improved by a local search for up to
+ * trip_local_search_time milliseconds (0 disables).
+ *
+ * The phantom nodes of up to snapping_cache_size frequently snapped coordinates are cached
+ * (0 disables). Coordinates that are equal in the first snapping_cache_precision decimal places
+ * (6 for exact matches) share one entry. Below 6 this is lossy, a coordinate gets the candidates
+ * of the first coordinate of its entry that are within its radius.
+ *
+ * With use_mmap the data is served directly from the .osrm files mapped into memory instead of
+ * being loaded, so processes using the same files share their pages. It can not be combined with
+ * use_shared_memory or a memory_file.
+ *
+ * With use_numa_replicas the query graph, the cell metrics, the coordinates and the R-tree are
+ * copied into the memory of every NUMA node. Threads that are pinned to a node with
+ * util::PinThreadToNUMANode read the copy of their node. The copy is picked by the thread that
+ * handles a request, the TBB workers that run the parallel parts of the request are not pinned
+ * and may read it from another node.
+ *
+ * With prefault_data the hot blocks are brought into memory before a dataset serves requests.
+ * The warmup function is called with an engine that queries a new dataset, at startup and before
+ * an update of a shared memory dataset becomes active, e.g. to replay a log of queries.
+ *
  * You can chose between three algorithms:
  *  - Algorithm::CH
  *      Contraction Hierarchies, extremely fast queries but slow pre-processing. The default right
@@ -87,8 +127,20 @@ struct EngineConfig final
     double max_radius_map_matching = -1.0;
     int max_results_nearest = -1;
     int max_alternatives = 3; // set an arbitrary upper bound; can be adjusted by user
+    int mld_unpacking_cache_size = 0;
+    int map_matching_window = 0;
+    int max_matching_sessions = 0;
+    int trip_local_search_time = 0;
+    int snapping_cache_size = 0;
+    int snapping_cache_precision = 6;
+    bool use_hub_labels = false;
+    bool use_transit_nodes = false;
     bool use_shared_memory = true;
     boost::filesystem::path memory_file;
+    bool use_mmap = false;
+    bool use_numa_replicas = false;
+    bool prefault_data = false;
+    std::function<void(const EngineInterface &)> warmup;
     Algorithm algorithm = Algorithm::CH;
     std::string verbosity;
     std::string dataset_name;
@@ -3,18 +3,28 @@
 
 #include "engine/approach.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/phantom_node_query.hpp"
+#include "engine/warmup_thread_scope.hpp"
+#include "extractor/class_data.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/hilbert_value.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
 #include "osrm/coordinate.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -36,10 +46,20 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     using EdgeData = typename RTreeT::EdgeData;
     using CoordinateList = typename RTreeT::CoordinateList;
     using CandidateSegment = typename RTreeT::CandidateSegment;
+    using TreeNodeSummary = typename RTreeT::TreeNodeSummary;
+
+    // Maximal number of queries of a batch that are snapped by one task. tbb splits the batch
+    // until no chunk is larger, so chunks hold between half of it and all of it.
+    static constexpr std::size_t SNAPPING_CHUNK_SIZE = 16;
 
   public:
-    GeospatialQuery(RTreeT &rtree_, const CoordinateList &coordinates_, DataFacadeT &datafacade_)
-        : rtree(rtree_), coordinates(coordinates_), datafacade(datafacade_)
+    // The exclude mask needs to match the one used by datafacade_.ExcludeNode
+    GeospatialQuery(RTreeT &rtree_,
+                    const CoordinateList &coordinates_,
+                    DataFacadeT &datafacade_,
+                    const extractor::ClassData exclude_mask_ = 0)
+        : rtree(rtree_), coordinates(coordinates_), datafacade(datafacade_),
+          exclude_mask(exclude_mask_)
     {
     }
 
@@ -57,6 +77,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(),
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
                 return boolPairAnd(boolPairAnd(HasValidEdge(segment), CheckSegmentExclude(segment)),
                                    CheckApproach(input_coordinate, segment, approach));
@@ -80,6 +101,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(bearing, bearing_range),
             [this, approach, &input_coordinate, bearing, bearing_range](
                 const CandidateSegment &segment) {
                 auto use_direction =
@@ -108,6 +130,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(bearing, bearing_range),
             [this, approach, &input_coordinate, bearing, bearing_range](
                 const CandidateSegment &segment) {
                 auto use_direction =
@@ -136,6 +159,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(bearing, bearing_range),
             [this, approach, &input_coordinate, bearing, bearing_range](
                 const CandidateSegment &segment) {
                 auto use_direction =
@@ -162,6 +186,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(),
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
                 return boolPairAnd(boolPairAnd(HasValidEdge(segment), CheckSegmentExclude(segment)),
                                    CheckApproach(input_coordinate, segment, approach));
@@ -183,6 +208,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(),
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
                 return boolPairAnd(boolPairAnd(HasValidEdge(segment), CheckSegmentExclude(segment)),
                                    CheckApproach(input_coordinate, segment, approach));
@@ -207,6 +233,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         bool has_big_component = false;
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(),
             [this, approach, &input_coordinate, &has_big_component, &has_small_component](
                 const CandidateSegment &segment) {
                 auto use_segment =
@@ -253,6 +280,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         bool has_big_component = false;
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(),
             [this, approach, &input_coordinate, &has_big_component, &has_small_component](
                 const CandidateSegment &segment) {
                 auto use_segment =
@@ -300,6 +328,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         bool has_big_component = false;
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(bearing, bearing_range),
             [this,
              approach,
              &input_coordinate,
@@ -358,6 +387,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         bool has_big_component = false;
         auto results = rtree.Nearest(
             input_coordinate,
+            MakeSubtreeFilter(bearing, bearing_range),
             [this,
              approach,
              &input_coordinate,
@@ -405,7 +435,100 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                               MakePhantomNode(input_coordinate, results.back()).phantom_node);
     }
 
+    // Returns the nearest PhantomNodes within the radius of every query, which is required.
+    // Does not filter by small/big component!
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<PhantomNodeQuery> &queries) const
+    {
+        return SnapInHilbertOrder<std::vector<PhantomNodeWithDistance>>(
+            queries, [this](const PhantomNodeQuery &query) {
+                BOOST_ASSERT(query.radius);
+                if (query.bearing)
+                {
+                    return NearestPhantomNodesInRange(query.coordinate,
+                                                      *query.radius,
+                                                      query.bearing->bearing,
+                                                      query.bearing->range,
+                                                      query.approach);
+                }
+                return NearestPhantomNodesInRange(query.coordinate, *query.radius, query.approach);
+            });
+    }
+
+    // Returns the nearest phantom node and an alternative from a big component for every query,
+    // see NearestPhantomNodeWithAlternativeFromBigComponent.
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<PhantomNodeQuery> &queries) const
+    {
+        return SnapInHilbertOrder<std::pair<PhantomNode, PhantomNode>>(
+            queries, [this](const PhantomNodeQuery &query) {
+                if (query.bearing && query.radius)
+                {
+                    return NearestPhantomNodeWithAlternativeFromBigComponent(query.coordinate,
+                                                                             *query.radius,
+                                                                             query.bearing->bearing,
+                                                                             query.bearing->range,
+                                                                             query.approach);
+                }
+                if (query.bearing)
+                {
+                    return NearestPhantomNodeWithAlternativeFromBigComponent(query.coordinate,
+                                                                             query.bearing->bearing,
+                                                                             query.bearing->range,
+                                                                             query.approach);
+                }
+                if (query.radius)
+                {
+                    return NearestPhantomNodeWithAlternativeFromBigComponent(
+                        query.coordinate, *query.radius, query.approach);
+                }
+                return NearestPhantomNodeWithAlternativeFromBigComponent(query.coordinate,
+                                                                         query.approach);
+            });
+    }
+
   private:
+    // Snaps a batch of queries in the order of the Hilbert value of their coordinates. Queries that
+    // follow each other on the curve are close, so they visit mostly the same tree nodes and leaf
+    // pages while these are still cached. Consecutive chunks of the curve are snapped in parallel
+    // and repeated queries are only snapped once per chunk.
+    template <typename ResultT, typename SnapT>
+    std::vector<ResultT> SnapInHilbertOrder(const std::vector<PhantomNodeQuery> &queries,
+                                            const SnapT &snap) const
+    {
+        std::vector<std::pair<std::uint64_t, std::size_t>> order;
+        order.reserve(queries.size());
+        for (std::size_t index = 0; index < queries.size(); ++index)
+        {
+            order.emplace_back(util::GetHilbertCode(queries[index].coordinate), index);
+        }
+        std::sort(order.begin(), order.end());
+
+        std::vector<ResultT> results(queries.size());
+        const auto warmup_thread = WarmupThreadScope::IsActive();
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, order.size(), SNAPPING_CHUNK_SIZE),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                const WarmupThreadScope warmup_scope(warmup_thread);
+                for (auto position = range.begin(); position < range.end(); ++position)
+                {
+                    const auto index = order[position].second;
+                    if (position > range.begin())
+                    {
+                        const auto previous_index = order[position - 1].second;
+                        if (queries[index] == queries[previous_index])
+                        {
+                            results[index] = results[previous_index];
+                            continue;
+                        }
+                    }
+                    results[index] = snap(queries[index]);
+                }
+            });
+        return results;
+    }
+
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
                      const std::vector<EdgeData> &results) const
@@ -560,6 +683,31 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         return transformed;
     }
 
+    // Skips the subtrees of the r-tree in which every segment has an excluded class or no
+    // direction in the requested bearing range, CheckSegmentExclude and CheckSegmentBearing
+    // would reject all of them
+    struct SubtreeFilter
+    {
+        extractor::ClassData exclude_mask;
+        std::uint32_t bearing_sectors;
+
+        bool operator()(const TreeNodeSummary &summary) const
+        {
+            return (summary.common_classes & exclude_mask) == 0 &&
+                   (summary.bearing_sectors & bearing_sectors) != 0;
+        }
+    };
+
+    SubtreeFilter MakeSubtreeFilter() const
+    {
+        return SubtreeFilter{exclude_mask, std::numeric_limits<std::uint32_t>::max()};
+    }
+
+    SubtreeFilter MakeSubtreeFilter(const int bearing, const int bearing_range) const
+    {
+        return SubtreeFilter{exclude_mask, util::bearing::GetSectorMask(bearing, bearing_range)};
+    }
+
     bool CheckSegmentDistance(const Coordinate input_coordinate,
                               const CandidateSegment &segment,
                               const double max_distance) const
@@ -692,6 +840,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     const RTreeT &rtree;
     const CoordinateList &coordinates;
     DataFacadeT &datafacade;
+    const extractor::ClassData exclude_mask;
 };
 }
 }
@@ -0,0 +1,203 @@
+#ifndef OSRM_ENGINE_MAP_MATCHING_MATCHING_SESSION_HPP
+#define OSRM_ENGINE_MAP_MATCHING_MATCHING_SESSION_HPP
+
+#include "engine/approach.hpp"
+#include "engine/bearing.hpp"
+#include "engine/phantom_node.hpp"
+
+#include "util/concurrent_lru_cache.hpp"
+#include "util/coordinate.hpp"
+#include "util/std_hash.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace map_matching
+{
+
+// Identifies the candidate lookup of one trace location
+struct CandidatesKey
+{
+    util::Coordinate coordinate;
+    double radius;
+    boost::optional<Bearing> bearing;
+    Approach approach;
+
+    bool operator==(const CandidatesKey &other) const
+    {
+        return coordinate == other.coordinate && radius == other.radius &&
+               bearing == other.bearing && approach == other.approach;
+    }
+};
+
+struct CandidatesKeyHash
+{
+    std::size_t operator()(const CandidatesKey &key) const
+    {
+        return hash_val(static_cast<std::int32_t>(key.coordinate.lon),
+                        static_cast<std::int32_t>(key.coordinate.lat),
+                        key.radius,
+                        key.bearing ? key.bearing->bearing : -1,
+                        key.bearing ? key.bearing->range : -1,
+                        static_cast<std::uint8_t>(key.approach));
+    }
+};
+
+// Identifies the transition between two candidates. Candidates are snapped to the same location
+// of the same segments by every lookup, which is all a search between them depends on.
+struct TransitionKey
+{
+    util::Coordinate source_location;
+    NodeID source_forward;
+    NodeID source_reverse;
+    util::Coordinate target_location;
+    NodeID target_forward;
+    NodeID target_reverse;
+    EdgeWeight weight_upper_bound;
+
+    TransitionKey(const PhantomNode &source,
+                  const PhantomNode &target,
+                  const EdgeWeight weight_upper_bound)
+        : source_location(source.location),
+          source_forward(source.forward_segment_id.enabled ? source.forward_segment_id.id
+                                                           : SPECIAL_NODEID),
+          source_reverse(source.reverse_segment_id.enabled ? source.reverse_segment_id.id
+                                                           : SPECIAL_NODEID),
+          target_location(target.location),
+          target_forward(target.forward_segment_id.enabled ? target.forward_segment_id.id
+                                                           : SPECIAL_NODEID),
+          target_reverse(target.reverse_segment_id.enabled ? target.reverse_segment_id.id
+                                                           : SPECIAL_NODEID),
+          weight_upper_bound(weight_upper_bound)
+    {
+    }
+
+    bool operator==(const TransitionKey &other) const
+    {
+        return source_location == other.source_location &&
+               source_forward == other.source_forward && source_reverse == other.source_reverse &&
+               target_location == other.target_location &&
+               target_forward == other.target_forward && target_reverse == other.target_reverse &&
+               weight_upper_bound == other.weight_upper_bound;
+    }
+};
+
+struct TransitionKeyHash
+{
+    std::size_t operator()(const TransitionKey &key) const
+    {
+        return hash_val(static_cast<std::int32_t>(key.source_location.lon),
+                        static_cast<std::int32_t>(key.source_location.lat),
+                        key.source_forward,
+                        key.source_reverse,
+                        static_cast<std::int32_t>(key.target_location.lon),
+                        static_cast<std::int32_t>(key.target_location.lat),
+                        key.target_forward,
+                        key.target_reverse,
+                        key.weight_upper_bound);
+    }
+};
+
+/**
+ * State of an incremental map matching session.
+ *
+ * Live tracking resubmits the trailing part of a trace with every new location. A session keeps
+ * the candidates and the network distances of the transitions of the previous request, so only
+ * the new locations need a lookup and a search. The results are the same as without a session.
+ *
+ * Entries that were not used by the last request are dropped, so a session never holds more
+ * than two requests worth of data. Requests of the same session are serialized by its mutex.
+ */
+class MatchingSession
+{
+  public:
+    using Candidates = std::vector<PhantomNodeWithDistance>;
+
+    std::mutex mutex;
+
+    // Drops all entries of another dataset, the searches depend on the facade
+    void Reset(const std::uint64_t generation_)
+    {
+        if (generation != generation_)
+        {
+            generation = generation_;
+            candidates = {};
+            previous_candidates = {};
+            transitions = {};
+            previous_transitions = {};
+        }
+    }
+
+    boost::optional<Candidates> FindCandidates(const CandidatesKey &key)
+    {
+        return find(candidates, previous_candidates, key);
+    }
+
+    void InsertCandidates(const CandidatesKey &key, Candidates value)
+    {
+        candidates[key] = std::move(value);
+    }
+
+    boost::optional<double> FindTransition(const TransitionKey &key)
+    {
+        return find(transitions, previous_transitions, key);
+    }
+
+    void InsertTransition(const TransitionKey &key, const double network_distance)
+    {
+        transitions[key] = network_distance;
+    }
+
+    // Called after each request, everything that was not used by it is dropped
+    void Age()
+    {
+        previous_candidates = std::move(candidates);
+        previous_transitions = std::move(transitions);
+        candidates = {};
+        transitions = {};
+    }
+
+  private:
+    template <typename Map>
+    static boost::optional<typename Map::mapped_type>
+    find(Map &current, Map &previous, const typename Map::key_type &key)
+    {
+        const auto iter = current.find(key);
+        if (iter != current.end())
+            return iter->second;
+
+        const auto previous_iter = previous.find(key);
+        if (previous_iter == previous.end())
+            return boost::none;
+
+        auto value = current.emplace(key, std::move(previous_iter->second)).first->second;
+        previous.erase(previous_iter);
+        return value;
+    }
+
+    std::uint64_t generation = 0;
+    std::unordered_map<CandidatesKey, Candidates, CandidatesKeyHash> candidates;
+    std::unordered_map<CandidatesKey, Candidates, CandidatesKeyHash> previous_candidates;
+    std::unordered_map<TransitionKey, double, TransitionKeyHash> transitions;
+    std::unordered_map<TransitionKey, double, TransitionKeyHash> previous_transitions;
+};
+
+// Sessions by their id, the least recently used session is evicted once the capacity is reached
+using MatchingSessions =
+    util::ConcurrentLRUCache<std::string, std::shared_ptr<MatchingSession>>;
+}
+}
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef OSRM_ENGINE_PHANTOM_NODE_QUERY_HPP
+#define OSRM_ENGINE_PHANTOM_NODE_QUERY_HPP
+
+#include "engine/approach.hpp"
+#include "engine/bearing.hpp"
+
+#include "util/coordinate.hpp"
+
+#include <boost/optional.hpp>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Parameters of the phantom node lookup of one coordinate, used to snap several coordinates at once
+struct PhantomNodeQuery
+{
+    util::Coordinate coordinate;
+    boost::optional<double> radius;
+    boost::optional<Bearing> bearing;
+    Approach approach = Approach::UNRESTRICTED;
+
+    bool operator==(const PhantomNodeQuery &other) const
+    {
+        return coordinate == other.coordinate && radius == other.radius &&
+               bearing == other.bearing && approach == other.approach;
+    }
+};
+}
+}
+
+#endif
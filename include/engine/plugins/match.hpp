@@ -2,6 +2,7 @@
 #define MATCH_HPP
 
 #include "engine/api/match_parameters.hpp"
+#include "engine/map_matching/matching_session.hpp"
 #include "engine/plugins/plugin_base.hpp"
 #include "engine/routing_algorithms.hpp"
 
@@ -24,9 +25,13 @@ class MatchPlugin : public BasePlugin
     using CandidateLists = routing_algorithms::CandidateLists;
     static const constexpr double RADIUS_MULTIPLIER = 3;
 
-    MatchPlugin(const int max_locations_map_matching, const double max_radius_map_matching)
+    MatchPlugin(const int max_locations_map_matching,
+                const double max_radius_map_matching,
+                const int map_matching_window = 0,
+                const int max_matching_sessions = 0)
         : max_locations_map_matching(max_locations_map_matching),
-          max_radius_map_matching(max_radius_map_matching)
+          max_radius_map_matching(max_radius_map_matching),
+          map_matching_window(map_matching_window), sessions(max_matching_sessions)
     {
     }
 
@@ -35,8 +40,17 @@ class MatchPlugin : public BasePlugin
                          util::json::Object &json_result) const;
 
   private:
+    CandidateLists GetSessionCandidates(const datafacade::BaseDataFacade &facade,
+                                        const api::MatchParameters &parameters,
+                                        const std::vector<double> &search_radiuses,
+                                        map_matching::MatchingSession &session,
+                                        SnappingCache &snapping_cache) const;
+
     const int max_locations_map_matching;
     const double max_radius_map_matching;
+    const int map_matching_window;
+    // shared by all requests, but every session is only used by one request at a time
+    mutable map_matching::MatchingSessions sessions;
 };
 }
 }
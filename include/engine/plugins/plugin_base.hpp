@@ -4,7 +4,9 @@
 #include "engine/api/base_parameters.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/phantom_node_query.hpp"
 #include "engine/routing_algorithms.hpp"
+#include "engine/snapping_cache.hpp"
 #include "engine/status.hpp"
 
 #include "util/coordinate.hpp"
@@ -138,22 +140,20 @@ class BasePlugin
     std::vector<std::vector<PhantomNodeWithDistance>>
     GetPhantomNodesInRange(const datafacade::BaseDataFacade &facade,
                            const api::BaseParameters &parameters,
-                           const std::vector<double> radiuses) const
+                           const std::vector<double> radiuses,
+                           SnappingCache &snapping_cache) const
     {
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
         BOOST_ASSERT(radiuses.size() == parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
-        const bool use_bearings = !parameters.bearings.empty();
-        const bool use_approaches = !parameters.approaches.empty();
 
+        // Coordinates without a valid hint are snapped as one batch
+        std::vector<PhantomNodeQuery> queries;
+        std::vector<std::size_t> query_indices;
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
-            Approach approach = engine::Approach::UNRESTRICTED;
-            if (use_approaches && parameters.approaches[i])
-                approach = parameters.approaches[i].get();
-
             if (use_hints && parameters.hints[i] &&
                 parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
             {
@@ -164,20 +164,26 @@ class BasePlugin
                 });
                 continue;
             }
-            if (use_bearings && parameters.bearings[i])
-            {
-                phantom_nodes[i] =
-                    facade.NearestPhantomNodesInRange(parameters.coordinates[i],
-                                                      radiuses[i],
-                                                      parameters.bearings[i]->bearing,
-                                                      parameters.bearings[i]->range,
-                                                      approach);
-            }
-            else
+
+            auto query = GetPhantomNodeQuery(parameters, i);
+            query.radius = radiuses[i];
+            if (auto cached = snapping_cache.FindInRange(facade.GetGeneration(), query))
             {
-                phantom_nodes[i] = facade.NearestPhantomNodesInRange(
-                    parameters.coordinates[i], radiuses[i], approach);
+                phantom_nodes[i] = std::move(*cached);
+                continue;
             }
+            queries.push_back(std::move(query));
+            query_indices.push_back(i);
+        }
+
+        auto results = facade.NearestPhantomNodesInRange(queries);
+        BOOST_ASSERT(results.size() == queries.size());
+        for (const auto query : util::irange<std::size_t>(0UL, queries.size()))
+        {
+            if (snapping_cache.IsEnabled())
+                snapping_cache.InsertInRange(
+                    facade.GetGeneration(), queries[query], results[query]);
+            phantom_nodes[query_indices[query]] = std::move(results[query]);
         }
 
         return phantom_nodes;
@@ -260,22 +266,20 @@ class BasePlugin
     }
 
     std::vector<PhantomNodePair> GetPhantomNodes(const datafacade::BaseDataFacade &facade,
-                                                 const api::BaseParameters &parameters) const
+                                                 const api::BaseParameters &parameters,
+                                                 SnappingCache &snapping_cache) const
     {
         std::vector<PhantomNodePair> phantom_node_pairs(parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
-        const bool use_bearings = !parameters.bearings.empty();
-        const bool use_radiuses = !parameters.radiuses.empty();
-        const bool use_approaches = !parameters.approaches.empty();
 
         BOOST_ASSERT(parameters.IsValid());
+
+        // Coordinates without a valid hint are snapped as one batch
+        std::vector<PhantomNodeQuery> queries;
+        std::vector<std::size_t> query_indices;
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
-            Approach approach = engine::Approach::UNRESTRICTED;
-            if (use_approaches && parameters.approaches[i])
-                approach = parameters.approaches[i].get();
-
             if (use_hints && parameters.hints[i] &&
                 parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
             {
@@ -284,57 +288,51 @@ class BasePlugin
                 continue;
             }
 
-            if (use_bearings && parameters.bearings[i])
+            auto query = GetPhantomNodeQuery(parameters, i);
+            if (auto cached = snapping_cache.FindWithAlternative(facade.GetGeneration(), query))
             {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            *parameters.radiuses[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range,
-                            approach);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range,
-                            approach);
-                }
-            }
-            else
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], *parameters.radiuses[i], approach);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], approach);
-                }
+                phantom_node_pairs[i] = *cached;
+                continue;
             }
+            queries.push_back(std::move(query));
+            query_indices.push_back(i);
+        }
 
+        const auto results = facade.NearestPhantomNodesWithAlternativeFromBigComponent(queries);
+        BOOST_ASSERT(results.size() == queries.size());
+        for (const auto query : util::irange<std::size_t>(0UL, queries.size()))
+        {
             // we didn't find a fitting node, return error
-            if (!phantom_node_pairs[i].first.IsValid())
+            if (!results[query].first.IsValid())
             {
                 // This ensures the list of phantom nodes only consists of valid nodes.
                 // We can use this on the call-site to detect an error.
                 phantom_node_pairs.pop_back();
                 break;
             }
-            BOOST_ASSERT(phantom_node_pairs[i].first.IsValid());
-            BOOST_ASSERT(phantom_node_pairs[i].second.IsValid());
+            BOOST_ASSERT(results[query].second.IsValid());
+            phantom_node_pairs[query_indices[query]] = results[query];
+            if (snapping_cache.IsEnabled())
+                snapping_cache.InsertWithAlternative(
+                    facade.GetGeneration(), queries[query], results[query]);
         }
         return phantom_node_pairs;
     }
+
+  private:
+    PhantomNodeQuery GetPhantomNodeQuery(const api::BaseParameters &parameters,
+                                         const std::size_t index) const
+    {
+        PhantomNodeQuery query;
+        query.coordinate = parameters.coordinates[index];
+        if (!parameters.radiuses.empty() && parameters.radiuses[index])
+            query.radius = *parameters.radiuses[index];
+        if (!parameters.bearings.empty() && parameters.bearings[index])
+            query.bearing = *parameters.bearings[index];
+        if (!parameters.approaches.empty() && parameters.approaches[index])
+            query.approach = *parameters.approaches[index];
+        return query;
+    }
 };
 }
 }
@@ -0,0 +1,75 @@
+#ifndef OSRM_ENGINE_REPLICATED_DATAFACADE_FACTORY_HPP
+#define OSRM_ENGINE_REPLICATED_DATAFACADE_FACTORY_HPP
+
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+#include "engine/datafacade/hot_blocks.hpp"
+#include "engine/datafacade/numa_replica_allocator.hpp"
+#include "engine/datafacade_factory.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/numa.hpp"
+#include "util/timing_util.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+// This class keeps one set of facades per NUMA node if the data is replicated and returns the
+// facades of the node the calling thread was pinned to. Threads that are not pinned use the
+// facades of the first node. With prefault the hot blocks are brought into memory first.
+template <template <typename A> class FacadeT, typename AlgorithmT>
+class ReplicatedDataFacadeFactory
+{
+  public:
+    using Facade = FacadeT<AlgorithmT>;
+    ReplicatedDataFacadeFactory() = default;
+
+    ReplicatedDataFacadeFactory(std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator,
+                                const bool replicate,
+                                const bool prefault = false)
+    {
+        if (prefault)
+        {
+            TIMER_START(prefault);
+            datafacade::prefaultHotBlocks(allocator->GetIndex());
+            TIMER_STOP(prefault);
+            util::Log() << "Prefaulted hot blocks in " << TIMER_SEC(prefault) << " seconds";
+        }
+
+        if (!replicate)
+        {
+            factories.emplace_back(std::move(allocator));
+            return;
+        }
+
+        const auto nodes = util::GetNUMANodes();
+        if (nodes.size() == 1)
+        {
+            util::Log() << "Only one NUMA node found, the data is not replicated";
+            factories.emplace_back(std::move(allocator));
+            return;
+        }
+
+        for (const auto node : util::irange<std::size_t>(0, nodes.size()))
+        {
+            factories.emplace_back(
+                std::make_shared<datafacade::NUMAReplicaAllocator>(allocator, node, nodes[node]));
+        }
+    }
+
+    template <typename ParameterT> std::shared_ptr<const Facade> Get(const ParameterT &params) const
+    {
+        return factories[util::CurrentNUMANode() % factories.size()].Get(params);
+    }
+
+  private:
+    std::vector<DataFacadeFactory<FacadeT, AlgorithmT>> factories;
+};
+}
+}
+
+#endif
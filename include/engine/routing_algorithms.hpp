@@ -10,6 +10,7 @@
 #include "engine/routing_algorithms/map_matching.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/routing_algorithms/tile_turns.hpp"
+#include "engine/snapping_cache.hpp"
 
 namespace osrm
 {
@@ -42,7 +43,8 @@ class RoutingAlgorithmsInterface
                 const std::vector<util::Coordinate> &trace_coordinates,
                 const std::vector<unsigned> &trace_timestamps,
                 const std::vector<boost::optional<double>> &trace_gps_precision,
-                const bool allow_splitting) const = 0;
+                const bool allow_splitting,
+                map_matching::MatchingSession *session) const = 0;
 
     virtual std::vector<routing_algorithms::TurnData>
     GetTileTurns(const std::vector<datafacade::BaseDataFacade::RTreeLeaf> &edges,
@@ -50,6 +52,8 @@ class RoutingAlgorithmsInterface
 
     virtual const DataFacadeBase &GetFacade() const = 0;
 
+    virtual SnappingCache &GetSnappingCache() const = 0;
+
     virtual bool HasAlternativePathSearch() const = 0;
     virtual bool HasShortestPathSearch() const = 0;
     virtual bool HasDirectShortestPathSearch() const = 0;
@@ -66,8 +70,9 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
 {
   public:
     RoutingAlgorithms(SearchEngineData<Algorithm> &heaps,
-                      std::shared_ptr<const DataFacade<Algorithm>> facade)
-        : heaps(heaps), facade(facade)
+                      std::shared_ptr<const DataFacade<Algorithm>> facade,
+                      SnappingCache &snapping_cache)
+        : heaps(heaps), facade(facade), snapping_cache(snapping_cache)
     {
     }
 
@@ -96,7 +101,8 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
                 const std::vector<util::Coordinate> &trace_coordinates,
                 const std::vector<unsigned> &trace_timestamps,
                 const std::vector<boost::optional<double>> &trace_gps_precision,
-                const bool allow_splitting) const final override;
+                const bool allow_splitting,
+                map_matching::MatchingSession *session) const final override;
 
     std::vector<routing_algorithms::TurnData>
     GetTileTurns(const std::vector<datafacade::BaseDataFacade::RTreeLeaf> &edges,
@@ -104,6 +110,8 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
 
     const DataFacadeBase &GetFacade() const final override { return *facade; }
 
+    SnappingCache &GetSnappingCache() const final override { return snapping_cache; }
+
     bool HasAlternativePathSearch() const final override
     {
         return routing_algorithms::HasAlternativePathSearch<Algorithm>::value;
@@ -149,6 +157,7 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
   private:
     SearchEngineData<Algorithm> &heaps;
     std::shared_ptr<const DataFacade<Algorithm>> facade;
+    SnappingCache &snapping_cache;
 };
 
 template <typename Algorithm>
@@ -182,7 +191,8 @@ inline routing_algorithms::SubMatchingList RoutingAlgorithms<Algorithm>::MapMatc
     const std::vector<util::Coordinate> &trace_coordinates,
     const std::vector<unsigned> &trace_timestamps,
     const std::vector<boost::optional<double>> &trace_gps_precision,
-    const bool allow_splitting) const
+    const bool allow_splitting,
+    map_matching::MatchingSession *session) const
 {
     return routing_algorithms::mapMatching(heaps,
                                            *facade,
@@ -190,7 +200,8 @@ inline routing_algorithms::SubMatchingList RoutingAlgorithms<Algorithm>::MapMatc
                                            trace_coordinates,
                                            trace_timestamps,
                                            trace_gps_precision,
-                                           allow_splitting);
+                                           allow_splitting,
+                                           session);
 }
 
 template <typename Algorithm>
@@ -3,6 +3,7 @@
 
 #include "engine/algorithm.hpp"
 #include "engine/datafacade.hpp"
+#include "engine/map_matching/matching_session.hpp"
 #include "engine/map_matching/sub_matching.hpp"
 #include "engine/search_engine_data.hpp"
 
@@ -22,6 +23,7 @@ static const constexpr double DEFAULT_GPS_PRECISION = 5;
 
 //[1] "Hidden Markov Map Matching Through Noise and Sparseness";
 //     P. Newson and J. Krumm; 2009; ACM GIS
+// The network distances of the transitions are reused from and stored in the session if given.
 template <typename Algorithm>
 SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                             const DataFacade<Algorithm> &facade,
@@ -29,7 +31,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                             const std::vector<util::Coordinate> &trace_coordinates,
                             const std::vector<unsigned> &trace_timestamps,
                             const std::vector<boost::optional<double>> &trace_gps_precision,
-                            const bool allow_splitting);
+                            const bool allow_splitting,
+                            map_matching::MatchingSession *session = nullptr);
 
 } // namespace routing_algorithms
 } // namespace engine
@@ -244,6 +244,8 @@ void unpackPath(const DataFacade<Algorithm> &facade,
         recursion_stack.emplace(*std::prev(current), *current);
     }
 
+    const auto &unpacked_shortcuts = facade.GetUnpackedShortcuts();
+
     std::pair<NodeID, NodeID> edge;
     while (!recursion_stack.empty())
     {
@@ -253,6 +255,7 @@ void unpackPath(const DataFacade<Algorithm> &facade,
         // Look for an edge on the forward CH graph (.forward)
         EdgeID smaller_edge_id = facade.FindSmallestEdge(
             edge.first, edge.second, [](const auto &data) { return data.forward; });
+        bool reverse = false;
 
         // If we didn't find one there, the we might be looking at a part of the path that
         // was found using the backward search.  Here, we flip the node order (.second, .first)
@@ -261,6 +264,7 @@ void unpackPath(const DataFacade<Algorithm> &facade,
         {
             smaller_edge_id = facade.FindSmallestEdge(
                 edge.second, edge.first, [](const auto &data) { return data.backward; });
+            reverse = true;
         }
 
         // If we didn't find anything *still*, then something is broken and someone has
@@ -271,8 +275,23 @@ void unpackPath(const DataFacade<Algorithm> &facade,
         BOOST_ASSERT_MSG(data.weight != std::numeric_limits<EdgeWeight>::max(),
                          "edge weight invalid");
 
+        // Shortcuts that were unpacked by osrm-contract can be copied directly
+        const auto shortcut = data.shortcut && !unpacked_shortcuts.Empty()
+                                  ? unpacked_shortcuts.Find(smaller_edge_id, reverse)
+                                  : contractor::UnpackedShortcutsView::INVALID_SHORTCUT;
+        if (shortcut != contractor::UnpackedShortcutsView::INVALID_SHORTCUT)
+        {
+            std::pair<NodeID, NodeID> original_edge{edge.first, SPECIAL_NODEID};
+            unpacked_shortcuts.ForEachEdge(
+                shortcut, [&](const NodeID target, const EdgeID original_edge_id) {
+                    original_edge.second = target;
+                    std::forward<Callback>(callback)(original_edge, original_edge_id);
+                    original_edge.first = target;
+                });
+            BOOST_ASSERT(original_edge.first == edge.second);
+        }
         // If the edge is a shortcut, we need to add the two halfs to the stack.
-        if (data.shortcut)
+        else if (data.shortcut)
         { // unpack
             const NodeID middle_node_id = data.turn_id;
             // Note the order here - we're adding these to a stack, so we
@@ -298,6 +317,8 @@ EdgeDistance calculateEBGNodeAnnotations(const DataFacade<Algorithm> &facade,
         std::distance(packed_path_begin, packed_path_end) <= 1)
         return 0;
 
+    const auto &unpacked_shortcuts = facade.GetUnpackedShortcuts();
+
     std::stack<std::tuple<NodeID, NodeID, bool>> recursion_stack;
     std::stack<EdgeDistance> distance_stack;
     // We have to push the path in reverse order onto the stack because it's LIFO.
@@ -325,6 +346,7 @@ EdgeDistance calculateEBGNodeAnnotations(const DataFacade<Algorithm> &facade,
                 facade.FindSmallestEdge(std::get<0>(edge), std::get<1>(edge), [](const auto &data) {
                     return data.forward;
                 });
+            bool reverse = false;
 
             // If we didn't find one there, the we might be looking at a part of the path that
             // was found using the backward search.  Here, we flip the node order (.second,
@@ -335,6 +357,7 @@ EdgeDistance calculateEBGNodeAnnotations(const DataFacade<Algorithm> &facade,
                     facade.FindSmallestEdge(std::get<1>(edge),
                                             std::get<0>(edge),
                                             [](const auto &data) { return data.backward; });
+                reverse = true;
             }
 
             // If we didn't find anything *still*, then something is broken and someone has
@@ -345,8 +368,22 @@ EdgeDistance calculateEBGNodeAnnotations(const DataFacade<Algorithm> &facade,
             BOOST_ASSERT_MSG(data.weight != std::numeric_limits<EdgeWeight>::max(),
                              "edge weight invalid");
 
+            // Shortcuts that were unpacked by osrm-contract contribute their summed distance
+            const auto shortcut = data.shortcut && !unpacked_shortcuts.Empty()
+                                      ? unpacked_shortcuts.Find(smaller_edge_id, reverse)
+                                      : contractor::UnpackedShortcutsView::INVALID_SHORTCUT;
+            if (shortcut != contractor::UnpackedShortcutsView::INVALID_SHORTCUT)
+            {
+                EdgeDistance distance = 0;
+                NodeID from = std::get<0>(edge);
+                unpacked_shortcuts.ForEachEdge(shortcut, [&](const NodeID target, const EdgeID) {
+                    distance += computeEdgeDistance(facade, from);
+                    from = target;
+                });
+                distance_stack.emplace(distance);
+            }
             // If the edge is a shortcut, we need to add the two halfs to the stack.
-            if (data.shortcut)
+            else if (data.shortcut)
             { // unpack
                 const NodeID middle_node_id = data.turn_id;
                 // Note the order here - we're adding these to a stack, so we
@@ -479,6 +516,16 @@ double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
                           const PhantomNode &target_phantom,
                           int duration_upper_bound = INVALID_EDGE_WEIGHT);
 
+// Same as getNetworkDistance for all pairs of sources and targets, stored row by row.
+// Uses one bounded backward search per target whose search spaces are stored in buckets
+// and one bounded forward search per source, see many_to_many_ch.cpp. Pairs with several
+// shortest paths or on the same segment are computed with getNetworkDistance.
+std::vector<double> getNetworkDistances(SearchEngineData<Algorithm> &engine_working_data,
+                                        const DataFacade<ch::Algorithm> &facade,
+                                        const std::vector<PhantomNode> &source_phantoms,
+                                        const std::vector<PhantomNode> &target_phantoms,
+                                        const EdgeWeight weight_upper_bound);
+
 } // namespace ch
 } // namespace routing_algorithms
 } // namespace engine
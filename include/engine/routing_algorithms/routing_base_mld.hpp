@@ -5,6 +5,7 @@
 #include "engine/datafacade.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
+#include "engine/unpacking_cache.hpp"
 
 #include "util/typedefs.hpp"
 
@@ -13,6 +14,7 @@
 #include <algorithm>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <tuple>
 #include <vector>
 
@@ -381,6 +383,91 @@ using UnpackedNodes = std::vector<NodeID>;
 using UnpackedEdges = std::vector<EdgeID>;
 using UnpackedPath = std::tuple<EdgeWeight, UnpackedNodes, UnpackedEdges>;
 
+template <typename Algorithm, typename... Args>
+UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
+                    const DataFacade<Algorithm> &facade,
+                    typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const bool force_loop_forward,
+                    const bool force_loop_reverse,
+                    EdgeWeight weight_upper_bound,
+                    Args... args);
+
+// Unpacks the clique arc source -> target of a cell on the given level by a search restricted
+// to that cell on the level below. The unpacked subpath only depends on the metric of the facade,
+// so popular arcs are shared between requests via the unpacking cache.
+template <typename Algorithm>
+void unpackOverlayEdge(SearchEngineData<Algorithm> &engine_working_data,
+                       const DataFacade<Algorithm> &facade,
+                       typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                       typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                       const bool force_loop_forward,
+                       const bool force_loop_reverse,
+                       const EdgeWeight weight_upper_bound,
+                       const LevelID level,
+                       const CellID parent_cell_id,
+                       const NodeID source,
+                       const NodeID target,
+                       std::vector<NodeID> &unpacked_nodes,
+                       std::vector<EdgeID> &unpacked_edges)
+{
+    auto &cache = engine_working_data.unpacking_cache;
+    const UnpackingCacheKey key{facade.GetGeneration(),
+                                level,
+                                parent_cell_id,
+                                source,
+                                target,
+                                force_loop_forward,
+                                force_loop_reverse};
+
+    if (const auto subpath = cache.Find(key).value_or(nullptr))
+    {
+        unpacked_nodes.insert(
+            unpacked_nodes.end(), std::next(subpath->nodes.begin()), subpath->nodes.end());
+        unpacked_edges.insert(unpacked_edges.end(), subpath->edges.begin(), subpath->edges.end());
+        return;
+    }
+
+    LevelID sublevel = level - 1;
+
+    // Here heaps can be reused, let's go deeper!
+    forward_heap.Clear();
+    reverse_heap.Clear();
+    forward_heap.Insert(source, 0, {source});
+    reverse_heap.Insert(target, 0, {target});
+
+    // TODO: when structured bindings will be allowed change to
+    // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
+    EdgeWeight subpath_weight;
+    std::vector<NodeID> subpath_nodes;
+    std::vector<EdgeID> subpath_edges;
+    std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
+                                                                    facade,
+                                                                    forward_heap,
+                                                                    reverse_heap,
+                                                                    force_loop_forward,
+                                                                    force_loop_reverse,
+                                                                    weight_upper_bound,
+                                                                    sublevel,
+                                                                    parent_cell_id);
+    BOOST_ASSERT(!subpath_edges.empty());
+    BOOST_ASSERT(subpath_nodes.size() > 1);
+    BOOST_ASSERT(subpath_nodes.front() == source);
+    BOOST_ASSERT(subpath_nodes.back() == target);
+
+    unpacked_nodes.insert(
+        unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
+    unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+
+    // A search with an upper bound might not find the arc, the result must not be reused
+    if (cache.IsEnabled() && subpath_weight != INVALID_EDGE_WEIGHT)
+    {
+        cache.Insert(key,
+                     std::make_shared<const UnpackedSubpath>(
+                         UnpackedSubpath{std::move(subpath_nodes), std::move(subpath_edges)}));
+    }
+}
+
 template <typename Algorithm, typename... Args>
 UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
                     const DataFacade<Algorithm> &facade,
@@ -474,35 +561,19 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
             CellID parent_cell_id = partition.GetCell(level, source);
             BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
 
-            LevelID sublevel = level - 1;
-
-            // Here heaps can be reused, let's go deeper!
-            forward_heap.Clear();
-            reverse_heap.Clear();
-            forward_heap.Insert(source, 0, {source});
-            reverse_heap.Insert(target, 0, {target});
-
-            // TODO: when structured bindings will be allowed change to
-            // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
-            EdgeWeight subpath_weight;
-            std::vector<NodeID> subpath_nodes;
-            std::vector<EdgeID> subpath_edges;
-            std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
-                                                                            facade,
-                                                                            forward_heap,
-                                                                            reverse_heap,
-                                                                            force_loop_forward,
-                                                                            force_loop_reverse,
-                                                                            INVALID_EDGE_WEIGHT,
-                                                                            sublevel,
-                                                                            parent_cell_id);
-            BOOST_ASSERT(!subpath_edges.empty());
-            BOOST_ASSERT(subpath_nodes.size() > 1);
-            BOOST_ASSERT(subpath_nodes.front() == source);
-            BOOST_ASSERT(subpath_nodes.back() == target);
-            unpacked_nodes.insert(
-                unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
-            unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+            unpackOverlayEdge(engine_working_data,
+                              facade,
+                              forward_heap,
+                              reverse_heap,
+                              force_loop_forward,
+                              force_loop_reverse,
+                              INVALID_EDGE_WEIGHT,
+                              level,
+                              parent_cell_id,
+                              source,
+                              target,
+                              unpacked_nodes,
+                              unpacked_edges);
         }
     }
 
@@ -559,35 +630,19 @@ unpackPathAndCalculateDistance(SearchEngineData<Algorithm> &engine_working_data,
             CellID parent_cell_id = partition.GetCell(level, source);
             BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
 
-            LevelID sublevel = level - 1;
-
-            // Here heaps can be reused, let's go deeper!
-            forward_heap.Clear();
-            reverse_heap.Clear();
-            forward_heap.Insert(source, 0, {source});
-            reverse_heap.Insert(target, 0, {target});
-
-            // TODO: when structured bindings will be allowed change to
-            // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
-            EdgeWeight subpath_weight;
-            std::vector<NodeID> subpath_nodes;
-            std::vector<EdgeID> subpath_edges;
-            std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
-                                                                            facade,
-                                                                            forward_heap,
-                                                                            reverse_heap,
-                                                                            force_loop_forward,
-                                                                            force_loop_reverse,
-                                                                            weight_upper_bound,
-                                                                            sublevel,
-                                                                            parent_cell_id);
-            BOOST_ASSERT(!subpath_edges.empty());
-            BOOST_ASSERT(subpath_nodes.size() > 1);
-            BOOST_ASSERT(subpath_nodes.front() == source);
-            BOOST_ASSERT(subpath_nodes.back() == target);
-            unpacked_nodes.insert(
-                unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
-            unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+            unpackOverlayEdge(engine_working_data,
+                              facade,
+                              forward_heap,
+                              reverse_heap,
+                              force_loop_forward,
+                              force_loop_reverse,
+                              weight_upper_bound,
+                              level,
+                              parent_cell_id,
+                              source,
+                              target,
+                              unpacked_nodes,
+                              unpacked_edges);
         }
     }
     return std::make_tuple(weight, std::move(unpacked_nodes), std::move(unpacked_edges));
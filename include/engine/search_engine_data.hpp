@@ -2,11 +2,18 @@
 #define SEARCH_ENGINE_DATA_HPP
 
 #include "engine/algorithm.hpp"
+#include "engine/engine_config.hpp"
+#include "engine/unpacking_cache.hpp"
 #include "util/query_heap.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/thread/tss.hpp>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -47,6 +54,12 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
     using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
 
+    SearchEngineData() = default;
+    explicit SearchEngineData(const EngineConfig &config)
+        : use_hub_labels(config.use_hub_labels), use_transit_nodes(config.use_transit_nodes)
+    {
+    }
+
     static SearchEngineHeapPtr forward_heap_1;
     static SearchEngineHeapPtr reverse_heap_1;
     static SearchEngineHeapPtr forward_heap_2;
@@ -55,6 +68,12 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     static SearchEngineHeapPtr reverse_heap_3;
     static ManyToManyHeapPtr many_to_many_heap;
 
+    // Answer duration tables from the hub labels of the dataset, disabled by default
+    bool use_hub_labels = false;
+
+    // Answer duration tables from the transit nodes of the dataset, disabled by default
+    bool use_transit_nodes = false;
+
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes);
@@ -62,6 +81,12 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     void InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
+
+    // CH heaps are hash maps and do not depend on the size of the dataset
+    template <typename FacadeT> void PrepareHeaps(const FacadeT &) {}
+
+    // There are no caches of dataset dependent results
+    void ResetCaches() {}
 };
 
 struct MultiLayerDijkstraHeapData
@@ -102,15 +127,61 @@ template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
     using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
 
+    SearchEngineData() = default;
+    explicit SearchEngineData(const EngineConfig &config)
+        : unpacking_cache(config.mld_unpacking_cache_size)
+    {
+    }
+
+    // The heaps are shared by all engines of the process, whose datasets should have the same
+    // number of boundary nodes. Otherwise the heaps are replaced whenever a thread switches
+    // between the datasets.
     static SearchEngineHeapPtr forward_heap_1;
     static SearchEngineHeapPtr reverse_heap_1;
     static ManyToManyHeapPtr many_to_many_heap;
 
+    // Number of boundary nodes the heaps of the thread were created for
+    static boost::thread_specific_ptr<unsigned> first_heaps_boundary_nodes;
+    static boost::thread_specific_ptr<unsigned> many_to_many_heap_boundary_nodes;
+
+    // Heaps created by PrepareHeaps for a dataset that is not published yet
+    static std::mutex prepared_heaps_mutex;
+    static unsigned prepared_boundary_nodes;
+    static std::vector<std::unique_ptr<QueryHeap>> prepared_heaps;
+    static std::vector<std::unique_ptr<ManyToManyQueryHeap>> prepared_many_to_many_heaps;
+
+    // Number of threads that own heaps, i.e. the number of heaps to prepare. A thread is counted
+    // on its first use of the heaps and no longer once it exits. Threads in a WarmupThreadScope
+    // are not counted.
+    static std::atomic<unsigned> number_of_first_heap_threads;
+    static std::atomic<unsigned> number_of_many_to_many_heap_threads;
+    static boost::thread_specific_ptr<std::atomic<unsigned>> first_heap_thread_counter;
+    static boost::thread_specific_ptr<std::atomic<unsigned>> many_to_many_heap_thread_counter;
+
+    // Unpacked clique arcs, shared between all threads of the engine
+    UnpackingCache unpacking_cache;
+
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes,
                                                   unsigned number_of_boundary_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes,
                                                        unsigned number_of_boundary_nodes);
+
+    // The overlay of the heaps is an array over the boundary nodes. Heaps of a dataset with a
+    // different number of boundary nodes are replaced on their next use, preferably by heaps
+    // that were prepared here before the dataset was published. Nothing is prepared if the
+    // number of boundary nodes stays the same.
+    void PrepareHeaps(unsigned number_of_nodes, unsigned number_of_boundary_nodes);
+
+    template <typename FacadeT> void PrepareHeaps(const FacadeT &facade)
+    {
+        PrepareHeaps(facade.GetNumberOfNodes(), facade.GetMaxBorderNodeID() + 1);
+    }
+
+    // Logs the hit and miss counters of the unpacking cache and drops the paths of the previous
+    // dataset, whose generation is never looked up again. The counters start over with the next
+    // dataset.
+    void ResetCaches();
 };
 }
 }
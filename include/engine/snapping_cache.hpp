@@ -0,0 +1,225 @@
+#ifndef OSRM_ENGINE_SNAPPING_CACHE_HPP
+#define OSRM_ENGINE_SNAPPING_CACHE_HPP
+
+#include "engine/phantom_node.hpp"
+#include "engine/phantom_node_query.hpp"
+
+#include "util/concurrent_lru_cache.hpp"
+#include "util/coordinate.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/std_hash.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Identifies the snapping of one coordinate. The generation identifies the facade, which differs
+// for every dataset and every set of exclude flags, so entries of a previous dataset are never
+// returned after a facade swap. Coordinates are compared after rounding them down to the
+// precision of the cache.
+struct SnappingCacheKey
+{
+    std::uint64_t generation;
+    std::int32_t lon;
+    std::int32_t lat;
+    double radius;
+    short bearing;
+    short bearing_range;
+    Approach approach;
+    bool with_alternative;
+
+    bool operator==(const SnappingCacheKey &other) const
+    {
+        return generation == other.generation && lon == other.lon && lat == other.lat &&
+               radius == other.radius && bearing == other.bearing &&
+               bearing_range == other.bearing_range && approach == other.approach &&
+               with_alternative == other.with_alternative;
+    }
+};
+
+struct SnappingCacheKeyHash
+{
+    std::size_t operator()(const SnappingCacheKey &key) const
+    {
+        return hash_val(key.generation,
+                        key.lon,
+                        key.lat,
+                        key.radius,
+                        key.bearing,
+                        key.bearing_range,
+                        static_cast<int>(key.approach),
+                        key.with_alternative);
+    }
+};
+
+/**
+ * Snapping results of frequently requested coordinates, shared between all threads.
+ *
+ * Results are cached for the lookups done by route, table, trip and match requests without a
+ * hint: the phantom nodes in range of a coordinate and the nearest phantom node with an
+ * alternative from a big component. With a coordinate precision below 6 decimal places close
+ * coordinates share one entry. The cached phantom nodes are handed out with the input location
+ * and distance of the actual coordinate, sorted by that distance and without the ones that are
+ * out of its radius. The candidates are still the ones found for the first coordinate that was
+ * snapped, so a lower precision is lossy: candidates that are only in range of the actual
+ * coordinate are missing.
+ */
+class SnappingCache
+{
+  public:
+    static constexpr int MAX_COORDINATE_PRECISION = 6;
+
+    explicit SnappingCache(const std::size_t capacity = 0,
+                           const int coordinate_precision = MAX_COORDINATE_PRECISION)
+        : cache(capacity), quantum(1)
+    {
+        BOOST_ASSERT(coordinate_precision >= 0 &&
+                     coordinate_precision <= MAX_COORDINATE_PRECISION);
+        for (int digit = coordinate_precision; digit < MAX_COORDINATE_PRECISION; ++digit)
+            quantum *= 10;
+    }
+
+    bool IsEnabled() const { return cache.IsEnabled(); }
+
+    boost::optional<std::vector<PhantomNodeWithDistance>>
+    FindInRange(const std::uint64_t generation, const PhantomNodeQuery &query)
+    {
+        auto cached = cache.Find(MakeKey(generation, query, false));
+        if (!cached)
+            return boost::none;
+
+        auto phantom_nodes = **cached;
+        bool moved = false;
+        for (auto &phantom_node : phantom_nodes)
+            moved = MoveToCoordinate(phantom_node, query.coordinate) || moved;
+        if (!moved)
+            return phantom_nodes;
+
+        phantom_nodes.erase(std::remove_if(phantom_nodes.begin(),
+                                           phantom_nodes.end(),
+                                           [&](const PhantomNodeWithDistance &phantom_node) {
+                                               return IsOutOfRange(phantom_node.phantom_node,
+                                                                   query);
+                                           }),
+                            phantom_nodes.end());
+        // all candidates of the first coordinate are out of range, the snapper may find others
+        if (phantom_nodes.empty() && !(*cached)->empty())
+            return boost::none;
+
+        std::stable_sort(phantom_nodes.begin(),
+                         phantom_nodes.end(),
+                         [](const PhantomNodeWithDistance &lhs, const PhantomNodeWithDistance &rhs) {
+                             return lhs.distance < rhs.distance;
+                         });
+        return phantom_nodes;
+    }
+
+    void InsertInRange(const std::uint64_t generation,
+                       const PhantomNodeQuery &query,
+                       std::vector<PhantomNodeWithDistance> phantom_nodes)
+    {
+        cache.Insert(MakeKey(generation, query, false),
+                     std::make_shared<const std::vector<PhantomNodeWithDistance>>(
+                         std::move(phantom_nodes)));
+    }
+
+    boost::optional<std::pair<PhantomNode, PhantomNode>>
+    FindWithAlternative(const std::uint64_t generation, const PhantomNodeQuery &query)
+    {
+        auto cached = cache.Find(MakeKey(generation, query, true));
+        if (!cached)
+            return boost::none;
+
+        BOOST_ASSERT((*cached)->size() == 2);
+        auto first = (*cached)->front();
+        auto second = (*cached)->back();
+        MoveToCoordinate(first, query.coordinate);
+        MoveToCoordinate(second, query.coordinate);
+        if (IsOutOfRange(first.phantom_node, query) || IsOutOfRange(second.phantom_node, query))
+            return boost::none;
+        return std::make_pair(first.phantom_node, second.phantom_node);
+    }
+
+    void InsertWithAlternative(const std::uint64_t generation,
+                               const PhantomNodeQuery &query,
+                               const std::pair<PhantomNode, PhantomNode> &phantom_nodes)
+    {
+        // only the phantom nodes are handed out, their distances are not used
+        auto entry = std::make_shared<const std::vector<PhantomNodeWithDistance>>(
+            std::vector<PhantomNodeWithDistance>{{phantom_nodes.first, 0.},
+                                                 {phantom_nodes.second, 0.}});
+        cache.Insert(MakeKey(generation, query, true), std::move(entry));
+    }
+
+    std::uint64_t GetHits() const { return cache.GetHits(); }
+
+    std::uint64_t GetMisses() const { return cache.GetMisses(); }
+
+  private:
+    using CachedPhantomNodes = std::shared_ptr<const std::vector<PhantomNodeWithDistance>>;
+    using Cache =
+        util::ConcurrentLRUCache<SnappingCacheKey, CachedPhantomNodes, SnappingCacheKeyHash>;
+
+    std::int32_t Quantize(const std::int32_t value) const
+    {
+        // rounds down, also for negative values
+        return value >= 0 ? value / quantum : -((-value + quantum - 1) / quantum);
+    }
+
+    SnappingCacheKey MakeKey(const std::uint64_t generation,
+                             const PhantomNodeQuery &query,
+                             const bool with_alternative) const
+    {
+        return SnappingCacheKey{generation,
+                                Quantize(static_cast<std::int32_t>(query.coordinate.lon)),
+                                Quantize(static_cast<std::int32_t>(query.coordinate.lat)),
+                                query.radius ? *query.radius : -1.,
+                                query.bearing ? query.bearing->bearing : short{-1},
+                                query.bearing ? query.bearing->range : short{-1},
+                                query.approach,
+                                with_alternative};
+    }
+
+    // The snapper measures the great circle distance to the point on the segment, which is
+    // recomputed for a coordinate that only shares the entry. For the coordinate that was snapped
+    // the stored distance is kept as is. Returns true if the phantom node was moved.
+    static bool MoveToCoordinate(PhantomNodeWithDistance &phantom_node,
+                                 const util::Coordinate coordinate)
+    {
+        if (phantom_node.phantom_node.input_location == coordinate)
+            return false;
+
+        phantom_node.phantom_node.input_location = coordinate;
+        if (phantom_node.phantom_node.IsValid())
+        {
+            phantom_node.distance = util::coordinate_calculation::greatCircleDistance(
+                coordinate, phantom_node.phantom_node.location);
+        }
+        return true;
+    }
+
+    // Like the snapper's radius check, which uses the haversine distance to the snapped point
+    static bool IsOutOfRange(const PhantomNode &phantom_node, const PhantomNodeQuery &query)
+    {
+        return query.radius && phantom_node.IsValid() &&
+               util::coordinate_calculation::haversineDistance(
+                   query.coordinate, phantom_node.location) > *query.radius;
+    }
+
+    Cache cache;
+    std::int32_t quantum;
+};
+}
+}
+
+#endif
@@ -0,0 +1,343 @@
+#ifndef TRIP_LOCAL_SEARCH_HPP
+#define TRIP_LOCAL_SEARCH_HPP
+
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+namespace detail
+{
+// Tour costs are summed in 64 bit, INVALID_EDGE_WEIGHT edges just count as very expensive
+using TripCost = std::int64_t;
+
+// Number of closest locations that are tried as new neighbours of a location
+const constexpr std::size_t LOCAL_SEARCH_NEIGHBOURS = 10;
+// Longest part of the tour that is moved by a single Or-opt move
+const constexpr std::size_t OR_OPT_MAX_SEGMENT = 3;
+// Number of independent searches, all but the first one start from a perturbed tour
+const constexpr std::size_t LOCAL_SEARCH_STARTS = 8;
+
+inline TripCost GetTourCost(const util::DistTableWrapper<EdgeWeight> &dist_table,
+                            const std::vector<NodeID> &tour)
+{
+    TripCost cost = 0;
+    for (std::size_t index = 0; index < tour.size(); ++index)
+    {
+        cost += dist_table(tour[index], tour[(index + 1) % tour.size()]);
+    }
+    return cost;
+}
+
+// For every location the closest other locations, in either direction
+inline std::vector<std::vector<NodeID>>
+GetNeighbourLists(const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    const auto number_of_locations = dist_table.GetNumberOfNodes();
+    const auto number_of_neighbours = std::min(LOCAL_SEARCH_NEIGHBOURS, number_of_locations - 1);
+
+    std::vector<std::vector<NodeID>> neighbours(number_of_locations);
+    std::vector<NodeID> others;
+    for (NodeID node = 0; node < number_of_locations; ++node)
+    {
+        const auto closeness = [&](const NodeID other) {
+            return std::make_pair(std::min(dist_table(node, other), dist_table(other, node)),
+                                  other);
+        };
+
+        others.clear();
+        for (NodeID other = 0; other < number_of_locations; ++other)
+        {
+            if (other != node)
+                others.push_back(other);
+        }
+        std::partial_sort(others.begin(),
+                          others.begin() + number_of_neighbours,
+                          others.end(),
+                          [&](const NodeID lhs, const NodeID rhs) {
+                              return closeness(lhs) < closeness(rhs);
+                          });
+        neighbours[node].assign(others.begin(), others.begin() + number_of_neighbours);
+    }
+    return neighbours;
+}
+
+// Replaces the tour A B C D by A C B D for random cut points, a change that 2-opt and Or-opt
+// moves can't easily undo
+template <typename Generator> void PerturbTour(std::vector<NodeID> &tour, Generator &generator)
+{
+    if (tour.size() < 8)
+        return;
+
+    std::uniform_int_distribution<std::size_t> distribution(1, tour.size() - 1);
+    std::vector<std::size_t> cuts;
+    while (cuts.size() < 3)
+    {
+        const auto cut = distribution(generator);
+        if (std::find(cuts.begin(), cuts.end(), cut) == cuts.end())
+            cuts.push_back(cut);
+    }
+    std::sort(cuts.begin(), cuts.end());
+    std::rotate(tour.begin() + cuts[0], tour.begin() + cuts[1], tour.begin() + cuts[2]);
+}
+
+// Improves a tour by 2-opt and Or-opt moves until no improving move is left or the deadline is
+// reached. Only moves that connect a location with one of its neighbours are tried. Locations
+// are queued again if one of their edges changed, the others are not looked at any more.
+//
+// The table doesn't need to be symmetric: the costs of traversing a part of the tour in either
+// direction are kept as prefix sums over the tour positions, so reversing a part is priced in
+// constant time.
+template <typename Clock> class TourImprover
+{
+  public:
+    TourImprover(const util::DistTableWrapper<EdgeWeight> &dist_table,
+                 const std::vector<std::vector<NodeID>> &neighbours,
+                 const typename Clock::time_point deadline)
+        : dist_table(dist_table), neighbours(neighbours), deadline(deadline)
+    {
+    }
+
+    std::vector<NodeID> Improve(std::vector<NodeID> tour_)
+    {
+        tour = std::move(tour_);
+        Update();
+
+        std::deque<NodeID> active(tour.begin(), tour.end());
+        queued.assign(tour.size(), true);
+        while (!active.empty() && Clock::now() < deadline)
+        {
+            const auto node = active.front();
+            active.pop_front();
+            queued[node] = false;
+
+            touched.clear();
+            if (TwoOpt(node) || OrOpt(node))
+            {
+                for (const auto touched_node : touched)
+                {
+                    if (!queued[touched_node])
+                    {
+                        queued[touched_node] = true;
+                        active.push_back(touched_node);
+                    }
+                }
+            }
+        }
+        return std::move(tour);
+    }
+
+  private:
+    TripCost Weight(const NodeID from, const NodeID to) const { return dist_table(from, to); }
+
+    std::size_t Wrap(const std::size_t index) const { return index % tour.size(); }
+
+    // Cost of the tour from position first to position last, wrapping around the end
+    TripCost ForwardCost(const std::size_t first, const std::size_t last) const
+    {
+        if (first <= last)
+            return forward_prefix[last] - forward_prefix[first];
+        return forward_prefix.back() - forward_prefix[first] + forward_prefix[last];
+    }
+
+    // Cost of the same part of the tour when it is traversed from last to first
+    TripCost BackwardCost(const std::size_t first, const std::size_t last) const
+    {
+        if (first <= last)
+            return backward_prefix[last] - backward_prefix[first];
+        return backward_prefix.back() - backward_prefix[first] + backward_prefix[last];
+    }
+
+    void Update()
+    {
+        const auto size = tour.size();
+        position.resize(size);
+        forward_prefix.resize(size + 1);
+        backward_prefix.resize(size + 1);
+        forward_prefix[0] = 0;
+        backward_prefix[0] = 0;
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            const auto next = tour[Wrap(index + 1)];
+            position[tour[index]] = index;
+            forward_prefix[index + 1] = forward_prefix[index] + Weight(tour[index], next);
+            backward_prefix[index + 1] = backward_prefix[index] + Weight(next, tour[index]);
+        }
+    }
+
+    // Replaces the edges a -> b and c -> d by a -> c and b -> d, reversing the tour from b to c
+    bool TryTwoOpt(const std::size_t a_position, const std::size_t c_position)
+    {
+        const auto b_position = Wrap(a_position + 1);
+        if (c_position == a_position || c_position == b_position)
+            return false;
+
+        const auto a = tour[a_position];
+        const auto b = tour[b_position];
+        const auto c = tour[c_position];
+        const auto d = tour[Wrap(c_position + 1)];
+
+        const auto old_cost = Weight(a, b) + Weight(c, d) + ForwardCost(b_position, c_position);
+        const auto new_cost = Weight(a, c) + Weight(b, d) + BackwardCost(b_position, c_position);
+        if (new_cost >= old_cost)
+            return false;
+
+        std::rotate(tour.begin(), tour.begin() + b_position, tour.end());
+        std::reverse(tour.begin(), tour.begin() + Wrap(c_position + tour.size() - b_position) + 1);
+        Update();
+        touched = {a, b, c, d};
+        return true;
+    }
+
+    bool TwoOpt(const NodeID node)
+    {
+        const auto size = tour.size();
+        for (const auto neighbour : neighbours[node])
+        {
+            // the new edge node -> neighbour either starts or ends the reversed part
+            if (TryTwoOpt(position[node], position[neighbour]) ||
+                TryTwoOpt(Wrap(position[node] + size - 1), Wrap(position[neighbour] + size - 1)))
+                return true;
+        }
+        return false;
+    }
+
+    // Moves the part of the tour of the given length that starts at first_position between x
+    // and its successor y, optionally reversed
+    bool TryOrOpt(const std::size_t first_position,
+                  const std::size_t length,
+                  const std::size_t x_position)
+    {
+        const auto size = tour.size();
+        const auto last_position = Wrap(first_position + length - 1);
+        const auto y_position = Wrap(x_position + 1);
+        const auto in_segment = [&](const std::size_t index) {
+            return Wrap(index + size - first_position) < length;
+        };
+        if (in_segment(x_position) || in_segment(y_position))
+            return false;
+
+        const auto first = tour[first_position];
+        const auto last = tour[last_position];
+        const auto p = tour[Wrap(first_position + size - 1)];
+        const auto q = tour[Wrap(last_position + 1)];
+        const auto x = tour[x_position];
+        const auto y = tour[y_position];
+
+        const auto forward = ForwardCost(first_position, last_position);
+        const auto backward = BackwardCost(first_position, last_position);
+        const auto removed_cost = Weight(p, first) + Weight(last, q) + Weight(x, y) + forward;
+        const auto kept_cost = Weight(p, q);
+        const auto forward_cost = kept_cost + Weight(x, first) + Weight(last, y) + forward;
+        const auto reversed_cost = kept_cost + Weight(x, last) + Weight(first, y) + backward;
+        if (std::min(forward_cost, reversed_cost) >= removed_cost)
+            return false;
+
+        std::vector<NodeID> segment;
+        for (std::size_t offset = 0; offset < length; ++offset)
+            segment.push_back(tour[Wrap(first_position + offset)]);
+        if (reversed_cost < forward_cost)
+            std::reverse(segment.begin(), segment.end());
+
+        std::vector<NodeID> new_tour;
+        new_tour.reserve(size);
+        for (auto index = Wrap(last_position + 1); index != first_position; index = Wrap(index + 1))
+        {
+            new_tour.push_back(tour[index]);
+            if (index == x_position)
+                new_tour.insert(new_tour.end(), segment.begin(), segment.end());
+        }
+        tour = std::move(new_tour);
+        Update();
+        touched = {p, q, x, y, first, last};
+        return true;
+    }
+
+    bool OrOpt(const NodeID node)
+    {
+        const auto size = tour.size();
+        for (std::size_t length = 1; length <= OR_OPT_MAX_SEGMENT && length + 3 <= size; ++length)
+        {
+            for (const auto neighbour : neighbours[node])
+            {
+                // insert after or before the neighbour
+                if (TryOrOpt(position[node], length, position[neighbour]) ||
+                    TryOrOpt(position[node], length, Wrap(position[neighbour] + size - 1)))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    const util::DistTableWrapper<EdgeWeight> &dist_table;
+    const std::vector<std::vector<NodeID>> &neighbours;
+    const typename Clock::time_point deadline;
+
+    std::vector<NodeID> tour;
+    std::vector<std::size_t> position;
+    std::vector<TripCost> forward_prefix;
+    std::vector<TripCost> backward_prefix;
+    std::vector<bool> queued;
+    std::vector<NodeID> touched;
+};
+}
+
+// Improves a trip, e.g. the result of the farthest insertion, by 2-opt and Or-opt moves. Several
+// searches run in parallel, each from a differently perturbed trip, and the cheapest result is
+// returned. The trip is never made worse. All searches stop once time_budget has passed on Clock,
+// so for large instances the result depends on the speed of the machine.
+template <typename Clock = std::chrono::steady_clock>
+std::vector<NodeID> LocalSearchTrip(std::vector<NodeID> trip,
+                                    const util::DistTableWrapper<EdgeWeight> &dist_table,
+                                    const std::chrono::milliseconds time_budget)
+{
+    BOOST_ASSERT(trip.size() == dist_table.GetNumberOfNodes());
+    if (trip.size() < 5)
+        return trip;
+
+    const auto deadline = Clock::now() + time_budget;
+    const auto neighbours = detail::GetNeighbourLists(dist_table);
+
+    std::vector<std::vector<NodeID>> tours(detail::LOCAL_SEARCH_STARTS, trip);
+    tbb::parallel_for(std::size_t{0}, detail::LOCAL_SEARCH_STARTS, [&](const std::size_t start) {
+        auto &tour = tours[start];
+        if (start > 0)
+        {
+            std::mt19937 generator(start);
+            detail::PerturbTour(tour, generator);
+        }
+        tour = detail::TourImprover<Clock>(dist_table, neighbours, deadline)
+                   .Improve(std::move(tour));
+    });
+
+    // the unperturbed search comes first and wins all ties
+    std::vector<detail::TripCost> costs;
+    for (const auto &tour : tours)
+        costs.push_back(detail::GetTourCost(dist_table, tour));
+    const auto best = std::min_element(costs.begin(), costs.end()) - costs.begin();
+    if (costs[best] >= detail::GetTourCost(dist_table, trip))
+        return trip;
+    return std::move(tours[best]);
+}
+}
+}
+}
+
+#endif // TRIP_LOCAL_SEARCH_HPP
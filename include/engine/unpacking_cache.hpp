@@ -0,0 +1,66 @@
+#ifndef OSRM_ENGINE_UNPACKING_CACHE_HPP
+#define OSRM_ENGINE_UNPACKING_CACHE_HPP
+
+#include "util/concurrent_lru_cache.hpp"
+#include "util/std_hash.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Identifies the unpacking of one MLD clique arc source -> target inside of a cell.
+// The generation identifies the facade (metric and exclude flags) the path was computed on,
+// so entries of a previous dataset can never be returned after a facade swap.
+struct UnpackingCacheKey
+{
+    std::uint64_t generation;
+    LevelID level;
+    CellID cell;
+    NodeID source;
+    NodeID target;
+    bool force_loop_forward;
+    bool force_loop_reverse;
+
+    bool operator==(const UnpackingCacheKey &other) const
+    {
+        return generation == other.generation && level == other.level && cell == other.cell &&
+               source == other.source && target == other.target &&
+               force_loop_forward == other.force_loop_forward &&
+               force_loop_reverse == other.force_loop_reverse;
+    }
+};
+
+struct UnpackingCacheKeyHash
+{
+    std::size_t operator()(const UnpackingCacheKey &key) const
+    {
+        return hash_val(key.generation,
+                        key.level,
+                        key.cell,
+                        key.source,
+                        key.target,
+                        key.force_loop_forward,
+                        key.force_loop_reverse);
+    }
+};
+
+// Base graph nodes and edges of an unpacked clique arc, including the source node
+struct UnpackedSubpath
+{
+    std::vector<NodeID> nodes;
+    std::vector<EdgeID> edges;
+};
+
+using UnpackingCache = util::ConcurrentLRUCache<UnpackingCacheKey,
+                                                std::shared_ptr<const UnpackedSubpath>,
+                                                UnpackingCacheKeyHash>;
+}
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef OSRM_ENGINE_WARMUP_THREAD_SCOPE_HPP
+#define OSRM_ENGINE_WARMUP_THREAD_SCOPE_HPP
+
+namespace osrm
+{
+namespace engine
+{
+
+// Marks the threads that warm up a dataset before it is published. The MLD heaps of these
+// threads are neither counted nor taken from the prepared ones, which are left for the threads
+// of the requests. Parallel regions of a query pass IsActive() of the calling thread on to their
+// worker threads.
+class WarmupThreadScope
+{
+  public:
+    explicit WarmupThreadScope(const bool warmup_thread = true) : was_active(IsActive())
+    {
+        Flag() = was_active || warmup_thread;
+    }
+
+    ~WarmupThreadScope() { Flag() = was_active; }
+
+    WarmupThreadScope(const WarmupThreadScope &) = delete;
+    WarmupThreadScope &operator=(const WarmupThreadScope &) = delete;
+
+    static bool IsActive() { return Flag(); }
+
+  private:
+    // Defined in the header so code outside of the engine, e.g. the R-tree queries, can use it
+    static bool &Flag()
+    {
+        static thread_local bool is_warmup_thread = false;
+        return is_warmup_thread;
+    }
+
+    const bool was_active;
+};
+}
+}
+
+#endif
@@ -84,7 +84,8 @@ class EdgeBasedGraphFactory
              const RestrictionMap &node_restriction_map,
              const ConditionalRestrictionMap &conditional_restriction_map,
              const WayRestrictionMap &way_restriction_map,
-             const std::vector<UnresolvedManeuverOverride> &maneuver_overrides);
+             const std::vector<UnresolvedManeuverOverride> &maneuver_overrides,
+             const bool compress_maneuver_overrides = false);
 
     // The following get access functions destroy the content in the factory
     void GetEdgeBasedEdges(util::DeallocatingVector<EdgeBasedEdge> &edges);
@@ -168,7 +169,8 @@ class EdgeBasedGraphFactory
                               const RestrictionMap &node_restriction_map,
                               const ConditionalRestrictionMap &conditional_restriction_map,
                               const WayRestrictionMap &way_restriction_map,
-                              const std::vector<UnresolvedManeuverOverride> &maneuver_overrides);
+                              const std::vector<UnresolvedManeuverOverride> &maneuver_overrides,
+                              const bool compress_maneuver_overrides);
 
     NBGToEBG InsertEdgeBasedNode(const NodeID u, const NodeID v);
 
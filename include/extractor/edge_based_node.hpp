@@ -8,10 +8,10 @@ namespace osrm
 namespace extractor
 {
 
+// Data of an edge-based node that is only needed for guidance and annotations. The geometry,
+// component and classes are stored separately, see EdgeBasedNodeDataContainer.
 struct EdgeBasedNode
 {
-    GeometryID geometry_id;
-    ComponentID component_id;
     std::uint32_t annotation_id : 31;
     std::uint32_t segregated : 1;
 };
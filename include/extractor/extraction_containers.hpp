@@ -30,7 +30,7 @@ class ExtractionContainers
     void WriteNodes(storage::tar::FileWriter &file_out) const;
     void WriteEdges(storage::tar::FileWriter &file_out) const;
     void WriteMetadata(storage::tar::FileWriter &file_out) const;
-    void WriteCharData(const std::string &file_name);
+    void WriteCharData(const std::string &file_name, const bool compress);
 
   public:
     using NodeIDVector = std::vector<OSMNodeID>;
@@ -69,9 +69,11 @@ class ExtractionContainers
 
     ExtractionContainers();
 
+    // With compress_names the names are written compressed
     void PrepareData(ScriptingEnvironment &scripting_environment,
                      const std::string &osrm_path,
-                     const std::string &names_data_path);
+                     const std::string &names_data_path,
+                     const bool compress_names = false);
 };
 }
 }
@@ -97,7 +97,8 @@ class Extractor
                         EdgeBasedNodeDataContainer &nodes_container) const;
     void BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_segments,
                     std::vector<bool> node_is_startpoint,
-                    const std::vector<util::Coordinate> &coordinates);
+                    const std::vector<util::Coordinate> &coordinates,
+                    const EdgeBasedNodeDataContainer &nodes_container);
     std::shared_ptr<RestrictionMap> LoadRestrictionMap();
 
     void WriteConditionalRestrictions(
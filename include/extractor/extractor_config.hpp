@@ -70,7 +70,8 @@ struct ExtractorConfig final : storage::IOConfig
                                       ".osrm.maneuver_overrides"}),
                                  requested_num_threads(0),
                                  parse_conditionals(false),
-                                 use_locations_cache(true)
+                                 use_locations_cache(true), store_rtree_coordinates(true),
+                                 compress_cold_data(false)
     {
     }
 
@@ -91,6 +92,8 @@ struct ExtractorConfig final : storage::IOConfig
     bool use_metadata;
     bool parse_conditionals;
     bool use_locations_cache;
+    bool store_rtree_coordinates;
+    bool compress_cold_data;
 };
 }
 }
@@ -29,13 +29,16 @@ namespace files
 template <typename IntersectionBearingsT, typename EntryClassVectorT>
 inline void writeIntersections(const boost::filesystem::path &path,
                                const IntersectionBearingsT &intersection_bearings,
-                               const EntryClassVectorT &entry_classes)
+                               const EntryClassVectorT &entry_classes,
+                               const storage::tar::FileWriter::CompressionFlag compression =
+                                   storage::tar::FileWriter::NoCompression)
 {
     static_assert(std::is_same<IntersectionBearingsContainer, IntersectionBearingsT>::value ||
                       std::is_same<IntersectionBearingsView, IntersectionBearingsT>::value,
                   "");
 
-    storage::tar::FileWriter writer(path, storage::tar::FileWriter::GenerateFingerprint);
+    storage::tar::FileWriter writer(
+        path, storage::tar::FileWriter::GenerateFingerprint, compression);
 
     serialization::write(writer, "/common/intersection_bearings", intersection_bearings);
     storage::serialization::write(writer, "/common/entry_classes", entry_classes);
@@ -266,14 +269,16 @@ inline void readTurnLaneDescriptions(const boost::filesystem::path &path,
 template <typename OffsetsT, typename MaskT>
 inline void writeTurnLaneDescriptions(const boost::filesystem::path &path,
                                       const OffsetsT &turn_offsets,
-                                      const MaskT &turn_masks)
+                                      const MaskT &turn_masks,
+                                      const storage::tar::FileWriter::CompressionFlag compression =
+                                          storage::tar::FileWriter::NoCompression)
 {
     static_assert(std::is_same<typename MaskT::value_type, extractor::TurnLaneType::Mask>::value,
                   "");
     static_assert(std::is_same<typename OffsetsT::value_type, std::uint32_t>::value, "");
 
     const auto fingerprint = storage::tar::FileWriter::GenerateFingerprint;
-    storage::tar::FileWriter writer{path, fingerprint};
+    storage::tar::FileWriter writer{path, fingerprint, compression};
 
     storage::serialization::write(writer, "/common/turn_lanes/offsets", turn_offsets);
     storage::serialization::write(writer, "/common/turn_lanes/masks", turn_masks);
@@ -326,10 +331,12 @@ inline void readManeuverOverrides(const boost::filesystem::path &path,
 // writes .osrm.maneuver_overrides
 inline void writeManeuverOverrides(const boost::filesystem::path &path,
                                    const std::vector<StorageManeuverOverride> &maneuver_overrides,
-                                   const std::vector<NodeID> &node_sequences)
+                                   const std::vector<NodeID> &node_sequences,
+                                   const storage::tar::FileWriter::CompressionFlag compression =
+                                       storage::tar::FileWriter::NoCompression)
 {
     const auto fingerprint = storage::tar::FileWriter::GenerateFingerprint;
-    storage::tar::FileWriter writer{path, fingerprint};
+    storage::tar::FileWriter writer{path, fingerprint, compression};
 
     storage::serialization::write(
         writer, "/common/maneuver_overrides/overrides", maneuver_overrides);
@@ -445,10 +452,13 @@ void readNames(const boost::filesystem::path &path, NameTableT &table)
 }
 
 template <typename NameTableT>
-void writeNames(const boost::filesystem::path &path, const NameTableT &table)
+void writeNames(const boost::filesystem::path &path,
+                const NameTableT &table,
+                const storage::tar::FileWriter::CompressionFlag compression =
+                    storage::tar::FileWriter::NoCompression)
 {
     const auto fingerprint = storage::tar::FileWriter::GenerateFingerprint;
-    storage::tar::FileWriter writer{path, fingerprint};
+    storage::tar::FileWriter writer{path, fingerprint, compression};
 
     serialization::write(writer, "/common/names", table);
 }
@@ -9,6 +9,7 @@
 #include "storage/shared_memory_ownership.hpp"
 #include "storage/tar_fwd.hpp"
 
+#include "util/integer_range.hpp"
 #include "util/permutation.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
@@ -55,19 +56,41 @@ template <storage::Ownership Ownership> class EdgeBasedNodeDataContainerImpl
 
     EdgeBasedNodeDataContainerImpl(const NodeID number_of_edge_based_nodes,
                                    const AnnotationID number_of_annotations)
-        : nodes(number_of_edge_based_nodes), annotation_data(number_of_annotations)
+        : geometry_ids(number_of_edge_based_nodes), component_ids(number_of_edge_based_nodes),
+          classes(number_of_edge_based_nodes), nodes(number_of_edge_based_nodes),
+          annotation_data(number_of_annotations)
     {
     }
 
-    EdgeBasedNodeDataContainerImpl(Vector<EdgeBasedNode> nodes,
+    // The geometry and component of the nodes are left empty
+    template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
+    EdgeBasedNodeDataContainerImpl(Vector<EdgeBasedNode> nodes_,
+                                   Vector<NodeBasedEdgeAnnotation> annotation_data_)
+        : geometry_ids(nodes_.size()), component_ids(nodes_.size()), classes(nodes_.size()),
+          nodes(std::move(nodes_)), annotation_data(std::move(annotation_data_))
+    {
+        for (const auto node_id : util::irange<NodeID>(0, nodes.size()))
+        {
+            const auto annotation_id = nodes[node_id].annotation_id;
+            if (annotation_id < annotation_data.size())
+                classes[node_id] = annotation_data[annotation_id].classes;
+        }
+    }
+
+    EdgeBasedNodeDataContainerImpl(Vector<GeometryID> geometry_ids,
+                                   Vector<ComponentID> component_ids,
+                                   Vector<ClassData> classes,
+                                   Vector<EdgeBasedNode> nodes,
                                    Vector<NodeBasedEdgeAnnotation> annotation_data)
-        : nodes(std::move(nodes)), annotation_data(std::move(annotation_data))
+        : geometry_ids(std::move(geometry_ids)), component_ids(std::move(component_ids)),
+          classes(std::move(classes)), nodes(std::move(nodes)),
+          annotation_data(std::move(annotation_data))
     {
     }
 
-    GeometryID GetGeometryID(const NodeID node_id) const { return nodes[node_id].geometry_id; }
+    GeometryID GetGeometryID(const NodeID node_id) const { return geometry_ids[node_id]; }
 
-    ComponentID GetComponentID(const NodeID node_id) const { return nodes[node_id].component_id; }
+    ComponentID GetComponentID(const NodeID node_id) const { return component_ids[node_id]; }
 
     TravelMode GetTravelMode(const NodeID node_id) const
     {
@@ -86,10 +109,7 @@ template <storage::Ownership Ownership> class EdgeBasedNodeDataContainerImpl
         return annotation_data[nodes[node_id].annotation_id].name_id;
     }
 
-    ClassData GetClassData(const NodeID node_id) const
-    {
-        return annotation_data[nodes[node_id].annotation_id].classes;
-    }
+    ClassData GetClassData(const NodeID node_id) const { return classes[node_id]; }
 
     friend void serialization::read<Ownership>(storage::tar::FileReader &reader,
                                                const std::string &name,
@@ -102,6 +122,9 @@ template <storage::Ownership Ownership> class EdgeBasedNodeDataContainerImpl
     template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
     void Renumber(const std::vector<std::uint32_t> &permutation)
     {
+        util::inplacePermutation(geometry_ids.begin(), geometry_ids.end(), permutation);
+        util::inplacePermutation(component_ids.begin(), component_ids.end(), permutation);
+        util::inplacePermutation(classes.begin(), classes.end(), permutation);
         util::inplacePermutation(nodes.begin(), nodes.end(), permutation);
     }
 
@@ -119,6 +142,33 @@ template <storage::Ownership Ownership> class EdgeBasedNodeDataContainerImpl
     }
 
   private:
+    template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
+    void Resize(const NodeID number_of_edge_based_nodes)
+    {
+        geometry_ids.resize(number_of_edge_based_nodes);
+        component_ids.resize(number_of_edge_based_nodes);
+        classes.resize(number_of_edge_based_nodes);
+        nodes.resize(number_of_edge_based_nodes);
+    }
+
+    void SetData(const NodeID node_id,
+                 const GeometryID geometry_id,
+                 const AnnotationID annotation_id,
+                 const bool segregated)
+    {
+        geometry_ids[node_id] = geometry_id;
+        classes[node_id] = GetAnnotation(annotation_id).classes;
+        nodes[node_id].annotation_id = annotation_id;
+        nodes[node_id].segregated = segregated;
+    }
+
+    // Needed by every search and for snapping, stored in separate arrays so these lookups only
+    // touch the data they use
+    Vector<GeometryID> geometry_ids;
+    Vector<ComponentID> component_ids;
+    // copy of the classes of the annotation of each node, so excluding nodes needs no indirection
+    Vector<ClassData> classes;
+    // Only needed for guidance and annotations
     Vector<EdgeBasedNode> nodes;
     Vector<NodeBasedEdgeAnnotation> annotation_data;
 };
@@ -117,6 +117,11 @@ inline void read(storage::tar::FileReader &reader,
                  detail::EdgeBasedNodeDataContainerImpl<Ownership> &node_data_container)
 {
     // read actual data
+    storage::serialization::read(
+        reader, name + "/geometry_ids", node_data_container.geometry_ids);
+    storage::serialization::read(
+        reader, name + "/component_ids", node_data_container.component_ids);
+    storage::serialization::read(reader, name + "/classes", node_data_container.classes);
     storage::serialization::read(reader, name + "/nodes", node_data_container.nodes);
     storage::serialization::read(
         reader, name + "/annotations", node_data_container.annotation_data);
@@ -127,6 +132,11 @@ inline void write(storage::tar::FileWriter &writer,
                   const std::string &name,
                   const detail::EdgeBasedNodeDataContainerImpl<Ownership> &node_data_container)
 {
+    storage::serialization::write(
+        writer, name + "/geometry_ids", node_data_container.geometry_ids);
+    storage::serialization::write(
+        writer, name + "/component_ids", node_data_container.component_ids);
+    storage::serialization::write(writer, name + "/classes", node_data_container.classes);
     storage::serialization::write(writer, name + "/nodes", node_data_container.nodes);
     storage::serialization::write(
         writer, name + "/annotations", node_data_container.annotation_data);
@@ -17,7 +17,12 @@ struct PartitionerConfig final : storage::IOConfig
 {
     PartitionerConfig()
         : IOConfig({".osrm", ".osrm.fileIndex", ".osrm.ebg_nodes", ".osrm.enw"},
-                   {".osrm.hsgr", ".osrm.cnbg"},
+                   {".osrm.hsgr",
+                    ".osrm.shortcuts",
+                    ".osrm.cch",
+                    ".osrm.hub_labels",
+                    ".osrm.tnr",
+                    ".osrm.cnbg"},
                    {".osrm.ebg",
                     ".osrm.cnbg",
                     ".osrm.cnbg_to_ebg",
@@ -0,0 +1,38 @@
+#ifndef SERVER_QUERY_REPLAY_HPP
+#define SERVER_QUERY_REPLAY_HPP
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+class EngineInterface;
+}
+
+namespace server
+{
+
+// Reads a query log with one request URL per line, e.g. /route/v1/driving/13.38,52.51;13.39,52.52
+// Empty lines and lines starting with # are skipped.
+std::vector<std::string> readQueryLog(const boost::filesystem::path &path);
+
+// Runs the queries through the plugins of the engine and drops the results. Queries that can not
+// be parsed are skipped. Returns the number of queries that were run.
+std::size_t replayQueries(const engine::EngineInterface &engine,
+                          const std::vector<std::string> &queries);
+
+// Selects the queries of the profile in their URL. The queries for an empty profile are the ones
+// of all profiles except other_profiles, which are served from datasets of their own, and the
+// ones that can not be parsed.
+std::vector<std::string> selectProfileQueries(const std::vector<std::string> &queries,
+                                              const std::string &profile,
+                                              const std::vector<std::string> &other_profiles);
+}
+}
+
+#endif
@@ -3,7 +3,9 @@
 
 #include "server/service_handler.hpp"
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace osrm
 {
@@ -24,12 +26,21 @@ class RequestHandler
     RequestHandler(const RequestHandler &) = delete;
     RequestHandler &operator=(const RequestHandler &) = delete;
 
+    // Answers requests for all profiles without a handler of their own
     void RegisterServiceHandler(std::unique_ptr<ServiceHandlerInterface> service_handler);
 
+    // Answers requests with the profile in the URL, e.g. /route/v1/<profile>/...
+    void RegisterServiceHandler(const std::string &profile,
+                                std::unique_ptr<ServiceHandlerInterface> service_handler);
+
     void HandleRequest(const http::request &current_request, http::reply &current_reply);
 
   private:
+    ServiceHandlerInterface *GetServiceHandler(const std::string &profile) const;
+
     std::unique_ptr<ServiceHandlerInterface> service_handler;
+    std::unordered_map<std::string, std::unique_ptr<ServiceHandlerInterface>>
+        profile_service_handlers;
 };
 }
 }
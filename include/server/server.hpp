@@ -7,6 +7,7 @@
 
 #include "util/integer_range.hpp"
 #include "util/log.hpp"
+#include "util/numa.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
@@ -33,17 +34,24 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                bool pin_threads_to_numa_nodes = false)
     {
         util::Log() << "http 1.1 compression handled by zlib version " << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        return std::make_shared<Server>(
+            ip_address, ip_port, real_num_threads, pin_threads_to_numa_nodes);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const bool pin_threads_to_numa_nodes = false)
+        : thread_pool_size(thread_pool_size), pin_threads_to_numa_nodes(pin_threads_to_numa_nodes),
+          acceptor(io_service),
           new_connection(std::make_shared<Connection>(io_service, request_handler))
     {
         const auto port_string = std::to_string(port);
@@ -70,11 +78,26 @@ class Server
 
     void Run()
     {
+        // The threads are spread evenly over the NUMA nodes, there is nothing to pin with one
+        const auto numa_nodes = pin_threads_to_numa_nodes ? util::GetNUMANodes()
+                                                          : std::vector<std::vector<unsigned>>{};
+
         std::vector<std::shared_ptr<std::thread>> threads;
         for (unsigned i = 0; i < thread_pool_size; ++i)
         {
-            std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-                boost::bind(&boost::asio::io_service::run, &io_service));
+            const auto run = [this, &numa_nodes, i] {
+                if (numa_nodes.size() > 1)
+                {
+                    const auto node = i % numa_nodes.size();
+                    if (!util::PinThreadToNUMANode(node, numa_nodes[node]))
+                    {
+                        util::Log(logWARNING) << "Could not pin thread " << i << " to NUMA node "
+                                              << node;
+                    }
+                }
+                io_service.run();
+            };
+            std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(run);
             threads.push_back(thread);
         }
         for (auto thread : threads)
@@ -90,6 +113,13 @@ class Server
         request_handler.RegisterServiceHandler(std::move(service_handler_));
     }
 
+    // All profiles are served by the same threads
+    void RegisterServiceHandler(const std::string &profile,
+                                std::unique_ptr<ServiceHandlerInterface> service_handler_)
+    {
+        request_handler.RegisterServiceHandler(profile, std::move(service_handler_));
+    }
+
   private:
     void HandleAccept(const boost::system::error_code &e)
     {
@@ -104,6 +134,7 @@ class Server
     }
 
     unsigned thread_pool_size;
+    bool pin_threads_to_numa_nodes;
     boost::asio::io_service io_service;
     boost::asio::ip::tcp::acceptor acceptor;
     std::shared_ptr<Connection> new_connection;
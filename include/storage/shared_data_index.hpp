@@ -44,6 +44,14 @@ class SharedDataIndex
         }
     }
 
+    // A block that is part of several regions is read from the last one
+    const std::vector<AllocatedRegion> &GetRegions() const { return regions; }
+
+    bool HasBlock(const std::string &name) const
+    {
+        return block_to_region.find(name) != block_to_region.end();
+    }
+
     template <typename T> auto GetBlockPtr(const std::string &name) const
     {
         const auto &region = GetBlockRegion(name);
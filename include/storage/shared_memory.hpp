@@ -3,6 +3,7 @@
 
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
+#include "util/huge_pages.hpp"
 #include "util/log.hpp"
 
 #include <boost/filesystem.hpp>
@@ -52,10 +53,13 @@ class SharedMemory
     SharedMemory(const SharedMemory &) = delete;
     SharedMemory &operator=(const SharedMemory &) = delete;
 
+    // With huge_pages a new region is backed by explicit huge pages if the system has enough of
+    // them reserved, otherwise by transparent huge pages if they are enabled for shared memory.
     template <typename IdentifierT>
     SharedMemory(const boost::filesystem::path &lock_file,
                  const IdentifierT id,
-                 const uint64_t size = 0)
+                 const uint64_t size = 0,
+                 const bool huge_pages = false)
         : key(lock_file.string().c_str(), id)
     {
         // open only
@@ -70,6 +74,8 @@ class SharedMemory
         // open or create
         else
         {
+            const bool explicit_huge_pages = huge_pages && CreateHugePageSegment(size);
+
             shm = boost::interprocess::xsi_shared_memory(
                 boost::interprocess::open_or_create, key, size);
             util::Log(logDEBUG) << "opening/creating " << shm.get_shmid() << " from id " << id
@@ -84,6 +90,18 @@ class SharedMemory
             }
 #endif
             region = boost::interprocess::mapped_region(shm, boost::interprocess::read_write);
+
+            if (huge_pages && !explicit_huge_pages)
+            {
+                if (util::AdviseHugePages(region.get_address(), region.get_size()))
+                {
+                    util::Log() << "Using transparent huge pages for shared memory";
+                }
+                else
+                {
+                    util::Log(logWARNING) << "Huge pages are not available for shared memory";
+                }
+            }
         }
     }
 
@@ -162,6 +180,29 @@ class SharedMemory
 #endif
 
   private:
+    // The segment needs to be created with SHM_HUGETLB before it is opened, its size is a
+    // multiple of the huge page size
+    bool CreateHugePageSegment(const uint64_t size)
+    {
+#if defined(__linux__) && defined(SHM_HUGETLB)
+        const auto huge_page_size = util::GetHugePageSize();
+        if (huge_page_size > 0)
+        {
+            const auto rounded_size = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+            if (-1 != ::shmget(key.get_key(), rounded_size, IPC_CREAT | SHM_HUGETLB | 0644))
+            {
+                util::Log() << "Using explicit huge pages of " << huge_page_size
+                            << " bytes for shared memory";
+                return true;
+            }
+        }
+        util::Log(logDEBUG) << "Could not allocate explicit huge pages for shared memory";
+#else
+        (void)size;
+#endif
+        return false;
+    }
+
     static bool RegionExists(const boost::interprocess::xsi_key &key)
     {
         bool result = true;
@@ -203,7 +244,11 @@ class SharedMemory
     void *Ptr() const { return region.get_address(); }
     std::size_t Size() const { return region.get_size(); }
 
-    SharedMemory(const boost::filesystem::path &lock_file, const int id, const uint64_t size = 0)
+    // Huge pages are not supported on Windows
+    SharedMemory(const boost::filesystem::path &lock_file,
+                 const int id,
+                 const uint64_t size = 0,
+                 const bool /*huge_pages*/ = false)
     {
         sprintf(key, "%s.%d", "osrm.lock", id);
         if (0 == size)
@@ -285,7 +330,8 @@ class SharedMemory
 #endif
 
 template <typename IdentifierT, typename LockFileT = OSRMLockFile>
-std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id, const uint64_t size = 0)
+std::unique_ptr<SharedMemory>
+makeSharedMemory(const IdentifierT &id, const uint64_t size = 0, const bool huge_pages = false)
 {
     static_assert(sizeof(id) == sizeof(std::uint16_t), "Key type is not 16 bits");
     try
@@ -302,7 +348,7 @@ std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id, const uint
                 boost::filesystem::ofstream ofs(lock_file(id));
             }
         }
-        return std::make_unique<SharedMemory>(lock_file(id), id, size);
+        return std::make_unique<SharedMemory>(lock_file(id), id, size, huge_pages);
     }
     catch (const boost::interprocess::interprocess_exception &e)
     {
@@ -35,6 +35,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/filesystem/path.hpp>
 
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -52,6 +53,10 @@ class Storage
     void PopulateStaticData(const SharedDataIndex &index);
     void PopulateUpdatableData(const SharedDataIndex &index);
 
+    // Tar files that make up the static and the updatable data, missing optional files are skipped
+    std::vector<boost::filesystem::path> GetStaticFiles() const;
+    std::vector<boost::filesystem::path> GetUpdatableFiles() const;
+
   private:
     StorageConfig config;
 };
@@ -40,6 +40,10 @@ namespace storage
 /**
  * Configures OSRM's file storage paths.
  *
+ * The leaves of the R-tree are read from the .fileIndex file on demand, unless
+ * rtree_leaves_in_memory is set. With huge_pages the memory holding the data is backed by huge
+ * pages where the system supports them, which reduces TLB misses on random access.
+ *
  * \see OSRM, EngineConfig
  */
 struct StorageConfig final : IOConfig
@@ -69,10 +73,16 @@ struct StorageConfig final : IOConfig
                     ".osrm.mldgr",
                     ".osrm.tld",
                     ".osrm.tls",
-                    ".osrm.partition"},
+                    ".osrm.partition",
+                    ".osrm.shortcuts",
+                    ".osrm.hub_labels",
+                    ".osrm.tnr"},
                    {})
     {
     }
+
+    bool rtree_leaves_in_memory = false;
+    bool huge_pages = false;
 };
 }
 }
@@ -7,8 +7,18 @@
 #include "util/integer_range.hpp"
 #include "util/version.hpp"
 
+#include <boost/assert.hpp>
 #include <boost/filesystem/path.hpp>
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 extern "C" {
 #include "microtar.h"
 }
@@ -19,8 +29,88 @@ namespace storage
 {
 namespace tar
 {
+// A compressed file is followed by a file with this suffix that stores its uncompressed size
+const constexpr char COMPRESSED_SIZE_SUFFIX[] = ".compressed.meta";
+
 namespace detail
 {
+// zlib counts bytes in 32 bit integers, larger buffers are passed in chunks
+const constexpr std::size_t ZLIB_CHUNK_SIZE = std::numeric_limits<uInt>::max();
+const constexpr std::size_t ZLIB_OUTPUT_SIZE = 1024 * 1024;
+
+inline std::vector<char> compressBlock(const char *data, const std::size_t size)
+{
+    z_stream stream{};
+    if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+        throw util::exception("Could not initialize zlib " + SOURCE_REF);
+    }
+
+    std::vector<char> compressed;
+    std::size_t remaining_input = size;
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+
+    int ret = Z_OK;
+    while (ret != Z_STREAM_END)
+    {
+        if (stream.avail_in == 0)
+        {
+            stream.avail_in = std::min(remaining_input, ZLIB_CHUNK_SIZE);
+            remaining_input -= stream.avail_in;
+        }
+
+        const auto position = compressed.size();
+        compressed.resize(position + ZLIB_OUTPUT_SIZE);
+        stream.next_out = reinterpret_cast<Bytef *>(compressed.data() + position);
+        stream.avail_out = ZLIB_OUTPUT_SIZE;
+
+        ret = deflate(&stream, remaining_input == 0 ? Z_FINISH : Z_NO_FLUSH);
+        BOOST_ASSERT(ret != Z_STREAM_ERROR);
+        compressed.resize(position + ZLIB_OUTPUT_SIZE - stream.avail_out);
+    }
+    deflateEnd(&stream);
+
+    return compressed;
+}
+
+// Returns false if the compressed data does not decompress to exactly size bytes
+inline bool decompressBlock(const char *compressed,
+                            const std::size_t compressed_size,
+                            char *data,
+                            const std::size_t size)
+{
+    z_stream stream{};
+    if (inflateInit(&stream) != Z_OK)
+    {
+        throw util::exception("Could not initialize zlib " + SOURCE_REF);
+    }
+
+    std::size_t remaining_input = compressed_size;
+    std::size_t remaining_output = size;
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed));
+    stream.next_out = reinterpret_cast<Bytef *>(data);
+
+    int ret = Z_OK;
+    while (ret == Z_OK)
+    {
+        if (stream.avail_in == 0)
+        {
+            stream.avail_in = std::min(remaining_input, ZLIB_CHUNK_SIZE);
+            remaining_input -= stream.avail_in;
+        }
+        if (stream.avail_out == 0)
+        {
+            stream.avail_out = std::min(remaining_output, ZLIB_CHUNK_SIZE);
+            remaining_output -= stream.avail_out;
+        }
+
+        ret = inflate(&stream, Z_NO_FLUSH);
+    }
+    inflateEnd(&stream);
+
+    return ret == Z_STREAM_END && stream.avail_out == 0 && remaining_output == 0;
+}
+
 inline void
 checkMTarError(int error_code, const boost::filesystem::path &filepath, const std::string &name)
 {
@@ -86,6 +176,8 @@ class FileReader
         auto ret = mtar_open(&handle, path.string().c_str(), "r");
         detail::checkMTarError(ret, path, "");
 
+        BuildIndex();
+
         if (flag == VerifyFingerprint)
         {
             ReadAndCheckFingerprint();
@@ -108,24 +200,39 @@ class FileReader
 
     template <typename T, typename OutIter> void ReadStreaming(const std::string &name, OutIter out)
     {
-        mtar_header_t header;
-        auto ret = mtar_find(&handle, name.c_str(), &header);
-        detail::checkMTarError(ret, path, name);
+        const auto entry_index = FindEntry(name);
+        const auto size = entries[entry_index].size;
 
-        auto number_of_elements = header.size / sizeof(T);
+        auto number_of_elements = size / sizeof(T);
         auto expected_size = sizeof(T) * number_of_elements;
-        if (header.size != expected_size)
+        if (size != expected_size)
         {
             throw util::RuntimeError(name + ": Datatype size does not match file size.",
                                      ErrorCode::UnexpectedEndOfFile,
                                      SOURCE_REF);
         }
 
+        if (entries[entry_index].compressed)
+        {
+            std::vector<char> buffer(size);
+            ReadEntry(entry_index, buffer.data());
+
+            T tmp;
+            for (auto index : util::irange<std::size_t>(0, number_of_elements))
+            {
+                std::memcpy(&tmp, buffer.data() + index * sizeof(T), sizeof(T));
+                *out++ = tmp;
+            }
+            return;
+        }
+
+        SeekToEntry(entry_index);
+
         T tmp;
         for (auto index : util::irange<std::size_t>(0, number_of_elements))
         {
             (void)index;
-            ret = mtar_read_data(&handle, reinterpret_cast<char *>(&tmp), sizeof(T));
+            auto ret = mtar_read_data(&handle, reinterpret_cast<char *>(&tmp), sizeof(T));
             detail::checkMTarError(ret, path, name);
 
             *out++ = tmp;
@@ -135,52 +242,141 @@ class FileReader
     template <typename T>
     void ReadInto(const std::string &name, T *data, const std::size_t number_of_elements)
     {
-        mtar_header_t header;
-        auto ret = mtar_find(&handle, name.c_str(), &header);
-        detail::checkMTarError(ret, path, name);
+        const auto entry_index = FindEntry(name);
 
         auto expected_size = sizeof(T) * number_of_elements;
-        if (header.size != expected_size)
+        if (entries[entry_index].size != expected_size)
         {
             throw util::RuntimeError(name + ": Datatype size does not match file size.",
                                      ErrorCode::UnexpectedEndOfFile,
                                      SOURCE_REF);
         }
 
-        ret = mtar_read_data(&handle, reinterpret_cast<char *>(data), header.size);
-        detail::checkMTarError(ret, path, name);
+        ReadEntry(entry_index, reinterpret_cast<char *>(data));
     }
 
+    // The size of a compressed file is its uncompressed size, the offset points to the
+    // compressed data
     struct FileEntry
     {
         std::string name;
         std::size_t size;
         std::size_t offset;
+        bool compressed = false;
     };
 
+    // Lists all files in the order they are stored in
     template <typename OutIter> void List(OutIter out)
+    {
+        std::copy(entries.begin(), entries.end(), out);
+    }
+
+    bool HasFile(const std::string &name) const
+    {
+        return entry_indices.find(name) != entry_indices.end();
+    }
+
+    // True if the archive was written with FileWriter::CompressBlocks and compression paid off
+    bool HasCompressedFiles() const
+    {
+        return std::any_of(
+            entries.begin(), entries.end(), [](const auto &entry) { return entry.compressed; });
+    }
+
+  private:
+    // Size of a tar header, the data of a file starts right after it
+    static constexpr std::size_t HEADER_SIZE = 512;
+
+    // Reads all headers once, so finding a file does not need to scan the archive from the start
+    void BuildIndex()
     {
         mtar_header_t header;
-        while (mtar_read_header(&handle, &header) != MTAR_ENULLRECORD)
+        int ret;
+        while ((ret = mtar_read_header(&handle, &header)) == MTAR_ESUCCESS)
         {
             if (header.type == MTAR_TREG)
             {
-                int ret = mtar_read_data(&handle, nullptr, 0);
-                detail::checkMTarError(ret, path, header.name);
+                // like mtar_find only the first file with a name can be found
+                entry_indices.emplace(header.name, entries.size());
+                entries.push_back(FileEntry{header.name, header.size, handle.pos + HEADER_SIZE});
+            }
+            ret = mtar_next(&handle);
+            detail::checkMTarError(ret, path, header.name);
+        }
+
+        if (ret != MTAR_ENULLRECORD)
+        {
+            detail::checkMTarError(ret, path, "");
+        }
+
+        stored_sizes.reserve(entries.size());
+        for (const auto &entry : entries)
+        {
+            stored_sizes.push_back(entry.size);
+        }
 
-                auto offset = handle.pos;
-                // seek back to the header
-                handle.remaining_data = 0;
-                ret = mtar_seek(&handle, handle.last_header);
-                detail::checkMTarError(ret, path, header.name);
+        const std::string suffix = COMPRESSED_SIZE_SUFFIX;
+        for (const auto index : util::irange<std::size_t>(0, entries.size()))
+        {
+            const auto &name = entries[index].name;
+            if (name.size() > suffix.size() &&
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+            {
+                std::uint64_t uncompressed_size;
+                ReadInto(name, uncompressed_size);
 
-                *out++ = FileEntry{header.name, header.size, offset};
+                auto &entry = entries[FindEntry(name.substr(0, name.size() - suffix.size()))];
+                entry.size = uncompressed_size;
+                entry.compressed = true;
             }
-            mtar_next(&handle);
         }
     }
 
-  private:
+    std::size_t FindEntry(const std::string &name) const
+    {
+        const auto iter = entry_indices.find(name);
+        if (iter == entry_indices.end())
+        {
+            detail::checkMTarError(MTAR_ENOTFOUND, path, name);
+        }
+        return iter->second;
+    }
+
+    // Positions the archive at the header of the file
+    void SeekToEntry(const std::size_t entry_index)
+    {
+        const auto &entry = entries[entry_index];
+
+        handle.remaining_data = 0;
+        auto ret = mtar_seek(&handle, entry.offset - HEADER_SIZE);
+        detail::checkMTarError(ret, path, entry.name);
+    }
+
+    // Reads the whole file, compressed files are decompressed
+    void ReadEntry(const std::size_t entry_index, char *data)
+    {
+        const auto &entry = entries[entry_index];
+        SeekToEntry(entry_index);
+
+        if (!entry.compressed)
+        {
+            auto ret = mtar_read_data(&handle, data, entry.size);
+            detail::checkMTarError(ret, path, entry.name);
+            return;
+        }
+
+        std::vector<char> compressed(stored_sizes[entry_index]);
+        auto ret = mtar_read_data(&handle, compressed.data(), compressed.size());
+        detail::checkMTarError(ret, path, entry.name);
+
+        if (!detail::decompressBlock(compressed.data(), compressed.size(), data, entry.size))
+        {
+            throw util::RuntimeError(entry.name + ": Could not decompress file.",
+                                     ErrorCode::FileReadError,
+                                     SOURCE_REF);
+        }
+    }
+
     bool ReadAndCheckFingerprint()
     {
         util::FingerPrint loaded_fingerprint;
@@ -209,6 +405,10 @@ class FileReader
 
     boost::filesystem::path path;
     mtar_t handle;
+    std::vector<FileEntry> entries;
+    // size of the data of every file in the archive, differs from the size of compressed files
+    std::vector<std::size_t> stored_sizes;
+    std::unordered_map<std::string, std::size_t> entry_indices;
 };
 
 class FileWriter
@@ -220,7 +420,20 @@ class FileWriter
         HasNoFingerprint
     };
 
-    FileWriter(const boost::filesystem::path &path, FingerprintFlag flag) : path(path)
+    // With CompressBlocks every file written by WriteFrom is compressed if it has at least
+    // MIN_COMPRESSED_SIZE bytes and gets smaller. FileReader decompresses them transparently.
+    enum CompressionFlag
+    {
+        NoCompression,
+        CompressBlocks
+    };
+
+    static constexpr std::size_t MIN_COMPRESSED_SIZE = 4096;
+
+    FileWriter(const boost::filesystem::path &path,
+               FingerprintFlag flag,
+               CompressionFlag compression = NoCompression)
+        : path(path), compression(compression)
     {
         auto ret = mtar_open(&handle, path.string().c_str(), "w");
         detail::checkMTarError(ret, path, "");
@@ -265,9 +478,15 @@ class FileWriter
     }
 
     // Continue writing an existing file, overwrites all data after the file!
+    // Compressed files can not be continued.
     template <typename T>
     void ContinueFrom(const std::string &name, const T *data, const std::size_t number_of_elements)
     {
+        if (compression != NoCompression)
+        {
+            throw util::exception("Can not continue the compressed file " + path.string() +
+                                  " : " + name + SOURCE_REF);
+        }
         auto number_of_bytes = number_of_elements * sizeof(T);
 
         mtar_header_t header;
@@ -292,7 +511,24 @@ class FileWriter
     template <typename T>
     void WriteFrom(const std::string &name, const T *data, const std::size_t number_of_elements)
     {
-        auto number_of_bytes = number_of_elements * sizeof(T);
+        std::uint64_t number_of_bytes = number_of_elements * sizeof(T);
+
+        if (compression == CompressBlocks && number_of_bytes >= MIN_COMPRESSED_SIZE)
+        {
+            const auto compressed =
+                detail::compressBlock(reinterpret_cast<const char *>(data), number_of_bytes);
+            if (compressed.size() < number_of_bytes)
+            {
+                auto ret = mtar_write_file_header(&handle, name.c_str(), compressed.size());
+                detail::checkMTarError(ret, path, name);
+
+                ret = mtar_write_data(&handle, compressed.data(), compressed.size());
+                detail::checkMTarError(ret, path, name);
+
+                WriteFrom(name + COMPRESSED_SIZE_SUFFIX, &number_of_bytes, 1);
+                return;
+            }
+        }
 
         auto ret = mtar_write_file_header(&handle, name.c_str(), number_of_bytes);
         detail::checkMTarError(ret, path, name);
@@ -309,6 +545,7 @@ class FileWriter
     }
 
     boost::filesystem::path path;
+    CompressionFlag compression;
     mtar_t handle;
 };
 }
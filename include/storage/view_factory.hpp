@@ -4,7 +4,10 @@
 #include "storage/shared_data_index.hpp"
 
 #include "contractor/contracted_metric.hpp"
+#include "contractor/hub_labels.hpp"
+#include "contractor/unpacked_shortcuts.hpp"
 #include "contractor/query_graph.hpp"
+#include "contractor/transit_nodes.hpp"
 
 #include "customizer/edge_based_graph.hpp"
 
@@ -96,11 +99,17 @@ inline auto make_turn_lane_description_views(const SharedDataIndex &index, const
 
 inline auto make_ebn_data_view(const SharedDataIndex &index, const std::string &name)
 {
+    auto geometry_ids = make_vector_view<GeometryID>(index, name + "/geometry_ids");
+    auto component_ids = make_vector_view<ComponentID>(index, name + "/component_ids");
+    auto classes = make_vector_view<extractor::ClassData>(index, name + "/classes");
     auto edge_based_node_data = make_vector_view<extractor::EdgeBasedNode>(index, name + "/nodes");
     auto annotation_data =
         make_vector_view<extractor::NodeBasedEdgeAnnotation>(index, name + "/annotations");
 
-    return extractor::EdgeBasedNodeDataView(std::move(edge_based_node_data),
+    return extractor::EdgeBasedNodeDataView(std::move(geometry_ids),
+                                            std::move(component_ids),
+                                            std::move(classes),
+                                            std::move(edge_based_node_data),
                                             std::move(annotation_data));
 }
 
@@ -200,15 +209,40 @@ inline auto make_turn_duration_view(const SharedDataIndex &index, const std::str
 inline auto make_search_tree_view(const SharedDataIndex &index, const std::string &name)
 {
     using RTreeLeaf = extractor::EdgeBasedNodeSegment;
-    using RTreeNode = util::StaticRTree<RTreeLeaf, storage::Ownership::View>::TreeNode;
+    using RTree = util::StaticRTree<RTreeLeaf, storage::Ownership::View>;
+    using RTreeNode = RTree::TreeNode;
+    using RTreeNodeSummary = RTree::TreeNodeSummary;
 
     const auto search_tree = make_vector_view<RTreeNode>(index, name + "/search_tree");
 
+    const auto search_tree_summaries =
+        make_vector_view<RTreeNodeSummary>(index, name + "/search_tree_summaries");
+
+    const auto leaf_coordinates =
+        make_vector_view<std::uint16_t>(index, name + "/leaf_coordinates");
+
+    const auto leaf_coordinate_offsets =
+        make_vector_view<std::uint64_t>(index, name + "/leaf_coordinate_offsets");
+
     const auto rtree_level_starts =
         make_vector_view<std::uint64_t>(index, name + "/search_tree_level_starts");
 
     const auto coordinates = make_coordinates_view(index, "/common/nbn_data/coordinates");
 
+    // the leaves were loaded into memory, the .fileIndex file isn't needed any more
+    if (index.HasBlock(name + "/leaves"))
+    {
+        const auto leaves = make_vector_view<RTreeLeaf>(index, name + "/leaves");
+        return util::StaticRTree<RTreeLeaf, storage::Ownership::View>{
+            std::move(search_tree),
+            std::move(search_tree_summaries),
+            std::move(leaf_coordinates),
+            std::move(leaf_coordinate_offsets),
+            std::move(rtree_level_starts),
+            util::vector_view<const RTreeLeaf>(leaves.data(), leaves.size()),
+            std::move(coordinates)};
+    }
+
     const char *path = index.template GetBlockPtr<char>(name + "/file_index_path");
 
     if (!boost::filesystem::exists(boost::filesystem::path{path}))
@@ -218,7 +252,13 @@ inline auto make_search_tree_view(const SharedDataIndex &index, const std::strin
     }
 
     return util::StaticRTree<RTreeLeaf, storage::Ownership::View>{
-        std::move(search_tree), std::move(rtree_level_starts), path, std::move(coordinates)};
+        std::move(search_tree),
+        std::move(search_tree_summaries),
+        std::move(leaf_coordinates),
+        std::move(leaf_coordinate_offsets),
+        std::move(rtree_level_starts),
+        path,
+        std::move(coordinates)};
 }
 
 inline auto make_intersection_bearings_view(const SharedDataIndex &index, const std::string &name)
@@ -260,6 +300,52 @@ inline auto make_contracted_metric_view(const SharedDataIndex &index, const std:
                                             std::move(edge_filter)};
 }
 
+inline auto make_unpacked_shortcuts_view(const SharedDataIndex &index, const std::string &name)
+{
+    auto keys = make_vector_view<contractor::UnpackedShortcutsView::ShortcutKey>(index,
+                                                                                 name + "/keys");
+    auto offsets = make_vector_view<std::uint64_t>(index, name + "/offsets");
+    auto nodes = make_vector_view<NodeID>(index, name + "/nodes");
+    auto edges = make_vector_view<EdgeID>(index, name + "/edges");
+
+    return contractor::UnpackedShortcutsView{
+        std::move(keys), std::move(offsets), std::move(nodes), std::move(edges)};
+}
+
+inline auto make_hub_labels_view(const SharedDataIndex &index, const std::string &name)
+{
+    auto entry_offsets = make_vector_view<std::uint64_t>(index, name + "/entry_offsets");
+    auto byte_offsets = make_vector_view<std::uint64_t>(index, name + "/byte_offsets");
+    auto hubs = make_vector_view<std::uint8_t>(index, name + "/hubs");
+    auto weights = make_vector_view<EdgeWeight>(index, name + "/weights");
+    auto durations = make_vector_view<EdgeDuration>(index, name + "/durations");
+
+    return contractor::HubLabelsView{std::move(entry_offsets),
+                                     std::move(byte_offsets),
+                                     std::move(hubs),
+                                     std::move(weights),
+                                     std::move(durations)};
+}
+
+inline auto make_transit_nodes_view(const SharedDataIndex &index, const std::string &name)
+{
+    auto transit_nodes = make_vector_view<NodeID>(index, name + "/transit_nodes");
+    auto table_weights = make_vector_view<EdgeWeight>(index, name + "/table_weights");
+    auto table_durations = make_vector_view<EdgeDuration>(index, name + "/table_durations");
+    auto access_offsets = make_vector_view<std::uint64_t>(index, name + "/access_offsets");
+    auto access_nodes = make_vector_view<std::uint32_t>(index, name + "/access_nodes");
+    auto access_weights = make_vector_view<EdgeWeight>(index, name + "/access_weights");
+    auto access_durations = make_vector_view<EdgeDuration>(index, name + "/access_durations");
+
+    return contractor::TransitNodesView{std::move(transit_nodes),
+                                        std::move(table_weights),
+                                        std::move(table_durations),
+                                        std::move(access_offsets),
+                                        std::move(access_nodes),
+                                        std::move(access_weights),
+                                        std::move(access_durations)};
+}
+
 inline auto make_partition_view(const SharedDataIndex &index, const std::string &name)
 {
     auto level_data_ptr =
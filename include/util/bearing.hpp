@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <boost/assert.hpp>
 #include <cmath>
+#include <cstdint>
 #include <string>
 
 namespace osrm
@@ -92,6 +93,29 @@ inline bool CheckInBounds(const int A, const int B, const int range)
     }
 }
 
+// Bearings can be summarized as a bit mask of sectors, each covering 360 / NUMBER_OF_SECTORS
+// degrees
+constexpr int NUMBER_OF_SECTORS = 32;
+
+// Returns the bit of the sector the bearing (in degrees, rounded) falls into
+inline std::uint32_t GetSectorMask(const int bearing)
+{
+    const int normalized = (bearing % 360 + 360) % 360;
+    return std::uint32_t{1} << (normalized * NUMBER_OF_SECTORS / 360);
+}
+
+// Returns the bits of all sectors that contain a bearing A with CheckInBounds(A, B, range)
+inline std::uint32_t GetSectorMask(const int B, const int range)
+{
+    std::uint32_t mask = 0;
+    for (int A = 0; A < 360; ++A)
+    {
+        if (CheckInBounds(A, B, range))
+            mask |= GetSectorMask(A);
+    }
+    return mask;
+}
+
 inline double reverse(const double bearing)
 {
     if (bearing >= 180)
@@ -0,0 +1,196 @@
+#ifndef OSRM_UTIL_CONCURRENT_LRU_CACHE_HPP
+#define OSRM_UTIL_CONCURRENT_LRU_CACHE_HPP
+
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Bounded key-value cache that can be shared between threads.
+ *
+ * Entries are distributed over a fixed number of shards by their hash. Every shard
+ * is protected by its own mutex and evicts its least recently used entry once it is full.
+ * This keeps lock contention low without needing a global recency order.
+ *
+ * A cache with a capacity of zero is disabled: lookups always miss and insertions are ignored.
+ * Values are copied out under the shard lock, so large values should be wrapped in a
+ * std::shared_ptr<const T>.
+ */
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>> class ConcurrentLRUCache
+{
+  public:
+    static constexpr std::size_t DEFAULT_NUMBER_OF_SHARDS = 16;
+
+    explicit ConcurrentLRUCache(const std::size_t capacity = 0,
+                                const std::size_t number_of_shards = DEFAULT_NUMBER_OF_SHARDS)
+        : capacity(capacity), hits(0), misses(0)
+    {
+        BOOST_ASSERT(number_of_shards > 0);
+        // the capacity is split exactly, the first shards take the remainder and no shard is
+        // left without capacity
+        const auto used_shards = std::max<std::size_t>(1, std::min(number_of_shards, capacity));
+        shards.reserve(used_shards);
+        for (auto index : util::irange<std::size_t>(0, used_shards))
+        {
+            const auto shard_capacity =
+                capacity / used_shards + (index < capacity % used_shards ? 1 : 0);
+            shards.push_back(std::make_unique<Shard>(shard_capacity));
+        }
+    }
+
+    ConcurrentLRUCache(const ConcurrentLRUCache &) = delete;
+    ConcurrentLRUCache &operator=(const ConcurrentLRUCache &) = delete;
+
+    bool IsEnabled() const { return capacity > 0; }
+
+    // Returns the cached value and marks it as most recently used
+    boost::optional<ValueT> Find(const KeyT &key)
+    {
+        if (!IsEnabled())
+            return boost::none;
+
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> guard(shard.mutex);
+
+        const auto iter = shard.index.find(key);
+        if (iter == shard.index.end())
+        {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return boost::none;
+        }
+
+        shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return iter->second->second;
+    }
+
+    // Inserts or replaces the value, evicting the least recently used entry of the shard if needed
+    void Insert(const KeyT &key, ValueT value)
+    {
+        if (!IsEnabled())
+            return;
+
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> guard(shard.mutex);
+
+        const auto iter = shard.index.find(key);
+        if (iter != shard.index.end())
+        {
+            iter->second->second = std::move(value);
+            shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+            return;
+        }
+
+        Emplace(shard, key, std::move(value));
+    }
+
+    // Returns the cached value or inserts make_value() if there is none. Lookup and insertion
+    // happen under the same shard lock, so concurrent callers with the same key share one value.
+    // A disabled cache returns a new value on every call.
+    template <typename Factory> ValueT FindOrInsert(const KeyT &key, Factory &&make_value)
+    {
+        if (!IsEnabled())
+            return make_value();
+
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> guard(shard.mutex);
+
+        const auto iter = shard.index.find(key);
+        if (iter != shard.index.end())
+        {
+            shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return iter->second->second;
+        }
+
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return Emplace(shard, key, make_value());
+    }
+
+    // Drops all entries and starts counting hits and misses anew
+    void Clear()
+    {
+        for (auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> guard(shard->mutex);
+            shard->index.clear();
+            shard->entries.clear();
+        }
+        hits.store(0, std::memory_order_relaxed);
+        misses.store(0, std::memory_order_relaxed);
+    }
+
+    std::size_t Size() const
+    {
+        std::size_t size = 0;
+        for (const auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> guard(shard->mutex);
+            size += shard->index.size();
+        }
+        return size;
+    }
+
+    std::size_t GetCapacity() const { return capacity; }
+
+    std::uint64_t GetHits() const { return hits.load(std::memory_order_relaxed); }
+
+    std::uint64_t GetMisses() const { return misses.load(std::memory_order_relaxed); }
+
+  private:
+    using Entry = std::pair<KeyT, ValueT>;
+    using EntryList = std::list<Entry>;
+
+    struct Shard
+    {
+        explicit Shard(std::size_t capacity) : capacity(capacity) {}
+
+        mutable std::mutex mutex;
+        EntryList entries;
+        std::unordered_map<KeyT, typename EntryList::iterator, HashT> index;
+        const std::size_t capacity;
+    };
+
+    Shard &GetShard(const KeyT &key) { return *shards[HashT()(key) % shards.size()]; }
+
+    // Adds a new most recently used entry, the shard lock has to be held
+    const ValueT &Emplace(Shard &shard, const KeyT &key, ValueT value)
+    {
+        if (shard.index.size() >= shard.capacity)
+        {
+            BOOST_ASSERT(!shard.entries.empty());
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+
+        shard.entries.emplace_front(key, std::move(value));
+        shard.index.emplace(key, shard.entries.begin());
+        return shard.entries.front().second;
+    }
+
+    const std::size_t capacity;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<std::uint64_t> hits;
+    std::atomic<std::uint64_t> misses;
+};
+}
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef OSRM_UTIL_HUGE_PAGES_HPP
+#define OSRM_UTIL_HUGE_PAGES_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <limits>
+#include <string>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+// Size of an explicit huge page in bytes, 0 if the system does not support them
+inline std::size_t GetHugePageSize()
+{
+#ifdef __linux__
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    while (meminfo >> key)
+    {
+        if (key == "Hugepagesize:")
+        {
+            std::size_t size_in_kb = 0;
+            meminfo >> size_in_kb;
+            return size_in_kb * 1024;
+        }
+        meminfo.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+#endif
+    return 0;
+}
+
+// Asks the kernel to back the pages of the range with transparent huge pages. Only the pages
+// that are allocated after the call are affected, so this needs to be called before the memory
+// is written to. Returns false if transparent huge pages are not available.
+inline bool AdviseHugePages(void *ptr, const std::size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // madvise needs a range that starts at a page boundary
+    const auto page_size = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<std::uintptr_t>(ptr);
+    const auto end = begin + size;
+    const auto aligned_begin = (begin + page_size - 1) / page_size * page_size;
+    if (aligned_begin >= end)
+        return false;
+
+    return ::madvise(reinterpret_cast<void *>(aligned_begin),
+                     end - aligned_begin,
+                     MADV_HUGEPAGE) == 0;
+#else
+    (void)ptr;
+    (void)size;
+    return false;
+#endif
+}
+}
+}
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "storage/tar.hpp"
 
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
 #include "util/mmap_file.hpp"
 
 #include <boost/iostreams/device/mapped_file.hpp>
@@ -31,6 +33,12 @@ inline DataMap mmapTarFile(const boost::filesystem::path &path,
 
     for (const auto &entry : entries)
     {
+        if (entry.compressed)
+        {
+            throw util::exception("Can not map the compressed file " + entry.name + " in " +
+                                  path.string() + SOURCE_REF);
+        }
+
         auto begin = raw_file.data() + entry.offset;
         auto end = begin + entry.size;
         map[entry.name] = DataRange{begin, end};
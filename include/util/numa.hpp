@@ -0,0 +1,102 @@
+#ifndef OSRM_UTIL_NUMA_HPP
+#define OSRM_UTIL_NUMA_HPP
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+// The CPUs of every NUMA node that has any. Systems without NUMA information are reported as a
+// single node without CPUs.
+inline std::vector<std::vector<unsigned>> GetNUMANodes()
+{
+    std::vector<std::vector<unsigned>> nodes;
+#ifdef __linux__
+    for (unsigned node = 0;; ++node)
+    {
+        const boost::filesystem::path node_path("/sys/devices/system/node/node" +
+                                                std::to_string(node));
+        if (!boost::filesystem::exists(node_path))
+            break;
+
+        // The list has the format "0-3,8-11"
+        boost::filesystem::ifstream cpulist(node_path / "cpulist");
+        std::string line;
+        std::getline(cpulist, line);
+        std::vector<std::string> ranges;
+        boost::algorithm::split(ranges, line, boost::algorithm::is_any_of(","));
+
+        std::vector<unsigned> cpus;
+        for (const auto &range : ranges)
+        {
+            if (range.empty())
+                continue;
+            const auto separator = range.find('-');
+            const auto first = std::stoul(range.substr(0, separator));
+            const auto last =
+                separator == std::string::npos ? first : std::stoul(range.substr(separator + 1));
+            for (auto cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+
+        // memory-only nodes can not run threads
+        if (!cpus.empty())
+        {
+            nodes.push_back(std::move(cpus));
+        }
+    }
+#endif
+    if (nodes.empty())
+    {
+        nodes.emplace_back();
+    }
+    return nodes;
+}
+
+// The NUMA node the current thread was pinned to with PinThreadToNUMANode, 0 otherwise
+inline std::size_t &CurrentNUMANode()
+{
+    static thread_local std::size_t node = 0;
+    return node;
+}
+
+// Restricts the current thread to the given CPUs. Memory the thread touches first is allocated
+// on its node by the default kernel policy. Returns false if the thread could not be pinned.
+inline bool PinThreadToNUMANode(const std::size_t node, const std::vector<unsigned> &cpus)
+{
+    CurrentNUMANode() = node;
+#ifdef __linux__
+    if (cpus.empty())
+        return false;
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : cpus)
+    {
+        CPU_SET(cpu, &cpu_set);
+    }
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    return false;
+#endif
+}
+}
+}
+
+#endif
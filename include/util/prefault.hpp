@@ -0,0 +1,53 @@
+#ifndef OSRM_UTIL_PREFAULT_HPP
+#define OSRM_UTIL_PREFAULT_HPP
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+// Makes sure the pages of the range are in memory. The kernel is asked to read the whole range
+// ahead, then one byte of every page is read in parallel to wait for the pages that are not
+// there yet. Mapped files are read from disk, shared memory is mapped into the process.
+inline void PrefaultMemory(const char *ptr, const std::size_t size)
+{
+    if (size == 0)
+        return;
+
+#ifdef __linux__
+    const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<std::uintptr_t>(ptr);
+    const auto aligned_begin = begin / page_size * page_size;
+    ::madvise(reinterpret_cast<void *>(aligned_begin),
+              begin + size - aligned_begin,
+              MADV_WILLNEED);
+#else
+    const std::size_t page_size = 4096;
+#endif
+
+    const auto num_pages = (size + page_size - 1) / page_size;
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_pages),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (auto page = range.begin(); page != range.end(); ++page)
+                          {
+                              // volatile keeps the read that faults the page in
+                              const volatile char *byte = ptr + page * page_size;
+                              (void)*byte;
+                          }
+                      });
+}
+}
+}
+
+#endif
@@ -0,0 +1,366 @@
+#ifndef OSRM_UTIL_RTREE_DISTANCES_HPP
+#define OSRM_UTIL_RTREE_DISTANCES_HPP
+
+#include "util/coordinate.hpp"
+#include "util/rectangle.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+// Distance kernels of the StaticRTree, they work on projected fixed point coordinates.
+//
+// Every kernel has a scalar version and is vectorized with AVX2 or SSE2, depending on what the
+// compiler targets (e.g. -march=native). All versions compute exactly the same values, rounding
+// uses the current floating point rounding mode (to nearest by default).
+namespace rtree_distances
+{
+
+// Squared distance between the location and every rectangle, 0 if the location is inside.
+// Same as RectangleInt2D::GetMinSquaredDist for valid rectangles.
+inline void getMinSquaredDistancesScalar(const RectangleInt2D *rectangles,
+                                         const std::size_t count,
+                                         const Coordinate location,
+                                         std::uint64_t *squared_distances)
+{
+    const auto lon = static_cast<std::int32_t>(location.lon);
+    const auto lat = static_cast<std::int32_t>(location.lat);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const auto &rectangle = rectangles[index];
+        const std::int64_t delta_lon =
+            std::max(0, static_cast<std::int32_t>(rectangle.min_lon) - lon) +
+            std::max(0, lon - static_cast<std::int32_t>(rectangle.max_lon));
+        const std::int64_t delta_lat =
+            std::max(0, static_cast<std::int32_t>(rectangle.min_lat) - lat) +
+            std::max(0, lat - static_cast<std::int32_t>(rectangle.max_lat));
+        squared_distances[index] = delta_lon * delta_lon + delta_lat * delta_lat;
+    }
+}
+
+// Projects the location onto every segment and returns the squared distance to the rounded
+// projection. The segments are given by the coordinates of their sources and targets in
+// separate arrays.
+inline void getSquaredSegmentDistancesScalar(const std::int32_t *source_lons,
+                                             const std::int32_t *source_lats,
+                                             const std::int32_t *target_lons,
+                                             const std::int32_t *target_lats,
+                                             const std::size_t count,
+                                             const Coordinate location,
+                                             std::uint64_t *squared_distances,
+                                             std::int32_t *nearest_lons,
+                                             std::int32_t *nearest_lats)
+{
+    const auto lon = static_cast<std::int32_t>(location.lon);
+    const auto lat = static_cast<std::int32_t>(location.lat);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const double source_lon = source_lons[index];
+        const double source_lat = source_lats[index];
+        const double slope_lon = target_lons[index] - source_lon;
+        const double slope_lat = target_lats[index] - source_lat;
+        const double relative_lon = lon - source_lon;
+        const double relative_lat = lat - source_lat;
+
+        const double unnormed_ratio = slope_lon * relative_lon + slope_lat * relative_lat;
+        const double squared_length = slope_lon * slope_lon + slope_lat * slope_lat;
+        const double ratio =
+            squared_length > 0 ? std::min(std::max(unnormed_ratio / squared_length, 0.), 1.) : 0.;
+
+        nearest_lons[index] =
+            static_cast<std::int32_t>(std::nearbyint(source_lon + slope_lon * ratio));
+        nearest_lats[index] =
+            static_cast<std::int32_t>(std::nearbyint(source_lat + slope_lat * ratio));
+
+        const std::int64_t delta_lon = nearest_lons[index] - lon;
+        const std::int64_t delta_lat = nearest_lats[index] - lat;
+        squared_distances[index] = delta_lon * delta_lon + delta_lat * delta_lat;
+    }
+}
+
+#if defined(__AVX2__)
+
+inline void getMinSquaredDistances(const RectangleInt2D *rectangles,
+                                   const std::size_t count,
+                                   const Coordinate location,
+                                   std::uint64_t *squared_distances)
+{
+    static_assert(sizeof(RectangleInt2D) == 4 * sizeof(std::int32_t), "unexpected layout");
+
+    const auto lon = static_cast<std::int32_t>(location.lon);
+    const auto lat = static_cast<std::int32_t>(location.lat);
+    // every rectangle is min_lon, max_lon, min_lat, max_lat
+    const auto query = _mm256_setr_epi32(lon, lon, lat, lat, lon, lon, lat, lat);
+    const auto sign = _mm256_setr_epi32(1, -1, 1, -1, 1, -1, 1, -1);
+    const auto zero = _mm256_setzero_si256();
+
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        const auto *data = reinterpret_cast<const __m256i *>(rectangles + index);
+        // min_lon - lon, lon - max_lon, min_lat - lat, lat - max_lat, at most one per axis > 0
+        const auto first = _mm256_max_epi32(
+            _mm256_sign_epi32(_mm256_sub_epi32(_mm256_loadu_si256(data), query), sign), zero);
+        const auto second = _mm256_max_epi32(
+            _mm256_sign_epi32(_mm256_sub_epi32(_mm256_loadu_si256(data + 1), query), sign), zero);
+        // delta_lon, delta_lat of the rectangles 0, 2 in the low lane and 1, 3 in the high lane
+        const auto deltas = _mm256_hadd_epi32(first, second);
+        const auto squared = _mm256_add_epi64(
+            _mm256_mul_epu32(deltas, deltas),
+            _mm256_mul_epu32(_mm256_srli_epi64(deltas, 32), _mm256_srli_epi64(deltas, 32)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(squared_distances + index),
+                            _mm256_permute4x64_epi64(squared, 0xD8));
+    }
+    getMinSquaredDistancesScalar(
+        rectangles + index, count - index, location, squared_distances + index);
+}
+
+inline void getSquaredSegmentDistances(const std::int32_t *source_lons,
+                                       const std::int32_t *source_lats,
+                                       const std::int32_t *target_lons,
+                                       const std::int32_t *target_lats,
+                                       const std::size_t count,
+                                       const Coordinate location,
+                                       std::uint64_t *squared_distances,
+                                       std::int32_t *nearest_lons,
+                                       std::int32_t *nearest_lats)
+{
+    const auto lon = static_cast<std::int32_t>(location.lon);
+    const auto lat = static_cast<std::int32_t>(location.lat);
+    const auto query_lon = _mm256_set1_pd(lon);
+    const auto query_lat = _mm256_set1_pd(lat);
+    const auto fixed_query_lon = _mm_set1_epi32(lon);
+    const auto fixed_query_lat = _mm_set1_epi32(lat);
+    const auto zero = _mm256_setzero_pd();
+    const auto one = _mm256_set1_pd(1.);
+
+    const auto load = [](const std::int32_t *values) {
+        return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values)));
+    };
+
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        const auto source_lon = load(source_lons + index);
+        const auto source_lat = load(source_lats + index);
+        const auto slope_lon = _mm256_sub_pd(load(target_lons + index), source_lon);
+        const auto slope_lat = _mm256_sub_pd(load(target_lats + index), source_lat);
+        const auto relative_lon = _mm256_sub_pd(query_lon, source_lon);
+        const auto relative_lat = _mm256_sub_pd(query_lat, source_lat);
+
+        const auto unnormed_ratio = _mm256_add_pd(_mm256_mul_pd(slope_lon, relative_lon),
+                                                  _mm256_mul_pd(slope_lat, relative_lat));
+        const auto squared_length = _mm256_add_pd(_mm256_mul_pd(slope_lon, slope_lon),
+                                                  _mm256_mul_pd(slope_lat, slope_lat));
+        // 0/0 is NaN for segments of length 0, max returns its second operand for NaN
+        const auto ratio = _mm256_min_pd(
+            _mm256_max_pd(_mm256_div_pd(unnormed_ratio, squared_length), zero), one);
+
+        const auto nearest_lon =
+            _mm256_cvtpd_epi32(_mm256_add_pd(source_lon, _mm256_mul_pd(slope_lon, ratio)));
+        const auto nearest_lat =
+            _mm256_cvtpd_epi32(_mm256_add_pd(source_lat, _mm256_mul_pd(slope_lat, ratio)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(nearest_lons + index), nearest_lon);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(nearest_lats + index), nearest_lat);
+
+        const auto delta_lon = _mm256_cvtepi32_epi64(_mm_sub_epi32(nearest_lon, fixed_query_lon));
+        const auto delta_lat = _mm256_cvtepi32_epi64(_mm_sub_epi32(nearest_lat, fixed_query_lat));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(squared_distances + index),
+                            _mm256_add_epi64(_mm256_mul_epi32(delta_lon, delta_lon),
+                                             _mm256_mul_epi32(delta_lat, delta_lat)));
+    }
+    getSquaredSegmentDistancesScalar(source_lons + index,
+                                     source_lats + index,
+                                     target_lons + index,
+                                     target_lats + index,
+                                     count - index,
+                                     location,
+                                     squared_distances + index,
+                                     nearest_lons + index,
+                                     nearest_lats + index);
+}
+
+#elif defined(__SSE2__)
+
+namespace detail
+{
+// Squares of four non-negative 32 bit values as 64 bit values, in two registers
+inline void square(const __m128i values, __m128i &low, __m128i &high)
+{
+    const auto zero = _mm_setzero_si128();
+    const auto low_values = _mm_unpacklo_epi32(values, zero);
+    const auto high_values = _mm_unpackhi_epi32(values, zero);
+    low = _mm_mul_epu32(low_values, low_values);
+    high = _mm_mul_epu32(high_values, high_values);
+}
+
+inline __m128i clampToZero(const __m128i values)
+{
+    return _mm_andnot_si128(_mm_srai_epi32(values, 31), values);
+}
+
+inline __m128i abs(const __m128i values)
+{
+    const auto sign = _mm_srai_epi32(values, 31);
+    return _mm_sub_epi32(_mm_xor_si128(values, sign), sign);
+}
+}
+
+inline void getMinSquaredDistances(const RectangleInt2D *rectangles,
+                                   const std::size_t count,
+                                   const Coordinate location,
+                                   std::uint64_t *squared_distances)
+{
+    static_assert(sizeof(RectangleInt2D) == 4 * sizeof(std::int32_t), "unexpected layout");
+
+    const auto lon = _mm_set1_epi32(static_cast<std::int32_t>(location.lon));
+    const auto lat = _mm_set1_epi32(static_cast<std::int32_t>(location.lat));
+
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        // transpose four rectangles into min_lons, max_lons, min_lats, max_lats
+        const auto *data = reinterpret_cast<const float *>(rectangles + index);
+        auto min_lons = _mm_loadu_ps(data);
+        auto max_lons = _mm_loadu_ps(data + 4);
+        auto min_lats = _mm_loadu_ps(data + 8);
+        auto max_lats = _mm_loadu_ps(data + 12);
+        _MM_TRANSPOSE4_PS(min_lons, max_lons, min_lats, max_lats);
+
+        const auto delta_lon = _mm_add_epi32(
+            detail::clampToZero(_mm_sub_epi32(_mm_castps_si128(min_lons), lon)),
+            detail::clampToZero(_mm_sub_epi32(lon, _mm_castps_si128(max_lons))));
+        const auto delta_lat = _mm_add_epi32(
+            detail::clampToZero(_mm_sub_epi32(_mm_castps_si128(min_lats), lat)),
+            detail::clampToZero(_mm_sub_epi32(lat, _mm_castps_si128(max_lats))));
+
+        __m128i lon_low, lon_high, lat_low, lat_high;
+        detail::square(delta_lon, lon_low, lon_high);
+        detail::square(delta_lat, lat_low, lat_high);
+        auto *result = reinterpret_cast<__m128i *>(squared_distances + index);
+        _mm_storeu_si128(result, _mm_add_epi64(lon_low, lat_low));
+        _mm_storeu_si128(result + 1, _mm_add_epi64(lon_high, lat_high));
+    }
+    getMinSquaredDistancesScalar(
+        rectangles + index, count - index, location, squared_distances + index);
+}
+
+inline void getSquaredSegmentDistances(const std::int32_t *source_lons,
+                                       const std::int32_t *source_lats,
+                                       const std::int32_t *target_lons,
+                                       const std::int32_t *target_lats,
+                                       const std::size_t count,
+                                       const Coordinate location,
+                                       std::uint64_t *squared_distances,
+                                       std::int32_t *nearest_lons,
+                                       std::int32_t *nearest_lats)
+{
+    const auto lon = static_cast<std::int32_t>(location.lon);
+    const auto lat = static_cast<std::int32_t>(location.lat);
+    const auto query_lon = _mm_set1_pd(lon);
+    const auto query_lat = _mm_set1_pd(lat);
+    const auto fixed_query_lon = _mm_set1_epi32(lon);
+    const auto fixed_query_lat = _mm_set1_epi32(lat);
+    const auto zero = _mm_setzero_pd();
+    const auto one = _mm_set1_pd(1.);
+
+    const auto load = [](const std::int32_t *values) {
+        return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(values)));
+    };
+
+    std::size_t index = 0;
+    for (; index + 2 <= count; index += 2)
+    {
+        const auto source_lon = load(source_lons + index);
+        const auto source_lat = load(source_lats + index);
+        const auto slope_lon = _mm_sub_pd(load(target_lons + index), source_lon);
+        const auto slope_lat = _mm_sub_pd(load(target_lats + index), source_lat);
+        const auto relative_lon = _mm_sub_pd(query_lon, source_lon);
+        const auto relative_lat = _mm_sub_pd(query_lat, source_lat);
+
+        const auto unnormed_ratio =
+            _mm_add_pd(_mm_mul_pd(slope_lon, relative_lon), _mm_mul_pd(slope_lat, relative_lat));
+        const auto squared_length =
+            _mm_add_pd(_mm_mul_pd(slope_lon, slope_lon), _mm_mul_pd(slope_lat, slope_lat));
+        // 0/0 is NaN for segments of length 0, max returns its second operand for NaN
+        const auto ratio =
+            _mm_min_pd(_mm_max_pd(_mm_div_pd(unnormed_ratio, squared_length), zero), one);
+
+        const auto nearest_lon =
+            _mm_cvtpd_epi32(_mm_add_pd(source_lon, _mm_mul_pd(slope_lon, ratio)));
+        const auto nearest_lat =
+            _mm_cvtpd_epi32(_mm_add_pd(source_lat, _mm_mul_pd(slope_lat, ratio)));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(nearest_lons + index), nearest_lon);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(nearest_lats + index), nearest_lat);
+
+        __m128i lon_squared, lat_squared, unused;
+        detail::square(
+            detail::abs(_mm_sub_epi32(nearest_lon, fixed_query_lon)), lon_squared, unused);
+        detail::square(
+            detail::abs(_mm_sub_epi32(nearest_lat, fixed_query_lat)), lat_squared, unused);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(squared_distances + index),
+                         _mm_add_epi64(lon_squared, lat_squared));
+    }
+    getSquaredSegmentDistancesScalar(source_lons + index,
+                                     source_lats + index,
+                                     target_lons + index,
+                                     target_lats + index,
+                                     count - index,
+                                     location,
+                                     squared_distances + index,
+                                     nearest_lons + index,
+                                     nearest_lats + index);
+}
+
+#else
+
+inline void getMinSquaredDistances(const RectangleInt2D *rectangles,
+                                   const std::size_t count,
+                                   const Coordinate location,
+                                   std::uint64_t *squared_distances)
+{
+    getMinSquaredDistancesScalar(rectangles, count, location, squared_distances);
+}
+
+inline void getSquaredSegmentDistances(const std::int32_t *source_lons,
+                                       const std::int32_t *source_lats,
+                                       const std::int32_t *target_lons,
+                                       const std::int32_t *target_lats,
+                                       const std::size_t count,
+                                       const Coordinate location,
+                                       std::uint64_t *squared_distances,
+                                       std::int32_t *nearest_lons,
+                                       std::int32_t *nearest_lats)
+{
+    getSquaredSegmentDistancesScalar(source_lons,
+                                     source_lats,
+                                     target_lons,
+                                     target_lats,
+                                     count,
+                                     location,
+                                     squared_distances,
+                                     nearest_lons,
+                                     nearest_lats);
+}
+
+#endif
+}
+}
+}
+
+#endif
@@ -2,6 +2,8 @@
 #define OSMR_UTIL_SERIALIZATION_HPP
 
 #include "util/dynamic_graph.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
 #include "util/indexed_data.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
@@ -11,6 +13,8 @@
 #include "storage/io.hpp"
 #include "storage/serialization.hpp"
 
+#include <string>
+
 namespace osrm
 {
 namespace util
@@ -126,7 +130,26 @@ void read(storage::tar::FileReader &reader,
           const std::string &name,
           util::StaticRTree<EdgeDataT, Ownership, BRANCHING_FACTOR, LEAF_PAGE_SIZE> &rtree)
 {
+    std::uint32_t format_version = 0;
+    if (reader.HasFile(name + "/format_version"))
+    {
+        reader.ReadInto(name + "/format_version", format_version);
+    }
+    if (format_version != RTREE_FORMAT_VERSION)
+    {
+        throw util::exception("The R-tree has format version " + std::to_string(format_version) +
+                              " but this version of OSRM reads version " +
+                              std::to_string(RTREE_FORMAT_VERSION) +
+                              ", the dataset needs to be extracted again" + SOURCE_REF);
+    }
+
     storage::serialization::read(reader, name + "/search_tree", rtree.m_search_tree);
+    storage::serialization::read(
+        reader, name + "/search_tree_summaries", rtree.m_search_tree_summaries);
+    storage::serialization::read(
+        reader, name + "/leaf_coordinates", rtree.m_leaf_coordinates);
+    storage::serialization::read(
+        reader, name + "/leaf_coordinate_offsets", rtree.m_leaf_coordinate_offsets);
     storage::serialization::read(
         reader, name + "/search_tree_level_starts", rtree.m_tree_level_starts);
 }
@@ -139,7 +162,15 @@ void write(storage::tar::FileWriter &writer,
            const std::string &name,
            const util::StaticRTree<EdgeDataT, Ownership, BRANCHING_FACTOR, LEAF_PAGE_SIZE> &rtree)
 {
+    writer.WriteElementCount64(name + "/format_version", 1);
+    writer.WriteFrom(name + "/format_version", RTREE_FORMAT_VERSION);
     storage::serialization::write(writer, name + "/search_tree", rtree.m_search_tree);
+    storage::serialization::write(
+        writer, name + "/search_tree_summaries", rtree.m_search_tree_summaries);
+    storage::serialization::write(
+        writer, name + "/leaf_coordinates", rtree.m_leaf_coordinates);
+    storage::serialization::write(
+        writer, name + "/leaf_coordinate_offsets", rtree.m_leaf_coordinate_offsets);
     storage::serialization::write(
         writer, name + "/search_tree_level_starts", rtree.m_tree_level_starts);
 }
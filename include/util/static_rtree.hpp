@@ -11,6 +11,7 @@
 #include "util/integer_range.hpp"
 #include "util/mmap_file.hpp"
 #include "util/rectangle.hpp"
+#include "util/rtree_distances.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
 #include "util/web_mercator.hpp"
@@ -40,6 +41,10 @@ namespace osrm
 {
 namespace util
 {
+// Version of the layout of the R-tree blocks in the .ramIndex, checked when the tree is loaded.
+// Files without a version were written before the leaf coordinates were stored.
+const constexpr std::uint32_t RTREE_FORMAT_VERSION = 1;
+
 template <class EdgeDataT,
           storage::Ownership Ownership = storage::Ownership::Container,
           std::uint32_t BRANCHING_FACTOR = 64,
@@ -189,6 +194,24 @@ class StaticRTree
         Rectangle minimum_bounding_rectangle;
     };
 
+    /**
+     * Describes the segments below a TreeNode, so a query can skip subtrees that contain no
+     * segment it would accept. Only enabled directions of a segment are taken into account.
+     */
+    struct TreeNodeSummary
+    {
+        // Union of the bearing sectors of all directions, see bearing::GetSectorMask
+        std::uint32_t bearing_sectors = 0;
+        // Classes shared by all directions, a subtree can be skipped if one is excluded
+        std::uint8_t common_classes = std::numeric_limits<std::uint8_t>::max();
+
+        void Merge(const TreeNodeSummary &other)
+        {
+            bearing_sectors |= other.bearing_sectors;
+            common_classes &= other.common_classes;
+        }
+    };
+
   private:
     /**
      * A lightweight wrapper for the Hilbert Code for each EdgeDataT object
@@ -252,8 +275,31 @@ class StaticRTree
         std::uint32_t segment_index;
     };
 
+    // Priority queue of a nearest neighbour query that can be emptied without freeing its storage
+    struct TraversalQueue : std::priority_queue<QueryCandidate>
+    {
+        void clear() { this->c.clear(); }
+
+        // Frees the storage if it grew beyond max_size candidates
+        void shrink(const std::size_t max_size)
+        {
+            if (this->c.capacity() > max_size)
+                decltype(this->c)().swap(this->c);
+        }
+    };
+
+    // Number of candidates a thread keeps storage for between nearest neighbour queries
+    static constexpr std::size_t MAX_RETAINED_QUEUE_SIZE = 4096;
+
     // Representation of the in-memory search tree
     Vector<TreeNode> m_search_tree;
+    // Summary of the segments below every node in m_search_tree, in the same order
+    Vector<TreeNodeSummary> m_search_tree_summaries;
+    // Projected coordinates of the segments of every leaf, see EncodeLeafCoordinates. Empty if
+    // they were not stored, the segments are projected on every query then.
+    Vector<std::uint16_t> m_leaf_coordinates;
+    // Start of the coordinates of every leaf in m_leaf_coordinates, plus the end of the last leaf
+    Vector<std::uint64_t> m_leaf_coordinate_offsets;
     // Reference to the actual lon/lat data we need for doing math
     util::vector_view<const Coordinate> m_coordinate_list;
     // Holds the start indexes of each level in m_search_tree
@@ -271,9 +317,14 @@ class StaticRTree
     StaticRTree &operator=(StaticRTree &&) = default;
 
     // Construct a packed Hilbert-R-Tree with Kamel-Faloutsos algorithm [1]
+    // The classes of the segments are looked up in node_classes by their node ids, without
+    // them no subtree is skipped because of excluded classes. Without store_leaf_coordinates
+    // the segments of a leaf are projected on every query instead of being stored.
     explicit StaticRTree(const std::vector<EdgeDataT> &input_data_vector,
                          const Vector<Coordinate> &coordinate_list,
-                         const boost::filesystem::path &on_disk_file_name)
+                         const boost::filesystem::path &on_disk_file_name,
+                         const std::vector<std::uint8_t> &node_classes = {},
+                         const bool store_leaf_coordinates = true)
         : m_coordinate_list(coordinate_list.data(), coordinate_list.size())
     {
         const auto element_count = input_data_vector.size();
@@ -326,9 +377,15 @@ class StaticRTree
             std::size_t wrapped_element_index = 0;
             auto objects_iter = out_objects.begin();
 
+            std::array<std::vector<std::int32_t>, 4> leaf_coordinates;
+            if (store_leaf_coordinates)
+                m_leaf_coordinate_offsets.push_back(0);
             while (wrapped_element_index < element_count)
             {
                 TreeNode current_node;
+                TreeNodeSummary current_summary;
+                for (auto &coordinates : leaf_coordinates)
+                    coordinates.clear();
 
                 // Loop over the next block of EdgeDataT, calculate the bounding box
                 // for the block, and save the data to write to disk in the correct
@@ -366,9 +423,19 @@ class StaticRTree
 
                     BOOST_ASSERT(rectangle.IsValid());
                     current_node.minimum_bounding_rectangle.MergeBoundingBoxes(rectangle);
+                    current_summary.Merge(SummarizeSegment(object, node_classes));
+
+                    leaf_coordinates[0].push_back(static_cast<std::int32_t>(projected_u.lon));
+                    leaf_coordinates[1].push_back(static_cast<std::int32_t>(projected_u.lat));
+                    leaf_coordinates[2].push_back(static_cast<std::int32_t>(projected_v.lon));
+                    leaf_coordinates[3].push_back(static_cast<std::int32_t>(projected_v.lat));
                 }
 
                 m_search_tree.emplace_back(current_node);
+                m_search_tree_summaries.emplace_back(current_summary);
+                if (store_leaf_coordinates)
+                    EncodeLeafCoordinates(current_node.minimum_bounding_rectangle,
+                                          leaf_coordinates);
             }
         }
         // mmap as read-only now
@@ -399,6 +466,7 @@ class StaticRTree
             for (auto current_node_idx : irange<std::size_t>(0, nodes_in_current_level))
             {
                 TreeNode parent_node;
+                TreeNodeSummary parent_summary;
                 auto first_child_index =
                     current_node_idx * BRANCHING_FACTOR + previous_level_start_pos;
                 auto last_child_index =
@@ -413,8 +481,10 @@ class StaticRTree
                 {
                     parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
                         m_search_tree[child_node_idx].minimum_bounding_rectangle);
+                    parent_summary.Merge(m_search_tree_summaries[child_node_idx]);
                 }
                 m_search_tree.emplace_back(parent_node);
+                m_search_tree_summaries.emplace_back(parent_summary);
             }
             nodes_in_previous_level = nodes_in_current_level;
             tree_level_sizes.push_back(nodes_in_previous_level);
@@ -426,6 +496,7 @@ class StaticRTree
         // Flip the tree so that the root node is at 0.
         // This just makes our math during search a bit more intuitive
         std::reverse(m_search_tree.begin(), m_search_tree.end());
+        std::reverse(m_search_tree_summaries.begin(), m_search_tree_summaries.end());
 
         // Same for the level sizes - root node / base level is at 0
         std::reverse(tree_level_sizes.begin(), tree_level_sizes.end());
@@ -452,6 +523,9 @@ class StaticRTree
         {
             std::reverse(m_search_tree.begin() + m_tree_level_starts[i],
                          m_search_tree.begin() + m_tree_level_starts[i] + tree_level_sizes[i]);
+            std::reverse(m_search_tree_summaries.begin() + m_tree_level_starts[i],
+                         m_search_tree_summaries.begin() + m_tree_level_starts[i] +
+                             tree_level_sizes[i]);
         }
     }
 
@@ -473,17 +547,46 @@ class StaticRTree
      * excep the .fileIndex file always stays on disk, and we mmap() it as usual
      */
     explicit StaticRTree(Vector<TreeNode> search_tree_,
+                         Vector<TreeNodeSummary> search_tree_summaries,
+                         Vector<std::uint16_t> leaf_coordinates,
+                         Vector<std::uint64_t> leaf_coordinate_offsets,
                          Vector<std::uint64_t> tree_level_starts,
                          const boost::filesystem::path &on_disk_file_name,
                          const Vector<Coordinate> &coordinate_list)
         : m_search_tree(std::move(search_tree_)),
+          m_search_tree_summaries(std::move(search_tree_summaries)),
+          m_leaf_coordinates(std::move(leaf_coordinates)),
+          m_leaf_coordinate_offsets(std::move(leaf_coordinate_offsets)),
           m_coordinate_list(coordinate_list.data(), coordinate_list.size()),
           m_tree_level_starts(std::move(tree_level_starts))
     {
         BOOST_ASSERT(m_tree_level_starts.size() >= 2);
+        BOOST_ASSERT(m_search_tree_summaries.size() == m_search_tree.size());
         m_objects = mmapFile<EdgeDataT>(on_disk_file_name, m_objects_region);
     }
 
+    /**
+     * Same as above, but the leaves were loaded into memory as well, so queries never read
+     * from the .fileIndex file. The leaves need to outlive the r-tree.
+     */
+    explicit StaticRTree(Vector<TreeNode> search_tree_,
+                         Vector<TreeNodeSummary> search_tree_summaries,
+                         Vector<std::uint16_t> leaf_coordinates,
+                         Vector<std::uint64_t> leaf_coordinate_offsets,
+                         Vector<std::uint64_t> tree_level_starts,
+                         util::vector_view<const EdgeDataT> objects,
+                         const Vector<Coordinate> &coordinate_list)
+        : m_search_tree(std::move(search_tree_)),
+          m_search_tree_summaries(std::move(search_tree_summaries)),
+          m_leaf_coordinates(std::move(leaf_coordinates)),
+          m_leaf_coordinate_offsets(std::move(leaf_coordinate_offsets)),
+          m_coordinate_list(coordinate_list.data(), coordinate_list.size()),
+          m_tree_level_starts(std::move(tree_level_starts)), m_objects(std::move(objects))
+    {
+        BOOST_ASSERT(m_tree_level_starts.size() >= 2);
+        BOOST_ASSERT(m_search_tree_summaries.size() == m_search_tree.size());
+    }
+
     /* Returns all features inside the bounding box.
        Rectangle needs to be projected!*/
     std::vector<EdgeDataT> SearchInBox(const Rectangle &search_rectangle) const
@@ -571,13 +674,31 @@ class StaticRTree
     std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
                                    const FilterT filter,
                                    const TerminationT terminate) const
+    {
+        return Nearest(input_coordinate,
+                       [](const TreeNodeSummary &) { return true; },
+                       filter,
+                       terminate);
+    }
+
+    // Same as above, but subtrees are only explored if subtree_filter accepts their summary.
+    // It must not reject a subtree that contains a segment the filter would use.
+    template <typename SubtreeFilterT, typename FilterT, typename TerminationT>
+    std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
+                                   const SubtreeFilterT subtree_filter,
+                                   const FilterT filter,
+                                   const TerminationT terminate) const
     {
         std::vector<EdgeDataT> results;
-        auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
-        Coordinate fixed_projected_coordinate{projected_coordinate};
-        // initialize queue with root element
-        std::priority_queue<QueryCandidate> traversal_queue;
-        traversal_queue.push(QueryCandidate{0, TreeIndex{}});
+        const Coordinate fixed_projected_coordinate{web_mercator::fromWGS84(input_coordinate)};
+        // initialize queue with root element, the queue of the thread is reused to keep its
+        // storage over the many lookups of a batch
+        thread_local TraversalQueue traversal_queue;
+        traversal_queue.clear();
+        if (subtree_filter(m_search_tree_summaries[0]))
+        {
+            traversal_queue.push(QueryCandidate{0, TreeIndex{}});
+        }
 
         while (!traversal_queue.empty())
         {
@@ -589,15 +710,15 @@ class StaticRTree
             { // current object is a tree node
                 if (is_leaf(current_tree_index))
                 {
-                    ExploreLeafNode(current_tree_index,
-                                    fixed_projected_coordinate,
-                                    projected_coordinate,
-                                    traversal_queue);
+                    ExploreLeafNode(
+                        current_tree_index, fixed_projected_coordinate, traversal_queue);
                 }
                 else
                 {
-                    ExploreTreeNode(
-                        current_tree_index, fixed_projected_coordinate, traversal_queue);
+                    ExploreTreeNode(current_tree_index,
+                                    fixed_projected_coordinate,
+                                    subtree_filter,
+                                    traversal_queue);
                 }
             }
             else
@@ -627,6 +748,8 @@ class StaticRTree
                 results.push_back(std::move(edge_data));
             }
         }
+        // a single query with a large search space must not pin its storage to the thread
+        traversal_queue.shrink(MAX_RETAINED_QUEUE_SIZE);
 
         return results;
     }
@@ -636,38 +759,184 @@ class StaticRTree
      * Iterates over all the objects in a leaf node and inserts them into our
      * search priority queue.  The speed of this function is very much governed
      * by the value of LEAF_NODE_SIZE, as we'll calculate the euclidean distance
-     * for every child of each leaf node visited.
+     * for every child of each leaf node visited.  The distances of all segments
+     * are computed at once from the projected coordinates of the leaf.
      */
     template <typename QueueT>
     void ExploreLeafNode(const TreeIndex &leaf_id,
                          const Coordinate &projected_input_coordinate_fixed,
-                         const FloatCoordinate &projected_input_coordinate,
                          QueueT &traversal_queue) const
     {
         // Check that we're actually looking at the bottom level of the tree
         BOOST_ASSERT(is_leaf(leaf_id));
 
-        for (const auto i : child_indexes(leaf_id))
+        const auto children = child_indexes(leaf_id);
+        const auto first_child_index = *children.begin();
+        const auto number_of_children = children.size();
+
+        std::array<std::int32_t, 4 * LEAF_NODE_SIZE> coordinates;
+        DecodeLeafCoordinates(leaf_id, number_of_children, coordinates.data());
+        const auto *source_lons = coordinates.data();
+        const auto *source_lats = source_lons + number_of_children;
+        const auto *target_lons = source_lats + number_of_children;
+        const auto *target_lats = target_lons + number_of_children;
+
+        std::array<std::uint64_t, LEAF_NODE_SIZE> squared_distances;
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lons;
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lats;
+        rtree_distances::getSquaredSegmentDistances(source_lons,
+                                                    source_lats,
+                                                    target_lons,
+                                                    target_lats,
+                                                    number_of_children,
+                                                    projected_input_coordinate_fixed,
+                                                    squared_distances.data(),
+                                                    nearest_lons.data(),
+                                                    nearest_lats.data());
+
+        for (const auto child : irange<std::size_t>(0, number_of_children))
         {
-            const auto &current_edge = m_objects[i];
-
-            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
-            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
-
-            FloatCoordinate projected_nearest;
-            std::tie(std::ignore, projected_nearest) =
-                coordinate_calculation::projectPointOnSegment(
-                    projected_u, projected_v, projected_input_coordinate);
-
-            const auto squared_distance = coordinate_calculation::squaredEuclideanDistance(
-                projected_input_coordinate_fixed, projected_nearest);
-            // distance must be non-negative
-            BOOST_ASSERT(0. <= squared_distance);
+            const auto i = first_child_index + child;
             BOOST_ASSERT(i < std::numeric_limits<std::uint32_t>::max());
-            traversal_queue.push(QueryCandidate{squared_distance,
+            traversal_queue.push(QueryCandidate{squared_distances[child],
                                                 leaf_id,
                                                 static_cast<std::uint32_t>(i),
-                                                Coordinate{projected_nearest}});
+                                                Coordinate{FixedLongitude{nearest_lons[child]},
+                                                           FixedLatitude{nearest_lats[child]}}});
+        }
+    }
+
+    // Returns the summary of the enabled directions of a single segment
+    TreeNodeSummary SummarizeSegment(const EdgeDataT &object,
+                                     const std::vector<std::uint8_t> &node_classes) const
+    {
+        TreeNodeSummary summary;
+        const auto forward_bearing = static_cast<int>(std::round(coordinate_calculation::bearing(
+            m_coordinate_list[object.u], m_coordinate_list[object.v])));
+
+        if (object.forward_segment_id.enabled)
+        {
+            summary.bearing_sectors |= bearing::GetSectorMask(forward_bearing);
+            if (!node_classes.empty())
+            {
+                BOOST_ASSERT(object.forward_segment_id.id < node_classes.size());
+                summary.common_classes &= node_classes[object.forward_segment_id.id];
+            }
+        }
+        if (object.reverse_segment_id.enabled)
+        {
+            summary.bearing_sectors |= bearing::GetSectorMask(forward_bearing + 180);
+            if (!node_classes.empty())
+            {
+                BOOST_ASSERT(object.reverse_segment_id.id < node_classes.size());
+                summary.common_classes &= node_classes[object.reverse_segment_id.id];
+            }
+        }
+        if (node_classes.empty())
+        {
+            summary.common_classes = 0;
+        }
+        return summary;
+    }
+
+    /**
+     * Appends the projected coordinates of the segments of a leaf to m_leaf_coordinates.
+     * They are stored as the source longitudes, source latitudes, target longitudes and target
+     * latitudes of all segments, each relative to the corner of the bounding box of the leaf.
+     * In most leaves these fit 16 bits, otherwise the lower and upper 16 bits of each value are
+     * stored one after the other. Which is used follows from the number of stored values.
+     */
+    void EncodeLeafCoordinates(const Rectangle &rectangle,
+                               const std::array<std::vector<std::int32_t>, 4> &coordinates)
+    {
+        const auto min_lon = static_cast<std::int32_t>(rectangle.min_lon);
+        const auto min_lat = static_cast<std::int32_t>(rectangle.min_lat);
+        const bool is_narrow =
+            static_cast<std::int64_t>(static_cast<std::int32_t>(rectangle.max_lon)) - min_lon <=
+                std::numeric_limits<std::uint16_t>::max() &&
+            static_cast<std::int64_t>(static_cast<std::int32_t>(rectangle.max_lat)) - min_lat <=
+                std::numeric_limits<std::uint16_t>::max();
+
+        for (const auto channel : irange<std::size_t>(0, coordinates.size()))
+        {
+            const auto base = channel % 2 == 0 ? min_lon : min_lat;
+            for (const auto value : coordinates[channel])
+            {
+                const auto delta = static_cast<std::uint32_t>(value - base);
+                m_leaf_coordinates.push_back(static_cast<std::uint16_t>(delta));
+            }
+            if (!is_narrow)
+            {
+                for (const auto value : coordinates[channel])
+                {
+                    const auto delta = static_cast<std::uint32_t>(value - base);
+                    m_leaf_coordinates.push_back(static_cast<std::uint16_t>(delta >> 16));
+                }
+            }
+        }
+        m_leaf_coordinate_offsets.push_back(m_leaf_coordinates.size());
+    }
+
+    // Writes the projected coordinates of the segments of a leaf in the order they are encoded in
+    void DecodeLeafCoordinates(const TreeIndex &leaf_id,
+                               const std::size_t number_of_children,
+                               std::int32_t *coordinates) const
+    {
+        if (m_leaf_coordinate_offsets.empty())
+        {
+            const auto first_child_index = *child_indexes(leaf_id).begin();
+            for (const auto child : irange<std::size_t>(0, number_of_children))
+            {
+                const auto &object = m_objects[first_child_index + child];
+                const Coordinate projected_u{
+                    web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.u]})};
+                const Coordinate projected_v{
+                    web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.v]})};
+                coordinates[child] = static_cast<std::int32_t>(projected_u.lon);
+                coordinates[number_of_children + child] =
+                    static_cast<std::int32_t>(projected_u.lat);
+                coordinates[2 * number_of_children + child] =
+                    static_cast<std::int32_t>(projected_v.lon);
+                coordinates[3 * number_of_children + child] =
+                    static_cast<std::int32_t>(projected_v.lat);
+            }
+            return;
+        }
+
+        BOOST_ASSERT(leaf_id.offset + 1 < m_leaf_coordinate_offsets.size());
+        const auto begin = m_leaf_coordinate_offsets[leaf_id.offset];
+        const auto end = m_leaf_coordinate_offsets[leaf_id.offset + 1];
+        const bool is_narrow = end - begin == 4 * number_of_children;
+        BOOST_ASSERT(is_narrow || end - begin == 8 * number_of_children);
+
+        const auto &rectangle =
+            m_search_tree[m_tree_level_starts[leaf_id.level] + leaf_id.offset]
+                .minimum_bounding_rectangle;
+        const std::array<std::int32_t, 2> bases = {{static_cast<std::int32_t>(rectangle.min_lon),
+                                                    static_cast<std::int32_t>(rectangle.min_lat)}};
+
+        const auto *encoded = m_leaf_coordinates.data() + begin;
+        for (const auto channel : irange<std::size_t>(0, 4))
+        {
+            const auto base = bases[channel % 2];
+            auto *decoded = coordinates + channel * number_of_children;
+            if (is_narrow)
+            {
+                for (const auto child : irange<std::size_t>(0, number_of_children))
+                    decoded[child] = base + encoded[child];
+                encoded += number_of_children;
+            }
+            else
+            {
+                const auto *upper = encoded + number_of_children;
+                for (const auto child : irange<std::size_t>(0, number_of_children))
+                {
+                    const std::uint32_t delta =
+                        (std::uint32_t{upper[child]} << 16) | encoded[child];
+                    decoded[child] = static_cast<std::int32_t>(base + delta);
+                }
+                encoded += 2 * number_of_children;
+            }
         }
     }
 
@@ -677,27 +946,37 @@ class StaticRTree
      * priority metric.
      * The closests distance to a box from our point is also the closest distance
      * to the closest line in that box (assuming the boxes hug their contents).
+     * Children rejected by the subtree filter are not inserted.
      */
-    template <class QueueT>
+    template <class SubtreeFilterT, class QueueT>
     void ExploreTreeNode(const TreeIndex &parent,
                          const Coordinate &fixed_projected_input_coordinate,
+                         const SubtreeFilterT &subtree_filter,
                          QueueT &traversal_queue) const
     {
         // Figure out which_id level the parent is on, and it's offset
         // in that level.
         // Check that we're actually looking at the bottom level of the tree
         BOOST_ASSERT(!is_leaf(parent));
+        static_assert(sizeof(TreeNode) == sizeof(Rectangle), "rectangles need to be contiguous");
 
-        for (const auto child_index : child_indexes(parent))
-        {
-            const auto &child = m_search_tree[child_index];
+        const auto children = child_indexes(parent);
+        const auto first_child_index = *children.begin();
+
+        std::array<std::uint64_t, BRANCHING_FACTOR> squared_lower_bounds;
+        rtree_distances::getMinSquaredDistances(
+            &m_search_tree[first_child_index].minimum_bounding_rectangle,
+            children.size(),
+            fixed_projected_input_coordinate,
+            squared_lower_bounds.data());
 
-            const auto squared_lower_bound_to_element =
-                child.minimum_bounding_rectangle.GetMinSquaredDist(
-                    fixed_projected_input_coordinate);
+        for (const auto child_index : children)
+        {
+            if (!subtree_filter(m_search_tree_summaries[child_index]))
+                continue;
 
             traversal_queue.push(QueryCandidate{
-                squared_lower_bound_to_element,
+                squared_lower_bounds[child_index - first_child_index],
                 TreeIndex(parent.level + 1, child_index - m_tree_level_starts[parent.level + 1])});
         }
     }
@@ -0,0 +1,167 @@
+#include "contractor/files.hpp"
+#include "contractor/query_graph.hpp"
+#include "extractor/files.hpp"
+#include "extractor/profile_properties.hpp"
+
+#include "util/filtered_graph.hpp"
+#include "util/query_heap.hpp"
+#include "util/timing_util.hpp"
+
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+
+using QueryHeap = util::QueryHeap<NodeID, NodeID, EdgeWeight, NodeID>;
+using FilteredQueryGraph = util::FilteredGraphContainer<contractor::QueryGraph>;
+
+// Plain bidirectional upward search on the CH graph, the same search space a CH query explores
+EdgeWeight chQuery(const FilteredQueryGraph &graph,
+                   QueryHeap &forward_heap,
+                   QueryHeap &reverse_heap,
+                   const NodeID source,
+                   const NodeID target)
+{
+    forward_heap.Clear();
+    reverse_heap.Clear();
+    forward_heap.Insert(source, 0, source);
+    reverse_heap.Insert(target, 0, target);
+
+    EdgeWeight best = INVALID_EDGE_WEIGHT;
+    const auto step = [&](QueryHeap &heap, const QueryHeap &other_heap, const bool forward) {
+        const auto node = heap.DeleteMin();
+        const auto weight = heap.GetKey(node);
+        if (other_heap.WasInserted(node))
+            best = std::min(best, weight + other_heap.GetKey(node));
+
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            if (!(forward ? data.forward : data.backward))
+                continue;
+
+            const auto to = graph.GetTarget(edge);
+            const auto to_weight = weight + data.weight;
+            if (!heap.WasInserted(to))
+                heap.Insert(to, to_weight, node);
+            else if (to_weight < heap.GetKey(to))
+                heap.DecreaseKey(to, to_weight);
+        }
+    };
+
+    while (!forward_heap.Empty() || !reverse_heap.Empty())
+    {
+        if (!forward_heap.Empty())
+        {
+            if (forward_heap.MinKey() >= best)
+                forward_heap.DeleteAll();
+            else
+                step(forward_heap, reverse_heap, true);
+        }
+        if (!reverse_heap.Empty())
+        {
+            if (reverse_heap.MinKey() >= best)
+                reverse_heap.DeleteAll();
+            else
+                step(reverse_heap, forward_heap, false);
+        }
+    }
+
+    return best;
+}
+
+template <typename QueryT>
+void benchmarkQuery(const std::vector<std::pair<NodeID, NodeID>> &queries,
+                    const std::string &name,
+                    QueryT query)
+{
+    std::cout << "Running " << name << " with " << queries.size() << " queries: " << std::flush;
+
+    std::size_t unreachable = 0;
+    TIMER_START(query);
+    for (const auto &q : queries)
+    {
+        unreachable += query(q.first, q.second) == INVALID_EDGE_WEIGHT;
+    }
+    TIMER_STOP(query);
+
+    std::cout << "Took " << TIMER_SEC(query) << " seconds "
+              << "(" << TIMER_MSEC(query) << "ms"
+              << ")  ->  " << TIMER_MSEC(query) * 1000. / queries.size() << " us/query, "
+              << unreachable << " unreachable" << std::endl;
+}
+
+// Compares point-to-point queries of the default exclude class on random node pairs
+void benchmark(contractor::ContractedMetric metric,
+               const contractor::HubLabels &labels,
+               const unsigned num_queries)
+{
+    const FilteredQueryGraph filtered_graph{std::move(metric.graph),
+                                            std::move(metric.edge_filter.front())};
+
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<NodeID> node_udist(0, labels.GetNumberOfNodes() - 1);
+    std::vector<std::pair<NodeID, NodeID>> queries;
+    for (unsigned i = 0; i < num_queries; i++)
+    {
+        queries.emplace_back(node_udist(mt_rand), node_udist(mt_rand));
+    }
+
+    QueryHeap forward_heap(labels.GetNumberOfNodes());
+    QueryHeap reverse_heap(labels.GetNumberOfNodes());
+    std::size_t mismatches = 0;
+    for (const auto &q : queries)
+    {
+        mismatches += chQuery(filtered_graph, forward_heap, reverse_heap, q.first, q.second) !=
+                      labels.Query(q.first, q.second).first;
+    }
+    std::cout << "Hub labels differ from CH for " << mismatches << " queries" << std::endl;
+
+    benchmarkQuery(queries, "CH queries", [&](const NodeID source, const NodeID target) {
+        return chQuery(filtered_graph, forward_heap, reverse_heap, source, target);
+    });
+    benchmarkQuery(queries, "hub label queries", [&](const NodeID source, const NodeID target) {
+        return labels.Query(source, target).first;
+    });
+}
+}
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "./hublabels-bench file.osrm"
+                  << "\n";
+        return 1;
+    }
+
+    const std::string base_path = argv[1];
+
+    osrm::extractor::ProfileProperties properties;
+    osrm::extractor::files::readProfileProperties(base_path + ".properties", properties);
+    const auto metric_name = properties.GetWeightName();
+
+    std::uint32_t connectivity_checksum;
+    std::unordered_map<std::string, osrm::contractor::ContractedMetric> metrics = {
+        {metric_name, {}}};
+    osrm::contractor::files::readGraph(base_path + ".hsgr", metrics, connectivity_checksum);
+
+    std::unordered_map<std::string, std::vector<osrm::contractor::HubLabels>> labels = {
+        {metric_name, {}}};
+    osrm::contractor::files::readHubLabels(
+        base_path + ".hub_labels", labels, connectivity_checksum);
+
+    osrm::benchmarks::benchmark(
+        std::move(metrics[metric_name]), labels[metric_name].front(), 100000);
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "query_latency.hpp"
+#include "random_cycle.hpp"
+
+#include "util/huge_pages.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/osrm.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace osrm;
+
+struct Measurement
+{
+    double populate_ms;
+    double random_read_ms;
+};
+
+// Follows a random cycle through the memory, every read depends on the previous one like the
+// lookups of a graph search do. This makes the cost of TLB misses visible in the timing.
+template <std::size_t num_reads, std::size_t num_entries> auto measure_random_access(bool huge)
+{
+    std::unique_ptr<std::uint64_t[]> memory(new std::uint64_t[num_entries]);
+    if (huge)
+    {
+        if (!util::AdviseHugePages(memory.get(), num_entries * sizeof(std::uint64_t)))
+        {
+            util::Log(logWARNING) << "Transparent huge pages are not available";
+        }
+    }
+#if defined(__linux__) && defined(MADV_NOHUGEPAGE)
+    else
+    {
+        // the system might use huge pages for all memory by default
+        const auto page_size = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+        const auto begin = reinterpret_cast<std::uintptr_t>(memory.get());
+        const auto aligned_begin = (begin + page_size - 1) / page_size * page_size;
+        ::madvise(reinterpret_cast<void *>(aligned_begin),
+                  begin + num_entries * sizeof(std::uint64_t) - aligned_begin,
+                  MADV_NOHUGEPAGE);
+    }
+#endif
+
+    const auto order = benchmarks::makeRandomOrder(num_entries);
+
+    TIMER_START(populate);
+    benchmarks::writeRandomCycle(memory.get(), order);
+    TIMER_STOP(populate);
+
+    TIMER_START(read);
+    benchmarks::followRandomCycle(memory.get(), order.front(), num_reads);
+    TIMER_STOP(read);
+
+    return Measurement{TIMER_MSEC(populate), TIMER_MSEC(read)};
+}
+
+void log_latency(const std::string &name, const benchmarks::LatencyStatistics &statistics)
+{
+    util::Log() << name << ": mean " << statistics.mean_us << " us, median "
+                << statistics.median_us << " us, p99 " << statistics.p99_us << " us, "
+                << statistics.failed << " failed";
+}
+
+// Route and table queries on a dataset loaded into process memory with and without huge pages
+void measure_queries(const std::string &base_path, const benchmarks::QueryArea &area)
+{
+    for (const bool huge : {false, true})
+    {
+        EngineConfig config;
+        config.storage_config = {base_path};
+        config.storage_config.huge_pages = huge;
+        config.use_shared_memory = false;
+        const OSRM osrm{config};
+
+        const auto latency = benchmarks::measureQueryLatency(osrm, area);
+        const std::string pages = huge ? "huge pages" : "small pages";
+        log_latency("route, " + pages, latency.route);
+        log_latency("table, " + pages, latency.table);
+    }
+}
+
+int main(int argc, const char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    if (argc != 1 && argc != 2 && argc != 6)
+    {
+        std::cerr << "Usage: " << argv[0] << " [data.osrm [min_lon min_lat max_lon max_lat]]\n";
+        return EXIT_FAILURE;
+    }
+
+    // 1 GiB of memory is far beyond the reach of the TLB with 4 KiB pages
+    constexpr std::size_t num_entries = 128 * 1024 * 1024;
+    constexpr std::size_t num_reads = 20 * 1000 * 1000;
+
+    auto result_small = measure_random_access<num_reads, num_entries>(false);
+    auto result_huge = measure_random_access<num_reads, num_entries>(true);
+
+    util::Log() << "populate: small pages " << result_small.populate_ms << " ms, huge pages "
+                << result_huge.populate_ms << " ms. "
+                << result_small.populate_ms / result_huge.populate_ms;
+    util::Log() << "random read: small pages " << result_small.random_read_ms
+                << " ms, huge pages " << result_huge.random_read_ms << " ms. "
+                << result_small.random_read_ms / result_huge.random_read_ms;
+    util::Log() << "random read latency: small pages "
+                << result_small.random_read_ms * 1000000. / num_reads << " ns, huge pages "
+                << result_huge.random_read_ms * 1000000. / num_reads << " ns";
+
+    if (argc > 1)
+    {
+        benchmarks::QueryArea area;
+        if (argc == 6)
+        {
+            area.min_lon = std::stod(argv[2]);
+            area.min_lat = std::stod(argv[3]);
+            area.max_lon = std::stod(argv[4]);
+            area.max_lat = std::stod(argv[5]);
+        }
+        measure_queries(argv[1], area);
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -1,3 +1,7 @@
+#include "engine/datafacade_provider.hpp"
+#include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/search_engine_data.hpp"
+#include "util/integer_range.hpp"
 #include "util/timing_util.hpp"
 
 #include "osrm/match_parameters.hpp"
@@ -15,6 +19,7 @@
 #include <iostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <cstdlib>
 
@@ -227,6 +232,73 @@ int main(int argc, const char *argv[]) try
     std::cout << (TIMER_MSEC(routes) / NUM / params.coordinates.size()) << "ms/coordinate"
               << std::endl;
 
+    // Transition distances between the candidates of consecutive locations, once with a search
+    // per candidate pair and once with the bounded many-to-many search that match uses on CH
+    if (config.algorithm == EngineConfig::Algorithm::CH)
+    {
+        using namespace osrm::engine;
+        using namespace osrm::engine::routing_algorithms;
+
+        const ImmutableProvider<ch::Algorithm> provider{config.storage_config};
+        const auto facade = provider.Get(api::BaseParameters{});
+        SearchEngineData<ch::Algorithm> heaps;
+
+        std::vector<std::vector<PhantomNode>> candidates;
+        for (const auto &coordinate : params.coordinates)
+        {
+            candidates.emplace_back();
+            for (const auto &candidate :
+                 facade->NearestPhantomNodes(coordinate, 10, Approach::UNRESTRICTED))
+                candidates.back().push_back(candidate.phantom_node);
+        }
+        const EdgeWeight weight_upper_bound = 1000 * facade->GetWeightMultiplier();
+
+        double checksum = 0;
+        TIMER_START(pairs);
+        for (int i = 0; i < NUM; ++i)
+        {
+            heaps.InitializeOrClearFirstThreadLocalStorage(facade->GetNumberOfNodes());
+            for (const auto index : util::irange<std::size_t>(1, candidates.size()))
+                for (const auto &source : candidates[index - 1])
+                    for (const auto &target : candidates[index])
+                        checksum += ch::getNetworkDistance(heaps,
+                                                           *facade,
+                                                           *heaps.forward_heap_1,
+                                                           *heaps.reverse_heap_1,
+                                                           source,
+                                                           target,
+                                                           weight_upper_bound);
+        }
+        TIMER_STOP(pairs);
+
+        double batched_checksum = 0;
+        TIMER_START(batched);
+        for (int i = 0; i < NUM; ++i)
+        {
+            for (const auto index : util::irange<std::size_t>(1, candidates.size()))
+            {
+                const auto distances = ch::getNetworkDistances(heaps,
+                                                               *facade,
+                                                               candidates[index - 1],
+                                                               candidates[index],
+                                                               weight_upper_bound);
+                for (const auto distance : distances)
+                    batched_checksum += distance;
+            }
+        }
+        TIMER_STOP(batched);
+
+        std::cout << (TIMER_MSEC(pairs) / NUM) << "ms/trace transitions with a search per pair"
+                  << std::endl;
+        std::cout << (TIMER_MSEC(batched) / NUM) << "ms/trace transitions with batched searches"
+                  << std::endl;
+        if (checksum != batched_checksum)
+        {
+            std::cerr << "Transition distances differ" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     return EXIT_SUCCESS;
 }
 catch (const std::exception &e)
@@ -0,0 +1,171 @@
+#include "query_latency.hpp"
+#include "random_cycle.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/numa.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/osrm.hpp"
+
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace osrm;
+
+struct Measurement
+{
+    double latency_ns;
+    double throughput_reads_per_us;
+};
+
+constexpr std::size_t num_entries = 64 * 1024 * 1024;
+constexpr std::size_t num_reads = 10 * 1000 * 1000;
+
+// Memory with a random cycle through all entries, placed on the node of the thread that
+// writes it first
+auto make_cycle(const std::size_t node, const std::vector<unsigned> &cpus)
+{
+    std::unique_ptr<std::uint64_t[]> memory;
+    std::thread populate([&] {
+        util::PinThreadToNUMANode(node, cpus);
+
+        const auto order = benchmarks::makeRandomOrder(num_entries);
+        memory.reset(new std::uint64_t[num_entries]);
+        benchmarks::writeRandomCycle(memory.get(), order);
+    });
+    populate.join();
+    return memory;
+}
+
+auto measure(const std::uint64_t *memory, const std::size_t node, const std::vector<unsigned> &cpus)
+{
+    Measurement result;
+
+    std::thread single([&] {
+        util::PinThreadToNUMANode(node, cpus);
+        TIMER_START(read);
+        benchmarks::followRandomCycle(memory, 0, num_reads);
+        TIMER_STOP(read);
+        result.latency_ns = TIMER_MSEC(read) * 1000000. / num_reads;
+    });
+    single.join();
+
+    // one thread per CPU of the node, every thread starts at another position of the cycle
+    const auto num_threads = std::max<std::size_t>(1, cpus.size());
+    std::vector<std::thread> threads;
+    TIMER_START(parallel);
+    for (auto thread_index : util::irange<std::size_t>(0, num_threads))
+    {
+        threads.emplace_back([&, thread_index] {
+            util::PinThreadToNUMANode(node, cpus);
+            benchmarks::followRandomCycle(memory, thread_index * 7919, num_reads);
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    TIMER_STOP(parallel);
+    result.throughput_reads_per_us = num_threads * num_reads / (TIMER_MSEC(parallel) * 1000.);
+
+    return result;
+}
+
+void log_latency(const std::string &name, const benchmarks::LatencyStatistics &statistics)
+{
+    util::Log() << name << ": mean " << statistics.mean_us << " us, median "
+                << statistics.median_us << " us, p99 " << statistics.p99_us << " us, "
+                << statistics.failed << " failed";
+}
+
+// Route and table queries from a thread pinned to every node, with and without replicas. The
+// parallel parts of a query run on TBB workers, which osrm-routed does not pin. Here every
+// pinned thread gets a scheduler without workers, so all work of its queries stays on its node.
+void measure_queries(const std::string &base_path,
+                     const benchmarks::QueryArea &area,
+                     const std::vector<std::vector<unsigned>> &nodes)
+{
+    for (const bool replicas : {false, true})
+    {
+        EngineConfig config;
+        config.storage_config = {base_path};
+        config.use_shared_memory = false;
+        config.use_numa_replicas = replicas;
+        const OSRM osrm{config};
+
+        for (auto node : util::irange<std::size_t>(0, nodes.size()))
+        {
+            benchmarks::QueryLatency latency;
+            std::thread query([&] {
+                util::PinThreadToNUMANode(node, nodes[node]);
+                tbb::task_scheduler_init init(1);
+                latency = benchmarks::measureQueryLatency(osrm, area);
+            });
+            query.join();
+
+            const std::string name = std::string(replicas ? "replicas" : "no replicas") +
+                                     ", threads on node " + std::to_string(node);
+            log_latency("route, " + name, latency.route);
+            log_latency("table, " + name, latency.table);
+        }
+    }
+}
+
+int main(int argc, const char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    if (argc != 1 && argc != 2 && argc != 6)
+    {
+        std::cerr << "Usage: " << argv[0] << " [data.osrm [min_lon min_lat max_lon max_lat]]\n";
+        return EXIT_FAILURE;
+    }
+
+    const auto nodes = util::GetNUMANodes();
+    util::Log() << "Found " << nodes.size() << " NUMA nodes";
+
+    for (auto memory_node : util::irange<std::size_t>(0, nodes.size()))
+    {
+        const auto memory = make_cycle(memory_node, nodes[memory_node]);
+
+        for (auto thread_node : util::irange<std::size_t>(0, nodes.size()))
+        {
+            const auto result = measure(memory.get(), thread_node, nodes[thread_node]);
+            util::Log() << (memory_node == thread_node ? "local " : "remote")
+                        << " memory node " << memory_node << ", threads on node " << thread_node
+                        << ": latency " << result.latency_ns << " ns, throughput "
+                        << result.throughput_reads_per_us << " reads/us";
+        }
+    }
+
+    if (argc > 1)
+    {
+        benchmarks::QueryArea area;
+        if (argc == 6)
+        {
+            area.min_lon = std::stod(argv[2]);
+            area.min_lat = std::stod(argv[3]);
+            area.max_lon = std::stod(argv[4]);
+            area.max_lat = std::stod(argv[5]);
+        }
+        measure_queries(argv[1], area, nodes);
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
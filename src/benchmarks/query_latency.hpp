@@ -0,0 +1,134 @@
+#ifndef OSRM_BENCHMARKS_QUERY_LATENCY_HPP
+#define OSRM_BENCHMARKS_QUERY_LATENCY_HPP
+
+#include "util/integer_range.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Area the random locations of the queries are drawn from, defaults to Monaco
+struct QueryArea
+{
+    double min_lon = 7.41;
+    double min_lat = 43.72;
+    double max_lon = 7.44;
+    double max_lat = 43.75;
+};
+
+struct LatencyStatistics
+{
+    double mean_us;
+    double median_us;
+    double p99_us;
+    std::size_t failed;
+};
+
+struct QueryLatency
+{
+    LatencyStatistics route;
+    LatencyStatistics table;
+};
+
+inline LatencyStatistics summarize(std::vector<double> latencies_us, const std::size_t failed)
+{
+    if (latencies_us.empty())
+        return LatencyStatistics{0., 0., 0., failed};
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    const auto mean =
+        std::accumulate(latencies_us.begin(), latencies_us.end(), 0.) / latencies_us.size();
+    return LatencyStatistics{mean,
+                             latencies_us[latencies_us.size() / 2],
+                             latencies_us[latencies_us.size() * 99 / 100],
+                             failed};
+}
+
+// Runs the same random route and table queries one after the other and measures each of them.
+// Queries that don't return Status::Ok are counted as failed and not measured. The first
+// num_warmup_routes routes only bring the data into the caches.
+inline QueryLatency measureQueryLatency(const OSRM &osrm,
+                                        const QueryArea &area,
+                                        const std::size_t num_routes = 1000,
+                                        const std::size_t num_tables = 100,
+                                        const std::size_t table_size = 25,
+                                        const std::size_t num_warmup_routes = 100)
+{
+    using util::FloatCoordinate;
+    using util::FloatLatitude;
+    using util::FloatLongitude;
+
+    std::mt19937 g(1337);
+    std::uniform_real_distribution<> lon_udist(area.min_lon, area.max_lon);
+    std::uniform_real_distribution<> lat_udist(area.min_lat, area.max_lat);
+    const auto random_coordinate = [&] {
+        return FloatCoordinate{FloatLongitude{lon_udist(g)}, FloatLatitude{lat_udist(g)}};
+    };
+
+    QueryLatency result;
+
+    std::vector<double> latencies_us;
+    std::size_t failed = 0;
+    for (const auto index : util::irange<std::size_t>(0, num_warmup_routes + num_routes))
+    {
+        RouteParameters params;
+        params.overview = RouteParameters::OverviewType::False;
+        params.coordinates = {random_coordinate(), random_coordinate()};
+
+        json::Object response;
+        TIMER_START(route);
+        const auto rc = osrm.Route(params, response);
+        TIMER_STOP(route);
+        if (index < num_warmup_routes)
+            continue;
+        if (rc == Status::Ok)
+            latencies_us.push_back(TIMER_NSEC(route) / 1000.);
+        else
+            ++failed;
+    }
+    result.route = summarize(std::move(latencies_us), failed);
+
+    latencies_us.clear();
+    failed = 0;
+    for (const auto index : util::irange<std::size_t>(0, num_tables))
+    {
+        (void)index;
+        TableParameters params;
+        for (const auto location : util::irange<std::size_t>(0, table_size))
+        {
+            (void)location;
+            params.coordinates.push_back(random_coordinate());
+        }
+
+        json::Object response;
+        TIMER_START(table);
+        const auto rc = osrm.Table(params, response);
+        TIMER_STOP(table);
+        if (rc == Status::Ok)
+            latencies_us.push_back(TIMER_NSEC(table) / 1000.);
+        else
+            ++failed;
+    }
+    result.table = summarize(std::move(latencies_us), failed);
+
+    return result;
+}
+}
+}
+
+#endif
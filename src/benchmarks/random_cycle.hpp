@@ -0,0 +1,62 @@
+#ifndef OSRM_BENCHMARKS_RANDOM_CYCLE_HPP
+#define OSRM_BENCHMARKS_RANDOM_CYCLE_HPP
+
+#include "util/integer_range.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+#ifdef _WIN32
+#pragma optimize("", off)
+template <class T> void dont_optimize_away(T &&datum) { T local = datum; }
+#pragma optimize("", on)
+#else
+template <class T> void dont_optimize_away(T &&datum) { asm volatile("" : "+r"(datum)); }
+#endif
+
+// A random order of all entries, the cycle visits them in this order
+inline std::vector<std::uint64_t> makeRandomOrder(const std::size_t num_entries)
+{
+    std::vector<std::uint64_t> order(num_entries);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 g(1337);
+    std::shuffle(order.begin(), order.end(), g);
+    return order;
+}
+
+// Writes the cycle through all entries of the memory, every entry holds the index of the next
+// one. The memory is placed where the calling thread touches it first.
+inline void writeRandomCycle(std::uint64_t *memory, const std::vector<std::uint64_t> &order)
+{
+    for (auto idx : util::irange<std::size_t>(0, order.size()))
+    {
+        memory[order[idx]] = order[(idx + 1) % order.size()];
+    }
+}
+
+// Every read depends on the previous one like the lookups of a graph search do, which makes
+// the latency of the memory and the cost of TLB misses visible in the timing
+inline std::uint64_t
+followRandomCycle(const std::uint64_t *memory, std::uint64_t position, const std::size_t num_reads)
+{
+    for (auto idx : util::irange<std::size_t>(0, num_reads))
+    {
+        (void)idx;
+        position = memory[position];
+        dont_optimize_away(position);
+    }
+    return position;
+}
+}
+}
+
+#endif
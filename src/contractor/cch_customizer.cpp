@@ -0,0 +1,278 @@
+#include "contractor/cch_customizer.hpp"
+#include "contractor/contracted_edge_container.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+// Customized metric of one travel direction of all arcs. The values are kept in separate
+// arrays so the triangle relaxation touches as little memory as possible.
+struct DirectedMetric
+{
+    explicit DirectedMetric(const std::size_t number_of_arcs)
+        : weight(number_of_arcs, INVALID_EDGE_WEIGHT),
+          duration(number_of_arcs, MAXIMAL_EDGE_DURATION), middle(number_of_arcs, SPECIAL_NODEID),
+          turn_id(number_of_arcs, SPECIAL_NODEID)
+    {
+    }
+
+    // Relaxes an original edge of the edge-based graph
+    void RelaxEdge(const EdgeID arc,
+                   const EdgeWeight new_weight,
+                   const EdgeWeight new_duration,
+                   const NodeID new_turn_id)
+    {
+        if (new_weight < weight[arc])
+        {
+            weight[arc] = new_weight;
+            duration[arc] = new_duration;
+            middle[arc] = SPECIAL_NODEID;
+            turn_id[arc] = new_turn_id;
+        }
+    }
+
+    // Relaxes the path over the node with the given rank
+    void RelaxShortcut(const EdgeID arc,
+                       const EdgeWeight new_weight,
+                       const EdgeWeight new_duration,
+                       const NodeID new_middle)
+    {
+        if (new_weight < weight[arc])
+        {
+            weight[arc] = new_weight;
+            duration[arc] = new_duration;
+            middle[arc] = new_middle;
+            turn_id[arc] = SPECIAL_NODEID;
+        }
+    }
+
+    bool IsValid(const EdgeID arc) const { return weight[arc] != INVALID_EDGE_WEIGHT; }
+
+    std::vector<EdgeWeight> weight;
+    std::vector<EdgeWeight> duration;
+    // rank of the middle node of shortcuts, SPECIAL_NODEID for original edges
+    std::vector<NodeID> middle;
+    std::vector<NodeID> turn_id;
+};
+
+inline bool isValid(const EdgeWeight first, const EdgeWeight second)
+{
+    return first != INVALID_EDGE_WEIGHT && second != INVALID_EDGE_WEIGHT;
+}
+}
+
+std::vector<QueryEdge> customizeCCH(const CCHTopology &topology,
+                                    const std::vector<extractor::EdgeBasedEdge> &edges,
+                                    const std::vector<EdgeWeight> &node_weights,
+                                    const std::vector<bool> &node_filter)
+{
+    const auto number_of_nodes = topology.GetNumberOfNodes();
+    BOOST_ASSERT(node_weights.size() == number_of_nodes);
+    BOOST_ASSERT(node_filter.size() == number_of_nodes);
+
+    // upward arcs are travelled from the lower to the upper node, downward arcs in reverse
+    DirectedMetric upward(topology.GetNumberOfArcs());
+    DirectedMetric downward(topology.GetNumberOfArcs());
+
+    const auto relax_edge = [&](const NodeID from, const NodeID to, const auto &data) {
+        const auto from_rank = topology.rank[from];
+        const auto to_rank = topology.rank[to];
+        const auto weight = std::max(data.weight, 1);
+        if (from_rank < to_rank)
+        {
+            const auto arc = topology.FindArc(from_rank, to_rank);
+            BOOST_ASSERT(arc != SPECIAL_EDGEID);
+            upward.RelaxEdge(arc, weight, data.duration, data.turn_id);
+        }
+        else
+        {
+            const auto arc = topology.FindArc(to_rank, from_rank);
+            BOOST_ASSERT(arc != SPECIAL_EDGEID);
+            downward.RelaxEdge(arc, weight, data.duration, data.turn_id);
+        }
+    };
+
+    for (const auto &edge : edges)
+    {
+        if (edge.source == edge.target || edge.data.weight == INVALID_EDGE_WEIGHT ||
+            !node_filter[edge.source] || !node_filter[edge.target])
+            continue;
+
+        if (edge.data.forward)
+            relax_edge(edge.source, edge.target, edge.data);
+        if (edge.data.backward)
+            relax_edge(edge.target, edge.source, edge.data);
+    }
+
+    // Loops of a node over lower nodes, needed for routes that start and end on the same node
+    std::vector<EdgeWeight> loop_weight(number_of_nodes, INVALID_EDGE_WEIGHT);
+    std::vector<EdgeWeight> loop_duration(number_of_nodes, MAXIMAL_EDGE_DURATION);
+    std::vector<NodeID> loop_middle(number_of_nodes, SPECIAL_NODEID);
+
+    // Pulls the lower triangles of all upward arcs of a node. Every lower triangle
+    // (lower, node, upper) only reads arcs of `lower`, which is on a smaller level
+    // and thus already customized.
+    const auto customize_node = [&](const NodeID node) {
+        for (const auto down_arc : topology.GetDownwardArcs(node))
+        {
+            const auto lower = topology.tail[down_arc];
+            const auto lower_node_arc = topology.in_arc[down_arc];
+
+            const auto node_to_lower_weight = downward.weight[lower_node_arc];
+            const auto lower_to_node_weight = upward.weight[lower_node_arc];
+            if (isValid(node_to_lower_weight, lower_to_node_weight) &&
+                node_to_lower_weight + lower_to_node_weight < loop_weight[node])
+            {
+                loop_weight[node] = node_to_lower_weight + lower_to_node_weight;
+                loop_duration[node] =
+                    downward.duration[lower_node_arc] + upward.duration[lower_node_arc];
+                loop_middle[node] = lower;
+            }
+
+            // The upper neighbours of `lower` form a clique, so every upper neighbour of
+            // `lower` above `node` is also an upper neighbour of `node`.
+            auto node_upper_arc = topology.first_out[node];
+            for (auto lower_upper_arc = lower_node_arc + 1;
+                 lower_upper_arc < topology.first_out[lower + 1];
+                 ++lower_upper_arc)
+            {
+                const auto upper = topology.head[lower_upper_arc];
+                while (topology.head[node_upper_arc] < upper)
+                {
+                    ++node_upper_arc;
+                    BOOST_ASSERT(node_upper_arc < topology.first_out[node + 1]);
+                }
+                BOOST_ASSERT(topology.head[node_upper_arc] == upper);
+
+                // node -> lower -> upper
+                if (isValid(node_to_lower_weight, upward.weight[lower_upper_arc]))
+                {
+                    upward.RelaxShortcut(node_upper_arc,
+                                         node_to_lower_weight + upward.weight[lower_upper_arc],
+                                         downward.duration[lower_node_arc] +
+                                             upward.duration[lower_upper_arc],
+                                         lower);
+                }
+
+                // upper -> lower -> node
+                if (isValid(downward.weight[lower_upper_arc], lower_to_node_weight))
+                {
+                    downward.RelaxShortcut(node_upper_arc,
+                                           downward.weight[lower_upper_arc] + lower_to_node_weight,
+                                           downward.duration[lower_upper_arc] +
+                                               upward.duration[lower_node_arc],
+                                           lower);
+                }
+            }
+        }
+    };
+
+    for (const auto level : util::irange<std::size_t>(0, topology.level_offsets.size() - 1))
+    {
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(topology.level_offsets[level],
+                                            topology.level_offsets[level + 1]),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                for (auto index = range.begin(); index < range.end(); ++index)
+                {
+                    customize_node(topology.level_nodes[index]);
+                }
+            });
+    }
+
+    const auto make_edge_data = [&](const DirectedMetric &metric,
+                                    const EdgeID arc,
+                                    const bool forward,
+                                    const bool backward) {
+        const auto shortcut = metric.middle[arc] != SPECIAL_NODEID;
+        const auto id = shortcut ? topology.order[metric.middle[arc]] : metric.turn_id[arc];
+        return QueryEdge::EdgeData{
+            id, shortcut, metric.weight[arc], metric.duration[arc], forward, backward};
+    };
+
+    std::vector<QueryEdge> query_edges;
+    for (const auto lower : util::irange<NodeID>(0, number_of_nodes))
+    {
+        const auto source = topology.order[lower];
+        for (const auto arc : topology.GetUpwardArcs(lower))
+        {
+            const auto target = topology.order[topology.head[arc]];
+            const auto is_bidirectional =
+                upward.IsValid(arc) && upward.weight[arc] == downward.weight[arc] &&
+                upward.duration[arc] == downward.duration[arc] &&
+                upward.middle[arc] == downward.middle[arc] &&
+                upward.turn_id[arc] == downward.turn_id[arc];
+
+            if (is_bidirectional)
+            {
+                query_edges.emplace_back(source, target, make_edge_data(upward, arc, true, true));
+                continue;
+            }
+            if (upward.IsValid(arc))
+            {
+                query_edges.emplace_back(source, target, make_edge_data(upward, arc, true, false));
+            }
+            if (downward.IsValid(arc))
+            {
+                query_edges.emplace_back(
+                    source, target, make_edge_data(downward, arc, false, true));
+            }
+        }
+
+        if (loop_weight[lower] < node_weights[source])
+        {
+            const auto middle = topology.order[loop_middle[lower]];
+            query_edges.emplace_back(
+                source,
+                source,
+                QueryEdge::EdgeData{
+                    middle, true, loop_weight[lower], loop_duration[lower], true, false});
+            query_edges.emplace_back(
+                source,
+                source,
+                QueryEdge::EdgeData{
+                    middle, true, loop_weight[lower], loop_duration[lower], false, true});
+        }
+    }
+
+    tbb::parallel_sort(query_edges.begin(), query_edges.end());
+
+    return query_edges;
+}
+
+std::tuple<QueryGraph, std::vector<std::vector<bool>>>
+customizeExcludableCCH(const CCHTopology &topology,
+                       const std::vector<extractor::EdgeBasedEdge> &edges,
+                       const std::vector<EdgeWeight> &node_weights,
+                       const std::vector<std::vector<bool>> &node_filters)
+{
+    ContractedEdgeContainer edge_container;
+    for (const auto &node_filter : node_filters)
+    {
+        edge_container.Merge(customizeCCH(topology, edges, node_weights, node_filter));
+    }
+
+    util::Log() << "Customized CCH has " << edge_container.edges.size() << " edges for "
+                << node_filters.size() << " exclude classes.";
+
+    return std::make_tuple(QueryGraph{static_cast<NodeID>(topology.GetNumberOfNodes()),
+                                      std::move(edge_container.edges)},
+                           edge_container.MakeEdgeFilters());
+}
+}
+}
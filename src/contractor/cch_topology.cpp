@@ -0,0 +1,196 @@
+#include "contractor/cch_topology.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+
+namespace osrm
+{
+namespace contractor
+{
+
+CCHTopology::CCHTopology(std::vector<NodeID> order_,
+                         std::vector<EdgeID> first_out_,
+                         std::vector<NodeID> head_)
+    : order(std::move(order_)), first_out(std::move(first_out_)), head(std::move(head_))
+{
+    const auto number_of_nodes = order.size();
+    BOOST_ASSERT(first_out.size() == number_of_nodes + 1);
+    BOOST_ASSERT(first_out.back() == head.size());
+
+    rank.resize(number_of_nodes);
+    for (const auto node_rank : util::irange<NodeID>(0, number_of_nodes))
+    {
+        rank[order[node_rank]] = node_rank;
+    }
+
+    // Counting sort of the upward arcs by their head gives the downward adjacency
+    first_in.resize(number_of_nodes + 1, 0);
+    for (const auto upper : head)
+    {
+        first_in[upper + 1]++;
+    }
+    std::partial_sum(first_in.begin(), first_in.end(), first_in.begin());
+
+    tail.resize(head.size());
+    in_arc.resize(head.size());
+    std::vector<EdgeID> insert_position(first_in.begin(), first_in.end() - 1);
+    std::vector<NodeID> level(number_of_nodes, 0);
+    NodeID max_level = 0;
+    for (const auto lower : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (const auto arc : GetUpwardArcs(lower))
+        {
+            const auto upper = head[arc];
+            BOOST_ASSERT(lower < upper);
+            const auto position = insert_position[upper]++;
+            tail[position] = lower;
+            in_arc[position] = arc;
+
+            level[upper] = std::max(level[upper], level[lower] + 1);
+            max_level = std::max(max_level, level[upper]);
+        }
+    }
+
+    level_offsets.resize(max_level + 2, 0);
+    for (const auto node_level : level)
+    {
+        level_offsets[node_level + 1]++;
+    }
+    std::partial_sum(level_offsets.begin(), level_offsets.end(), level_offsets.begin());
+
+    level_nodes.resize(number_of_nodes);
+    std::vector<std::size_t> level_position(level_offsets.begin(), level_offsets.end() - 1);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        level_nodes[level_position[level[node]]++] = node;
+    }
+}
+
+std::vector<NodeID>
+computeNestedDissectionOrder(const partitioner::MultiLevelPartition &mlp,
+                             const NodeID number_of_nodes,
+                             const std::vector<std::pair<NodeID, NodeID>> &edges)
+{
+    // Every edge that crosses a cell boundary needs one endpoint in the separator of that level.
+    // We greedily pick the endpoint with more cut edges, starting with the highest level.
+    std::vector<std::tuple<LevelID, NodeID, NodeID>> cut_edges;
+    std::vector<std::uint32_t> cut_degree(number_of_nodes, 0);
+    for (const auto &edge : edges)
+    {
+        const auto level = mlp.GetHighestDifferentLevel(edge.first, edge.second);
+        if (level > 0)
+        {
+            cut_edges.emplace_back(level, edge.first, edge.second);
+            cut_degree[edge.first]++;
+            cut_degree[edge.second]++;
+        }
+    }
+    tbb::parallel_sort(cut_edges.begin(), cut_edges.end(), [](const auto &lhs, const auto &rhs) {
+        return std::get<0>(lhs) > std::get<0>(rhs);
+    });
+
+    std::vector<LevelID> separator_level(number_of_nodes, 0);
+    for (const auto &cut_edge : cut_edges)
+    {
+        LevelID level;
+        NodeID first, second;
+        std::tie(level, first, second) = cut_edge;
+        if (separator_level[first] >= level || separator_level[second] >= level)
+            continue;
+
+        const auto separator_node = cut_degree[first] >= cut_degree[second] ? first : second;
+        separator_level[separator_node] = level;
+    }
+
+    const auto number_of_levels = mlp.GetNumberOfLevels();
+    std::vector<NodeID> order(number_of_nodes);
+    std::iota(order.begin(), order.end(), 0);
+    tbb::parallel_sort(order.begin(), order.end(), [&](const NodeID lhs, const NodeID rhs) {
+        if (separator_level[lhs] != separator_level[rhs])
+            return separator_level[lhs] < separator_level[rhs];
+
+        for (LevelID level = number_of_levels - 1; level > 0; --level)
+        {
+            const auto lhs_cell = mlp.GetCell(level, lhs);
+            const auto rhs_cell = mlp.GetCell(level, rhs);
+            if (lhs_cell != rhs_cell)
+                return lhs_cell < rhs_cell;
+        }
+        return lhs < rhs;
+    });
+
+    const auto number_of_separator_nodes =
+        std::count_if(separator_level.begin(), separator_level.end(), [](const auto level) {
+            return level > 0;
+        });
+    util::Log() << "Nested dissection order has " << number_of_separator_nodes
+                << " separator nodes.";
+
+    return order;
+}
+
+CCHTopology buildCCHTopology(std::vector<NodeID> order,
+                             const std::vector<std::pair<NodeID, NodeID>> &edges)
+{
+    const auto number_of_nodes = order.size();
+    std::vector<NodeID> rank(number_of_nodes);
+    for (const auto node_rank : util::irange<NodeID>(0, number_of_nodes))
+    {
+        rank[order[node_rank]] = node_rank;
+    }
+
+    std::vector<std::vector<NodeID>> upper_neighbours(number_of_nodes);
+    for (const auto &edge : edges)
+    {
+        if (edge.first == edge.second)
+            continue;
+
+        const auto first = rank[edge.first];
+        const auto second = rank[edge.second];
+        upper_neighbours[std::min(first, second)].push_back(std::max(first, second));
+    }
+
+    // Contracting a node connects all of its upper neighbours. Since they form a clique
+    // afterwards it is enough to add them to the lowest one of them, its parent in the
+    // elimination tree, which passes them on when it is contracted itself.
+    std::vector<EdgeID> first_out(number_of_nodes + 1, 0);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        auto &neighbours = upper_neighbours[node];
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        neighbours.shrink_to_fit();
+
+        if (!neighbours.empty())
+        {
+            auto &parent_neighbours = upper_neighbours[neighbours.front()];
+            parent_neighbours.insert(
+                parent_neighbours.end(), std::next(neighbours.begin()), neighbours.end());
+        }
+        first_out[node + 1] = first_out[node] + neighbours.size();
+    }
+
+    std::vector<NodeID> head;
+    head.reserve(first_out.back());
+    for (auto &neighbours : upper_neighbours)
+    {
+        head.insert(head.end(), neighbours.begin(), neighbours.end());
+        neighbours = {};
+    }
+
+    util::Log() << "CCH topology has " << head.size() << " arcs for " << edges.size()
+                << " input edges.";
+
+    return CCHTopology{std::move(order), std::move(first_out), std::move(head)};
+}
+}
+}
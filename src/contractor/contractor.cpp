@@ -1,16 +1,23 @@
 #include "contractor/contractor.hpp"
+#include "contractor/cch_customizer.hpp"
+#include "contractor/cch_topology.hpp"
 #include "contractor/contract_excludable_graph.hpp"
 #include "contractor/contracted_edge_container.hpp"
 #include "contractor/crc32_processor.hpp"
 #include "contractor/files.hpp"
 #include "contractor/graph_contractor.hpp"
 #include "contractor/graph_contractor_adaptors.hpp"
+#include "contractor/hub_labeling.hpp"
+#include "contractor/transit_node_routing.hpp"
+#include "contractor/unpack_shortcuts.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
 #include "extractor/files.hpp"
 #include "extractor/node_based_edge.hpp"
 
+#include "partitioner/files.hpp"
+
 #include "storage/io.hpp"
 
 #include "updater/updater.hpp"
@@ -32,9 +39,11 @@
 #include <fstream>
 #include <iterator>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <boost/assert.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include <tbb/task_scheduler_init.h>
 namespace osrm
@@ -42,6 +51,58 @@ namespace osrm
 namespace contractor
 {
 
+namespace
+{
+// The CCH topology only depends on the graph connectivity and the partition, so a cached
+// topology is reused as long as the connectivity checksum did not change.
+CCHTopology loadOrBuildCCHTopology(const ContractorConfig &config,
+                                   const EdgeID number_of_edge_based_nodes,
+                                   const std::vector<extractor::EdgeBasedEdge> &edges,
+                                   const std::uint32_t connectivity_checksum)
+{
+    CCHTopology topology;
+    if (boost::filesystem::exists(config.GetPath(".osrm.cch")))
+    {
+        std::uint32_t cached_checksum = 0;
+        files::readCCHTopology(config.GetPath(".osrm.cch"), topology, cached_checksum);
+        if (cached_checksum == connectivity_checksum &&
+            topology.GetNumberOfNodes() == number_of_edge_based_nodes)
+        {
+            util::Log() << "Reusing cached CCH topology.";
+            return topology;
+        }
+        util::Log(logWARNING) << "Ignoring outdated CCH topology "
+                              << config.GetPath(".osrm.cch").string();
+    }
+
+    if (!boost::filesystem::exists(config.GetPath(".osrm.partition")))
+    {
+        throw util::exception("CCH needs the nested dissection of " +
+                              config.GetPath(".osrm.partition").string() +
+                              ", please run osrm-partition first." + SOURCE_REF);
+    }
+
+    TIMER_START(cch_topology);
+    partitioner::MultiLevelPartition mlp;
+    partitioner::files::readPartition(config.GetPath(".osrm.partition"), mlp);
+
+    std::vector<std::pair<NodeID, NodeID>> node_pairs;
+    node_pairs.reserve(edges.size());
+    for (const auto &edge : edges)
+    {
+        node_pairs.emplace_back(edge.source, edge.target);
+    }
+
+    auto order = computeNestedDissectionOrder(mlp, number_of_edge_based_nodes, node_pairs);
+    topology = buildCCHTopology(std::move(order), node_pairs);
+    files::writeCCHTopology(config.GetPath(".osrm.cch"), topology, connectivity_checksum);
+    TIMER_STOP(cch_topology);
+    util::Log() << "Building the CCH topology took " << TIMER_SEC(cch_topology) << " sec";
+
+    return topology;
+}
+}
+
 int Contractor::Run()
 {
     tbb::task_scheduler_init init(config.requested_num_threads);
@@ -102,14 +163,94 @@ int Contractor::Run()
     QueryGraph query_graph;
     std::vector<std::vector<bool>> edge_filters;
     std::vector<std::vector<bool>> cores;
-    std::tie(query_graph, edge_filters) = contractExcludableGraph(
-        toContractorGraph(number_of_edge_based_nodes, std::move(edge_based_edge_list)),
-        std::move(node_weights),
-        std::move(node_filters));
+    if (config.use_cch)
+    {
+        const auto topology = loadOrBuildCCHTopology(
+            config, number_of_edge_based_nodes, edge_based_edge_list, connectivity_checksum);
+        std::tie(query_graph, edge_filters) =
+            customizeExcludableCCH(topology, edge_based_edge_list, node_weights, node_filters);
+    }
+    else
+    {
+        std::tie(query_graph, edge_filters) = contractExcludableGraph(
+            toContractorGraph(number_of_edge_based_nodes, std::move(edge_based_edge_list)),
+            std::move(node_weights),
+            std::move(node_filters));
+    }
     TIMER_STOP(contraction);
     util::Log() << "Contracted graph has " << query_graph.GetNumberOfEdges() << " edges.";
     util::Log() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
+    // Unpacked shortcuts are only valid for the graph they were computed on, so a stale
+    // file of a previous run is removed when they are disabled.
+    if (config.unpack_shortcuts_min_edges > 0)
+    {
+        TIMER_START(unpack_shortcuts);
+        std::vector<UnpackedShortcuts> exclude_shortcuts;
+        for (const auto &edge_filter : edge_filters)
+        {
+            exclude_shortcuts.push_back(
+                unpackShortcuts(query_graph, edge_filter, config.unpack_shortcuts_min_edges));
+            util::Log() << "Stored " << exclude_shortcuts.back().GetNumberOfShortcuts()
+                        << " unpacked shortcuts with "
+                        << exclude_shortcuts.back().GetNumberOfOriginalEdges()
+                        << " original edges.";
+        }
+        TIMER_STOP(unpack_shortcuts);
+        util::Log() << "Unpacking shortcuts took " << TIMER_SEC(unpack_shortcuts) << " sec";
+
+        std::unordered_map<std::string, std::vector<UnpackedShortcuts>> shortcuts = {
+            {metric_name, std::move(exclude_shortcuts)}};
+        files::writeUnpackedShortcuts(
+            config.GetPath(".osrm.shortcuts"), shortcuts, connectivity_checksum);
+    }
+    else if (boost::filesystem::exists(config.GetPath(".osrm.shortcuts")))
+    {
+        boost::filesystem::remove(config.GetPath(".osrm.shortcuts"));
+    }
+
+    // Hub labels are only valid for the graph they were computed on, the same as shortcuts
+    if (config.use_hub_labels)
+    {
+        TIMER_START(hub_labels);
+        std::vector<HubLabels> exclude_labels;
+        for (const auto &edge_filter : edge_filters)
+        {
+            exclude_labels.push_back(computeHubLabels(query_graph, edge_filter));
+        }
+        TIMER_STOP(hub_labels);
+        util::Log() << "Computing hub labels took " << TIMER_SEC(hub_labels) << " sec";
+
+        std::unordered_map<std::string, std::vector<HubLabels>> labels = {
+            {metric_name, std::move(exclude_labels)}};
+        files::writeHubLabels(config.GetPath(".osrm.hub_labels"), labels, connectivity_checksum);
+    }
+    else if (boost::filesystem::exists(config.GetPath(".osrm.hub_labels")))
+    {
+        boost::filesystem::remove(config.GetPath(".osrm.hub_labels"));
+    }
+
+    if (config.transit_nodes > 0)
+    {
+        TIMER_START(transit_nodes);
+        std::vector<TransitNodes> exclude_transit_nodes;
+        for (const auto &edge_filter : edge_filters)
+        {
+            exclude_transit_nodes.push_back(
+                computeTransitNodes(query_graph, edge_filter, config.transit_nodes));
+        }
+        TIMER_STOP(transit_nodes);
+        util::Log() << "Computing transit nodes took " << TIMER_SEC(transit_nodes) << " sec";
+
+        std::unordered_map<std::string, std::vector<TransitNodes>> transit_nodes = {
+            {metric_name, std::move(exclude_transit_nodes)}};
+        files::writeTransitNodes(config.GetPath(".osrm.tnr"), transit_nodes, connectivity_checksum);
+    }
+    else if (boost::filesystem::exists(config.GetPath(".osrm.tnr")))
+    {
+        boost::filesystem::remove(config.GetPath(".osrm.tnr"));
+    }
+
     std::unordered_map<std::string, ContractedMetric> metrics = {
         {metric_name, {std::move(query_graph), std::move(edge_filters)}}};
 
@@ -0,0 +1,77 @@
+#include "contractor/hierarchy_levels.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstdint>
+#include <numeric>
+
+namespace osrm
+{
+namespace contractor
+{
+
+std::vector<std::vector<NodeID>> computeHierarchyLevels(const QueryGraph &graph,
+                                                        const std::vector<bool> &edge_filter)
+{
+    const auto number_of_nodes = graph.GetNumberOfNodes();
+
+    const auto is_upward_edge = [&](const NodeID node, const EdgeID edge) {
+        return edge_filter[edge] && graph.GetTarget(edge) != node;
+    };
+
+    std::vector<std::uint32_t> remaining_upward_edges(number_of_nodes, 0);
+    std::vector<EdgeID> first_lower(number_of_nodes + 1, 0);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            if (!is_upward_edge(node, edge))
+                continue;
+            remaining_upward_edges[node]++;
+            first_lower[graph.GetTarget(edge) + 1]++;
+        }
+    }
+    std::partial_sum(first_lower.begin(), first_lower.end(), first_lower.begin());
+
+    std::vector<NodeID> lower(first_lower.back());
+    std::vector<EdgeID> insert_position(first_lower.begin(), first_lower.end() - 1);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            if (is_upward_edge(node, edge))
+                lower[insert_position[graph.GetTarget(edge)]++] = node;
+        }
+    }
+
+    std::vector<std::vector<NodeID>> levels(1);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        if (remaining_upward_edges[node] == 0)
+            levels.back().push_back(node);
+    }
+
+    while (!levels.back().empty())
+    {
+        std::vector<NodeID> next_level;
+        for (const auto upper : levels.back())
+        {
+            for (const auto index :
+                 util::irange<EdgeID>(first_lower[upper], first_lower[upper + 1]))
+            {
+                const auto node = lower[index];
+                BOOST_ASSERT(remaining_upward_edges[node] > 0);
+                if (--remaining_upward_edges[node] == 0)
+                    next_level.push_back(node);
+            }
+        }
+        levels.push_back(std::move(next_level));
+    }
+    levels.pop_back();
+
+    return levels;
+}
+}
+}
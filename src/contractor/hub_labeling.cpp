@@ -0,0 +1,142 @@
+#include "contractor/hub_labeling.hpp"
+#include "contractor/hierarchy_levels.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+using Label = std::vector<HubLabelEntry>;
+
+// Shortest weight over all common hubs of a forward and a backward label
+EdgeWeight queryLabels(const Label &forward_label, const Label &backward_label)
+{
+    EdgeWeight best = INVALID_EDGE_WEIGHT;
+    auto forward_entry = forward_label.begin();
+    auto backward_entry = backward_label.begin();
+    while (forward_entry != forward_label.end() && backward_entry != backward_label.end())
+    {
+        if (forward_entry->hub < backward_entry->hub)
+        {
+            ++forward_entry;
+        }
+        else if (forward_entry->hub > backward_entry->hub)
+        {
+            ++backward_entry;
+        }
+        else
+        {
+            best = std::min(best, forward_entry->weight + backward_entry->weight);
+            ++forward_entry;
+            ++backward_entry;
+        }
+    }
+    return best;
+}
+}
+
+HubLabels computeHubLabels(const QueryGraph &graph, const std::vector<bool> &edge_filter)
+{
+    BOOST_ASSERT(edge_filter.size() == graph.GetNumberOfEdges());
+    const auto number_of_nodes = graph.GetNumberOfNodes();
+
+    std::vector<Label> forward_labels(number_of_nodes);
+    std::vector<Label> backward_labels(number_of_nodes);
+
+    // Merges the labels of all upward neighbours into the label of the node and removes all
+    // hubs for which another hub of the label already gives a path of at most the same weight.
+    // This only reads labels of upward neighbours and their hubs, which are all complete.
+    const auto compute_label = [&](const NodeID node, const bool forward, Label &candidate) {
+        const auto &labels = forward ? forward_labels : backward_labels;
+        const auto &opposite_labels = forward ? backward_labels : forward_labels;
+
+        candidate.clear();
+        candidate.push_back(HubLabelEntry{node, 0, 0});
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            const auto target = graph.GetTarget(edge);
+            if (!edge_filter[edge] || target == node || !(forward ? data.forward : data.backward))
+                continue;
+
+            for (const auto &entry : labels[target])
+            {
+                candidate.push_back(HubLabelEntry{
+                    entry.hub, entry.weight + data.weight, entry.duration + data.duration});
+            }
+        }
+
+        std::sort(candidate.begin(), candidate.end(), [](const auto &lhs, const auto &rhs) {
+            return std::tie(lhs.hub, lhs.weight, lhs.duration) <
+                   std::tie(rhs.hub, rhs.weight, rhs.duration);
+        });
+        candidate.erase(std::unique(candidate.begin(),
+                                    candidate.end(),
+                                    [](const auto &lhs, const auto &rhs) {
+                                        return lhs.hub == rhs.hub;
+                                    }),
+                        candidate.end());
+
+        Label label;
+        for (const auto &entry : candidate)
+        {
+            const auto &hub_label = opposite_labels[entry.hub];
+            const auto covered_weight = entry.hub == node
+                                            ? INVALID_EDGE_WEIGHT
+                                            : forward ? queryLabels(candidate, hub_label)
+                                                      : queryLabels(hub_label, candidate);
+            if (entry.weight <= covered_weight)
+                label.push_back(entry);
+        }
+        label.shrink_to_fit();
+        return label;
+    };
+
+    const auto levels = computeHierarchyLevels(graph, edge_filter);
+    for (const auto &level : levels)
+    {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, level.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              Label candidate;
+                              for (auto index = range.begin(); index < range.end(); ++index)
+                              {
+                                  const auto node = level[index];
+                                  forward_labels[node] = compute_label(node, true, candidate);
+                                  backward_labels[node] = compute_label(node, false, candidate);
+                              }
+                          });
+    }
+
+    HubLabels hub_labels;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        hub_labels.Add(forward_labels[node].begin(), forward_labels[node].end());
+        hub_labels.Add(backward_labels[node].begin(), backward_labels[node].end());
+        forward_labels[node] = {};
+        backward_labels[node] = {};
+    }
+
+    util::Log() << "Hub labels have " << levels.size() << " levels and "
+                << (number_of_nodes > 0 ? hub_labels.GetNumberOfEntries() / (2 * number_of_nodes)
+                                        : 0)
+                << " hubs per label on average, stored in " << hub_labels.GetNumberOfHubBytes()
+                << " bytes of hub IDs.";
+
+    return hub_labels;
+}
+}
+}
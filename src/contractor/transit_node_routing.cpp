@@ -0,0 +1,322 @@
+#include "contractor/transit_node_routing.hpp"
+#include "contractor/hierarchy_levels.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/query_heap.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+constexpr std::uint32_t INVALID_TRANSIT_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+struct HeapData
+{
+    EdgeDuration duration;
+};
+using Heap = util::QueryHeap<NodeID, NodeID, EdgeWeight, HeapData>;
+using HeapPtr = tbb::enumerable_thread_specific<Heap>;
+
+struct AccessNode
+{
+    std::uint32_t transit_index;
+    EdgeWeight weight;
+    EdgeDuration duration;
+};
+
+struct Bucket
+{
+    NodeID node;
+    std::uint32_t column;
+    EdgeWeight weight;
+    EdgeDuration duration;
+
+    bool operator<(const Bucket &other) const
+    {
+        return std::tie(node, column) < std::tie(other.node, other.column);
+    }
+};
+
+// Upward search that calls settle(node, weight, duration) for every settled node and only
+// relaxes the edges of a node if settle returns true
+template <typename SettleCallback>
+void searchUpward(const QueryGraph &graph,
+                  const std::vector<bool> &edge_filter,
+                  Heap &heap,
+                  const NodeID source,
+                  const bool forward,
+                  SettleCallback &&settle)
+{
+    heap.Clear();
+    heap.Insert(source, 0, {0});
+    while (!heap.Empty())
+    {
+        const auto node = heap.DeleteMin();
+        const auto weight = heap.GetKey(node);
+        const auto duration = heap.GetData(node).duration;
+        if (!settle(node, weight, duration))
+            continue;
+
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            const auto target = graph.GetTarget(edge);
+            if (!edge_filter[edge] || target == node || !(forward ? data.forward : data.backward))
+                continue;
+
+            const auto to_weight = weight + data.weight;
+            const auto to_duration = duration + data.duration;
+            if (!heap.WasInserted(target))
+            {
+                heap.Insert(target, to_weight, {to_duration});
+            }
+            else if (heap.WasRemoved(target))
+            {
+                continue;
+            }
+            else if (to_weight < heap.GetKey(target))
+            {
+                heap.GetData(target).duration = to_duration;
+                heap.DecreaseKey(target, to_weight);
+            }
+            else if (to_weight == heap.GetKey(target) &&
+                     to_duration < heap.GetData(target).duration)
+            {
+                heap.GetData(target).duration = to_duration;
+            }
+        }
+    }
+}
+
+// Sorts the nodes top-down by their level and picks the first nodes that have lower neighbours.
+// All upward neighbours of a node are on an earlier level, so the selection is closed upwards.
+// Nodes without lower neighbours are never reached from another node's upward search.
+std::vector<NodeID> selectTransitNodes(const QueryGraph &graph,
+                                       const std::vector<bool> &edge_filter,
+                                       const std::size_t number_of_transit_nodes)
+{
+    std::vector<std::uint32_t> lower_degree(graph.GetNumberOfNodes(), 0);
+    for (const auto node : util::irange<NodeID>(0, graph.GetNumberOfNodes()))
+    {
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            if (edge_filter[edge] && graph.GetTarget(edge) != node)
+                lower_degree[graph.GetTarget(edge)]++;
+        }
+    }
+
+    std::vector<NodeID> transit_nodes;
+    for (auto level : computeHierarchyLevels(graph, edge_filter))
+    {
+        if (transit_nodes.size() >= number_of_transit_nodes)
+            break;
+
+        std::stable_sort(level.begin(), level.end(), [&](const NodeID lhs, const NodeID rhs) {
+            return lower_degree[lhs] > lower_degree[rhs];
+        });
+        for (const auto node : level)
+        {
+            if (transit_nodes.size() >= number_of_transit_nodes || lower_degree[node] == 0)
+                break;
+            transit_nodes.push_back(node);
+        }
+    }
+
+    return transit_nodes;
+}
+
+// Removes all access nodes for which the path over another access node is at least as good.
+// A dominated access node is never needed since the table contains the complete path.
+void pruneAccessNodes(const std::vector<EdgeWeight> &table_weights,
+                      const std::size_t table_size,
+                      const bool forward,
+                      std::vector<AccessNode> &nodes)
+{
+    std::vector<AccessNode> pruned;
+    for (const auto &node : nodes)
+    {
+        const auto is_dominated = std::any_of(nodes.begin(), nodes.end(), [&](const auto &other) {
+            if (other.transit_index == node.transit_index)
+                return false;
+            const auto table_weight =
+                forward ? table_weights[other.transit_index * table_size + node.transit_index]
+                        : table_weights[node.transit_index * table_size + other.transit_index];
+            if (table_weight == INVALID_EDGE_WEIGHT)
+                return false;
+            // ties are broken by the index to never remove both nodes
+            return std::make_pair(other.weight + table_weight, other.transit_index) <
+                   std::make_pair(node.weight, node.transit_index);
+        });
+        if (!is_dominated)
+            pruned.push_back(node);
+    }
+    nodes = std::move(pruned);
+}
+}
+
+TransitNodes computeTransitNodes(const QueryGraph &graph,
+                                 const std::vector<bool> &edge_filter,
+                                 const std::size_t number_of_transit_nodes)
+{
+    BOOST_ASSERT(edge_filter.size() == graph.GetNumberOfEdges());
+    const auto number_of_nodes = graph.GetNumberOfNodes();
+
+    auto transit_nodes = selectTransitNodes(graph, edge_filter, number_of_transit_nodes);
+    const auto table_size = transit_nodes.size();
+    std::vector<std::uint32_t> transit_index(number_of_nodes, INVALID_TRANSIT_INDEX);
+    for (const auto index : util::irange<std::size_t>(0, table_size))
+    {
+        transit_index[transit_nodes[index]] = index;
+    }
+
+    Heap heap_exemplar(number_of_nodes);
+    HeapPtr heaps(heap_exemplar);
+
+    // The table is a many-to-many CH search between all transit nodes. Since transit nodes are
+    // closed upwards their search spaces only consist of transit nodes and stay small.
+    std::vector<std::vector<Bucket>> column_buckets(table_size);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, table_size),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          auto &heap = heaps.local();
+                          for (auto column = range.begin(); column < range.end(); ++column)
+                          {
+                              searchUpward(graph,
+                                           edge_filter,
+                                           heap,
+                                           transit_nodes[column],
+                                           false,
+                                           [&](const NodeID node,
+                                               const EdgeWeight weight,
+                                               const EdgeDuration duration) {
+                                               column_buckets[column].push_back(Bucket{
+                                                   node,
+                                                   static_cast<std::uint32_t>(column),
+                                                   weight,
+                                                   duration});
+                                               return true;
+                                           });
+                          }
+                      });
+    std::vector<Bucket> buckets;
+    for (auto &column : column_buckets)
+    {
+        buckets.insert(buckets.end(), column.begin(), column.end());
+        column = {};
+    }
+    std::sort(buckets.begin(), buckets.end());
+    const auto by_node = [](const Bucket &lhs, const Bucket &rhs) { return lhs.node < rhs.node; };
+
+    std::vector<EdgeWeight> table_weights(table_size * table_size, INVALID_EDGE_WEIGHT);
+    std::vector<EdgeDuration> table_durations(table_size * table_size, MAXIMAL_EDGE_DURATION);
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, table_size),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            auto &heap = heaps.local();
+            for (auto row = range.begin(); row < range.end(); ++row)
+            {
+                searchUpward(
+                    graph,
+                    edge_filter,
+                    heap,
+                    transit_nodes[row],
+                    true,
+                    [&](const NodeID node, const EdgeWeight weight, const EdgeDuration duration) {
+                        const auto node_buckets = std::equal_range(
+                            buckets.begin(), buckets.end(), Bucket{node, 0, 0, 0}, by_node);
+                        for (auto bucket = node_buckets.first; bucket != node_buckets.second;
+                             ++bucket)
+                        {
+                            const auto index = row * table_size + bucket->column;
+                            const auto new_weight = weight + bucket->weight;
+                            const auto new_duration = duration + bucket->duration;
+                            if (std::tie(new_weight, new_duration) <
+                                std::tie(table_weights[index], table_durations[index]))
+                            {
+                                table_weights[index] = new_weight;
+                                table_durations[index] = new_duration;
+                            }
+                        }
+                        return true;
+                    });
+            }
+        });
+    buckets = {};
+
+    std::vector<std::vector<AccessNode>> forward_access(number_of_nodes);
+    std::vector<std::vector<AccessNode>> backward_access(number_of_nodes);
+    tbb::parallel_for(
+        tbb::blocked_range<NodeID>(0, number_of_nodes),
+        [&](const tbb::blocked_range<NodeID> &range) {
+            auto &heap = heaps.local();
+            for (auto node = range.begin(); node < range.end(); ++node)
+            {
+                for (const auto forward : {true, false})
+                {
+                    auto &access = forward ? forward_access[node] : backward_access[node];
+                    searchUpward(graph,
+                                 edge_filter,
+                                 heap,
+                                 node,
+                                 forward,
+                                 [&](const NodeID settled,
+                                     const EdgeWeight weight,
+                                     const EdgeDuration duration) {
+                                     if (transit_index[settled] == INVALID_TRANSIT_INDEX)
+                                         return true;
+                                     access.push_back(
+                                         AccessNode{transit_index[settled], weight, duration});
+                                     return false;
+                                 });
+                    pruneAccessNodes(table_weights, table_size, forward, access);
+                }
+            }
+        });
+
+    std::vector<std::uint64_t> access_offsets{0};
+    std::vector<std::uint32_t> access_nodes;
+    std::vector<EdgeWeight> access_weights;
+    std::vector<EdgeDuration> access_durations;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (auto *access : {&forward_access[node], &backward_access[node]})
+        {
+            for (const auto &entry : *access)
+            {
+                access_nodes.push_back(entry.transit_index);
+                access_weights.push_back(entry.weight);
+                access_durations.push_back(entry.duration);
+            }
+            access_offsets.push_back(access_nodes.size());
+            *access = {};
+        }
+    }
+
+    util::Log() << "Selected " << table_size << " transit nodes with "
+                << (number_of_nodes > 0 ? access_nodes.size() / (2 * number_of_nodes) : 0)
+                << " access nodes per node on average.";
+
+    return TransitNodes{std::move(transit_nodes),
+                        std::move(table_weights),
+                        std::move(table_durations),
+                        std::move(access_offsets),
+                        std::move(access_nodes),
+                        std::move(access_weights),
+                        std::move(access_durations)};
+}
+}
+}
@@ -4,6 +4,7 @@
 #include "storage/serialization.hpp"
 #include "storage/storage.hpp"
 
+#include "util/huge_pages.hpp"
 #include "util/log.hpp"
 #include "util/mmap_file.hpp"
 
@@ -36,6 +37,10 @@ MMapMemoryAllocator::MMapMemoryAllocator(const storage::StorageConfig &config,
         auto total_size = data_size + encoded_layout.size();
 
         mapped_memory = util::mmapFile<char>(memory_file, mapped_memory_file, total_size);
+        if (config.huge_pages && !util::AdviseHugePages(mapped_memory.data(), total_size))
+        {
+            util::Log(logWARNING) << "Huge pages are not available for " << memory_file;
+        }
 
         std::copy(encoded_layout.begin(), encoded_layout.end(), mapped_memory.data());
 
@@ -48,6 +53,10 @@ MMapMemoryAllocator::MMapMemoryAllocator(const storage::StorageConfig &config,
     else
     {
         mapped_memory = util::mmapFile<char>(memory_file, mapped_memory_file);
+        if (config.huge_pages)
+        {
+            util::AdviseHugePages(mapped_memory.data(), mapped_memory.size());
+        }
 
         storage::DataLayout layout;
         storage::io::BufferReader reader(mapped_memory.data(), mapped_memory.size());
@@ -0,0 +1,165 @@
+#include "engine/datafacade/mmap_tar_allocator.hpp"
+#include "engine/datafacade/validate_index.hpp"
+
+#include "extractor/edge_based_node_segment.hpp"
+
+#include "storage/storage.hpp"
+#include "storage/tar.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/huge_pages.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+namespace
+{
+using AllocatedRegion = storage::SharedDataIndex::AllocatedRegion;
+
+// Huge pages for file backed memory depend on the kernel and the file system, the advice is
+// silently ignored where they are not supported.
+char *mmapPrivate(const boost::filesystem::path &path,
+                  boost::iostreams::mapped_file &region,
+                  const bool huge_pages)
+{
+    try
+    {
+        boost::iostreams::mapped_file_params params;
+        params.path = path.string();
+        params.flags = boost::iostreams::mapped_file::priv;
+        region.open(params);
+        if (huge_pages)
+        {
+            util::AdviseHugePages(region.data(), region.size());
+        }
+        return region.data();
+    }
+    catch (const std::exception &exc)
+    {
+        throw util::exception(
+            boost::str(boost::format("File %1% mapping failed: %2%") % path % exc.what()) +
+            SOURCE_REF);
+    }
+}
+
+// Every block is a region of its own that starts at the data of its file in the archive.
+// Compressed files are decompressed into process memory.
+void addTarBlocks(const boost::filesystem::path &path,
+                  char *memory_ptr,
+                  std::vector<AllocatedRegion> &regions,
+                  std::vector<std::unique_ptr<char[]>> &decompressed_blocks)
+{
+    storage::tar::FileReader reader(path, storage::tar::FileReader::VerifyFingerprint);
+
+    std::vector<storage::tar::FileReader::FileEntry> entries;
+    reader.List(std::back_inserter(entries));
+
+    for (const auto &entry : entries)
+    {
+        if (entry.name.rfind(".meta") == std::string::npos)
+        {
+            storage::DataLayout layout;
+            layout.SetBlock(entry.name,
+                            storage::Block{reader.ReadElementCount64(entry.name), entry.size});
+
+            if (entry.compressed)
+            {
+                decompressed_blocks.push_back(std::make_unique<char[]>(layout.GetSizeOfLayout()));
+                reader.ReadInto(
+                    entry.name,
+                    layout.GetBlockPtr<char>(decompressed_blocks.back().get(), entry.name),
+                    entry.size);
+                regions.push_back({decompressed_blocks.back().get(), std::move(layout)});
+            }
+            else
+            {
+                regions.push_back({memory_ptr + entry.offset, std::move(layout)});
+            }
+        }
+    }
+}
+}
+
+MMapTarAllocator::MMapTarAllocator(const storage::StorageConfig &config)
+{
+    storage::Storage storage(config);
+    std::vector<AllocatedRegion> regions;
+
+    // the path of the R-tree leaves is the only block that is not stored in a file
+    {
+        const auto absolute_file_index_path =
+            boost::filesystem::absolute(config.GetPath(".osrm.fileIndex")).string();
+
+        storage::DataLayout layout;
+        layout.SetBlock("/common/rtree/file_index_path",
+                        storage::make_block<char>(absolute_file_index_path.size() + 1));
+
+        file_index_path_memory = std::make_unique<char[]>(layout.GetSizeOfLayout());
+        const auto file_index_path_ptr = layout.GetBlockPtr<char>(
+            file_index_path_memory.get(), "/common/rtree/file_index_path");
+        *std::copy(absolute_file_index_path.begin(),
+                   absolute_file_index_path.end(),
+                   file_index_path_ptr) = '\0';
+
+        regions.push_back({file_index_path_memory.get(), std::move(layout)});
+    }
+
+    auto files = storage.GetStaticFiles();
+    const auto updatable_files = storage.GetUpdatableFiles();
+    files.insert(files.end(), updatable_files.begin(), updatable_files.end());
+
+    // every mapping needs to keep its address, the regions point into them
+    mapped_files.resize(files.size() + 1);
+
+    for (const auto index : util::irange<std::size_t>(0, files.size()))
+    {
+        addTarBlocks(files[index],
+                     mmapPrivate(files[index], mapped_files[index], config.huge_pages),
+                     regions,
+                     decompressed_blocks);
+    }
+
+    if (config.rtree_leaves_in_memory)
+    {
+        const auto file_index_path = config.GetPath(".osrm.fileIndex");
+        const auto number_of_leaves = boost::filesystem::file_size(file_index_path) /
+                                      sizeof(extractor::EdgeBasedNodeSegment);
+
+        storage::DataLayout layout;
+        layout.SetBlock("/common/rtree/leaves",
+                        storage::make_block<extractor::EdgeBasedNodeSegment>(number_of_leaves));
+        char *memory_ptr =
+            number_of_leaves > 0
+                ? mmapPrivate(file_index_path, mapped_files.back(), config.huge_pages)
+                : nullptr;
+        regions.push_back({memory_ptr, std::move(layout)});
+    }
+
+    index = storage::SharedDataIndex{std::move(regions)};
+
+    validateIndex(index);
+
+    util::Log() << "Mapped " << files.size() << " files into memory";
+}
+
+MMapTarAllocator::~MMapTarAllocator() {}
+
+const storage::SharedDataIndex &MMapTarAllocator::GetIndex() { return index; }
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -0,0 +1,73 @@
+#include "engine/datafacade/numa_replica_allocator.hpp"
+#include "engine/datafacade/hot_blocks.hpp"
+
+#include "util/log.hpp"
+#include "util/numa.hpp"
+
+#include <boost/function_output_iterator.hpp>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+NUMAReplicaAllocator::NUMAReplicaAllocator(std::shared_ptr<ContiguousBlockAllocator> allocator_,
+                                           const std::size_t node,
+                                           const std::vector<unsigned> &node_cpus)
+    : allocator(std::move(allocator_))
+{
+    const auto &shared_index = allocator->GetIndex();
+
+    storage::DataLayout layout;
+    shared_index.List("", boost::make_function_output_iterator([&](const auto &name) {
+                          if (isHotBlock(name))
+                          {
+                              layout.SetBlock(name,
+                                              storage::Block{shared_index.GetBlockEntries(name),
+                                                             shared_index.GetBlockSize(name)});
+                          }
+                      }));
+
+    std::vector<std::string> names;
+    layout.List("", std::back_inserter(names));
+
+    // The first touch of a page decides its node, so the memory is allocated and filled by a
+    // thread that runs on the node.
+    std::thread copy_thread([&] {
+        if (!util::PinThreadToNUMANode(node, node_cpus))
+        {
+            util::Log(logWARNING) << "Could not pin thread to NUMA node " << node;
+        }
+
+        replica_memory.reset(new char[layout.GetSizeOfLayout()]);
+        for (const auto &name : names)
+        {
+            const auto source = shared_index.GetBlockPtr<char>(name);
+            std::copy_n(source,
+                        shared_index.GetBlockSize(name),
+                        layout.GetBlockPtr<char>(replica_memory.get(), name));
+        }
+    });
+    copy_thread.join();
+
+    util::Log() << "Replicated " << names.size() << " blocks with " << layout.GetSizeOfLayout()
+                << " bytes on NUMA node " << node;
+
+    auto regions = shared_index.GetRegions();
+    regions.push_back({replica_memory.get(), std::move(layout)});
+    index = storage::SharedDataIndex{std::move(regions)};
+}
+
+NUMAReplicaAllocator::~NUMAReplicaAllocator() {}
+
+const storage::SharedDataIndex &NUMAReplicaAllocator::GetIndex() { return index; }
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -1,7 +1,16 @@
 #include "engine/datafacade/process_memory_allocator.hpp"
+#include "engine/datafacade/shared_blocks.hpp"
 #include "storage/storage.hpp"
 
+#include "util/huge_pages.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+
 #include "boost/assert.hpp"
+#include <boost/function_output_iterator.hpp>
+
+#include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -15,17 +24,78 @@ ProcessMemoryAllocator::ProcessMemoryAllocator(const storage::StorageConfig &con
     storage::Storage storage(config);
 
     // Calculate the layout/size of the memory block
+    storage::DataLayout full_layout;
+    storage.PopulateStaticLayout(full_layout);
+    storage.PopulateUpdatableLayout(full_layout);
+
+    // Blocks that other datasets of this process might have loaded already get a memory block of
+    // their own, so a duplicate can be freed after loading
     storage::DataLayout layout;
-    storage.PopulateStaticLayout(layout);
-    storage.PopulateUpdatableLayout(layout);
+    std::vector<std::string> shareable_names;
+    full_layout.List("", boost::make_function_output_iterator([&](const auto &name) {
+                         if (isShareableBlock(name))
+                         {
+                             shareable_names.push_back(name);
+                         }
+                         else
+                         {
+                             layout.SetBlock(name,
+                                             storage::Block{full_layout.GetBlockEntries(name),
+                                                            full_layout.GetBlockSize(name)});
+                         }
+                     }));
 
-    // Allocate the memory block, then load data from files into it
-    internal_memory = std::make_unique<char[]>(layout.GetSizeOfLayout());
+    // Allocate the memory blocks, then load data from files into them. The blocks are not value
+    // initialized so that the huge page advice applies before the first page is touched.
+    const auto allocate = [&config](const std::size_t size) {
+        std::shared_ptr<char> memory(new char[size], std::default_delete<char[]>());
+        if (config.huge_pages && !util::AdviseHugePages(memory.get(), size))
+        {
+            util::Log(logWARNING) << "Transparent huge pages are not available";
+        }
+        return memory;
+    };
 
-    index = storage::SharedDataIndex({{internal_memory.get(), std::move(layout)}});
+    std::vector<storage::SharedDataIndex::AllocatedRegion> regions;
+    internal_memory = allocate(layout.GetSizeOfLayout());
+    regions.push_back({internal_memory.get(), std::move(layout)});
+    for (const auto &name : shareable_names)
+    {
+        storage::DataLayout block_layout;
+        block_layout.SetBlock(name,
+                              storage::Block{full_layout.GetBlockEntries(name),
+                                             full_layout.GetBlockSize(name)});
+        shared_memory.push_back(allocate(block_layout.GetSizeOfLayout()));
+        regions.push_back({shared_memory.back().get(), std::move(block_layout)});
+    }
+
+    index = storage::SharedDataIndex(regions);
 
     storage.PopulateStaticData(index);
     storage.PopulateUpdatableData(index);
+
+    std::uint64_t shared_bytes = 0;
+    for (const auto region_index : util::irange<std::size_t>(0, shared_memory.size()))
+    {
+        const auto &name = shareable_names[region_index];
+        auto &region = regions[region_index + 1];
+        auto memory = shareBlock(name,
+                                 shared_memory[region_index],
+                                 region.layout.GetBlockPtr<char>(region.memory_ptr, name),
+                                 region.layout.GetBlockSize(name));
+        if (memory != shared_memory[region_index])
+        {
+            shared_bytes += region.layout.GetBlockSize(name);
+            shared_memory[region_index] = std::move(memory);
+            region.memory_ptr = shared_memory[region_index].get();
+        }
+    }
+
+    if (shared_bytes > 0)
+    {
+        util::Log() << "Sharing " << shared_bytes << " bytes with other datasets";
+        index = storage::SharedDataIndex(std::move(regions));
+    }
 }
 
 ProcessMemoryAllocator::~ProcessMemoryAllocator() {}
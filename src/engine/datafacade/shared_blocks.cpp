@@ -0,0 +1,70 @@
+#include "engine/datafacade/shared_blocks.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+namespace
+{
+struct SharedBlock
+{
+    std::weak_ptr<char> memory;
+    const char *data;
+    std::size_t byte_size;
+};
+
+std::mutex shared_blocks_mutex;
+std::unordered_map<std::string, std::vector<SharedBlock>> shared_blocks;
+}
+
+bool isShareableBlock(const std::string &name)
+{
+    static const std::array<std::string, 2> prefixes = {{"/common/names/", "/common/nbn_data/"}};
+    return std::any_of(prefixes.begin(), prefixes.end(), [&](const auto &prefix) {
+        return name.compare(0, prefix.size(), prefix) == 0;
+    });
+}
+
+std::shared_ptr<char> shareBlock(const std::string &name,
+                                 std::shared_ptr<char> memory,
+                                 const char *data,
+                                 const std::size_t byte_size)
+{
+    std::lock_guard<std::mutex> lock(shared_blocks_mutex);
+
+    // blocks of datasets that were unloaded in the meantime can not be shared anymore
+    auto &candidates = shared_blocks[name];
+    candidates.erase(std::remove_if(candidates.begin(),
+                                    candidates.end(),
+                                    [](const auto &block) { return block.memory.expired(); }),
+                     candidates.end());
+
+    for (const auto &candidate : candidates)
+    {
+        if (candidate.byte_size != byte_size)
+            continue;
+
+        auto candidate_memory = candidate.memory.lock();
+        if (candidate_memory && std::memcmp(candidate.data, data, byte_size) == 0)
+        {
+            return candidate_memory;
+        }
+    }
+
+    candidates.push_back({memory, data, byte_size});
+    return memory;
+}
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -21,9 +21,16 @@ bool EngineConfig::IsValid() const
                               unlimited_or_more_than(max_locations_trip, 2) &&
                               unlimited_or_more_than(max_locations_viaroute, 2) &&
                               unlimited_or_more_than(max_results_nearest, 0) &&
-                              max_alternatives >= 0;
+                              max_alternatives >= 0 && mld_unpacking_cache_size >= 0 &&
+                              (map_matching_window == 0 || map_matching_window > 2) &&
+                              max_matching_sessions >= 0 && trip_local_search_time >= 0 &&
+                              snapping_cache_size >= 0 && snapping_cache_precision >= 0 &&
+                              snapping_cache_precision <= 6;
 
-    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) && limits_valid;
+    const bool data_source_valid = !use_mmap || (!use_shared_memory && memory_file.empty());
+
+    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) &&
+           data_source_valid && limits_valid;
 }
 }
 }
@@ -6,11 +6,15 @@
 #include "engine/api/match_parameters_tidy.hpp"
 #include "engine/map_matching/bayes_classifier.hpp"
 #include "engine/map_matching/sub_matching.hpp"
+#include "engine/warmup_thread_scope.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_util.hpp"
 #include "util/string_util.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <cstdlib>
 
 #include <algorithm>
@@ -110,6 +114,164 @@ void filterCandidates(const std::vector<util::Coordinate> &coordinates,
     }
 }
 
+// Matches the trace in consecutive windows of at most window_size locations. Each window starts
+// at the last matched location of the previous one, restricted to the candidate chosen there, so
+// its first sub matching continues the previous one. Only one window is in the hidden markov model
+// at a time, but the candidates of a window are fixed once it is matched.
+MatchPlugin::SubMatchingList
+windowedMapMatching(const RoutingAlgorithmsInterface &algorithms,
+                    const MatchPlugin::CandidateLists &candidates_lists,
+                    const api::MatchParameters &parameters,
+                    const bool allow_splitting,
+                    const std::size_t window_size,
+                    map_matching::MatchingSession *session)
+{
+    BOOST_ASSERT(window_size > 2);
+    const auto number_of_coordinates = parameters.coordinates.size();
+    const auto slice = [](const auto &values, const std::size_t begin, const std::size_t end) {
+        using Values = std::remove_const_t<std::remove_reference_t<decltype(values)>>;
+        if (values.empty())
+            return Values{};
+        return Values(values.begin() + begin, values.begin() + end);
+    };
+
+    MatchPlugin::SubMatchingList sub_matchings;
+    std::size_t window_begin = 0;
+    boost::optional<PhantomNodeWithDistance> seed;
+    while (window_begin + 1 < number_of_coordinates)
+    {
+        const auto window_end = std::min(number_of_coordinates, window_begin + window_size);
+        auto window_candidates = slice(candidates_lists, window_begin, window_end);
+        if (seed)
+        {
+            window_candidates.front() = {*seed};
+        }
+
+        auto window_matchings =
+            algorithms.MapMatching(window_candidates,
+                                   slice(parameters.coordinates, window_begin, window_end),
+                                   slice(parameters.timestamps, window_begin, window_end),
+                                   slice(parameters.radiuses, window_begin, window_end),
+                                   allow_splitting,
+                                   session);
+        for (auto &matching : window_matchings)
+        {
+            for (auto &index : matching.indices)
+                index += window_begin;
+        }
+
+        auto next_matching = window_matchings.begin();
+        if (seed && next_matching != window_matchings.end() &&
+            next_matching->indices.front() == window_begin)
+        {
+            auto &previous = sub_matchings.back();
+            BOOST_ASSERT(previous.indices.back() == window_begin);
+            const auto previous_legs = previous.indices.size() - 1;
+            const auto next_legs = next_matching->indices.size() - 1;
+            previous.confidence =
+                (previous.confidence * previous_legs + next_matching->confidence * next_legs) /
+                (previous_legs + next_legs);
+            // the first location is shared with the previous window
+            previous.nodes.insert(previous.nodes.end(),
+                                  std::next(next_matching->nodes.begin()),
+                                  next_matching->nodes.end());
+            previous.indices.insert(previous.indices.end(),
+                                    std::next(next_matching->indices.begin()),
+                                    next_matching->indices.end());
+            previous.alternatives_count.insert(previous.alternatives_count.end(),
+                                               std::next(next_matching->alternatives_count.begin()),
+                                               next_matching->alternatives_count.end());
+            ++next_matching;
+        }
+        sub_matchings.insert(sub_matchings.end(),
+                             std::make_move_iterator(next_matching),
+                             std::make_move_iterator(window_matchings.end()));
+
+        if (window_end == number_of_coordinates)
+        {
+            break;
+        }
+
+        if (!sub_matchings.empty() && sub_matchings.back().indices.back() > window_begin)
+        {
+            const auto last_index = sub_matchings.back().indices.back();
+            const auto &last_node = sub_matchings.back().nodes.back();
+            seed = PhantomNodeWithDistance{last_node,
+                                           util::coordinate_calculation::haversineDistance(
+                                               parameters.coordinates[last_index],
+                                               last_node.location)};
+            window_begin = last_index;
+        }
+        else
+        {
+            seed = boost::none;
+            window_begin = window_end;
+        }
+    }
+
+    return sub_matchings;
+}
+
+// Candidates of locations that were part of the previous request of the session are reused.
+// Locations with hints are always looked up, that is cheap.
+MatchPlugin::CandidateLists
+MatchPlugin::GetSessionCandidates(const datafacade::BaseDataFacade &facade,
+                                  const api::MatchParameters &parameters,
+                                  const std::vector<double> &search_radiuses,
+                                  map_matching::MatchingSession &session,
+                                  SnappingCache &snapping_cache) const
+{
+    const auto number_of_coordinates = parameters.coordinates.size();
+    CandidateLists candidates_lists(number_of_coordinates);
+
+    api::MatchParameters missing_parameters;
+    std::vector<double> missing_radiuses;
+    std::vector<std::size_t> missing_indices;
+    std::vector<boost::optional<map_matching::CandidatesKey>> keys(number_of_coordinates);
+    for (const auto index : util::irange<std::size_t>(0UL, number_of_coordinates))
+    {
+        const auto has_hint = !parameters.hints.empty() && parameters.hints[index];
+        if (!has_hint)
+        {
+            keys[index] = map_matching::CandidatesKey{
+                parameters.coordinates[index],
+                search_radiuses[index],
+                parameters.bearings.empty() ? boost::none : parameters.bearings[index],
+                parameters.approaches.empty() || !parameters.approaches[index]
+                    ? Approach::UNRESTRICTED
+                    : *parameters.approaches[index]};
+
+            if (auto candidates = session.FindCandidates(*keys[index]))
+            {
+                candidates_lists[index] = std::move(*candidates);
+                continue;
+            }
+        }
+
+        missing_indices.push_back(index);
+        missing_radiuses.push_back(search_radiuses[index]);
+        missing_parameters.coordinates.push_back(parameters.coordinates[index]);
+        if (!parameters.hints.empty())
+            missing_parameters.hints.push_back(parameters.hints[index]);
+        if (!parameters.bearings.empty())
+            missing_parameters.bearings.push_back(parameters.bearings[index]);
+        if (!parameters.approaches.empty())
+            missing_parameters.approaches.push_back(parameters.approaches[index]);
+    }
+
+    auto missing_candidates =
+        GetPhantomNodesInRange(facade, missing_parameters, missing_radiuses, snapping_cache);
+    for (const auto missing_index : util::irange<std::size_t>(0UL, missing_indices.size()))
+    {
+        const auto index = missing_indices[missing_index];
+        if (keys[index])
+            session.InsertCandidates(*keys[index], missing_candidates[missing_index]);
+        candidates_lists[index] = std::move(missing_candidates[missing_index]);
+    }
+
+    return candidates_lists;
+}
+
 Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                   const api::MatchParameters &parameters,
                                   util::json::Object &json_result) const
@@ -213,7 +375,23 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                        });
     }
 
-    auto candidates_lists = GetPhantomNodesInRange(facade, tidied.parameters, search_radiuses);
+    std::shared_ptr<map_matching::MatchingSession> session;
+    std::unique_lock<std::mutex> session_lock;
+    if (!parameters.session.empty() && sessions.IsEnabled())
+    {
+        session = sessions.FindOrInsert(parameters.session, [] {
+            return std::make_shared<map_matching::MatchingSession>();
+        });
+        session_lock = std::unique_lock<std::mutex>(session->mutex);
+        session->Reset(facade.GetGeneration());
+    }
+
+    auto &snapping_cache = algorithms.GetSnappingCache();
+    auto candidates_lists =
+        session
+            ? GetSessionCandidates(
+                  facade, tidied.parameters, search_radiuses, *session, snapping_cache)
+            : GetPhantomNodesInRange(facade, tidied.parameters, search_radiuses, snapping_cache);
 
     filterCandidates(tidied.parameters.coordinates, candidates_lists);
     if (std::all_of(candidates_lists.begin(),
@@ -222,18 +400,41 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                         return candidates.empty();
                     }))
     {
+        if (session)
+            session->Age();
         return Error("NoSegment",
                      std::string("Could not find a matching segment for any coordinate."),
                      json_result);
     }
 
     // call the actual map matching
-    sub_matchings =
-        algorithms.MapMatching(candidates_lists,
-                               tidied.parameters.coordinates,
-                               tidied.parameters.timestamps,
-                               tidied.parameters.radiuses,
-                               parameters.gaps == api::MatchParameters::GapsType::Split);
+    const auto allow_splitting = parameters.gaps == api::MatchParameters::GapsType::Split;
+    if (map_matching_window > 0 &&
+        tidied.parameters.coordinates.size() > static_cast<std::size_t>(map_matching_window))
+    {
+        sub_matchings = windowedMapMatching(algorithms,
+                                            candidates_lists,
+                                            tidied.parameters,
+                                            allow_splitting,
+                                            map_matching_window,
+                                            session.get());
+    }
+    else
+    {
+        sub_matchings = algorithms.MapMatching(candidates_lists,
+                                               tidied.parameters.coordinates,
+                                               tidied.parameters.timestamps,
+                                               tidied.parameters.radiuses,
+                                               allow_splitting,
+                                               session.get());
+    }
+
+    // the session only keeps what this request used
+    if (session)
+    {
+        session->Age();
+        session_lock.unlock();
+    }
 
     if (sub_matchings.size() == 0)
     {
@@ -267,49 +468,58 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     BOOST_ASSERT(parameters.waypoints.empty() || sub_matchings.size() == 1);
     const auto collapse_legs = !parameters.waypoints.empty();
 
-    // each sub_route will correspond to a MatchObject
+    // each sub_route will correspond to a MatchObject, the sub matchings are independent and
+    // each thread uses its own search heaps, the workers of a warm-up query warm up as well
     std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
-    for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
-    {
-        BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
-
-        // FIXME we only run this to obtain the geometry
-        // The clean way would be to get this directly from the map matching plugin
-        PhantomNodes current_phantom_node_pair;
-        for (unsigned i = 0; i < sub_matchings[index].nodes.size() - 1; ++i)
-        {
-            current_phantom_node_pair.source_phantom = sub_matchings[index].nodes[i];
-            current_phantom_node_pair.target_phantom = sub_matchings[index].nodes[i + 1];
-            BOOST_ASSERT(current_phantom_node_pair.source_phantom.IsValid());
-            BOOST_ASSERT(current_phantom_node_pair.target_phantom.IsValid());
-            sub_routes[index].segment_end_coordinates.emplace_back(current_phantom_node_pair);
-        }
-        // force uturns to be on
-        // we split the phantom nodes anyway and only have bi-directional phantom nodes for
-        // possible uturns
-        sub_routes[index] =
-            algorithms.ShortestPathSearch(sub_routes[index].segment_end_coordinates, {false});
-        BOOST_ASSERT(sub_routes[index].shortest_path_weight != INVALID_EDGE_WEIGHT);
-        if (collapse_legs)
-        {
-            std::vector<bool> waypoint_legs;
-            waypoint_legs.reserve(sub_matchings[index].indices.size());
-            for (unsigned i = 0, j = 0; i < sub_matchings[index].indices.size(); ++i)
+    const auto warmup_thread = WarmupThreadScope::IsActive();
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0UL, sub_matchings.size()),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            const WarmupThreadScope warmup_scope(warmup_thread);
+            for (auto index = range.begin(); index < range.end(); ++index)
             {
-                auto current_wp = tidied.parameters.waypoints[j];
-                if (current_wp == sub_matchings[index].indices[i])
+                BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
+
+                // FIXME we only run this to obtain the geometry
+                // The clean way would be to get this directly from the map matching plugin
+                PhantomNodes current_phantom_node_pair;
+                for (unsigned i = 0; i < sub_matchings[index].nodes.size() - 1; ++i)
                 {
-                    waypoint_legs.push_back(true);
-                    ++j;
+                    current_phantom_node_pair.source_phantom = sub_matchings[index].nodes[i];
+                    current_phantom_node_pair.target_phantom = sub_matchings[index].nodes[i + 1];
+                    BOOST_ASSERT(current_phantom_node_pair.source_phantom.IsValid());
+                    BOOST_ASSERT(current_phantom_node_pair.target_phantom.IsValid());
+                    sub_routes[index].segment_end_coordinates.emplace_back(
+                        current_phantom_node_pair);
                 }
-                else
+                // force uturns to be on
+                // we split the phantom nodes anyway and only have bi-directional phantom nodes for
+                // possible uturns
+                sub_routes[index] = algorithms.ShortestPathSearch(
+                    sub_routes[index].segment_end_coordinates, {false});
+                BOOST_ASSERT(sub_routes[index].shortest_path_weight != INVALID_EDGE_WEIGHT);
+                if (collapse_legs)
                 {
-                    waypoint_legs.push_back(false);
+                    std::vector<bool> waypoint_legs;
+                    waypoint_legs.reserve(sub_matchings[index].indices.size());
+                    for (unsigned i = 0, j = 0; i < sub_matchings[index].indices.size(); ++i)
+                    {
+                        auto current_wp = tidied.parameters.waypoints[j];
+                        if (current_wp == sub_matchings[index].indices[i])
+                        {
+                            waypoint_legs.push_back(true);
+                            ++j;
+                        }
+                        else
+                        {
+                            waypoint_legs.push_back(false);
+                        }
+                    }
+                    sub_routes[index] =
+                        CollapseInternalRouteResult(sub_routes[index], waypoint_legs);
                 }
             }
-            sub_routes[index] = CollapseInternalRouteResult(sub_routes[index], waypoint_legs);
-        }
-    }
+        });
 
     api::MatchAPI match_api{facade, parameters, tidied};
     match_api.MakeResponse(sub_matchings, sub_routes, json_result);
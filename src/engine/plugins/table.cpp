@@ -70,7 +70,7 @@ Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
         return Status::Error;
 
     const auto &facade = algorithms.GetFacade();
-    auto phantom_nodes = GetPhantomNodes(facade, params);
+    auto phantom_nodes = GetPhantomNodes(facade, params, algorithms.GetSnappingCache());
 
     if (phantom_nodes.size() != params.coordinates.size())
     {
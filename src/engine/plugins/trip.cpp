@@ -4,6 +4,7 @@
 #include "engine/api/trip_parameters.hpp"
 #include "engine/trip/trip_brute_force.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_local_search.hpp"
 #include "engine/trip/trip_nearest_neighbour.hpp"
 #include "util/dist_table_wrapper.hpp" // to access the dist table more easily
 #include "util/json_container.hpp"
@@ -11,6 +12,7 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <iterator>
 #include <limits>
@@ -195,7 +197,8 @@ Status TripPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
         return Status::Error;
 
     const auto &facade = algorithms.GetFacade();
-    auto phantom_node_pairs = GetPhantomNodes(facade, parameters);
+    auto phantom_node_pairs =
+        GetPhantomNodes(facade, parameters, algorithms.GetSnappingCache());
     if (phantom_node_pairs.size() != number_of_locations)
     {
         return Error("NoSegment",
@@ -252,6 +255,13 @@ Status TripPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     else
     {
         duration_trip = trip::FarthestInsertionTrip(number_of_locations, result_duration_table);
+        if (trip_local_search_time > 0)
+        {
+            duration_trip =
+                trip::LocalSearchTrip(std::move(duration_trip),
+                                      result_duration_table,
+                                      std::chrono::milliseconds(trip_local_search_time));
+        }
     }
 
     // rotate result such that roundtrip starts at node with index 0
@@ -77,7 +77,8 @@ Status ViaRoutePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithm
         return Status::Error;
 
     const auto &facade = algorithms.GetFacade();
-    auto phantom_node_pairs = GetPhantomNodes(facade, route_parameters);
+    auto phantom_node_pairs =
+        GetPhantomNodes(facade, route_parameters, algorithms.GetSnappingCache());
     if (phantom_node_pairs.size() != route_parameters.coordinates.size())
     {
         return Error("NoSegment",
@@ -604,39 +604,22 @@ void unpackPackedPaths(InputIt first,
                 CellID parent_cell_id = partition.GetCell(level, source);
                 BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
 
-                LevelID sublevel = level - 1;
-
-                // Here heaps can be reused, let's go deeper!
-                forward_heap.Clear();
-                reverse_heap.Clear();
-                forward_heap.Insert(source, 0, {source});
-                reverse_heap.Insert(target, 0, {target});
-
                 BOOST_ASSERT(!facade.ExcludeNode(source));
                 BOOST_ASSERT(!facade.ExcludeNode(target));
 
-                // TODO: when structured bindings will be allowed change to
-                // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
-                EdgeWeight subpath_weight;
-                std::vector<NodeID> subpath_nodes;
-                std::vector<EdgeID> subpath_edges;
-                std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(search_engine_data,
-                                                                                facade,
-                                                                                forward_heap,
-                                                                                reverse_heap,
-                                                                                DO_NOT_FORCE_LOOPS,
-                                                                                DO_NOT_FORCE_LOOPS,
-                                                                                INVALID_EDGE_WEIGHT,
-                                                                                sublevel,
-                                                                                parent_cell_id);
-                BOOST_ASSERT(!subpath_edges.empty());
-                BOOST_ASSERT(subpath_nodes.size() > 1);
-                BOOST_ASSERT(subpath_nodes.front() == source);
-                BOOST_ASSERT(subpath_nodes.back() == target);
-                unpacked_nodes.insert(
-                    unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
-                unpacked_edges.insert(
-                    unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+                unpackOverlayEdge(search_engine_data,
+                                  facade,
+                                  forward_heap,
+                                  reverse_heap,
+                                  DO_NOT_FORCE_LOOPS,
+                                  DO_NOT_FORCE_LOOPS,
+                                  INVALID_EDGE_WEIGHT,
+                                  level,
+                                  parent_cell_id,
+                                  source,
+                                  target,
+                                  unpacked_nodes,
+                                  unpacked_edges);
             }
         }
 
@@ -4,8 +4,12 @@
 #include <boost/assert.hpp>
 #include <boost/range/iterator_range_core.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <tuple>
+#include <unordered_set>
 #include <vector>
 
 namespace osrm
@@ -157,6 +161,300 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
         facade, node, target_weight, target_duration, query_heap, phantom_node);
 }
 
+// Many-to-many search on the hub labels of the phantom nodes. This works the same way as the
+// bucket search: the backward labels of all targets fill the buckets, which are then scanned
+// for every hub of the forward labels of a source. No graph search is needed at all.
+std::vector<EdgeDuration>
+hubLabelManyToManySearch(const DataFacade<Algorithm> &facade,
+                         const std::vector<PhantomNode> &phantom_nodes,
+                         const std::vector<std::size_t> &source_indices,
+                         const std::vector<std::size_t> &target_indices)
+{
+    const auto &hub_labels = facade.GetHubLabels();
+    const auto number_of_targets = target_indices.size();
+    const auto number_of_entries = source_indices.size() * number_of_targets;
+
+    std::vector<EdgeWeight> weights_table(number_of_entries, INVALID_EDGE_WEIGHT);
+    std::vector<EdgeDuration> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
+
+    std::vector<NodeBucket> hub_buckets;
+    const auto add_target = [&](const unsigned column_index,
+                                const NodeID node,
+                                const EdgeWeight weight,
+                                const EdgeDuration duration) {
+        hub_labels.ForEachHub(node,
+                              false,
+                              [&](const NodeID hub,
+                                  const EdgeWeight hub_weight,
+                                  const EdgeDuration hub_duration) {
+                                  hub_buckets.emplace_back(hub,
+                                                           node,
+                                                           column_index,
+                                                           weight + hub_weight,
+                                                           duration + hub_duration);
+                              });
+    };
+
+    for (const auto column_index : util::irange<unsigned>(0, number_of_targets))
+    {
+        const auto &phantom = phantom_nodes[target_indices[column_index]];
+        if (phantom.IsValidForwardTarget())
+        {
+            add_target(column_index,
+                       phantom.forward_segment_id.id,
+                       phantom.GetForwardWeightPlusOffset(),
+                       phantom.GetForwardDuration());
+        }
+        if (phantom.IsValidReverseTarget())
+        {
+            add_target(column_index,
+                       phantom.reverse_segment_id.id,
+                       phantom.GetReverseWeightPlusOffset(),
+                       phantom.GetReverseDuration());
+        }
+    }
+    std::sort(hub_buckets.begin(), hub_buckets.end());
+
+    const auto add_source = [&](const std::size_t row_index,
+                                const NodeID node,
+                                const EdgeWeight weight,
+                                const EdgeDuration duration) {
+        hub_labels.ForEachHub(
+            node,
+            true,
+            [&](const NodeID hub, const EdgeWeight hub_weight, const EdgeDuration hub_duration) {
+                const auto bucket_list = std::equal_range(
+                    hub_buckets.begin(), hub_buckets.end(), hub, NodeBucket::Compare());
+                for (const auto &current_bucket : boost::make_iterator_range(bucket_list))
+                {
+                    const auto index = row_index * number_of_targets + current_bucket.column_index;
+                    auto &current_weight = weights_table[index];
+                    auto &current_duration = durations_table[index];
+
+                    auto new_weight = weight + hub_weight + current_bucket.weight;
+                    auto new_duration = duration + hub_duration + current_bucket.duration;
+
+                    if (new_weight < 0)
+                    {
+                        if (addLoopWeight(facade, hub, new_weight, new_duration))
+                        {
+                            current_weight = std::min(current_weight, new_weight);
+                            current_duration = std::min(current_duration, new_duration);
+                        }
+                    }
+                    else if (std::tie(new_weight, new_duration) <
+                             std::tie(current_weight, current_duration))
+                    {
+                        current_weight = new_weight;
+                        current_duration = new_duration;
+                    }
+                }
+            });
+    };
+
+    for (const auto row_index : util::irange<std::size_t>(0, source_indices.size()))
+    {
+        const auto &phantom = phantom_nodes[source_indices[row_index]];
+        if (phantom.IsValidForwardSource())
+        {
+            add_source(row_index,
+                       phantom.forward_segment_id.id,
+                       -phantom.GetForwardWeightPlusOffset(),
+                       -phantom.GetForwardDuration());
+        }
+        if (phantom.IsValidReverseSource())
+        {
+            add_source(row_index,
+                       phantom.reverse_segment_id.id,
+                       -phantom.GetReverseWeightPlusOffset(),
+                       -phantom.GetReverseDuration());
+        }
+    }
+
+    return durations_table;
+}
+
+// Many-to-many search on the transit node table. The shortest path between a source and a target
+// that passes a transit node is the best combination of a forward access node of the source,
+// the table entry and a backward access node of the target. Paths that stay below the transit
+// nodes are not covered: their highest node is reached by upward edges from both the source and
+// the target without passing a transit node. Rows with a target whose local search space meets
+// the one of the source, or without a path over transit nodes, are returned for a graph search.
+std::pair<std::vector<EdgeDuration>, std::vector<std::size_t>>
+transitNodeManyToManySearch(const DataFacade<Algorithm> &facade,
+                            const std::vector<PhantomNode> &phantom_nodes,
+                            const std::vector<std::size_t> &source_indices,
+                            const std::vector<std::size_t> &target_indices)
+{
+    const auto &transit_nodes = facade.GetTransitNodes();
+    const auto number_of_targets = target_indices.size();
+
+    struct AccessEntry
+    {
+        std::uint32_t transit_index;
+        EdgeWeight weight;
+        EdgeDuration duration;
+    };
+    const auto add_access = [&](std::vector<AccessEntry> &access,
+                                const NodeID node,
+                                const bool forward,
+                                const EdgeWeight weight,
+                                const EdgeDuration duration) {
+        transit_nodes.ForEachAccessNode(
+            node,
+            forward,
+            [&](const std::uint32_t transit_index,
+                const EdgeWeight access_weight,
+                const EdgeDuration access_duration) {
+                access.push_back(
+                    AccessEntry{transit_index, weight + access_weight, duration + access_duration});
+            });
+    };
+
+    // Sorted nodes of the phantom segments and all non-transit nodes reachable from them by
+    // upward edges that don't continue at transit nodes
+    const auto local_search_space = [&](const PhantomNode &phantom, const bool forward) {
+        std::vector<NodeID> search_space;
+        for (const auto &segment : {phantom.forward_segment_id, phantom.reverse_segment_id})
+        {
+            if (segment.enabled)
+                search_space.push_back(segment.id);
+        }
+        std::unordered_set<NodeID> visited(search_space.begin(), search_space.end());
+        std::vector<NodeID> stack(search_space);
+        while (!stack.empty())
+        {
+            const auto node = stack.back();
+            stack.pop_back();
+            if (transit_nodes.IsTransitNode(node))
+                continue;
+
+            for (const auto edge : facade.GetAdjacentEdgeRange(node))
+            {
+                const auto &data = facade.GetEdgeData(edge);
+                const NodeID to = facade.GetTarget(edge);
+                if ((forward ? data.forward : data.backward) && visited.insert(to).second &&
+                    !transit_nodes.IsTransitNode(to))
+                {
+                    search_space.push_back(to);
+                    stack.push_back(to);
+                }
+            }
+        }
+        std::sort(search_space.begin(), search_space.end());
+        return search_space;
+    };
+    const auto intersect = [](const std::vector<NodeID> &lhs, const std::vector<NodeID> &rhs) {
+        auto lhs_iter = lhs.begin(), rhs_iter = rhs.begin();
+        while (lhs_iter != lhs.end() && rhs_iter != rhs.end())
+        {
+            if (*lhs_iter == *rhs_iter)
+                return true;
+            if (*lhs_iter < *rhs_iter)
+                ++lhs_iter;
+            else
+                ++rhs_iter;
+        }
+        return false;
+    };
+
+    std::vector<std::vector<AccessEntry>> target_access(number_of_targets);
+    std::vector<std::vector<NodeID>> target_search_spaces(number_of_targets);
+    for (const auto column_index : util::irange<std::size_t>(0, number_of_targets))
+    {
+        const auto &phantom = phantom_nodes[target_indices[column_index]];
+        target_search_spaces[column_index] = local_search_space(phantom, false);
+        if (phantom.IsValidForwardTarget())
+        {
+            add_access(target_access[column_index],
+                       phantom.forward_segment_id.id,
+                       false,
+                       phantom.GetForwardWeightPlusOffset(),
+                       phantom.GetForwardDuration());
+        }
+        if (phantom.IsValidReverseTarget())
+        {
+            add_access(target_access[column_index],
+                       phantom.reverse_segment_id.id,
+                       false,
+                       phantom.GetReverseWeightPlusOffset(),
+                       phantom.GetReverseDuration());
+        }
+    }
+
+    std::vector<EdgeDuration> durations_table(source_indices.size() * number_of_targets,
+                                              MAXIMAL_EDGE_DURATION);
+    std::vector<std::size_t> local_rows;
+    std::vector<AccessEntry> source_access;
+    for (const auto row_index : util::irange<std::size_t>(0, source_indices.size()))
+    {
+        const auto &source_phantom = phantom_nodes[source_indices[row_index]];
+        const auto source_search_space = local_search_space(source_phantom, true);
+        const auto has_local_target = std::any_of(
+            target_search_spaces.begin(),
+            target_search_spaces.end(),
+            [&](const auto &target_search_space) {
+                return intersect(source_search_space, target_search_space);
+            });
+        if (has_local_target)
+        {
+            local_rows.push_back(row_index);
+            continue;
+        }
+
+        source_access.clear();
+        if (source_phantom.IsValidForwardSource())
+        {
+            add_access(source_access,
+                       source_phantom.forward_segment_id.id,
+                       true,
+                       -source_phantom.GetForwardWeightPlusOffset(),
+                       -source_phantom.GetForwardDuration());
+        }
+        if (source_phantom.IsValidReverseSource())
+        {
+            add_access(source_access,
+                       source_phantom.reverse_segment_id.id,
+                       true,
+                       -source_phantom.GetReverseWeightPlusOffset(),
+                       -source_phantom.GetReverseDuration());
+        }
+
+        bool is_covered = true;
+        for (const auto column_index : util::irange<std::size_t>(0, number_of_targets))
+        {
+            std::pair<EdgeWeight, EdgeDuration> best{INVALID_EDGE_WEIGHT, MAXIMAL_EDGE_DURATION};
+            for (const auto &source_entry : source_access)
+            {
+                for (const auto &target_entry : target_access[column_index])
+                {
+                    const auto entry = transit_nodes.GetTableEntry(source_entry.transit_index,
+                                                                   target_entry.transit_index);
+                    if (entry.first == INVALID_EDGE_WEIGHT)
+                        continue;
+                    best = std::min(best,
+                                    std::make_pair(source_entry.weight + entry.first +
+                                                       target_entry.weight,
+                                                   source_entry.duration + entry.second +
+                                                       target_entry.duration));
+                }
+            }
+
+            if (best.first == INVALID_EDGE_WEIGHT || best.first < 0)
+            {
+                is_covered = false;
+                break;
+            }
+            durations_table[row_index * number_of_targets + column_index] = best.second;
+        }
+
+        if (!is_covered)
+            local_rows.push_back(row_index);
+    }
+
+    return std::make_pair(std::move(durations_table), std::move(local_rows));
+}
+
 } // namespace ch
 
 void retrievePackedPathFromSearchSpace(const NodeID middle_node_id,
@@ -313,18 +611,232 @@ void calculateDistances(typename SearchEngineData<ch::Algorithm>::ManyToManyQuer
     }
 }
 
-template <>
-std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
-manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
-                 const DataFacade<ch::Algorithm> &facade,
-                 const std::vector<PhantomNode> &phantom_nodes,
-                 const std::vector<std::size_t> &source_indices,
-                 const std::vector<std::size_t> &target_indices,
-                 const bool calculate_distance,
-                 const bool calculate_duration)
+namespace ch
 {
-    (void)calculate_duration; // TODO: stub to use when computing durations become optional
+namespace
+{
+// Relaxes like the point-to-point search: equal weights keep the first parent. Nodes that are
+// reached by a second path of the same weight are stored in tied_nodes.
+template <bool DIRECTION>
+void relaxOutgoingEdgesWithTies(const DataFacade<Algorithm> &facade,
+                                const NodeID node,
+                                const EdgeWeight weight,
+                                SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
+                                std::unordered_set<NodeID> &tied_nodes)
+{
+    if (stallAtNode<DIRECTION>(facade, node, weight, query_heap))
+    {
+        return;
+    }
+
+    for (const auto edge : facade.GetAdjacentEdgeRange(node))
+    {
+        const auto &data = facade.GetEdgeData(edge);
+        if (DIRECTION == FORWARD_DIRECTION ? data.forward : data.backward)
+        {
+            const NodeID to = facade.GetTarget(edge);
+            const auto to_weight = weight + data.weight;
+
+            if (!query_heap.WasInserted(to))
+            {
+                query_heap.Insert(to, to_weight, {node, 0});
+            }
+            else if (to_weight < query_heap.GetKey(to))
+            {
+                query_heap.GetData(to) = {node, 0};
+                query_heap.DecreaseKey(to, to_weight);
+                tied_nodes.erase(to);
+            }
+            else if (to_weight == query_heap.GetKey(to) && query_heap.GetData(to).parent != node)
+            {
+                tied_nodes.insert(to);
+            }
+        }
+    }
+}
+}
+
+std::vector<double> getNetworkDistances(SearchEngineData<Algorithm> &engine_working_data,
+                                        const DataFacade<Algorithm> &facade,
+                                        const std::vector<PhantomNode> &source_phantoms,
+                                        const std::vector<PhantomNode> &target_phantoms,
+                                        const EdgeWeight weight_upper_bound)
+{
+    const auto number_of_targets = target_phantoms.size();
+    std::vector<double> distances(source_phantoms.size() * number_of_targets,
+                                  std::numeric_limits<double>::max());
+
+    // The bidirectional search stops each direction with the smallest source offset,
+    // the backward searches use the smallest one of all sources to cover every pair
+    EdgeWeight min_source_offset = 0;
+    for (const auto &phantom : source_phantoms)
+    {
+        if (phantom.IsValidForwardSource())
+            min_source_offset = std::min(min_source_offset, -phantom.GetForwardWeightPlusOffset());
+        if (phantom.IsValidReverseSource())
+            min_source_offset = std::min(min_source_offset, -phantom.GetReverseWeightPlusOffset());
+    }
+
+    // A settled node is ambiguous if it or a node on its path to the phantom was reached by two
+    // paths of equal weight. The point-to-point search may pick another one of them, so pairs
+    // with an ambiguous shortest path are computed with getNetworkDistance.
+    std::unordered_set<NodeID> tied_nodes;
+    std::vector<NodeBucket> search_space_with_buckets;
+    std::vector<std::pair<NodeID, unsigned>> ambiguous_buckets;
+    std::unordered_set<NodeID> ambiguous_nodes;
+    for (const auto column_index : util::irange<unsigned>(0, number_of_targets))
+    {
+        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+            facade.GetNumberOfNodes());
+        auto &query_heap = *(engine_working_data.many_to_many_heap);
+        insertTargetInHeap(query_heap, target_phantoms[column_index]);
+        tied_nodes.clear();
+        ambiguous_nodes.clear();
+
+        while (!query_heap.Empty() && query_heap.MinKey() + min_source_offset <= weight_upper_bound)
+        {
+            const auto node = query_heap.DeleteMin();
+            const auto weight = query_heap.GetKey(node);
+            const auto parent = query_heap.GetData(node).parent;
+            search_space_with_buckets.emplace_back(node, parent, column_index, weight, 0);
+            if (tied_nodes.count(node) > 0 || (parent != node && ambiguous_nodes.count(parent) > 0))
+            {
+                ambiguous_nodes.insert(node);
+                ambiguous_buckets.emplace_back(node, column_index);
+            }
+
+            relaxOutgoingEdgesWithTies<REVERSE_DIRECTION>(
+                facade, node, weight, query_heap, tied_nodes);
+        }
+    }
+    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    std::sort(ambiguous_buckets.begin(), ambiguous_buckets.end());
+
+    std::vector<EdgeWeight> weights(number_of_targets);
+    std::vector<NodeID> middle_nodes(number_of_targets);
+    std::vector<bool> is_ambiguous(number_of_targets);
+    std::vector<bool> needs_loop(number_of_targets);
+    std::vector<NodeID> packed_leg;
+    std::vector<PathData> unpacked_path;
+    bool point_to_point_heaps_initialized = false;
+    for (const auto row_index : util::irange<std::size_t>(0, source_phantoms.size()))
+    {
+        const auto &source_phantom = source_phantoms[row_index];
+
+        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+            facade.GetNumberOfNodes());
+        auto &query_heap = *(engine_working_data.many_to_many_heap);
+        insertSourceInHeap(query_heap, source_phantom);
+        if (query_heap.Empty())
+            continue;
 
+        std::fill(weights.begin(), weights.end(), INVALID_EDGE_WEIGHT);
+        std::fill(middle_nodes.begin(), middle_nodes.end(), SPECIAL_NODEID);
+        std::fill(is_ambiguous.begin(), is_ambiguous.end(), false);
+        std::fill(needs_loop.begin(), needs_loop.end(), false);
+        tied_nodes.clear();
+        ambiguous_nodes.clear();
+
+        const auto min_edge_offset = std::min(0, query_heap.MinKey());
+        while (!query_heap.Empty() && query_heap.MinKey() + min_edge_offset <= weight_upper_bound)
+        {
+            const auto node = query_heap.DeleteMin();
+            const auto weight = query_heap.GetKey(node);
+            const auto parent = query_heap.GetData(node).parent;
+            const auto is_ambiguous_node =
+                tied_nodes.count(node) > 0 || (parent != node && ambiguous_nodes.count(parent) > 0);
+            if (is_ambiguous_node)
+                ambiguous_nodes.insert(node);
+
+            const auto bucket_list = std::equal_range(search_space_with_buckets.begin(),
+                                                      search_space_with_buckets.end(),
+                                                      node,
+                                                      NodeBucket::Compare());
+            for (const auto &bucket : boost::make_iterator_range(bucket_list))
+            {
+                const auto column_index = bucket.column_index;
+                const auto new_weight = weight + bucket.weight;
+                if (new_weight < 0)
+                {
+                    // source and target on the same segment, loops are left to the
+                    // point-to-point search even if a later bucket gives a shorter path
+                    needs_loop[column_index] = true;
+                }
+                else if (new_weight < weights[column_index])
+                {
+                    weights[column_index] = new_weight;
+                    middle_nodes[column_index] = node;
+                    is_ambiguous[column_index] =
+                        is_ambiguous_node ||
+                        std::binary_search(ambiguous_buckets.begin(),
+                                           ambiguous_buckets.end(),
+                                           std::make_pair(node, column_index));
+                }
+                else if (new_weight == weights[column_index])
+                {
+                    is_ambiguous[column_index] = true;
+                }
+            }
+
+            relaxOutgoingEdgesWithTies<FORWARD_DIRECTION>(
+                facade, node, weight, query_heap, tied_nodes);
+        }
+
+        for (const auto column_index : util::irange<unsigned>(0, number_of_targets))
+        {
+            const auto &target_phantom = target_phantoms[column_index];
+            auto &distance = distances[row_index * number_of_targets + column_index];
+            if (is_ambiguous[column_index] || needs_loop[column_index])
+            {
+                if (!point_to_point_heaps_initialized)
+                {
+                    engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                        facade.GetNumberOfNodes());
+                    point_to_point_heaps_initialized = true;
+                }
+                distance = getNetworkDistance(engine_working_data,
+                                              facade,
+                                              *engine_working_data.forward_heap_1,
+                                              *engine_working_data.reverse_heap_1,
+                                              source_phantom,
+                                              target_phantom,
+                                              weight_upper_bound);
+                continue;
+            }
+
+            const auto middle_node_id = middle_nodes[column_index];
+            if (middle_node_id == SPECIAL_NODEID || weights[column_index] >= weight_upper_bound)
+                continue;
+
+            packed_leg.clear();
+            retrievePackedPathFromSingleManyToManyHeap(query_heap, middle_node_id, packed_leg);
+            std::reverse(packed_leg.begin(), packed_leg.end());
+            packed_leg.push_back(middle_node_id);
+            retrievePackedPathFromSearchSpace(
+                middle_node_id, column_index, search_space_with_buckets, packed_leg);
+
+            unpacked_path.clear();
+            unpackPath(facade,
+                       packed_leg.begin(),
+                       packed_leg.end(),
+                       {source_phantom, target_phantom},
+                       unpacked_path);
+            distance = getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
+        }
+    }
+
+    return distances;
+}
+} // namespace ch
+
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+bucketManyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                       const DataFacade<ch::Algorithm> &facade,
+                       const std::vector<PhantomNode> &phantom_nodes,
+                       const std::vector<std::size_t> &source_indices,
+                       const std::vector<std::size_t> &target_indices,
+                       const bool calculate_distance)
+{
     const auto number_of_sources = source_indices.size();
     const auto number_of_targets = target_indices.size();
     const auto number_of_entries = number_of_sources * number_of_targets;
@@ -404,6 +916,67 @@ manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
     return std::make_pair(durations_table, distances_table);
 }
 
+template <>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                 const DataFacade<ch::Algorithm> &facade,
+                 const std::vector<PhantomNode> &phantom_nodes,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 const bool calculate_distance,
+                 const bool calculate_duration)
+{
+    (void)calculate_duration; // TODO: stub to use when computing durations become optional
+
+    // Hub labels only give weights and durations, distances need the packed paths
+    if (!calculate_distance && engine_working_data.use_hub_labels &&
+        !facade.GetHubLabels().Empty())
+    {
+        return std::make_pair(
+            ch::hubLabelManyToManySearch(facade, phantom_nodes, source_indices, target_indices),
+            std::vector<EdgeDistance>{});
+    }
+
+    // The same holds for transit nodes, only rows with local queries need a graph search
+    if (!calculate_distance && engine_working_data.use_transit_nodes &&
+        !facade.GetTransitNodes().Empty())
+    {
+        std::vector<EdgeDuration> durations_table;
+        std::vector<std::size_t> local_rows;
+        std::tie(durations_table, local_rows) = ch::transitNodeManyToManySearch(
+            facade, phantom_nodes, source_indices, target_indices);
+        if (!local_rows.empty())
+        {
+            std::vector<std::size_t> local_source_indices;
+            for (const auto row_index : local_rows)
+                local_source_indices.push_back(source_indices[row_index]);
+
+            const auto local_durations = bucketManyToManySearch(engine_working_data,
+                                                                facade,
+                                                                phantom_nodes,
+                                                                local_source_indices,
+                                                                target_indices,
+                                                                false)
+                                             .first;
+            const auto number_of_targets = target_indices.size();
+            for (const auto local_row : util::irange<std::size_t>(0, local_rows.size()))
+            {
+                std::copy_n(local_durations.begin() + local_row * number_of_targets,
+                            number_of_targets,
+                            durations_table.begin() + local_rows[local_row] * number_of_targets);
+            }
+        }
+        return std::make_pair(std::move(durations_table), std::vector<EdgeDistance>{});
+    }
+
+    return bucketManyToManySearch(engine_working_data,
+                                  facade,
+                                  phantom_nodes,
+                                  source_indices,
+                                  target_indices,
+                                  calculate_distance);
+}
+
 } // namespace routing_algorithms
 } // namespace engine
 } // namespace osrm
@@ -65,6 +65,137 @@ inline void initializeHeap<mld::Algorithm>(SearchEngineData<mld::Algorithm> &eng
     const auto border_nodes_number = facade.GetMaxBorderNodeID() + 1;
     engine_working_data.InitializeOrClearFirstThreadLocalStorage(nodes_number, border_nodes_number);
 }
+
+// Network distances of the transitions between the candidates of two timestamps. By default
+// every transition is computed on demand with a point-to-point search, the search levels of
+// MLD depend on both phantom nodes. Transitions that are in the session are not searched again.
+template <typename Algorithm> class TransitionDistances
+{
+  public:
+    TransitionDistances(SearchEngineData<Algorithm> &engine_working_data,
+                        const DataFacade<Algorithm> &facade,
+                        const CandidateList &prev_candidates,
+                        const std::vector<bool> &,
+                        const CandidateList &current_candidates,
+                        const EdgeWeight weight_upper_bound,
+                        map_matching::MatchingSession *session)
+        : engine_working_data(engine_working_data), facade(facade),
+          prev_candidates(prev_candidates), current_candidates(current_candidates),
+          weight_upper_bound(weight_upper_bound), session(session)
+    {
+    }
+
+    double operator()(const std::size_t s, const std::size_t s_prime) const
+    {
+        const auto &source_phantom = prev_candidates[s].phantom_node;
+        const auto &target_phantom = current_candidates[s_prime].phantom_node;
+        const map_matching::TransitionKey key{source_phantom, target_phantom, weight_upper_bound};
+        if (session)
+        {
+            if (const auto network_distance = session->FindTransition(key))
+                return *network_distance;
+        }
+
+        const auto network_distance = getNetworkDistance(engine_working_data,
+                                                         facade,
+                                                         *engine_working_data.forward_heap_1,
+                                                         *engine_working_data.reverse_heap_1,
+                                                         source_phantom,
+                                                         target_phantom,
+                                                         weight_upper_bound);
+        if (session)
+            session->InsertTransition(key, network_distance);
+        return network_distance;
+    }
+
+  private:
+    SearchEngineData<Algorithm> &engine_working_data;
+    const DataFacade<Algorithm> &facade;
+    const CandidateList &prev_candidates;
+    const CandidateList &current_candidates;
+    const EdgeWeight weight_upper_bound;
+    map_matching::MatchingSession *session;
+};
+
+// CH computes all transitions of the unpruned previous candidates at once with a bounded
+// many-to-many search instead of a bidirectional search per pair. The search is skipped if
+// the session already has all of them.
+template <> class TransitionDistances<ch::Algorithm>
+{
+  public:
+    TransitionDistances(SearchEngineData<ch::Algorithm> &engine_working_data,
+                        const DataFacade<ch::Algorithm> &facade,
+                        const CandidateList &prev_candidates,
+                        const std::vector<bool> &prev_pruned,
+                        const CandidateList &current_candidates,
+                        const EdgeWeight weight_upper_bound,
+                        map_matching::MatchingSession *session)
+        : source_rows(prev_candidates.size(), 0), number_of_targets(current_candidates.size())
+    {
+        std::vector<PhantomNode> source_phantoms;
+        for (const auto s : util::irange<std::size_t>(0UL, prev_candidates.size()))
+        {
+            if (!prev_pruned[s])
+            {
+                source_rows[s] = source_phantoms.size();
+                source_phantoms.push_back(prev_candidates[s].phantom_node);
+            }
+        }
+
+        std::vector<PhantomNode> target_phantoms;
+        target_phantoms.reserve(current_candidates.size());
+        for (const auto &candidate : current_candidates)
+        {
+            target_phantoms.push_back(candidate.phantom_node);
+        }
+
+        if (session)
+        {
+            const auto find_all = [&] {
+                for (const auto &source_phantom : source_phantoms)
+                {
+                    for (const auto &target_phantom : target_phantoms)
+                    {
+                        const auto network_distance = session->FindTransition(
+                            {source_phantom, target_phantom, weight_upper_bound});
+                        if (!network_distance)
+                            return false;
+                        distances.push_back(*network_distance);
+                    }
+                }
+                return true;
+            };
+            if (find_all())
+                return;
+        }
+
+        distances = ch::getNetworkDistances(
+            engine_working_data, facade, source_phantoms, target_phantoms, weight_upper_bound);
+
+        if (session)
+        {
+            for (const auto row : util::irange<std::size_t>(0UL, source_phantoms.size()))
+            {
+                for (const auto column : util::irange<std::size_t>(0UL, number_of_targets))
+                {
+                    session->InsertTransition(
+                        {source_phantoms[row], target_phantoms[column], weight_upper_bound},
+                        distances[row * number_of_targets + column]);
+                }
+            }
+        }
+    }
+
+    double operator()(const std::size_t s, const std::size_t s_prime) const
+    {
+        return distances[source_rows[s] * number_of_targets + s_prime];
+    }
+
+  private:
+    std::vector<std::size_t> source_rows;
+    std::size_t number_of_targets;
+    std::vector<double> distances;
+};
 }
 
 template <typename Algorithm>
@@ -74,7 +205,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                             const std::vector<util::Coordinate> &trace_coordinates,
                             const std::vector<unsigned> &trace_timestamps,
                             const std::vector<boost::optional<double>> &trace_gps_precision,
-                            const bool allow_splitting)
+                            const bool allow_splitting,
+                            map_matching::MatchingSession *session)
 {
     map_matching::MatchingConfidence confidence;
     map_matching::EmissionLogProbability default_emission_log_probability(DEFAULT_GPS_PRECISION);
@@ -151,8 +283,6 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
     }
 
     initializeHeap(engine_working_data, facade);
-    auto &forward_heap = *engine_working_data.forward_heap_1;
-    auto &reverse_heap = *engine_working_data.reverse_heap_1;
 
     std::size_t breakage_begin = map_matching::INVALID_STATE;
     std::vector<std::size_t> split_points;
@@ -219,6 +349,13 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
             // assumes minumum of 4 m/s
             const EdgeWeight weight_upper_bound =
                 ((haversine_distance + max_distance_delta) / 4.) * facade.GetWeightMultiplier();
+            const TransitionDistances<Algorithm> transition_distances(engine_working_data,
+                                                                      facade,
+                                                                      prev_unbroken_timestamps_list,
+                                                                      prev_pruned,
+                                                                      current_timestamps_list,
+                                                                      weight_upper_bound,
+                                                                      session);
 
             // compute d_t for this timestamp and the next one
             for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
@@ -237,14 +374,7 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                         continue;
                     }
 
-                    double network_distance =
-                        getNetworkDistance(engine_working_data,
-                                           facade,
-                                           forward_heap,
-                                           reverse_heap,
-                                           prev_unbroken_timestamps_list[s].phantom_node,
-                                           current_timestamps_list[s_prime].phantom_node,
-                                           weight_upper_bound);
+                    double network_distance = transition_distances(s, s_prime);
 
                     // get distance diff between loc1/2 and locs/s_prime
                     const auto d_t = std::abs(network_distance - haversine_distance);
@@ -445,7 +575,8 @@ mapMatching(SearchEngineData<ch::Algorithm> &engine_working_data,
             const std::vector<util::Coordinate> &trace_coordinates,
             const std::vector<unsigned> &trace_timestamps,
             const std::vector<boost::optional<double>> &trace_gps_precision,
-            const bool allow_splitting);
+            const bool allow_splitting,
+            map_matching::MatchingSession *session);
 
 // MLD
 template SubMatchingList
@@ -455,7 +586,8 @@ mapMatching(SearchEngineData<mld::Algorithm> &engine_working_data,
             const std::vector<util::Coordinate> &trace_coordinates,
             const std::vector<unsigned> &trace_timestamps,
             const std::vector<boost::optional<double>> &trace_gps_precision,
-            const bool allow_splitting);
+            const bool allow_splitting,
+            map_matching::MatchingSession *session);
 
 } // namespace routing_algorithms
 } // namespace engine
@@ -1,4 +1,7 @@
 #include "engine/search_engine_data.hpp"
+#include "engine/warmup_thread_scope.hpp"
+
+#include "util/log.hpp"
 
 namespace osrm
 {
@@ -95,17 +98,84 @@ using MLD = routing_algorithms::mld::Algorithm;
 SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::forward_heap_1;
 SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::reverse_heap_1;
 SearchEngineData<MLD>::ManyToManyHeapPtr SearchEngineData<MLD>::many_to_many_heap;
+boost::thread_specific_ptr<unsigned> SearchEngineData<MLD>::first_heaps_boundary_nodes;
+boost::thread_specific_ptr<unsigned> SearchEngineData<MLD>::many_to_many_heap_boundary_nodes;
+std::mutex SearchEngineData<MLD>::prepared_heaps_mutex;
+unsigned SearchEngineData<MLD>::prepared_boundary_nodes = 0;
+std::vector<std::unique_ptr<SearchEngineData<MLD>::QueryHeap>>
+    SearchEngineData<MLD>::prepared_heaps;
+std::vector<std::unique_ptr<SearchEngineData<MLD>::ManyToManyQueryHeap>>
+    SearchEngineData<MLD>::prepared_many_to_many_heaps;
+std::atomic<unsigned> SearchEngineData<MLD>::number_of_first_heap_threads{0};
+std::atomic<unsigned> SearchEngineData<MLD>::number_of_many_to_many_heap_threads{0};
+
+namespace
+{
+// Called when a counted thread exits, the counter itself is static and not deleted
+void leaveHeapThreadCounter(std::atomic<unsigned> *counter) { --*counter; }
+
+// Counts the calling thread once, unless it only warms up datasets
+void countHeapThread(boost::thread_specific_ptr<std::atomic<unsigned>> &thread_counter,
+                     std::atomic<unsigned> &counter)
+{
+    if (thread_counter.get() || WarmupThreadScope::IsActive())
+        return;
+    ++counter;
+    thread_counter.reset(&counter);
+}
+}
+
+boost::thread_specific_ptr<std::atomic<unsigned>>
+    SearchEngineData<MLD>::first_heap_thread_counter(&leaveHeapThreadCounter);
+boost::thread_specific_ptr<std::atomic<unsigned>>
+    SearchEngineData<MLD>::many_to_many_heap_thread_counter(&leaveHeapThreadCounter);
+
+namespace
+{
+// Takes a prepared heap of the requested size or creates a new one
+template <typename HeapT>
+HeapT *makeHeap(std::vector<std::unique_ptr<HeapT>> &prepared,
+                const unsigned number_of_nodes,
+                const unsigned number_of_boundary_nodes)
+{
+    if (!WarmupThreadScope::IsActive())
+    {
+        std::lock_guard<std::mutex> lock(SearchEngineData<MLD>::prepared_heaps_mutex);
+        if (SearchEngineData<MLD>::prepared_boundary_nodes == number_of_boundary_nodes &&
+            !prepared.empty())
+        {
+            auto heap = std::move(prepared.back());
+            prepared.pop_back();
+            return heap.release();
+        }
+    }
+    return new HeapT(number_of_nodes, number_of_boundary_nodes);
+}
+}
 
 void SearchEngineData<MLD>::InitializeOrClearFirstThreadLocalStorage(
     unsigned number_of_nodes, unsigned number_of_boundary_nodes)
 {
+    countHeapThread(first_heap_thread_counter, number_of_first_heap_threads);
+
+    if (!first_heaps_boundary_nodes.get())
+    {
+        first_heaps_boundary_nodes.reset(new unsigned(number_of_boundary_nodes));
+    }
+    else if (*first_heaps_boundary_nodes != number_of_boundary_nodes)
+    {
+        *first_heaps_boundary_nodes = number_of_boundary_nodes;
+        forward_heap_1.reset();
+        reverse_heap_1.reset();
+    }
+
     if (forward_heap_1.get())
     {
         forward_heap_1->Clear();
     }
     else
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
+        forward_heap_1.reset(makeHeap(prepared_heaps, number_of_nodes, number_of_boundary_nodes));
     }
 
     if (reverse_heap_1.get())
@@ -114,21 +184,78 @@ void SearchEngineData<MLD>::InitializeOrClearFirstThreadLocalStorage(
     }
     else
     {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
+        reverse_heap_1.reset(makeHeap(prepared_heaps, number_of_nodes, number_of_boundary_nodes));
     }
 }
 
 void SearchEngineData<MLD>::InitializeOrClearManyToManyThreadLocalStorage(
     unsigned number_of_nodes, unsigned number_of_boundary_nodes)
 {
+    countHeapThread(many_to_many_heap_thread_counter, number_of_many_to_many_heap_threads);
+
+    if (!many_to_many_heap_boundary_nodes.get())
+    {
+        many_to_many_heap_boundary_nodes.reset(new unsigned(number_of_boundary_nodes));
+    }
+    else if (*many_to_many_heap_boundary_nodes != number_of_boundary_nodes)
+    {
+        *many_to_many_heap_boundary_nodes = number_of_boundary_nodes;
+        many_to_many_heap.reset();
+    }
+
     if (many_to_many_heap.get())
     {
         many_to_many_heap->Clear();
     }
     else
     {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes, number_of_boundary_nodes));
+        many_to_many_heap.reset(
+            makeHeap(prepared_many_to_many_heaps, number_of_nodes, number_of_boundary_nodes));
     }
 }
+
+void SearchEngineData<MLD>::PrepareHeaps(unsigned number_of_nodes,
+                                         unsigned number_of_boundary_nodes)
+{
+    {
+        std::lock_guard<std::mutex> lock(prepared_heaps_mutex);
+        if (prepared_boundary_nodes == number_of_boundary_nodes)
+            return;
+    }
+
+    const auto number_of_heaps = 2 * number_of_first_heap_threads;
+    const auto number_of_many_to_many_heaps = number_of_many_to_many_heap_threads.load();
+
+    // the heaps are created without holding the lock, requests might take the old ones meanwhile
+    std::vector<std::unique_ptr<QueryHeap>> heaps;
+    std::vector<std::unique_ptr<ManyToManyQueryHeap>> many_to_many_heaps;
+    for (unsigned index = 0; index < number_of_heaps; ++index)
+    {
+        heaps.push_back(std::make_unique<QueryHeap>(number_of_nodes, number_of_boundary_nodes));
+    }
+    for (unsigned index = 0; index < number_of_many_to_many_heaps; ++index)
+    {
+        many_to_many_heaps.push_back(
+            std::make_unique<ManyToManyQueryHeap>(number_of_nodes, number_of_boundary_nodes));
+    }
+
+    std::lock_guard<std::mutex> lock(prepared_heaps_mutex);
+    prepared_boundary_nodes = number_of_boundary_nodes;
+    prepared_heaps = std::move(heaps);
+    prepared_many_to_many_heaps = std::move(many_to_many_heaps);
+}
+
+void SearchEngineData<MLD>::ResetCaches()
+{
+    if (!unpacking_cache.IsEnabled())
+        return;
+
+    const auto hits = unpacking_cache.GetHits();
+    const auto lookups = hits + unpacking_cache.GetMisses();
+    util::Log() << "MLD unpacking cache: " << hits << " hits in " << lookups << " lookups ("
+                << (lookups > 0 ? 100. * hits / lookups : 0.) << "%), " << unpacking_cache.Size()
+                << " of " << unpacking_cache.GetCapacity() << " entries";
+    unpacking_cache.Clear();
+}
 }
 }
@@ -184,21 +184,17 @@ NBGToEBG EdgeBasedGraphFactory::InsertEdgeBasedNode(const NodeID node_u, const N
 
     // Add edge-based node data for forward and reverse nodes indexed by edge_id
     BOOST_ASSERT(nbe_to_ebn_mapping[edge_id_1] != SPECIAL_EDGEID);
-    m_edge_based_node_container.nodes[nbe_to_ebn_mapping[edge_id_1]].geometry_id =
-        forward_data.geometry_id;
-    m_edge_based_node_container.nodes[nbe_to_ebn_mapping[edge_id_1]].annotation_id =
-        forward_data.annotation_data;
-    m_edge_based_node_container.nodes[nbe_to_ebn_mapping[edge_id_1]].segregated =
-        segregated_edges.count(edge_id_1) > 0;
+    m_edge_based_node_container.SetData(nbe_to_ebn_mapping[edge_id_1],
+                                        forward_data.geometry_id,
+                                        forward_data.annotation_data,
+                                        segregated_edges.count(edge_id_1) > 0);
 
     if (nbe_to_ebn_mapping[edge_id_2] != SPECIAL_EDGEID)
     {
-        m_edge_based_node_container.nodes[nbe_to_ebn_mapping[edge_id_2]].geometry_id =
-            reverse_data.geometry_id;
-        m_edge_based_node_container.nodes[nbe_to_ebn_mapping[edge_id_2]].annotation_id =
-            reverse_data.annotation_data;
-        m_edge_based_node_container.nodes[nbe_to_ebn_mapping[edge_id_2]].segregated =
-            segregated_edges.count(edge_id_2) > 0;
+        m_edge_based_node_container.SetData(nbe_to_ebn_mapping[edge_id_2],
+                                            reverse_data.geometry_id,
+                                            reverse_data.annotation_data,
+                                            segregated_edges.count(edge_id_2) > 0);
     }
 
     // Add segments of edge-based nodes
@@ -245,7 +241,8 @@ void EdgeBasedGraphFactory::Run(
     const RestrictionMap &node_restriction_map,
     const ConditionalRestrictionMap &conditional_node_restriction_map,
     const WayRestrictionMap &way_restriction_map,
-    const std::vector<UnresolvedManeuverOverride> &unresolved_maneuver_overrides)
+    const std::vector<UnresolvedManeuverOverride> &unresolved_maneuver_overrides,
+    const bool compress_maneuver_overrides)
 {
     TIMER_START(renumber);
     m_number_of_edge_based_nodes =
@@ -255,7 +252,7 @@ void EdgeBasedGraphFactory::Run(
     // Allocate memory for edge-based nodes
     // In addition to the normal edges, allocate enough space for copied edges from
     // via-way-restrictions, see calculation above
-    m_edge_based_node_container.nodes.resize(m_number_of_edge_based_nodes);
+    m_edge_based_node_container.Resize(m_number_of_edge_based_nodes);
 
     TIMER_START(generate_nodes);
     {
@@ -274,7 +271,8 @@ void EdgeBasedGraphFactory::Run(
                               node_restriction_map,
                               conditional_node_restriction_map,
                               way_restriction_map,
-                              unresolved_maneuver_overrides);
+                              unresolved_maneuver_overrides,
+                              compress_maneuver_overrides);
 
     TIMER_STOP(generate_edges);
 
@@ -395,12 +393,10 @@ EdgeBasedGraphFactory::GenerateEdgeExpandedNodes(const WayRestrictionMap &way_re
             // find node in the edge based graph, we only require one id:
             const EdgeData &edge_data = m_node_based_graph.GetEdgeData(eid);
             // BOOST_ASSERT(edge_data.edge_id < m_edge_based_node_container.Size());
-            m_edge_based_node_container.nodes[edge_based_node_id].geometry_id =
-                edge_data.geometry_id;
-            m_edge_based_node_container.nodes[edge_based_node_id].annotation_id =
-                edge_data.annotation_data;
-            m_edge_based_node_container.nodes[edge_based_node_id].segregated =
-                segregated_edges.count(eid) > 0;
+            m_edge_based_node_container.SetData(edge_based_node_id,
+                                                edge_data.geometry_id,
+                                                edge_data.annotation_data,
+                                                segregated_edges.count(eid) > 0);
 
             const auto ebn_weight = m_edge_based_node_weights[nbe_to_ebn_mapping[eid]];
             BOOST_ASSERT((ebn_weight & 0x7fffffff) == edge_data.weight);
@@ -436,7 +432,8 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     const RestrictionMap &node_restriction_map,
     const ConditionalRestrictionMap &conditional_restriction_map,
     const WayRestrictionMap &way_restriction_map,
-    const std::vector<UnresolvedManeuverOverride> &unresolved_maneuver_overrides)
+    const std::vector<UnresolvedManeuverOverride> &unresolved_maneuver_overrides,
+    const bool compress_maneuver_overrides)
 {
     util::Log() << "Generating edge-expanded edges ";
 
@@ -1129,8 +1126,12 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                   storage_maneuver_overrides.end(),
                   [](const auto &a, const auto &b) { return a.start_node < b.start_node; });
 
-        files::writeManeuverOverrides(
-            maneuver_overrides_filename, storage_maneuver_overrides, maneuver_override_sequences);
+        files::writeManeuverOverrides(maneuver_overrides_filename,
+                                      storage_maneuver_overrides,
+                                      maneuver_override_sequences,
+                                      compress_maneuver_overrides
+                                          ? storage::tar::FileWriter::CompressBlocks
+                                          : storage::tar::FileWriter::NoCompression);
     }
 
     util::Log() << "done.";
@@ -130,7 +130,8 @@ ExtractionContainers::ExtractionContainers()
  */
 void ExtractionContainers::PrepareData(ScriptingEnvironment &scripting_environment,
                                        const std::string &osrm_path,
-                                       const std::string &name_file_name)
+                                       const std::string &name_file_name,
+                                       const bool compress_names)
 {
     storage::tar::FileWriter writer(osrm_path, storage::tar::FileWriter::GenerateFingerprint);
 
@@ -156,10 +157,10 @@ void ExtractionContainers::PrepareData(ScriptingEnvironment &scripting_environme
 
     PrepareManeuverOverrides();
     PrepareRestrictions();
-    WriteCharData(name_file_name);
+    WriteCharData(name_file_name, compress_names);
 }
 
-void ExtractionContainers::WriteCharData(const std::string &file_name)
+void ExtractionContainers::WriteCharData(const std::string &file_name, const bool compress)
 {
     util::UnbufferedLog log;
     log << "writing street name index ... ";
@@ -167,7 +168,9 @@ void ExtractionContainers::WriteCharData(const std::string &file_name)
 
     files::writeNames(file_name,
                       NameTable{NameTable::IndexedData(
-                          name_offsets.begin(), name_offsets.end(), name_char_data.begin())});
+                          name_offsets.begin(), name_offsets.end(), name_char_data.begin())},
+                      compress ? storage::tar::FileWriter::CompressBlocks
+                               : storage::tar::FileWriter::NoCompression);
 
     TIMER_STOP(write_index);
     log << "ok, after " << TIMER_SEC(write_index) << "s";
@@ -358,7 +358,10 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
 
     util::Log() << "Building r-tree ...";
     TIMER_START(rtree);
-    BuildRTree(std::move(edge_based_node_segments), std::move(node_is_startpoint), coordinates);
+    BuildRTree(std::move(edge_based_node_segments),
+               std::move(node_is_startpoint),
+               coordinates,
+               edge_based_nodes_container);
 
     TIMER_STOP(rtree);
 
@@ -636,7 +639,8 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
 
     extraction_containers.PrepareData(scripting_environment,
                                       config.GetPath(".osrm").string(),
-                                      config.GetPath(".osrm.names").string());
+                                      config.GetPath(".osrm.names").string(),
+                                      config.compress_cold_data);
 
     auto profile_properties = scripting_environment.GetProfileProperties();
     SetClassNames(scripting_environment.GetClassNames(), classes_map, profile_properties);
@@ -707,7 +711,7 @@ void Extractor::FindComponents(unsigned number_of_edge_based_nodes,
         const auto component_size = component_search.GetComponentSize(forward_component);
         const auto is_tiny = component_size < config.small_component_size;
         BOOST_ASSERT(node_id < nodes_container.NumberOfNodes());
-        nodes_container.nodes[node_id].component_id = {1 + forward_component, is_tiny};
+        nodes_container.component_ids[node_id] = {1 + forward_component, is_tiny};
     }
 }
 
@@ -775,7 +779,8 @@ EdgeID Extractor::BuildEdgeExpandedGraph(
                                      via_node_restriction_map,
                                      conditional_node_restriction_map,
                                      via_way_restriction_map,
-                                     maneuver_overrides);
+                                     maneuver_overrides,
+                                     config.compress_cold_data);
         return edge_based_graph_factory.GetNumberOfEdgeBasedNodes();
     };
 
@@ -798,7 +803,8 @@ EdgeID Extractor::BuildEdgeExpandedGraph(
  */
 void Extractor::BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_segments,
                            std::vector<bool> node_is_startpoint,
-                           const std::vector<util::Coordinate> &coordinates)
+                           const std::vector<util::Coordinate> &coordinates,
+                           const EdgeBasedNodeDataContainer &nodes_container)
 {
     util::Log() << "Constructing r-tree of " << edge_based_node_segments.size()
                 << " segments build on-top of " << coordinates.size() << " coordinates";
@@ -827,9 +833,19 @@ void Extractor::BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_seg
     }
     edge_based_node_segments.resize(new_size);
 
+    // lets queries skip subtrees in which all segments have an excluded class
+    std::vector<ClassData> node_classes(nodes_container.NumberOfNodes());
+    for (const auto node : util::irange<NodeID>(0, nodes_container.NumberOfNodes()))
+    {
+        node_classes[node] = nodes_container.GetClassData(node);
+    }
+
     TIMER_START(construction);
-    util::StaticRTree<EdgeBasedNodeSegment> rtree(
-        edge_based_node_segments, coordinates, config.GetPath(".osrm.fileIndex"));
+    util::StaticRTree<EdgeBasedNodeSegment> rtree(edge_based_node_segments,
+                                                  coordinates,
+                                                  config.GetPath(".osrm.fileIndex"),
+                                                  node_classes,
+                                                  config.store_rtree_coordinates);
 
     files::writeRamIndex(config.GetPath(".osrm.ramIndex"), rtree);
 
@@ -904,13 +920,18 @@ void Extractor::ProcessGuidanceTurns(
     TIMER_STOP(turn_annotations);
     util::Log() << "Guidance turn annotations took " << TIMER_SEC(turn_annotations) << "s";
 
+    const auto cold_data_compression = config.compress_cold_data
+                                           ? storage::tar::FileWriter::CompressBlocks
+                                           : storage::tar::FileWriter::NoCompression;
+
     util::Log() << "Writing Intersection Classification Data";
     TIMER_START(write_intersections);
     files::writeIntersections(
         config.GetPath(".osrm.icd").string(),
         IntersectionBearingsContainer{bearing_class_by_node_based_node,
                                       convertIDMapToVector(bearing_class_hash.data)},
-        convertIDMapToVector(entry_class_hash.data));
+        convertIDMapToVector(entry_class_hash.data),
+        cold_data_compression);
     TIMER_STOP(write_intersections);
     util::Log() << "ok, after " << TIMER_SEC(write_intersections) << "s";
 
@@ -927,8 +948,10 @@ void Extractor::ProcessGuidanceTurns(
         std::vector<TurnLaneType::Mask> turn_lane_masks;
         std::tie(turn_lane_offsets, turn_lane_masks) =
             transformTurnLaneMapIntoArrays(lane_description_map);
-        files::writeTurnLaneDescriptions(
-            config.GetPath(".osrm.tls"), turn_lane_offsets, turn_lane_masks);
+        files::writeTurnLaneDescriptions(config.GetPath(".osrm.tls"),
+                                         turn_lane_offsets,
+                                         turn_lane_masks,
+                                         cold_data_compression);
     }
 
     osrm::guidance::files::writeTurnData(
@@ -29,6 +29,13 @@ OSRM::OSRM(engine::EngineConfig &config)
                               "pre-processing steps been run?");
     }
 
+    // The data is either mapped from the files or comes from somewhere else
+    if (config.use_mmap && (config.use_shared_memory || !config.memory_file.empty()))
+    {
+        throw util::exception("use_mmap can not be combined with use_shared_memory or a "
+                              "memory_file.");
+    }
+
     // Now, check that the algorithm requested can be used with the data
     // that's available.
 
@@ -161,7 +161,14 @@ int Partitioner::Run(const PartitionerConfig &config)
         extractor::files::readManeuverOverrides(filename, maneuver_overrides, node_sequences);
         renumber(maneuver_overrides, permutation);
         renumber(node_sequences, permutation);
-        extractor::files::writeManeuverOverrides(filename, maneuver_overrides, node_sequences);
+        // keep the file compressed if osrm-extract compressed it
+        const auto compression =
+            storage::tar::FileReader{filename, storage::tar::FileReader::VerifyFingerprint}
+                    .HasCompressedFiles()
+                ? storage::tar::FileWriter::CompressBlocks
+                : storage::tar::FileWriter::NoCompression;
+        extractor::files::writeManeuverOverrides(
+            filename, maneuver_overrides, node_sequences, compression);
     }
     if (boost::filesystem::exists(config.GetPath(".osrm.hsgr")))
     {
@@ -169,6 +176,30 @@ int Partitioner::Run(const PartitionerConfig &config)
                                  "osrm-contract after osrm-partition.";
         boost::filesystem::remove(config.GetPath(".osrm.hsgr"));
     }
+    if (boost::filesystem::exists(config.GetPath(".osrm.shortcuts")))
+    {
+        util::Log(logWARNING) << "Found existing .osrm.shortcuts file, removing. You need to "
+                                 "re-run osrm-contract after osrm-partition.";
+        boost::filesystem::remove(config.GetPath(".osrm.shortcuts"));
+    }
+    if (boost::filesystem::exists(config.GetPath(".osrm.cch")))
+    {
+        util::Log(logWARNING) << "Found existing .osrm.cch file, removing. You need to re-run "
+                                 "osrm-contract after osrm-partition.";
+        boost::filesystem::remove(config.GetPath(".osrm.cch"));
+    }
+    if (boost::filesystem::exists(config.GetPath(".osrm.hub_labels")))
+    {
+        util::Log(logWARNING) << "Found existing .osrm.hub_labels file, removing. You need to "
+                                 "re-run osrm-contract after osrm-partition.";
+        boost::filesystem::remove(config.GetPath(".osrm.hub_labels"));
+    }
+    if (boost::filesystem::exists(config.GetPath(".osrm.tnr")))
+    {
+        util::Log(logWARNING) << "Found existing .osrm.tnr file, removing. You need to "
+                                 "re-run osrm-contract after osrm-partition.";
+        boost::filesystem::remove(config.GetPath(".osrm.tnr"));
+    }
     TIMER_STOP(renumber);
     util::Log() << "Renumbered data in " << TIMER_SEC(renumber) << " seconds";
 
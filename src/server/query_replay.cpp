@@ -0,0 +1,144 @@
+#include "server/query_replay.hpp"
+
+#include "server/api/parameters_parser.hpp"
+#include "server/api/url_parser.hpp"
+
+#include "engine/engine.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/json_container.hpp"
+#include "util/log.hpp"
+#include "util/string_util.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+template <typename ParametersT, typename RunT> bool replay(std::string &query, RunT run)
+{
+    auto query_iterator = query.begin();
+    const auto parameters = api::parseParameters<ParametersT>(query_iterator, query.end());
+    if (!parameters || query_iterator != query.end() || !parameters->IsValid())
+    {
+        return false;
+    }
+
+    // errors like NoRoute warm up the data just as well
+    run(*parameters);
+    return true;
+}
+
+bool replay(const engine::EngineInterface &engine, api::ParsedURL &parsed_url)
+{
+    util::json::Object json_result;
+    std::string tile_result;
+
+    if (parsed_url.service == "route")
+        return replay<engine::api::RouteParameters>(
+            parsed_url.query, [&](const auto &params) { engine.Route(params, json_result); });
+    if (parsed_url.service == "table")
+        return replay<engine::api::TableParameters>(
+            parsed_url.query, [&](const auto &params) { engine.Table(params, json_result); });
+    if (parsed_url.service == "nearest")
+        return replay<engine::api::NearestParameters>(
+            parsed_url.query, [&](const auto &params) { engine.Nearest(params, json_result); });
+    if (parsed_url.service == "trip")
+        return replay<engine::api::TripParameters>(
+            parsed_url.query, [&](const auto &params) { engine.Trip(params, json_result); });
+    if (parsed_url.service == "match")
+        return replay<engine::api::MatchParameters>(
+            parsed_url.query, [&](const auto &params) { engine.Match(params, json_result); });
+    if (parsed_url.service == "tile")
+        return replay<engine::api::TileParameters>(
+            parsed_url.query, [&](const auto &params) { engine.Tile(params, tile_result); });
+    return false;
+}
+
+boost::optional<api::ParsedURL> parseQuery(const std::string &query)
+{
+    std::string request_string;
+    util::URIDecode(query, request_string);
+
+    auto api_iterator = request_string.begin();
+    auto parsed_url = api::parseURL(api_iterator, request_string.end());
+    if (!parsed_url || api_iterator != request_string.end())
+    {
+        return boost::none;
+    }
+    return parsed_url;
+}
+}
+
+std::vector<std::string> readQueryLog(const boost::filesystem::path &path)
+{
+    boost::filesystem::ifstream log(path);
+    if (!log)
+    {
+        throw util::exception("Could not open query log " + path.string() + SOURCE_REF);
+    }
+
+    std::vector<std::string> queries;
+    std::string line;
+    while (std::getline(log, line))
+    {
+        if (!line.empty() && line.front() != '#')
+        {
+            queries.push_back(std::move(line));
+        }
+    }
+    return queries;
+}
+
+std::size_t replayQueries(const engine::EngineInterface &engine,
+                          const std::vector<std::string> &queries)
+{
+    std::size_t num_replayed = 0;
+    for (const auto &query : queries)
+    {
+        auto parsed_url = parseQuery(query);
+        if (parsed_url && replay(engine, *parsed_url))
+        {
+            ++num_replayed;
+        }
+        else
+        {
+            util::Log(logDEBUG) << "Skipped query " << query;
+        }
+    }
+
+    util::Log() << "Replayed " << num_replayed << " of " << queries.size() << " queries";
+    return num_replayed;
+}
+
+std::vector<std::string> selectProfileQueries(const std::vector<std::string> &queries,
+                                              const std::string &profile,
+                                              const std::vector<std::string> &other_profiles)
+{
+    std::vector<std::string> selected;
+    std::copy_if(queries.begin(),
+                 queries.end(),
+                 std::back_inserter(selected),
+                 [&](const std::string &query) {
+                     const auto parsed_url = parseQuery(query);
+                     if (!parsed_url)
+                         return profile.empty();
+                     if (!profile.empty())
+                         return parsed_url->profile == profile;
+                     return std::find(other_profiles.begin(),
+                                      other_profiles.end(),
+                                      parsed_url->profile) == other_profiles.end();
+                 });
+    return selected;
+}
+}
+}
@@ -38,9 +38,25 @@ void RequestHandler::RegisterServiceHandler(
     service_handler = std::move(service_handler_);
 }
 
+void RequestHandler::RegisterServiceHandler(
+    const std::string &profile, std::unique_ptr<ServiceHandlerInterface> service_handler_)
+{
+    profile_service_handlers[profile] = std::move(service_handler_);
+}
+
+ServiceHandlerInterface *RequestHandler::GetServiceHandler(const std::string &profile) const
+{
+    const auto iter = profile_service_handlers.find(profile);
+    if (iter != profile_service_handlers.end())
+    {
+        return iter->second.get();
+    }
+    return service_handler.get();
+}
+
 void RequestHandler::HandleRequest(const http::request &current_request, http::reply &current_reply)
 {
-    if (!service_handler)
+    if (!service_handler && profile_service_handlers.empty())
     {
         current_reply = http::reply::stock_reply(http::reply::internal_server_error);
         util::Log(logWARNING) << "No service handler registered." << std::endl;
@@ -65,17 +81,29 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         // check if the was an error with the request
         if (maybe_parsed_url && api_iterator == request_string.end())
         {
-
-            const engine::Status status =
-                service_handler->RunQuery(*std::move(maybe_parsed_url), result);
-            if (status != engine::Status::Ok)
+            auto profile_service_handler = GetServiceHandler(maybe_parsed_url->profile);
+            if (!profile_service_handler)
             {
-                // 4xx bad request return code
                 current_reply.status = http::reply::bad_request;
+                result = util::json::Object();
+                auto &json_result = result.get<util::json::Object>();
+                json_result.values["code"] = "InvalidProfile";
+                json_result.values["message"] =
+                    "Profile " + maybe_parsed_url->profile + " not found!";
             }
             else
             {
-                BOOST_ASSERT(status == engine::Status::Ok);
+                const engine::Status status =
+                    profile_service_handler->RunQuery(*std::move(maybe_parsed_url), result);
+                if (status != engine::Status::Ok)
+                {
+                    // 4xx bad request return code
+                    current_reply.status = http::reply::bad_request;
+                }
+                else
+                {
+                    BOOST_ASSERT(status == engine::Status::Ok);
+                }
             }
         }
         else
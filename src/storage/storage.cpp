@@ -17,6 +17,7 @@
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
 #include "util/log.hpp"
+#include "util/timing_util.hpp"
 
 #ifdef __linux__
 #include <sys/mman.h>
@@ -24,17 +25,27 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <cstdint>
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <new>
+#include <numeric>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -44,7 +55,23 @@ namespace
 {
 using Monitor = SharedMonitor<SharedRegionRegister>;
 
-void readBlocks(const boost::filesystem::path &path, DataLayout &layout)
+constexpr bool REQUIRED = true;
+constexpr bool OPTIONAL = false;
+
+// Blocks of the updatable files that do not depend on the metric. They are stored in the static
+// region, so a metric update neither needs to copy them nor to allocate memory for them.
+bool isStaticBlock(const std::string &name)
+{
+    return name == "/common/segment_data/index" || name == "/common/segment_data/nodes";
+}
+
+bool isUpdatableBlock(const std::string &name) { return !isStaticBlock(name); }
+
+bool isAnyBlock(const std::string &) { return true; }
+
+void readBlocks(const boost::filesystem::path &path,
+                DataLayout &layout,
+                const std::function<bool(const std::string &)> &filter = isAnyBlock)
 {
     tar::FileReader reader(path, tar::FileReader::VerifyFingerprint);
 
@@ -54,7 +81,7 @@ void readBlocks(const boost::filesystem::path &path, DataLayout &layout)
     for (const auto &entry : entries)
     {
         const auto name_end = entry.name.rfind(".meta");
-        if (name_end == std::string::npos)
+        if (name_end == std::string::npos && filter(entry.name))
         {
             auto number_of_elements = reader.ReadElementCount64(entry.name);
             layout.SetBlock(entry.name, Block{number_of_elements, entry.size});
@@ -62,6 +89,88 @@ void readBlocks(const boost::filesystem::path &path, DataLayout &layout)
     }
 }
 
+// Copies the blocks of a file that are part of the index as they are stored
+void readBlocksData(const boost::filesystem::path &path,
+                    const SharedDataIndex &index,
+                    const std::function<bool(const std::string &)> &filter)
+{
+    tar::FileReader reader(path, tar::FileReader::VerifyFingerprint);
+
+    std::vector<tar::FileReader::FileEntry> entries;
+    reader.List(std::back_inserter(entries));
+
+    for (const auto &entry : entries)
+    {
+        const auto name_end = entry.name.rfind(".meta");
+        if (name_end == std::string::npos && filter(entry.name))
+        {
+            reader.ReadInto(
+                entry.name, index.GetBlockPtr<char>(entry.name), index.GetBlockSize(entry.name));
+        }
+    }
+}
+
+// Returns the files that exist, throws if a required file is missing
+std::vector<boost::filesystem::path>
+existingFiles(const std::vector<std::pair<bool, boost::filesystem::path>> &tar_files)
+{
+    std::vector<boost::filesystem::path> existing_files;
+    for (const auto &file : tar_files)
+    {
+        if (boost::filesystem::exists(file.second))
+        {
+            existing_files.push_back(file.second);
+        }
+        else
+        {
+            if (file.first == REQUIRED)
+            {
+                throw util::exception("Could not find required filed: " +
+                                      std::get<1>(file).string());
+            }
+        }
+    }
+    return existing_files;
+}
+
+// Reads one file into its preassigned blocks of the shared memory regions
+using FileLoader = std::pair<boost::filesystem::path, std::function<void()>>;
+
+// Runs the loaders concurrently, every file is read into its own blocks so the loaders do not
+// need to be synchronized. The largest files are started first because they bound the total time.
+void loadFiles(std::vector<FileLoader> loaders)
+{
+    std::vector<std::uint64_t> file_sizes;
+    file_sizes.reserve(loaders.size());
+    for (const auto &loader : loaders)
+    {
+        file_sizes.push_back(boost::filesystem::file_size(loader.first));
+    }
+
+    std::vector<std::size_t> order(loaders.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const auto lhs, const auto rhs) {
+        return file_sizes[lhs] > file_sizes[rhs];
+    });
+
+    TIMER_START(load_files);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, order.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (auto index = range.begin(); index != range.end(); ++index)
+                          {
+                              const auto &loader = loaders[order[index]];
+                              TIMER_START(load_file);
+                              loader.second();
+                              TIMER_STOP(load_file);
+                              util::Log() << "Loaded " << loader.first.filename().string() << " ("
+                                          << file_sizes[order[index]] << " bytes) in "
+                                          << TIMER_SEC(load_file) << "s";
+                          }
+                      });
+    TIMER_STOP(load_files);
+    util::Log() << "Loaded " << loaders.size() << " files in " << TIMER_SEC(load_files) << "s";
+}
+
 struct RegionHandle
 {
     std::unique_ptr<SharedMemory> memory;
@@ -69,7 +178,9 @@ struct RegionHandle
     std::uint16_t shm_key;
 };
 
-auto setupRegion(SharedRegionRegister &shared_register, const DataLayout &layout)
+auto setupRegion(SharedRegionRegister &shared_register,
+                 const DataLayout &layout,
+                 const bool huge_pages)
 {
     // This is safe because we have an exclusive lock for all osrm-datastore processes.
     auto shm_key = shared_register.ReserveKey();
@@ -93,7 +204,7 @@ auto setupRegion(SharedRegionRegister &shared_register, const DataLayout &layout
     auto regions_size = encoded_static_layout.size() + layout.GetSizeOfLayout();
     util::Log() << "Data layout has a size of " << encoded_static_layout.size() << " bytes";
     util::Log() << "Allocating shared memory of " << regions_size << " bytes";
-    auto memory = makeSharedMemory(shm_key, regions_size);
+    auto memory = makeSharedMemory(shm_key, regions_size, huge_pages);
 
     // Copy memory static_layout to shared memory and populate data
     char *shared_memory_ptr = static_cast<char *>(memory->Ptr());
@@ -248,6 +359,13 @@ int Storage::Run(int max_wait, const std::string &dataset_name, bool only_metric
                                 static_memory->Size());
         serialization::read(reader, static_layout);
         auto layout_size = reader.GetPosition();
+
+        if (!static_layout.HasBlock("/common/segment_data/nodes"))
+        {
+            throw util::exception("The static data of " + dataset_name +
+                                  " was loaded by an older version, the metric can only be "
+                                  "updated after loading the complete dataset once.");
+        }
         auto *data_ptr = reinterpret_cast<char *>(static_memory->Ptr()) + layout_size;
 
         regions.push_back({data_ptr, static_layout});
@@ -257,14 +375,14 @@ int Storage::Run(int max_wait, const std::string &dataset_name, bool only_metric
     {
         DataLayout static_layout;
         PopulateStaticLayout(static_layout);
-        auto static_handle = setupRegion(shared_register, static_layout);
+        auto static_handle = setupRegion(shared_register, static_layout, config.huge_pages);
         regions.push_back({static_handle.data_ptr, static_layout});
         handles[dataset_name + "/static"] = std::move(static_handle);
     }
 
     DataLayout updatable_layout;
     PopulateUpdatableLayout(updatable_layout);
-    auto updatable_handle = setupRegion(shared_register, updatable_layout);
+    auto updatable_handle = setupRegion(shared_register, updatable_layout, config.huge_pages);
     regions.push_back({updatable_handle.data_ptr, updatable_layout});
     handles[dataset_name + "/updatable"] = std::move(updatable_handle);
 
@@ -294,11 +412,41 @@ void Storage::PopulateStaticLayout(DataLayout &static_layout)
 
         static_layout.SetBlock("/common/rtree/file_index_path",
                                make_block<char>(absolute_file_index_path.string().length() + 1));
+
+        if (config.rtree_leaves_in_memory)
+        {
+            io::FileReader reader(absolute_file_index_path, io::FileReader::HasNoFingerprint);
+            // the leaves have no fingerprint, at least make sure they are whole segments
+            if (reader.GetSize() % sizeof(extractor::EdgeBasedNodeSegment) != 0)
+            {
+                throw util::exception("The R-tree leaves in " + absolute_file_index_path.string() +
+                                      " do not match this version of OSRM" + SOURCE_REF);
+            }
+            static_layout.SetBlock("/common/rtree/leaves",
+                                   make_block<extractor::EdgeBasedNodeSegment>(
+                                       reader.GetSize() / sizeof(extractor::EdgeBasedNodeSegment)));
+        }
     }
 
-    constexpr bool REQUIRED = true;
-    constexpr bool OPTIONAL = false;
-    std::vector<std::pair<bool, boost::filesystem::path>> tar_files = {
+    for (const auto &file : GetStaticFiles())
+    {
+        readBlocks(file, static_layout);
+    }
+
+    readBlocks(config.GetPath(".osrm.geometry"), static_layout, isStaticBlock);
+}
+
+void Storage::PopulateUpdatableLayout(DataLayout &updatable_layout)
+{
+    for (const auto &file : GetUpdatableFiles())
+    {
+        readBlocks(file, updatable_layout, isUpdatableBlock);
+    }
+}
+
+std::vector<boost::filesystem::path> Storage::GetStaticFiles() const
+{
+    return existingFiles({
         {OPTIONAL, config.GetPath(".osrm.cells")},
         {OPTIONAL, config.GetPath(".osrm.partition")},
         {REQUIRED, config.GetPath(".osrm.icd")},
@@ -311,54 +459,23 @@ void Storage::PopulateStaticLayout(DataLayout &static_layout)
         {REQUIRED, config.GetPath(".osrm.edges")},
         {REQUIRED, config.GetPath(".osrm.names")},
         {REQUIRED, config.GetPath(".osrm.ramIndex")},
-    };
-
-    for (const auto &file : tar_files)
-    {
-        if (boost::filesystem::exists(file.second))
-        {
-            readBlocks(file.second, static_layout);
-        }
-        else
-        {
-            if (file.first == REQUIRED)
-            {
-                throw util::exception("Could not find required filed: " +
-                                      std::get<1>(file).string());
-            }
-        }
-    }
+    });
 }
 
-void Storage::PopulateUpdatableLayout(DataLayout &updatable_layout)
+std::vector<boost::filesystem::path> Storage::GetUpdatableFiles() const
 {
-    constexpr bool REQUIRED = true;
-    constexpr bool OPTIONAL = false;
-    std::vector<std::pair<bool, boost::filesystem::path>> tar_files = {
+    return existingFiles({
         {OPTIONAL, config.GetPath(".osrm.mldgr")},
         {OPTIONAL, config.GetPath(".osrm.cell_metrics")},
         {OPTIONAL, config.GetPath(".osrm.hsgr")},
+        {OPTIONAL, config.GetPath(".osrm.shortcuts")},
+        {OPTIONAL, config.GetPath(".osrm.hub_labels")},
+        {OPTIONAL, config.GetPath(".osrm.tnr")},
         {REQUIRED, config.GetPath(".osrm.datasource_names")},
         {REQUIRED, config.GetPath(".osrm.geometry")},
         {REQUIRED, config.GetPath(".osrm.turn_weight_penalties")},
         {REQUIRED, config.GetPath(".osrm.turn_duration_penalties")},
-    };
-
-    for (const auto &file : tar_files)
-    {
-        if (boost::filesystem::exists(file.second))
-        {
-            readBlocks(file.second, updatable_layout);
-        }
-        else
-        {
-            if (file.first == REQUIRED)
-            {
-                throw util::exception("Could not find required filed: " +
-                                      std::get<1>(file).string());
-            }
-        }
-    }
+    });
 }
 
 void Storage::PopulateStaticData(const SharedDataIndex &index)
@@ -366,47 +483,72 @@ void Storage::PopulateStaticData(const SharedDataIndex &index)
     // read actual data into shared memory object //
 
     // store the filename of the on-disk portion of the RTree
+    const auto absolute_file_index_path =
+        boost::filesystem::absolute(config.GetPath(".osrm.fileIndex")).string();
     {
         const auto file_index_path_ptr = index.GetBlockPtr<char>("/common/rtree/file_index_path");
         // make sure we have 0 ending
         std::fill(file_index_path_ptr,
                   file_index_path_ptr + index.GetBlockSize("/common/rtree/file_index_path"),
                   0);
-        const auto absolute_file_index_path =
-            boost::filesystem::absolute(config.GetPath(".osrm.fileIndex")).string();
         BOOST_ASSERT(static_cast<std::size_t>(index.GetBlockSize(
                          "/common/rtree/file_index_path")) >= absolute_file_index_path.size());
         std::copy(
             absolute_file_index_path.begin(), absolute_file_index_path.end(), file_index_path_ptr);
     }
 
-    // Name data
+    // FIXME we only need to get the weight name
+    std::string metric_name;
+    // load profile properties
     {
+        const auto profile_properties_ptr =
+            index.GetBlockPtr<extractor::ProfileProperties>("/common/properties");
+        extractor::files::readProfileProperties(config.GetPath(".osrm.properties"),
+                                                *profile_properties_ptr);
+
+        metric_name = profile_properties_ptr->GetWeightName();
+    }
+
+    // all remaining files are independent of each other
+    std::vector<FileLoader> loaders;
+
+    if (index.HasBlock("/common/rtree/leaves"))
+    {
+        loaders.emplace_back(config.GetPath(".osrm.fileIndex"), [&] {
+            io::FileReader reader(absolute_file_index_path, io::FileReader::HasNoFingerprint);
+            const auto leaves_ptr =
+                index.GetBlockPtr<extractor::EdgeBasedNodeSegment>("/common/rtree/leaves");
+            reader.ReadInto(leaves_ptr, index.GetBlockEntries("/common/rtree/leaves"));
+        });
+    }
+
+    // Name data
+    loaders.emplace_back(config.GetPath(".osrm.names"), [&] {
         auto name_table = make_name_table_view(index, "/common/names");
         extractor::files::readNames(config.GetPath(".osrm.names"), name_table);
-    }
+    });
 
     // Turn lane data
-    {
+    loaders.emplace_back(config.GetPath(".osrm.tld"), [&] {
         auto turn_lane_data = make_lane_data_view(index, "/common/turn_lanes");
         extractor::files::readTurnLaneData(config.GetPath(".osrm.tld"), turn_lane_data);
-    }
+    });
 
     // Turn lane descriptions
-    {
+    loaders.emplace_back(config.GetPath(".osrm.tls"), [&] {
         auto views = make_turn_lane_description_views(index, "/common/turn_lanes");
         extractor::files::readTurnLaneDescriptions(
             config.GetPath(".osrm.tls"), std::get<0>(views), std::get<1>(views));
-    }
+    });
 
     // Load edge-based nodes data
-    {
+    loaders.emplace_back(config.GetPath(".osrm.ebg_nodes"), [&] {
         auto node_data = make_ebn_data_view(index, "/common/ebg_node_data");
         extractor::files::readNodeData(config.GetPath(".osrm.ebg_nodes"), node_data);
-    }
+    });
 
     // Load original edge data
-    {
+    loaders.emplace_back(config.GetPath(".osrm.edges"), [&] {
         auto turn_data = make_turn_data_view(index, "/common/turn_data");
 
         auto connectivity_checksum_ptr =
@@ -414,160 +556,271 @@ void Storage::PopulateStaticData(const SharedDataIndex &index)
 
         guidance::files::readTurnData(
             config.GetPath(".osrm.edges"), turn_data, *connectivity_checksum_ptr);
-    }
+    });
 
     // Loading list of coordinates
-    {
+    loaders.emplace_back(config.GetPath(".osrm.nbg_nodes"), [&] {
         auto views = make_nbn_data_view(index, "/common/nbn_data");
         extractor::files::readNodes(
             config.GetPath(".osrm.nbg_nodes"), std::get<0>(views), std::get<1>(views));
-    }
+    });
 
     // store search tree portion of rtree
-    {
+    loaders.emplace_back(config.GetPath(".osrm.ramIndex"), [&] {
         auto rtree = make_search_tree_view(index, "/common/rtree");
         extractor::files::readRamIndex(config.GetPath(".osrm.ramIndex"), rtree);
-    }
-
-    // FIXME we only need to get the weight name
-    std::string metric_name;
-    // load profile properties
-    {
-        const auto profile_properties_ptr =
-            index.GetBlockPtr<extractor::ProfileProperties>("/common/properties");
-        extractor::files::readProfileProperties(config.GetPath(".osrm.properties"),
-                                                *profile_properties_ptr);
-
-        metric_name = profile_properties_ptr->GetWeightName();
-    }
+        // the version is not part of the tree, readRamIndex only accepts the current one
+        *index.GetBlockPtr<std::uint32_t>("/common/rtree/format_version") =
+            util::RTREE_FORMAT_VERSION;
+    });
 
     // Load intersection data
-    {
+    loaders.emplace_back(config.GetPath(".osrm.icd"), [&] {
         auto intersection_bearings_view =
             make_intersection_bearings_view(index, "/common/intersection_bearings");
         auto entry_classes = make_entry_classes_view(index, "/common/entry_classes");
         extractor::files::readIntersections(
             config.GetPath(".osrm.icd"), intersection_bearings_view, entry_classes);
-    }
+    });
 
     if (boost::filesystem::exists(config.GetPath(".osrm.partition")))
     {
-        auto mlp = make_partition_view(index, "/mld/multilevelpartition");
-        partitioner::files::readPartition(config.GetPath(".osrm.partition"), mlp);
+        loaders.emplace_back(config.GetPath(".osrm.partition"), [&] {
+            auto mlp = make_partition_view(index, "/mld/multilevelpartition");
+            partitioner::files::readPartition(config.GetPath(".osrm.partition"), mlp);
+        });
     }
 
     if (boost::filesystem::exists(config.GetPath(".osrm.cells")))
     {
-        auto storage = make_cell_storage_view(index, "/mld/cellstorage");
-        partitioner::files::readCells(config.GetPath(".osrm.cells"), storage);
+        loaders.emplace_back(config.GetPath(".osrm.cells"), [&] {
+            auto storage = make_cell_storage_view(index, "/mld/cellstorage");
+            partitioner::files::readCells(config.GetPath(".osrm.cells"), storage);
+        });
     }
 
     if (boost::filesystem::exists(config.GetPath(".osrm.cell_metrics")))
     {
-        auto exclude_metrics = make_cell_metric_view(index, "/mld/metrics/" + metric_name);
-        std::unordered_map<std::string, std::vector<customizer::CellMetricView>> metrics = {
-            {metric_name, std::move(exclude_metrics)},
-        };
-        customizer::files::readCellMetrics(config.GetPath(".osrm.cell_metrics"), metrics);
+        loaders.emplace_back(config.GetPath(".osrm.cell_metrics"), [&] {
+            auto exclude_metrics = make_cell_metric_view(index, "/mld/metrics/" + metric_name);
+            std::unordered_map<std::string, std::vector<customizer::CellMetricView>> metrics = {
+                {metric_name, std::move(exclude_metrics)},
+            };
+            customizer::files::readCellMetrics(config.GetPath(".osrm.cell_metrics"), metrics);
+        });
     }
 
+    // load the nodes of the compressed geometry, they do not depend on the metric
+    loaders.emplace_back(config.GetPath(".osrm.geometry"), [&] {
+        readBlocksData(config.GetPath(".osrm.geometry"), index, isStaticBlock);
+    });
+
     // load maneuver overrides
-    {
+    loaders.emplace_back(config.GetPath(".osrm.maneuver_overrides"), [&] {
         auto views = make_maneuver_overrides_views(index, "/common/maneuver_overrides");
         extractor::files::readManeuverOverrides(
             config.GetPath(".osrm.maneuver_overrides"), std::get<0>(views), std::get<1>(views));
-    }
+    });
+
+    loadFiles(std::move(loaders));
 }
 
 void Storage::PopulateUpdatableData(const SharedDataIndex &index)
 {
-    // load compressed geometry
+    // FIXME we only need to get the weight name
+    std::string metric_name;
+    // load profile properties
     {
-        auto segment_data = make_segment_data_view(index, "/common/segment_data");
-        extractor::files::readSegmentData(config.GetPath(".osrm.geometry"), segment_data);
+        extractor::ProfileProperties properties;
+        extractor::files::readProfileProperties(config.GetPath(".osrm.properties"), properties);
+
+        metric_name = properties.GetWeightName();
     }
 
-    {
+    // all files are independent of each other, the connectivity checksums are compared to the
+    // one of the static data that was loaded before
+    std::vector<FileLoader> loaders;
+
+    // load weights, durations and data sources of the compressed geometry
+    loaders.emplace_back(config.GetPath(".osrm.geometry"), [&] {
+        readBlocksData(config.GetPath(".osrm.geometry"), index, isUpdatableBlock);
+    });
+
+    loaders.emplace_back(config.GetPath(".osrm.datasource_names"), [&] {
         const auto datasources_names_ptr =
             index.GetBlockPtr<extractor::Datasources>("/common/data_sources_names");
         extractor::files::readDatasources(config.GetPath(".osrm.datasource_names"),
                                           *datasources_names_ptr);
-    }
+    });
 
     // load turn weight penalties
-    {
+    loaders.emplace_back(config.GetPath(".osrm.turn_weight_penalties"), [&] {
         auto turn_duration_penalties = make_turn_weight_view(index, "/common/turn_penalty");
         extractor::files::readTurnWeightPenalty(config.GetPath(".osrm.turn_weight_penalties"),
                                                 turn_duration_penalties);
-    }
+    });
 
     // load turn duration penalties
-    {
+    loaders.emplace_back(config.GetPath(".osrm.turn_duration_penalties"), [&] {
         auto turn_duration_penalties = make_turn_duration_view(index, "/common/turn_penalty");
         extractor::files::readTurnDurationPenalty(config.GetPath(".osrm.turn_duration_penalties"),
                                                   turn_duration_penalties);
+    });
+
+    if (boost::filesystem::exists(config.GetPath(".osrm.hsgr")))
+    {
+        loaders.emplace_back(config.GetPath(".osrm.hsgr"), [&] {
+            const std::string metric_prefix = "/ch/metrics/" + metric_name;
+            auto contracted_metric = make_contracted_metric_view(index, metric_prefix);
+            std::unordered_map<std::string, contractor::ContractedMetricView> metrics = {
+                {metric_name, std::move(contracted_metric)}};
+
+            std::uint32_t graph_connectivity_checksum = 0;
+            contractor::files::readGraph(
+                config.GetPath(".osrm.hsgr"), metrics, graph_connectivity_checksum);
+
+            auto turns_connectivity_checksum =
+                *index.GetBlockPtr<std::uint32_t>("/common/connectivity_checksum");
+            if (turns_connectivity_checksum != graph_connectivity_checksum)
+            {
+                throw util::exception("Connectivity checksum " +
+                                      std::to_string(graph_connectivity_checksum) + " in " +
+                                      config.GetPath(".osrm.hsgr").string() +
+                                      " does not equal to checksum " +
+                                      std::to_string(turns_connectivity_checksum) + " in " +
+                                      config.GetPath(".osrm.edges").string());
+            }
+        });
     }
 
-    // FIXME we only need to get the weight name
-    std::string metric_name;
-    // load profile properties
+    if (boost::filesystem::exists(config.GetPath(".osrm.shortcuts")))
     {
-        extractor::ProfileProperties properties;
-        extractor::files::readProfileProperties(config.GetPath(".osrm.properties"), properties);
+        loaders.emplace_back(config.GetPath(".osrm.shortcuts"), [&] {
+            const std::string shortcuts_prefix =
+                "/ch/metrics/" + metric_name + "/unpacked_shortcuts/";
+            std::vector<contractor::UnpackedShortcutsView> exclude_shortcuts;
+            while (index.HasBlock(shortcuts_prefix + std::to_string(exclude_shortcuts.size()) +
+                                  "/keys"))
+            {
+                exclude_shortcuts.push_back(make_unpacked_shortcuts_view(
+                    index, shortcuts_prefix + std::to_string(exclude_shortcuts.size())));
+            }
+            std::unordered_map<std::string, std::vector<contractor::UnpackedShortcutsView>>
+                shortcuts = {{metric_name, std::move(exclude_shortcuts)}};
 
-        metric_name = properties.GetWeightName();
+            std::uint32_t shortcuts_connectivity_checksum = 0;
+            contractor::files::readUnpackedShortcuts(
+                config.GetPath(".osrm.shortcuts"), shortcuts, shortcuts_connectivity_checksum);
+
+            auto turns_connectivity_checksum =
+                *index.GetBlockPtr<std::uint32_t>("/common/connectivity_checksum");
+            if (turns_connectivity_checksum != shortcuts_connectivity_checksum)
+            {
+                throw util::exception(
+                    "Connectivity checksum " + std::to_string(shortcuts_connectivity_checksum) +
+                    " in " + config.GetPath(".osrm.shortcuts").string() +
+                    " does not equal to checksum " + std::to_string(turns_connectivity_checksum) +
+                    " in " + config.GetPath(".osrm.edges").string());
+            }
+        });
     }
 
-    if (boost::filesystem::exists(config.GetPath(".osrm.hsgr")))
+    if (boost::filesystem::exists(config.GetPath(".osrm.hub_labels")))
     {
-        const std::string metric_prefix = "/ch/metrics/" + metric_name;
-        auto contracted_metric = make_contracted_metric_view(index, metric_prefix);
-        std::unordered_map<std::string, contractor::ContractedMetricView> metrics = {
-            {metric_name, std::move(contracted_metric)}};
-
-        std::uint32_t graph_connectivity_checksum = 0;
-        contractor::files::readGraph(
-            config.GetPath(".osrm.hsgr"), metrics, graph_connectivity_checksum);
-
-        auto turns_connectivity_checksum =
-            *index.GetBlockPtr<std::uint32_t>("/common/connectivity_checksum");
-        if (turns_connectivity_checksum != graph_connectivity_checksum)
-        {
-            throw util::exception(
-                "Connectivity checksum " + std::to_string(graph_connectivity_checksum) + " in " +
-                config.GetPath(".osrm.hsgr").string() + " does not equal to checksum " +
-                std::to_string(turns_connectivity_checksum) + " in " +
-                config.GetPath(".osrm.edges").string());
-        }
+        loaders.emplace_back(config.GetPath(".osrm.hub_labels"), [&] {
+            const std::string labels_prefix = "/ch/metrics/" + metric_name + "/hub_labels/";
+            std::vector<contractor::HubLabelsView> exclude_labels;
+            while (index.HasBlock(labels_prefix + std::to_string(exclude_labels.size()) +
+                                  "/entry_offsets"))
+            {
+                exclude_labels.push_back(make_hub_labels_view(
+                    index, labels_prefix + std::to_string(exclude_labels.size())));
+            }
+            std::unordered_map<std::string, std::vector<contractor::HubLabelsView>> labels = {
+                {metric_name, std::move(exclude_labels)}};
+
+            std::uint32_t labels_connectivity_checksum = 0;
+            contractor::files::readHubLabels(
+                config.GetPath(".osrm.hub_labels"), labels, labels_connectivity_checksum);
+
+            auto turns_connectivity_checksum =
+                *index.GetBlockPtr<std::uint32_t>("/common/connectivity_checksum");
+            if (turns_connectivity_checksum != labels_connectivity_checksum)
+            {
+                throw util::exception(
+                    "Connectivity checksum " + std::to_string(labels_connectivity_checksum) +
+                    " in " + config.GetPath(".osrm.hub_labels").string() +
+                    " does not equal to checksum " + std::to_string(turns_connectivity_checksum) +
+                    " in " + config.GetPath(".osrm.edges").string());
+            }
+        });
+    }
+
+    if (boost::filesystem::exists(config.GetPath(".osrm.tnr")))
+    {
+        loaders.emplace_back(config.GetPath(".osrm.tnr"), [&] {
+            const std::string transit_prefix = "/ch/metrics/" + metric_name + "/transit_nodes/";
+            std::vector<contractor::TransitNodesView> exclude_transit_nodes;
+            while (index.HasBlock(transit_prefix + std::to_string(exclude_transit_nodes.size()) +
+                                  "/access_offsets"))
+            {
+                exclude_transit_nodes.push_back(make_transit_nodes_view(
+                    index, transit_prefix + std::to_string(exclude_transit_nodes.size())));
+            }
+            std::unordered_map<std::string, std::vector<contractor::TransitNodesView>>
+                transit_nodes = {{metric_name, std::move(exclude_transit_nodes)}};
+
+            std::uint32_t transit_connectivity_checksum = 0;
+            contractor::files::readTransitNodes(
+                config.GetPath(".osrm.tnr"), transit_nodes, transit_connectivity_checksum);
+
+            auto turns_connectivity_checksum =
+                *index.GetBlockPtr<std::uint32_t>("/common/connectivity_checksum");
+            if (turns_connectivity_checksum != transit_connectivity_checksum)
+            {
+                throw util::exception(
+                    "Connectivity checksum " + std::to_string(transit_connectivity_checksum) +
+                    " in " + config.GetPath(".osrm.tnr").string() +
+                    " does not equal to checksum " + std::to_string(turns_connectivity_checksum) +
+                    " in " + config.GetPath(".osrm.edges").string());
+            }
+        });
     }
 
     if (boost::filesystem::exists(config.GetPath(".osrm.cell_metrics")))
     {
-        auto exclude_metrics = make_cell_metric_view(index, "/mld/metrics/" + metric_name);
-        std::unordered_map<std::string, std::vector<customizer::CellMetricView>> metrics = {
-            {metric_name, std::move(exclude_metrics)},
-        };
-        customizer::files::readCellMetrics(config.GetPath(".osrm.cell_metrics"), metrics);
+        loaders.emplace_back(config.GetPath(".osrm.cell_metrics"), [&] {
+            auto exclude_metrics = make_cell_metric_view(index, "/mld/metrics/" + metric_name);
+            std::unordered_map<std::string, std::vector<customizer::CellMetricView>> metrics = {
+                {metric_name, std::move(exclude_metrics)},
+            };
+            customizer::files::readCellMetrics(config.GetPath(".osrm.cell_metrics"), metrics);
+        });
     }
 
     if (boost::filesystem::exists(config.GetPath(".osrm.mldgr")))
     {
-        auto graph_view = make_multi_level_graph_view(index, "/mld/multilevelgraph");
-        std::uint32_t graph_connectivity_checksum = 0;
-        customizer::files::readGraph(
-            config.GetPath(".osrm.mldgr"), graph_view, graph_connectivity_checksum);
-
-        auto turns_connectivity_checksum =
-            *index.GetBlockPtr<std::uint32_t>("/common/connectivity_checksum");
-        if (turns_connectivity_checksum != graph_connectivity_checksum)
-        {
-            throw util::exception(
-                "Connectivity checksum " + std::to_string(graph_connectivity_checksum) + " in " +
-                config.GetPath(".osrm.hsgr").string() + " does not equal to checksum " +
-                std::to_string(turns_connectivity_checksum) + " in " +
-                config.GetPath(".osrm.edges").string());
-        }
+        loaders.emplace_back(config.GetPath(".osrm.mldgr"), [&] {
+            auto graph_view = make_multi_level_graph_view(index, "/mld/multilevelgraph");
+            std::uint32_t graph_connectivity_checksum = 0;
+            customizer::files::readGraph(
+                config.GetPath(".osrm.mldgr"), graph_view, graph_connectivity_checksum);
+
+            auto turns_connectivity_checksum =
+                *index.GetBlockPtr<std::uint32_t>("/common/connectivity_checksum");
+            if (turns_connectivity_checksum != graph_connectivity_checksum)
+            {
+                throw util::exception("Connectivity checksum " +
+                                      std::to_string(graph_connectivity_checksum) + " in " +
+                                      config.GetPath(".osrm.hsgr").string() +
+                                      " does not equal to checksum " +
+                                      std::to_string(turns_connectivity_checksum) + " in " +
+                                      config.GetPath(".osrm.edges").string());
+            }
+        });
     }
+
+    loadFiles(std::move(loaders));
 }
 }
 }
@@ -81,7 +81,26 @@ return_code parseArguments(int argc,
         "time-zone-file",
         boost::program_options::value<std::string>(&contractor_config.updater_config.tz_file_path),
         "Required for conditional turn restriction parsing, provide a geojson file containing "
-        "time zone boundaries");
+        "time zone boundaries")(
+        "unpack-shortcuts-min-edges",
+        boost::program_options::value<unsigned>(&contractor_config.unpack_shortcuts_min_edges)
+            ->default_value(0),
+        "Store the unpacked path of all shortcuts that consist of at least this many original "
+        "edges in the .osrm.shortcuts file to speed up path unpacking. 0 disables it.")(
+        "cch",
+        boost::program_options::bool_switch(&contractor_config.use_cch)->default_value(false),
+        "Use the nested dissection order of .osrm.partition and customize the cached .osrm.cch "
+        "topology instead of contracting the graph from scratch.")(
+        "hub-labels",
+        boost::program_options::bool_switch(&contractor_config.use_hub_labels)
+            ->default_value(false),
+        "Compute hub labels from the contraction hierarchy and store them in .osrm.hub_labels "
+        "to answer duration-only table requests without a graph search.")(
+        "transit-nodes",
+        boost::program_options::value<unsigned>(&contractor_config.transit_nodes)->default_value(0),
+        "Use this many of the highest nodes of the contraction hierarchy as transit nodes and "
+        "store their distance table in .osrm.tnr to answer long-distance table requests by "
+        "lookups. 0 disables it.");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
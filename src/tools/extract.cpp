@@ -71,7 +71,18 @@ return_code parseArguments(int argc,
         boost::program_options::bool_switch(&extractor_config.use_locations_cache)
             ->implicit_value(false)
             ->default_value(true),
-        "Use internal nodes locations cache for location-dependent data lookups");
+        "Use internal nodes locations cache for location-dependent data lookups")(
+        "rtree-coordinates",
+        boost::program_options::value<bool>(&extractor_config.store_rtree_coordinates)
+            ->default_value(true),
+        "Store the projected coordinates of the R-tree segments in .osrm.ramIndex. They take "
+        "about 8 bytes per segment and save projecting them on every nearest query.")(
+        "compress-cold-data",
+        boost::program_options::bool_switch(&extractor_config.compress_cold_data)
+            ->default_value(false),
+        "Compress the names, turn lanes, maneuver overrides and intersection classes, which are "
+        "only read when loading the data. This saves disk space and I/O but takes more time to "
+        "load.");
 
     bool dummy;
     // hidden options, will be allowed on command line, but will not be
@@ -1,3 +1,4 @@
+#include "server/query_replay.hpp"
 #include "server/server.hpp"
 #include "util/exception_utils.hpp"
 #include "util/log.hpp"
@@ -26,6 +27,7 @@
 #include <new>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -81,7 +83,9 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              int &ip_port,
                                              bool &trial,
                                              EngineConfig &config,
-                                             int &requested_thread_num)
+                                             int &requested_thread_num,
+                                             boost::filesystem::path &warmup_queries,
+                                             std::vector<std::string> &profiles)
 {
     using boost::filesystem::path;
     using boost::program_options::value;
@@ -120,9 +124,41 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("memory_file",
          value<boost::filesystem::path>(&config.memory_file),
          "Store data in a memory mapped file rather than in process memory.") //
+        ("mmap",
+         value<bool>(&config.use_mmap)->implicit_value(true)->default_value(false),
+         "Map the data files into memory instead of loading them. Processes using the same "
+         "files share their memory.") //
+        ("numa-replicas",
+         value<bool>(&config.use_numa_replicas)->implicit_value(true)->default_value(false),
+         "Copy the query graph, the cell metrics, the coordinates and the R-tree into the memory "
+         "of every NUMA node and pin the server threads to the nodes.") //
+        ("prefault",
+         value<bool>(&config.prefault_data)->implicit_value(true)->default_value(false),
+         "Bring the query graph, the cell metrics, the coordinates and the R-tree into memory "
+         "before serving requests and before a data update becomes active.") //
+        ("warmup-queries",
+         value<boost::filesystem::path>(&warmup_queries),
+         "Replay the request URLs in this file, one per line, before serving requests and "
+         "before a data update becomes active.") //
+        ("rtree-leaves-in-memory",
+         value<bool>(&config.storage_config.rtree_leaves_in_memory)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Load the leaves of the R-tree from the .fileIndex file as well, instead of reading them "
+         "on demand. Has no effect with shared memory, see osrm-datastore.") //
+        ("huge-pages",
+         value<bool>(&config.storage_config.huge_pages)->implicit_value(true)->default_value(false),
+         "Back the loaded or mapped data with transparent huge pages. Has no effect with shared "
+         "memory, see osrm-datastore.") //
         ("dataset-name",
          value<std::string>(&config.dataset_name),
          "Name of the shared memory dataset to connect to.") //
+        ("profile",
+         value<std::vector<std::string>>(&profiles)->composing(),
+         "Answer requests for a profile, e.g. /route/v1/<name>/..., from another dataset given as "
+         "<name>=<base.osrm>, or as <name>=<dataset name> with shared memory. Can be repeated. "
+         "All profiles share the threads, identical names and nodes are loaded only once. "
+         "Several profiles require CH.") //
         ("algorithm,a",
          value<EngineConfig::Algorithm>(&config.algorithm)
              ->default_value(EngineConfig::Algorithm::CH, "CH"),
@@ -147,7 +183,39 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. number of alternatives supported in the MLD route query") //
         ("max-matching-radius",
          value<double>(&config.max_radius_map_matching)->default_value(-1.0),
-         "Max. radius size supported in map matching query. Default: unlimited.");
+         "Max. radius size supported in map matching query. Default: unlimited.") //
+        ("mld-unpacking-cache-size",
+         value<int>(&config.mld_unpacking_cache_size)->default_value(0),
+         "Max. number of unpacked MLD overlay shortcuts to cache across requests. Default: 0 "
+         "(disabled).") //
+        ("hub-labels",
+         value<bool>(&config.use_hub_labels)->implicit_value(true)->default_value(false),
+         "Answer duration tables from the hub labels of a CH dataset, see osrm-contract "
+         "--hub-labels") //
+        ("transit-nodes",
+         value<bool>(&config.use_transit_nodes)->implicit_value(true)->default_value(false),
+         "Answer duration tables from the transit nodes of a CH dataset, see osrm-contract "
+         "--transit-nodes") //
+        ("map-matching-window",
+         value<int>(&config.map_matching_window)->default_value(0),
+         "Max. number of locations matched at once, longer traces are matched in consecutive "
+         "windows. Default: 0 (disabled).") //
+        ("max-matching-sessions",
+         value<int>(&config.max_matching_sessions)->default_value(0),
+         "Max. number of map matching sessions whose candidates and transitions are kept for the "
+         "next request of the session. Default: 0 (disabled).") //
+        ("trip-local-search-time",
+         value<int>(&config.trip_local_search_time)->default_value(0),
+         "Max. time in milliseconds spent on improving a trip of more than 9 locations by local "
+         "search. Default: 0 (disabled).") //
+        ("snapping-cache-size",
+         value<int>(&config.snapping_cache_size)->default_value(0),
+         "Max. number of snapped coordinates whose phantom nodes are cached for requests without "
+         "hints. Default: 0 (disabled).") //
+        ("snapping-cache-precision",
+         value<int>(&config.snapping_cache_precision)->default_value(6),
+         "Number of decimal places in which coordinates need to match to share a snapping cache "
+         "entry, from 0 to 6. Values below 6 can miss candidates. Default: 6 (exact).");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -197,7 +265,13 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
-    if (!config.use_shared_memory && option_variables.count("base"))
+    if (config.use_mmap && (config.use_shared_memory || !config.memory_file.empty()))
+    {
+        util::Log(logERROR) << "--mmap can not be combined with --shared-memory or --memory_file";
+        return INIT_FAILED;
+    }
+
+    if (!config.use_shared_memory && (option_variables.count("base") || !profiles.empty()))
     {
         return INIT_OK_START_ENGINE;
     }
@@ -227,10 +301,20 @@ int main(int argc, const char *argv[]) try
 
     EngineConfig config;
     boost::filesystem::path base_path;
+    boost::filesystem::path warmup_queries;
+    std::vector<std::string> profiles;
 
     int requested_thread_num = 1;
-    const unsigned init_result = generateServerProgramOptions(
-        argc, argv, base_path, ip_address, ip_port, trial_run, config, requested_thread_num);
+    const unsigned init_result = generateServerProgramOptions(argc,
+                                                              argv,
+                                                              base_path,
+                                                              ip_address,
+                                                              ip_port,
+                                                              trial_run,
+                                                              config,
+                                                              requested_thread_num,
+                                                              warmup_queries,
+                                                              profiles);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -242,22 +326,103 @@ int main(int argc, const char *argv[]) try
 
     util::LogPolicy::GetInstance().SetLevel(config.verbosity);
 
-    if (!base_path.empty())
+    const auto makeStorageConfig = [&config](const boost::filesystem::path &path) {
+        storage::StorageConfig storage_config(path);
+        storage_config.rtree_leaves_in_memory = config.storage_config.rtree_leaves_in_memory;
+        storage_config.huge_pages = config.storage_config.huge_pages;
+        return storage_config;
+    };
+
+    // every profile is a copy of the configuration with its own dataset
+    std::vector<std::pair<std::string, EngineConfig>> profile_configs;
+    for (const auto &profile : profiles)
     {
-        config.storage_config = storage::StorageConfig(base_path);
+        const auto separator = profile.find('=');
+        if (separator == std::string::npos || separator == 0 || separator + 1 == profile.size())
+        {
+            util::Log(logERROR) << "Invalid profile \"" << profile
+                                << "\", expected <name>=<base.osrm> or <name>=<dataset name>";
+            return EXIT_FAILURE;
+        }
+
+        auto profile_config = config;
+        const auto dataset = profile.substr(separator + 1);
+        if (config.use_shared_memory)
+        {
+            profile_config.dataset_name = dataset;
+        }
+        else
+        {
+            profile_config.storage_config = makeStorageConfig(dataset);
+            if (!profile_config.storage_config.IsValid())
+            {
+                util::Log(logERROR) << "Required files of profile " << profile
+                                    << " are missing, cannot continue";
+                return EXIT_FAILURE;
+            }
+        }
+        if (!profile_config.IsValid())
+        {
+            util::Log(logERROR) << "Invalid configuration of profile " << profile;
+            return EXIT_FAILURE;
+        }
+        profile_configs.emplace_back(profile.substr(0, separator), std::move(profile_config));
     }
-    if (!config.use_shared_memory && !config.storage_config.IsValid())
+
+    // the base path or shared memory dataset answers requests of all other profiles
+    const bool serve_default_profile =
+        config.use_shared_memory ? profiles.empty() : !base_path.empty();
+
+    // the MLD heaps of a thread are sized for one dataset and shared by all engines
+    if (config.algorithm == EngineConfig::Algorithm::MLD &&
+        profile_configs.size() + (serve_default_profile ? 1 : 0) > 1)
     {
-        util::Log(logERROR) << "Required files are missing, cannot continue";
+        util::Log(logERROR) << "MLD can only serve one dataset, use CH for several profiles";
         return EXIT_FAILURE;
     }
-    if (!config.IsValid())
+
+    // every dataset replays the queries of the profiles it answers
+    if (!warmup_queries.empty())
     {
-        if (base_path.empty() != config.use_shared_memory)
+        const auto queries = server::readQueryLog(warmup_queries);
+        std::vector<std::string> profile_names;
+        for (const auto &profile_config : profile_configs)
         {
-            util::Log(logWARNING) << "Path settings and shared memory conflicts.";
+            profile_names.push_back(profile_config.first);
+        }
+
+        const auto set_warmup = [&](EngineConfig &engine_config, const std::string &profile) {
+            auto profile_queries = std::make_shared<const std::vector<std::string>>(
+                server::selectProfileQueries(queries, profile, profile_names));
+            engine_config.warmup = [profile_queries](const engine::EngineInterface &engine) {
+                server::replayQueries(engine, *profile_queries);
+            };
+        };
+        set_warmup(config, "");
+        for (auto &profile_config : profile_configs)
+        {
+            set_warmup(profile_config.second, profile_config.first);
+        }
+    }
+    if (serve_default_profile)
+    {
+        if (!base_path.empty())
+        {
+            config.storage_config = makeStorageConfig(base_path);
+        }
+        if (!config.use_shared_memory && !config.storage_config.IsValid())
+        {
+            util::Log(logERROR) << "Required files are missing, cannot continue";
+            return EXIT_FAILURE;
+        }
+        if (!config.IsValid())
+        {
+            if (base_path.empty() != config.use_shared_memory)
+            {
+                util::Log(logWARNING) << "Path settings and shared memory conflicts.";
+            }
+            return EXIT_FAILURE;
         }
-        return EXIT_FAILURE;
     }
 
     util::Log() << "starting up engines, " << OSRM_VERSION;
@@ -281,10 +446,19 @@ int main(int argc, const char *argv[]) try
     pthread_sigmask(SIG_BLOCK, &wait_mask, nullptr); // only block necessary signals
 #endif
 
-    auto service_handler = std::make_unique<server::ServiceHandler>(config);
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    auto routing_server = server::Server::CreateServer(
+        ip_address, ip_port, requested_thread_num, config.use_numa_replicas);
 
-    routing_server->RegisterServiceHandler(std::move(service_handler));
+    if (serve_default_profile)
+    {
+        routing_server->RegisterServiceHandler(std::make_unique<server::ServiceHandler>(config));
+    }
+    for (auto &profile_config : profile_configs)
+    {
+        util::Log() << "Loading profile " << profile_config.first;
+        routing_server->RegisterServiceHandler(
+            profile_config.first, std::make_unique<server::ServiceHandler>(profile_config.second));
+    }
 
     if (trial_run)
     {
@@ -100,7 +100,9 @@ bool generateDataStoreOptions(const int argc,
                               std::string &dataset_name,
                               bool &list_datasets,
                               bool &list_blocks,
-                              bool &only_metric)
+                              bool &only_metric,
+                              bool &rtree_leaves_in_memory,
+                              bool &huge_pages)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -141,7 +143,19 @@ bool generateDataStoreOptions(const int argc,
                 ->implicit_value(true),
             "Only reload the metric data without updating the full dataset. This is an "
             "optimization "
-            "for traffic updates.");
+            "for traffic updates.")(
+            "rtree-leaves-in-memory",
+            boost::program_options::value<bool>(&rtree_leaves_in_memory)
+                ->default_value(false)
+                ->implicit_value(true),
+            "Load the leaves of the R-tree from the .fileIndex file into shared memory as well, "
+            "so that snapping never reads from disk.")(
+            "huge-pages",
+            boost::program_options::value<bool>(&huge_pages)
+                ->default_value(false)
+                ->implicit_value(true),
+            "Back the shared memory regions with huge pages. Uses explicit huge pages if enough "
+            "are reserved and transparent huge pages otherwise.");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -238,6 +252,8 @@ int main(const int argc, const char *argv[]) try
     bool list_datasets = false;
     bool list_blocks = false;
     bool only_metric = false;
+    bool rtree_leaves_in_memory = false;
+    bool huge_pages = false;
     if (!generateDataStoreOptions(argc,
                                   argv,
                                   verbosity,
@@ -246,7 +262,9 @@ int main(const int argc, const char *argv[]) try
                                   dataset_name,
                                   list_datasets,
                                   list_blocks,
-                                  only_metric))
+                                  only_metric,
+                                  rtree_leaves_in_memory,
+                                  huge_pages))
     {
         return EXIT_SUCCESS;
     }
@@ -260,6 +278,8 @@ int main(const int argc, const char *argv[]) try
     }
 
     storage::StorageConfig config(base_path);
+    config.rtree_leaves_in_memory = rtree_leaves_in_memory;
+    config.huge_pages = huge_pages;
     if (!config.IsValid())
     {
         util::Log(logERROR) << "Config contains invalid file paths. Exiting!";
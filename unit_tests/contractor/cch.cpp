@@ -0,0 +1,207 @@
+#include "contractor/cch_customizer.hpp"
+#include "contractor/cch_topology.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+BOOST_AUTO_TEST_SUITE(cch)
+
+namespace
+{
+/*
+ * 0 - 1 > 2
+ * |   |   v
+ * 3 - 4 - 5
+ *
+ * 1 -> 2 and 2 -> 5 are oneways, all other edges can be used in both directions.
+ */
+std::vector<extractor::EdgeBasedEdge> makeEdges()
+{
+    return {extractor::EdgeBasedEdge{0, 1, 0, 2, 4, true, true},
+            extractor::EdgeBasedEdge{1, 2, 1, 3, 6, true, false},
+            extractor::EdgeBasedEdge{3, 4, 2, 5, 10, true, true},
+            extractor::EdgeBasedEdge{4, 5, 3, 7, 14, true, true},
+            extractor::EdgeBasedEdge{0, 3, 4, 1, 2, true, true},
+            extractor::EdgeBasedEdge{1, 4, 5, 9, 18, true, true},
+            extractor::EdgeBasedEdge{2, 5, 6, 4, 8, true, false}};
+}
+
+std::vector<std::pair<NodeID, NodeID>>
+makeNodePairs(const std::vector<extractor::EdgeBasedEdge> &edges)
+{
+    std::vector<std::pair<NodeID, NodeID>> node_pairs;
+    for (const auto &edge : edges)
+        node_pairs.emplace_back(edge.source, edge.target);
+    return node_pairs;
+}
+
+// Plain Dijkstra on the input edges, only using nodes that pass the filter
+std::vector<EdgeWeight> computeDistances(const std::vector<extractor::EdgeBasedEdge> &edges,
+                                         const std::vector<bool> &node_filter,
+                                         const NodeID source)
+{
+    std::vector<EdgeWeight> distance(node_filter.size(), INVALID_EDGE_WEIGHT);
+    std::vector<bool> settled(node_filter.size(), false);
+    distance[source] = 0;
+    while (true)
+    {
+        NodeID node = SPECIAL_NODEID;
+        for (const auto candidate : util::irange<NodeID>(0, distance.size()))
+        {
+            if (!settled[candidate] && distance[candidate] != INVALID_EDGE_WEIGHT &&
+                (node == SPECIAL_NODEID || distance[candidate] < distance[node]))
+                node = candidate;
+        }
+        if (node == SPECIAL_NODEID)
+            break;
+        settled[node] = true;
+
+        for (const auto &edge : edges)
+        {
+            if (!node_filter[edge.source] || !node_filter[edge.target])
+                continue;
+            if (edge.data.forward && edge.source == node)
+                distance[edge.target] =
+                    std::min(distance[edge.target], distance[node] + edge.data.weight);
+            if (edge.data.backward && edge.target == node)
+                distance[edge.source] =
+                    std::min(distance[edge.source], distance[node] + edge.data.weight);
+        }
+    }
+    return distance;
+}
+
+// Upward search with all edges of the given direction, the same way the CH query searches
+std::vector<EdgeWeight>
+searchUpward(const std::vector<QueryEdge> &query_edges, const NodeID source, const bool forward)
+{
+    std::vector<EdgeWeight> distance(6, INVALID_EDGE_WEIGHT);
+    distance[source] = 0;
+    // edges are sorted by their lower node so all upward paths are relaxed in one pass
+    // as long as the order is the identity
+    for (const auto &edge : query_edges)
+    {
+        if (edge.source == edge.target || distance[edge.source] == INVALID_EDGE_WEIGHT)
+            continue;
+        if (forward ? edge.data.forward : edge.data.backward)
+            distance[edge.target] =
+                std::min(distance[edge.target], distance[edge.source] + edge.data.weight);
+    }
+    return distance;
+}
+
+EdgeWeight
+query(const std::vector<QueryEdge> &query_edges, const NodeID source, const NodeID target)
+{
+    const auto forward = searchUpward(query_edges, source, true);
+    const auto backward = searchUpward(query_edges, target, false);
+    EdgeWeight best = INVALID_EDGE_WEIGHT;
+    for (const auto node : util::irange<std::size_t>(0, forward.size()))
+    {
+        if (forward[node] != INVALID_EDGE_WEIGHT && backward[node] != INVALID_EDGE_WEIGHT)
+            best = std::min(best, forward[node] + backward[node]);
+    }
+    return best;
+}
+}
+
+BOOST_AUTO_TEST_CASE(topology_is_chordal)
+{
+    const auto topology = buildCCHTopology({0, 1, 2, 3, 4, 5}, makeNodePairs(makeEdges()));
+
+    BOOST_CHECK_EQUAL(topology.GetNumberOfNodes(), 6);
+    // contracting 0 adds 1 - 3, contracting 1 adds 2 - 3 and 2 - 4, contracting 2 adds 3 - 5
+    BOOST_CHECK_EQUAL(topology.GetNumberOfArcs(), 11);
+
+    for (const auto node : util::irange<NodeID>(0, topology.GetNumberOfNodes()))
+    {
+        for (const auto first : topology.GetUpwardArcs(node))
+        {
+            for (const auto second : topology.GetUpwardArcs(node))
+            {
+                if (topology.head[first] < topology.head[second])
+                    BOOST_CHECK(topology.FindArc(topology.head[first], topology.head[second]) !=
+                                SPECIAL_EDGEID);
+            }
+        }
+        for (const auto arc : topology.GetDownwardArcs(node))
+        {
+            BOOST_CHECK_EQUAL(topology.head[topology.in_arc[arc]], node);
+            BOOST_CHECK_LT(topology.tail[arc], node);
+        }
+    }
+
+    // every node is customized after all of its lower neighbours
+    std::vector<std::size_t> level(topology.GetNumberOfNodes());
+    for (const auto index : util::irange<std::size_t>(0, topology.level_offsets.size() - 1))
+    {
+        for (auto position = topology.level_offsets[index];
+             position < topology.level_offsets[index + 1];
+             ++position)
+            level[topology.level_nodes[position]] = index;
+    }
+    for (const auto node : util::irange<NodeID>(0, topology.GetNumberOfNodes()))
+    {
+        for (const auto arc : topology.GetDownwardArcs(node))
+            BOOST_CHECK_LT(level[topology.tail[arc]], level[node]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(customization_preserves_distances)
+{
+    const auto edges = makeEdges();
+    const auto topology = buildCCHTopology({0, 1, 2, 3, 4, 5}, makeNodePairs(edges));
+    const std::vector<EdgeWeight> node_weights(6, 1);
+
+    const auto check_distances = [&](const std::vector<bool> &node_filter) {
+        const auto query_edges = customizeCCH(topology, edges, node_weights, node_filter);
+        for (const auto source : util::irange<NodeID>(0, 6))
+        {
+            const auto distances = computeDistances(edges, node_filter, source);
+            for (const auto target : util::irange<NodeID>(0, 6))
+            {
+                if (!node_filter[source] || !node_filter[target])
+                    continue;
+                BOOST_CHECK_EQUAL(query(query_edges, source, target), distances[target]);
+            }
+        }
+    };
+
+    check_distances(std::vector<bool>(6, true));
+    check_distances({true, false, true, true, true, true});
+    check_distances({true, true, true, true, false, true});
+}
+
+BOOST_AUTO_TEST_CASE(nested_dissection_order)
+{
+    // node:                 0  1  2  3  4  5
+    std::vector<CellID> l1{{0, 0, 1, 0, 0, 1}};
+    const partitioner::MultiLevelPartition mlp{{l1}, {2}};
+
+    const auto edges = makeNodePairs(makeEdges());
+    const auto order = computeNestedDissectionOrder(mlp, 6, edges);
+    BOOST_REQUIRE_EQUAL(order.size(), 6);
+
+    // the two nodes with the highest rank separate both cells
+    const auto is_separator = [&](const NodeID node) {
+        return node == order[4] || node == order[5];
+    };
+    for (const auto &edge : edges)
+    {
+        if (mlp.GetCell(1, edge.first) != mlp.GetCell(1, edge.second))
+            BOOST_CHECK(is_separator(edge.first) || is_separator(edge.second));
+    }
+
+    auto sorted_order = order;
+    std::sort(sorted_order.begin(), sorted_order.end());
+    BOOST_CHECK_EQUAL(sorted_order.front(), 0);
+    BOOST_CHECK(std::unique(sorted_order.begin(), sorted_order.end()) == sorted_order.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -55,4 +55,131 @@ BOOST_AUTO_TEST_CASE(read_write_hsgr)
                             reference_metrics["duration"].edge_filter[3]);
 }
 
+BOOST_AUTO_TEST_CASE(read_write_unpacked_shortcuts)
+{
+    auto reference_connectivity_checksum = 0xDEADBEEF;
+    std::vector<NodeID> nodes = {1, 2, 3, 2, 3};
+    std::vector<EdgeID> edges = {0, 3, 4, 3, 4};
+
+    UnpackedShortcuts reference_shortcuts;
+    reference_shortcuts.Add(2, false, nodes.begin(), nodes.begin() + 3, edges.begin());
+    reference_shortcuts.Add(5, true, nodes.begin() + 3, nodes.end(), edges.begin() + 3);
+
+    std::unordered_map<std::string, std::vector<UnpackedShortcuts>> reference_metrics = {
+        {"duration", {reference_shortcuts, UnpackedShortcuts{}}}};
+
+    TemporaryFile tmp{TEST_DATA_DIR "/read_write_shortcuts_test.osrm.shortcuts"};
+    contractor::files::writeUnpackedShortcuts(
+        tmp.path, reference_metrics, reference_connectivity_checksum);
+
+    unsigned connectivity_checksum;
+
+    std::unordered_map<std::string, std::vector<UnpackedShortcuts>> metrics = {{"duration", {}}};
+    contractor::files::readUnpackedShortcuts(tmp.path, metrics, connectivity_checksum);
+
+    BOOST_CHECK_EQUAL(connectivity_checksum, reference_connectivity_checksum);
+    BOOST_REQUIRE_EQUAL(metrics["duration"].size(), 2);
+    BOOST_CHECK(metrics["duration"][1].Empty());
+
+    const auto &shortcuts = metrics["duration"][0];
+    BOOST_CHECK_EQUAL(shortcuts.GetNumberOfShortcuts(), 2);
+    BOOST_CHECK_EQUAL(shortcuts.GetNumberOfOriginalEdges(), 5);
+    BOOST_CHECK(shortcuts.Find(2, true) == UnpackedShortcuts::INVALID_SHORTCUT);
+
+    std::vector<NodeID> unpacked_nodes;
+    std::vector<EdgeID> unpacked_edges;
+    shortcuts.ForEachEdge(shortcuts.Find(5, true), [&](const NodeID node, const EdgeID edge) {
+        unpacked_nodes.push_back(node);
+        unpacked_edges.push_back(edge);
+    });
+    CHECK_EQUAL_RANGE(unpacked_nodes, 2, 3);
+    CHECK_EQUAL_RANGE(unpacked_edges, 3, 4);
+}
+
+BOOST_AUTO_TEST_CASE(read_write_hub_labels)
+{
+    auto reference_connectivity_checksum = 0xDEADBEEF;
+    std::vector<HubLabelEntry> forward_label = {{0, 0, 0}, {1, 5, 10}, {300, 7, 14}};
+    std::vector<HubLabelEntry> backward_label = {{0, 0, 0}, {300, 3, 6}};
+    std::vector<HubLabelEntry> target_label = {{1, 0, 0}};
+
+    HubLabels reference_labels;
+    reference_labels.Add(forward_label.begin(), forward_label.end());
+    reference_labels.Add(backward_label.begin(), backward_label.end());
+    reference_labels.Add(target_label.begin(), target_label.end());
+    reference_labels.Add(target_label.begin(), target_label.end());
+
+    std::unordered_map<std::string, std::vector<HubLabels>> reference_metrics = {
+        {"duration", {reference_labels}}};
+
+    TemporaryFile tmp{TEST_DATA_DIR "/read_write_hub_labels_test.osrm.hub_labels"};
+    contractor::files::writeHubLabels(tmp.path, reference_metrics, reference_connectivity_checksum);
+
+    unsigned connectivity_checksum;
+
+    std::unordered_map<std::string, std::vector<HubLabels>> metrics = {{"duration", {}}};
+    contractor::files::readHubLabels(tmp.path, metrics, connectivity_checksum);
+
+    BOOST_CHECK_EQUAL(connectivity_checksum, reference_connectivity_checksum);
+    BOOST_REQUIRE_EQUAL(metrics["duration"].size(), 1);
+
+    const auto &labels = metrics["duration"][0];
+    BOOST_CHECK_EQUAL(labels.GetNumberOfNodes(), 2);
+    BOOST_CHECK_EQUAL(labels.GetNumberOfEntries(), 7);
+    // the delta 299 needs two bytes
+    BOOST_CHECK_EQUAL(labels.GetNumberOfHubBytes(), 9);
+
+    std::vector<NodeID> hubs;
+    labels.ForEachHub(0, true, [&](const NodeID hub, const EdgeWeight, const EdgeDuration) {
+        hubs.push_back(hub);
+    });
+    CHECK_EQUAL_RANGE(hubs, 0, 1, 300);
+
+    BOOST_CHECK_EQUAL(labels.Query(0, 1).first, 5);
+    BOOST_CHECK_EQUAL(labels.Query(0, 1).second, 10);
+    BOOST_CHECK_EQUAL(labels.Query(0, 0).first, 0);
+    BOOST_CHECK_EQUAL(labels.Query(1, 0).first, INVALID_EDGE_WEIGHT);
+}
+
+BOOST_AUTO_TEST_CASE(read_write_transit_nodes)
+{
+    auto reference_connectivity_checksum = 0xDEADBEEF;
+    // transit nodes 2 and 3, node 0 accesses both, node 1 only reaches 3
+    TransitNodes reference_transit_nodes{{2, 3},
+                                         {0, 4, INVALID_EDGE_WEIGHT, 0},
+                                         {0, 8, MAXIMAL_EDGE_DURATION, 0},
+                                         {0, 2, 2, 3, 3, 3, 4, 4, 5},
+                                         {0, 1, 1, 0, 1},
+                                         {1, 6, 2, 0, 0},
+                                         {2, 12, 4, 0, 0}};
+
+    std::unordered_map<std::string, std::vector<TransitNodes>> reference_metrics = {
+        {"duration", {reference_transit_nodes}}};
+
+    TemporaryFile tmp{TEST_DATA_DIR "/read_write_transit_nodes_test.osrm.tnr"};
+    contractor::files::writeTransitNodes(
+        tmp.path, reference_metrics, reference_connectivity_checksum);
+
+    unsigned connectivity_checksum;
+
+    std::unordered_map<std::string, std::vector<TransitNodes>> metrics = {{"duration", {}}};
+    contractor::files::readTransitNodes(tmp.path, metrics, connectivity_checksum);
+
+    BOOST_CHECK_EQUAL(connectivity_checksum, reference_connectivity_checksum);
+    BOOST_REQUIRE_EQUAL(metrics["duration"].size(), 1);
+
+    const auto &transit_nodes = metrics["duration"][0];
+    BOOST_CHECK_EQUAL(transit_nodes.GetNumberOfNodes(), 4);
+    BOOST_CHECK_EQUAL(transit_nodes.GetNumberOfTransitNodes(), 2);
+    BOOST_CHECK_EQUAL(transit_nodes.GetNumberOfAccessNodes(), 5);
+    BOOST_CHECK_EQUAL(transit_nodes.GetTransitNode(1), 3);
+    BOOST_CHECK_EQUAL(transit_nodes.GetTableEntry(0, 1).first, 4);
+    BOOST_CHECK_EQUAL(transit_nodes.GetTableEntry(1, 0).first, INVALID_EDGE_WEIGHT);
+
+    // 0 -> 2 -> 3 is 1 + 4 + 0 and better than 0 -> 3 directly
+    BOOST_CHECK_EQUAL(transit_nodes.Query(0, 3).first, 5);
+    BOOST_CHECK_EQUAL(transit_nodes.Query(0, 3).second, 10);
+    BOOST_CHECK_EQUAL(transit_nodes.Query(1, 2).first, INVALID_EDGE_WEIGHT);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,153 @@
+#include "contractor/hub_labeling.hpp"
+#include "contractor/contract_excludable_graph.hpp"
+
+#include "helper.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+
+using namespace osrm;
+using namespace osrm::contractor;
+using namespace osrm::unit_test;
+
+BOOST_AUTO_TEST_SUITE(hub_labeling)
+
+namespace
+{
+/*
+ * 4x4 grid, all horizontal roads are oneways in alternating directions:
+ *
+ *  0 >  1 >  2 >  3
+ *  |    |    |    |
+ *  4 <  5 <  6 <  7
+ *  |    |    |    |
+ *  8 >  9 > 10 > 11
+ *  |    |    |    |
+ * 12 < 13 < 14 < 15
+ */
+std::vector<TestEdge> makeGridEdges()
+{
+    std::vector<TestEdge> edges;
+    for (const auto row : util::irange<unsigned>(0, 4))
+    {
+        for (const auto column : util::irange<unsigned>(0, 4))
+        {
+            const auto node = row * 4 + column;
+            const int weight = (node * 7) % 5 + 1;
+            if (column < 3)
+            {
+                if (row % 2 == 0)
+                    edges.emplace_back(node, node + 1, weight);
+                else
+                    edges.emplace_back(node + 1, node, weight);
+            }
+            if (row < 3)
+            {
+                edges.emplace_back(node, node + 4, weight + 1);
+                edges.emplace_back(node + 4, node, weight + 1);
+            }
+        }
+    }
+    return edges;
+}
+
+std::vector<EdgeWeight> computeDistances(const std::vector<TestEdge> &edges,
+                                         const unsigned number_of_nodes,
+                                         const unsigned source)
+{
+    std::vector<EdgeWeight> distance(number_of_nodes, INVALID_EDGE_WEIGHT);
+    distance[source] = 0;
+    // Bellman-Ford is fast enough for the small test graph
+    for (const auto iteration : util::irange<unsigned>(0, number_of_nodes))
+    {
+        (void)iteration;
+        for (const auto &edge : edges)
+        {
+            unsigned from, to;
+            int weight;
+            std::tie(from, to, weight) = edge;
+            if (distance[from] != INVALID_EDGE_WEIGHT)
+                distance[to] = std::min(distance[to], distance[from] + weight);
+        }
+    }
+    return distance;
+}
+
+QueryGraph contract(const std::vector<TestEdge> &edges, const unsigned number_of_nodes)
+{
+    QueryGraph graph;
+    std::vector<std::vector<bool>> edge_filters;
+    std::tie(graph, edge_filters) =
+        contractExcludableGraph(makeGraph(edges),
+                                std::vector<EdgeWeight>(number_of_nodes, 1),
+                                {std::vector<bool>(number_of_nodes, true)});
+    return graph;
+}
+}
+
+BOOST_AUTO_TEST_CASE(query_matches_shortest_paths)
+{
+    const auto edges = makeGridEdges();
+    const auto graph = contract(edges, 16);
+    const auto labels = computeHubLabels(graph, std::vector<bool>(graph.GetNumberOfEdges(), true));
+
+    BOOST_REQUIRE_EQUAL(labels.GetNumberOfNodes(), 16);
+    for (const auto source : util::irange<NodeID>(0, 16))
+    {
+        const auto distances = computeDistances(edges, 16, source);
+        for (const auto target : util::irange<NodeID>(0, 16))
+        {
+            const auto result = labels.Query(source, target);
+            BOOST_CHECK_EQUAL(result.first, distances[target]);
+            // makeGraph uses twice the weight as duration
+            BOOST_CHECK_EQUAL(result.second, 2 * distances[target]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(labels_are_pruned)
+{
+    const auto edges = makeGridEdges();
+    const auto graph = contract(edges, 16);
+    const auto labels = computeHubLabels(graph, std::vector<bool>(graph.GetNumberOfEdges(), true));
+
+    for (const auto node : util::irange<NodeID>(0, 16))
+    {
+        for (const auto forward : {true, false})
+        {
+            std::vector<NodeID> hubs;
+            bool has_node = false;
+            labels.ForEachHub(
+                node, forward, [&](const NodeID hub, const EdgeWeight weight, const EdgeDuration) {
+                    hubs.push_back(hub);
+                    has_node = has_node || (hub == node && weight == 0);
+                });
+            BOOST_CHECK(has_node);
+            BOOST_CHECK(std::is_sorted(hubs.begin(), hubs.end()));
+        }
+    }
+
+    // every node is a hub of itself, but not all pairs need to be stored
+    BOOST_CHECK_LT(labels.GetNumberOfEntries(), 2 * 16 * 16);
+    // all deltas of this small graph fit into a single byte
+    BOOST_CHECK_EQUAL(labels.GetNumberOfHubBytes(), labels.GetNumberOfEntries());
+}
+
+BOOST_AUTO_TEST_CASE(unreachable_nodes)
+{
+    // 0 -> 1 -> 2 and the separate 3 <-> 4
+    const std::vector<TestEdge> edges = {
+        TestEdge{0, 1, 1}, TestEdge{1, 2, 1}, TestEdge{3, 4, 1}, TestEdge{4, 3, 1}};
+    const auto graph = contract(edges, 5);
+    const auto labels = computeHubLabels(graph, std::vector<bool>(graph.GetNumberOfEdges(), true));
+
+    BOOST_CHECK_EQUAL(labels.Query(0, 2).first, 2);
+    BOOST_CHECK_EQUAL(labels.Query(2, 0).first, INVALID_EDGE_WEIGHT);
+    BOOST_CHECK_EQUAL(labels.Query(0, 4).first, INVALID_EDGE_WEIGHT);
+    BOOST_CHECK_EQUAL(labels.Query(4, 3).first, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
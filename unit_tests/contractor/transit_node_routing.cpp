@@ -0,0 +1,174 @@
+#include "contractor/transit_node_routing.hpp"
+#include "contractor/contract_excludable_graph.hpp"
+
+#include "helper.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+
+using namespace osrm;
+using namespace osrm::contractor;
+using namespace osrm::unit_test;
+
+BOOST_AUTO_TEST_SUITE(transit_node_routing)
+
+namespace
+{
+/*
+ * 4x4 grid, all horizontal roads are oneways in alternating directions:
+ *
+ *  0 >  1 >  2 >  3
+ *  |    |    |    |
+ *  4 <  5 <  6 <  7
+ *  |    |    |    |
+ *  8 >  9 > 10 > 11
+ *  |    |    |    |
+ * 12 < 13 < 14 < 15
+ */
+std::vector<TestEdge> makeGridEdges()
+{
+    std::vector<TestEdge> edges;
+    for (const auto row : util::irange<unsigned>(0, 4))
+    {
+        for (const auto column : util::irange<unsigned>(0, 4))
+        {
+            const auto node = row * 4 + column;
+            const int weight = (node * 7) % 5 + 1;
+            if (column < 3)
+            {
+                if (row % 2 == 0)
+                    edges.emplace_back(node, node + 1, weight);
+                else
+                    edges.emplace_back(node + 1, node, weight);
+            }
+            if (row < 3)
+            {
+                edges.emplace_back(node, node + 4, weight + 1);
+                edges.emplace_back(node + 4, node, weight + 1);
+            }
+        }
+    }
+    return edges;
+}
+
+std::vector<EdgeWeight> computeDistances(const std::vector<TestEdge> &edges,
+                                         const unsigned number_of_nodes,
+                                         const unsigned source)
+{
+    std::vector<EdgeWeight> distance(number_of_nodes, INVALID_EDGE_WEIGHT);
+    distance[source] = 0;
+    // Bellman-Ford is fast enough for the small test graph
+    for (const auto iteration : util::irange<unsigned>(0, number_of_nodes))
+    {
+        (void)iteration;
+        for (const auto &edge : edges)
+        {
+            unsigned from, to;
+            int weight;
+            std::tie(from, to, weight) = edge;
+            if (distance[from] != INVALID_EDGE_WEIGHT)
+                distance[to] = std::min(distance[to], distance[from] + weight);
+        }
+    }
+    return distance;
+}
+
+QueryGraph contract(const std::vector<TestEdge> &edges, const unsigned number_of_nodes)
+{
+    QueryGraph graph;
+    std::vector<std::vector<bool>> edge_filters;
+    std::tie(graph, edge_filters) =
+        contractExcludableGraph(makeGraph(edges),
+                                std::vector<EdgeWeight>(number_of_nodes, 1),
+                                {std::vector<bool>(number_of_nodes, true)});
+    return graph;
+}
+}
+
+BOOST_AUTO_TEST_CASE(transit_nodes_are_closed_upwards)
+{
+    const auto graph = contract(makeGridEdges(), 16);
+    const std::vector<bool> edge_filter(graph.GetNumberOfEdges(), true);
+    const auto transit_nodes = computeTransitNodes(graph, edge_filter, 4);
+
+    BOOST_REQUIRE_EQUAL(transit_nodes.GetNumberOfTransitNodes(), 4);
+    BOOST_CHECK_EQUAL(transit_nodes.GetNumberOfNodes(), 16);
+
+    std::vector<bool> is_transit_node(16, false);
+    for (const auto index : util::irange<std::uint32_t>(0, 4))
+        is_transit_node[transit_nodes.GetTransitNode(index)] = true;
+
+    for (const auto node : util::irange<NodeID>(0, 16))
+    {
+        if (!is_transit_node[node])
+            continue;
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            BOOST_CHECK(is_transit_node[graph.GetTarget(edge)]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(query_matches_paths_over_transit_nodes)
+{
+    const auto edges = makeGridEdges();
+    const auto graph = contract(edges, 16);
+    const std::vector<bool> edge_filter(graph.GetNumberOfEdges(), true);
+
+    std::vector<std::vector<EdgeWeight>> distances;
+    for (const auto source : util::irange<NodeID>(0, 16))
+        distances.push_back(computeDistances(edges, 16, source));
+
+    for (const auto number_of_transit_nodes : {1, 4, 16})
+    {
+        const auto transit_nodes =
+            computeTransitNodes(graph, edge_filter, number_of_transit_nodes);
+
+        for (const auto source : util::irange<NodeID>(0, 16))
+        {
+            for (const auto target : util::irange<NodeID>(0, 16))
+            {
+                // the query is exact whenever a shortest path passes a transit node
+                bool passes_transit_node = false;
+                for (const auto index :
+                     util::irange<std::uint32_t>(0, transit_nodes.GetNumberOfTransitNodes()))
+                {
+                    const auto node = transit_nodes.GetTransitNode(index);
+                    passes_transit_node = passes_transit_node ||
+                                          distances[source][node] + distances[node][target] ==
+                                              distances[source][target];
+                }
+
+                const auto result = transit_nodes.Query(source, target);
+                if (passes_transit_node)
+                {
+                    BOOST_CHECK_EQUAL(result.first, distances[source][target]);
+                    // makeGraph uses twice the weight as duration
+                    BOOST_CHECK_EQUAL(result.second, 2 * distances[source][target]);
+                }
+                else
+                {
+                    BOOST_CHECK_GE(result.first, distances[source][target]);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unreachable_nodes)
+{
+    // 0 -> 1 -> 2 and the separate 3 <-> 4
+    const std::vector<TestEdge> edges = {
+        TestEdge{0, 1, 1}, TestEdge{1, 2, 1}, TestEdge{3, 4, 1}, TestEdge{4, 3, 1}};
+    const auto graph = contract(edges, 5);
+    const auto transit_nodes =
+        computeTransitNodes(graph, std::vector<bool>(graph.GetNumberOfEdges(), true), 5);
+
+    BOOST_CHECK_EQUAL(transit_nodes.Query(0, 2).first, 2);
+    BOOST_CHECK_EQUAL(transit_nodes.Query(2, 0).first, INVALID_EDGE_WEIGHT);
+    BOOST_CHECK_EQUAL(transit_nodes.Query(0, 4).first, INVALID_EDGE_WEIGHT);
+    BOOST_CHECK_EQUAL(transit_nodes.Query(4, 3).first, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
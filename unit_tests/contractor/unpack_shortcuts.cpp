@@ -0,0 +1,100 @@
+#include "contractor/unpack_shortcuts.hpp"
+
+#include "../common/range_tools.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+BOOST_AUTO_TEST_SUITE(unpack_shortcuts)
+
+namespace
+{
+/*
+ * Path 0 -> 1 -> 2 -> 3 with the shortcuts 0 -> 2 (via 1), 0 -> 3 (via 2)
+ * and 1 -> 3 (via 2) which is stored as backward edge at node 3.
+ *
+ * Edge IDs: 0: 0->1, 1: 0->2, 2: 0->3, 3: 1->2, 4: 2->3, 5: 3->1
+ */
+QueryGraph makeQueryGraph()
+{
+    using EdgeData = QueryEdge::EdgeData;
+    std::vector<QueryEdge> edges = {QueryEdge{0, 1, EdgeData{10, false, 1, 1, true, false}},
+                                    QueryEdge{0, 2, EdgeData{1, true, 2, 2, true, false}},
+                                    QueryEdge{0, 3, EdgeData{2, true, 3, 3, true, false}},
+                                    QueryEdge{1, 2, EdgeData{11, false, 1, 1, true, false}},
+                                    QueryEdge{2, 3, EdgeData{12, false, 1, 1, true, false}},
+                                    QueryEdge{3, 1, EdgeData{2, true, 2, 2, false, true}}};
+    return QueryGraph{4, edges};
+}
+
+template <typename ShortcutsT>
+std::pair<std::vector<NodeID>, std::vector<EdgeID>> unpack(const ShortcutsT &shortcuts,
+                                                          const EdgeID edge,
+                                                          const bool reverse)
+{
+    std::vector<NodeID> nodes;
+    std::vector<EdgeID> edges;
+    const auto shortcut = shortcuts.Find(edge, reverse);
+    BOOST_REQUIRE(shortcut != ShortcutsT::INVALID_SHORTCUT);
+    shortcuts.ForEachEdge(shortcut, [&](const NodeID node, const EdgeID original_edge) {
+        nodes.push_back(node);
+        edges.push_back(original_edge);
+    });
+    return std::make_pair(std::move(nodes), std::move(edges));
+}
+}
+
+BOOST_AUTO_TEST_CASE(unpack_all_shortcuts)
+{
+    const auto graph = makeQueryGraph();
+    const std::vector<bool> edge_filter(graph.GetNumberOfEdges(), true);
+
+    const auto shortcuts = unpackShortcuts(graph, edge_filter, 2);
+    BOOST_CHECK_EQUAL(shortcuts.GetNumberOfShortcuts(), 3);
+    BOOST_CHECK_EQUAL(shortcuts.GetNumberOfOriginalEdges(), 7);
+
+    // original edges and the wrong direction of a shortcut are not stored
+    BOOST_CHECK(shortcuts.Find(0, false) == UnpackedShortcuts::INVALID_SHORTCUT);
+    BOOST_CHECK(shortcuts.Find(1, true) == UnpackedShortcuts::INVALID_SHORTCUT);
+    BOOST_CHECK(shortcuts.Find(5, false) == UnpackedShortcuts::INVALID_SHORTCUT);
+
+    auto path = unpack(shortcuts, 1, false);
+    CHECK_EQUAL_RANGE(path.first, 1, 2);
+    CHECK_EQUAL_RANGE(path.second, 0, 3);
+
+    path = unpack(shortcuts, 2, false);
+    CHECK_EQUAL_RANGE(path.first, 1, 2, 3);
+    CHECK_EQUAL_RANGE(path.second, 0, 3, 4);
+
+    path = unpack(shortcuts, 5, true);
+    CHECK_EQUAL_RANGE(path.first, 2, 3);
+    CHECK_EQUAL_RANGE(path.second, 3, 4);
+}
+
+BOOST_AUTO_TEST_CASE(unpack_long_shortcuts)
+{
+    const auto graph = makeQueryGraph();
+    const std::vector<bool> edge_filter(graph.GetNumberOfEdges(), true);
+
+    const auto shortcuts = unpackShortcuts(graph, edge_filter, 3);
+    BOOST_CHECK_EQUAL(shortcuts.GetNumberOfShortcuts(), 1);
+    BOOST_CHECK(shortcuts.Find(1, false) == UnpackedShortcuts::INVALID_SHORTCUT);
+
+    const auto path = unpack(shortcuts, 2, false);
+    CHECK_EQUAL_RANGE(path.first, 1, 2, 3);
+    CHECK_EQUAL_RANGE(path.second, 0, 3, 4);
+}
+
+BOOST_AUTO_TEST_CASE(unpack_filtered_shortcuts)
+{
+    const auto graph = makeQueryGraph();
+    const std::vector<bool> edge_filter = {true, true, false, true, true, true};
+
+    const auto shortcuts = unpackShortcuts(graph, edge_filter, 2);
+    BOOST_CHECK_EQUAL(shortcuts.GetNumberOfShortcuts(), 2);
+    BOOST_CHECK(shortcuts.Find(2, false) == UnpackedShortcuts::INVALID_SHORTCUT);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
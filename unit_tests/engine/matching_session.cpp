@@ -0,0 +1,71 @@
+#include "engine/map_matching/matching_session.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(matching_session_test)
+
+using namespace osrm;
+using namespace osrm::util;
+using namespace osrm::engine;
+using namespace osrm::engine::map_matching;
+
+namespace
+{
+PhantomNode makePhantom(const NodeID forward, const double lon, const double lat)
+{
+    PhantomNode phantom;
+    phantom.forward_segment_id = {forward, true};
+    phantom.location = Coordinate{FloatLongitude{lon}, FloatLatitude{lat}};
+    return phantom;
+}
+}
+
+BOOST_AUTO_TEST_CASE(transitions_are_kept_while_used)
+{
+    const auto source = makePhantom(1, 7.42, 43.73);
+    const auto target = makePhantom(2, 7.43, 43.74);
+    const TransitionKey key{source, target, 100};
+
+    MatchingSession session;
+    session.Reset(1);
+    BOOST_CHECK(!session.FindTransition(key));
+    session.InsertTransition(key, 42.);
+    BOOST_CHECK_EQUAL(*session.FindTransition(key), 42.);
+
+    // the bound and the candidates are part of the key
+    BOOST_CHECK(!session.FindTransition({source, target, 200}));
+    BOOST_CHECK(!session.FindTransition({target, source, 100}));
+    BOOST_CHECK(!session.FindTransition({source, makePhantom(3, 7.43, 43.74), 100}));
+
+    // used by the next request
+    session.Age();
+    BOOST_CHECK_EQUAL(*session.FindTransition(key), 42.);
+
+    // not used by the next request
+    session.Age();
+    session.Age();
+    BOOST_CHECK(!session.FindTransition(key));
+}
+
+BOOST_AUTO_TEST_CASE(candidates_are_dropped_for_other_datasets)
+{
+    const CandidatesKey key{
+        Coordinate{FloatLongitude{7.42}, FloatLatitude{43.73}}, 15., boost::none, Approach::CURB};
+
+    MatchingSession session;
+    session.Reset(1);
+    session.InsertCandidates(key, {PhantomNodeWithDistance{makePhantom(1, 7.42, 43.73), 1.}});
+    BOOST_CHECK_EQUAL(session.FindCandidates(key)->size(), 1);
+
+    CandidatesKey other_key = key;
+    other_key.approach = Approach::UNRESTRICTED;
+    BOOST_CHECK(!session.FindCandidates(other_key));
+
+    session.Reset(1);
+    BOOST_CHECK(session.FindCandidates(key));
+    session.Reset(2);
+    BOOST_CHECK(!session.FindCandidates(key));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+#include "engine/datafacade/numa_replica_allocator.hpp"
+
+#include "util/numa.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(numa_replica_allocator)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+class VectorAllocator final : public datafacade::ContiguousBlockAllocator
+{
+  public:
+    VectorAllocator(storage::DataLayout layout) : memory(layout.GetSizeOfLayout())
+    {
+        index = storage::SharedDataIndex{{{memory.data(), std::move(layout)}}};
+    }
+
+    const storage::SharedDataIndex &GetIndex() override { return index; }
+
+    std::vector<char> memory;
+    storage::SharedDataIndex index;
+};
+}
+
+BOOST_AUTO_TEST_CASE(replicate_hot_blocks)
+{
+    storage::DataLayout layout;
+    layout.SetBlock("/common/nbn_data/coordinates", storage::make_block<std::uint32_t>(3));
+    layout.SetBlock("/common/names/values", storage::make_block<std::uint32_t>(2));
+    auto allocator = std::make_shared<VectorAllocator>(std::move(layout));
+
+    auto coordinates = allocator->index.GetBlockPtr<std::uint32_t>("/common/nbn_data/coordinates");
+    coordinates[0] = 1;
+    coordinates[1] = 2;
+    coordinates[2] = 3;
+
+    const auto nodes = util::GetNUMANodes();
+    datafacade::NUMAReplicaAllocator replica(allocator, 0, nodes.front());
+    const auto &index = replica.GetIndex();
+
+    // the hot block is copied, everything else still points to the shared memory
+    auto replicated_coordinates =
+        index.GetBlockPtr<std::uint32_t>("/common/nbn_data/coordinates");
+    BOOST_CHECK(replicated_coordinates != coordinates);
+    BOOST_CHECK_EQUAL(index.GetBlockEntries("/common/nbn_data/coordinates"), 3);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        replicated_coordinates, replicated_coordinates + 3, coordinates, coordinates + 3);
+    BOOST_CHECK(index.GetBlockPtr<std::uint32_t>("/common/names/values") ==
+                allocator->index.GetBlockPtr<std::uint32_t>("/common/names/values"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
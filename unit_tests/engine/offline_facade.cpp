@@ -32,6 +32,8 @@ template <> struct SearchEngineData<routing_algorithms::offline::Algorithm>
     SearchEngineHeapPtr forward_heap_1;
     SearchEngineHeapPtr reverse_heap_1;
 
+    UnpackingCache unpacking_cache;
+
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
     {
         if (forward_heap_1.get())
@@ -146,6 +148,8 @@ class ContiguousInternalMemoryDataFacade<routing_algorithms::offline::Algorithm>
 
     unsigned GetCheckSum() const override { return 0; }
 
+    std::uint64_t GetGeneration() const override { return 0; }
+
     // node and edge information access
     util::Coordinate GetCoordinateOfNode(const NodeID /*id*/) const override
     {
@@ -314,6 +318,19 @@ class ContiguousInternalMemoryDataFacade<routing_algorithms::offline::Algorithm>
         return {};
     }
 
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<PhantomNodeQuery> &queries) const override
+    {
+        return std::vector<std::vector<PhantomNodeWithDistance>>(queries.size());
+    }
+
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<PhantomNodeQuery> &queries) const override
+    {
+        return std::vector<std::pair<PhantomNode, PhantomNode>>(queries.size());
+    }
+
     util::guidance::LaneTupleIdPair GetLaneData(const EdgeID /*id*/) const override
     {
         return util::guidance::LaneTupleIdPair{};
@@ -0,0 +1,164 @@
+#include "engine/search_engine_data.hpp"
+#include "engine/warmup_thread_scope.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <mutex>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(search_engine_data)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+using MLD = routing_algorithms::mld::Algorithm;
+
+// The prepared heaps are shared by all engines of the process, every test starts without any
+struct PreparedHeapsFixture
+{
+    PreparedHeapsFixture() { reset(); }
+    ~PreparedHeapsFixture() { reset(); }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(SearchEngineData<MLD>::prepared_heaps_mutex);
+        SearchEngineData<MLD>::prepared_boundary_nodes = 0;
+        SearchEngineData<MLD>::prepared_heaps.clear();
+        SearchEngineData<MLD>::prepared_many_to_many_heaps.clear();
+    }
+};
+
+// The heaps are thread local, a new thread starts without heaps and is no longer counted once
+// it exits
+template <typename Function> void runOnNewThread(Function function)
+{
+    std::thread thread(function);
+    thread.join();
+}
+
+BOOST_FIXTURE_TEST_CASE(mld_heaps_follow_dataset_size, PreparedHeapsFixture)
+{
+    const auto number_of_threads = SearchEngineData<MLD>::number_of_first_heap_threads.load();
+
+    bool reused_heap = false;
+    bool cleared_heap = false;
+    std::size_t prepared_for_thread = 0;
+    std::size_t prepared_after_use = 0;
+    bool covers_new_boundary_nodes = false;
+    std::size_t prepared_for_other_size = 0;
+    runOnNewThread([&] {
+        SearchEngineData<MLD> heaps;
+        heaps.InitializeOrClearFirstThreadLocalStorage(100, 10);
+        const auto *old_forward_heap = heaps.forward_heap_1.get();
+        heaps.forward_heap_1->Insert(5, 1, 5);
+        heaps.InitializeOrClearFirstThreadLocalStorage(100, 10);
+        reused_heap = heaps.forward_heap_1.get() == old_forward_heap;
+        cleared_heap = heaps.forward_heap_1->Empty();
+
+        // this thread owns heaps, so two heaps are prepared for the next dataset
+        heaps.PrepareHeaps(200, 20);
+        prepared_for_thread = SearchEngineData<MLD>::prepared_heaps.size();
+
+        heaps.InitializeOrClearFirstThreadLocalStorage(200, 20);
+        prepared_after_use = SearchEngineData<MLD>::prepared_heaps.size();
+        // the overlay covers the new boundary nodes
+        heaps.forward_heap_1->Insert(15, 1, 15);
+        covers_new_boundary_nodes = heaps.forward_heap_1->WasInserted(15);
+
+        // a dataset of another size than the prepared one gets new heaps
+        heaps.PrepareHeaps(300, 30);
+        heaps.InitializeOrClearFirstThreadLocalStorage(400, 40);
+        prepared_for_other_size = SearchEngineData<MLD>::prepared_heaps.size();
+    });
+
+    BOOST_CHECK(reused_heap);
+    BOOST_CHECK(cleared_heap);
+    BOOST_CHECK_EQUAL(prepared_for_thread, 2 * (number_of_threads + 1));
+    BOOST_CHECK_EQUAL(prepared_after_use, 2 * number_of_threads);
+    BOOST_CHECK(covers_new_boundary_nodes);
+    BOOST_CHECK_EQUAL(prepared_for_other_size, 2 * (number_of_threads + 1));
+
+    // the thread exited and is no longer counted
+    BOOST_CHECK_EQUAL(SearchEngineData<MLD>::number_of_first_heap_threads.load(),
+                      number_of_threads);
+}
+
+BOOST_FIXTURE_TEST_CASE(mld_heaps_same_size_not_prepared, PreparedHeapsFixture)
+{
+    std::size_t prepared_for_new_size = 0;
+    std::size_t prepared_for_same_size = 0;
+    runOnNewThread([&] {
+        SearchEngineData<MLD> heaps;
+        heaps.InitializeOrClearFirstThreadLocalStorage(100, 10);
+        heaps.PrepareHeaps(200, 20);
+        prepared_for_new_size = SearchEngineData<MLD>::prepared_heaps.size();
+
+        // an update that keeps the number of boundary nodes does not create heaps again
+        SearchEngineData<MLD>::prepared_heaps.clear();
+        heaps.PrepareHeaps(200, 20);
+        prepared_for_same_size = SearchEngineData<MLD>::prepared_heaps.size();
+    });
+
+    BOOST_CHECK_GE(prepared_for_new_size, 2);
+    BOOST_CHECK_EQUAL(prepared_for_same_size, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(mld_warmup_keeps_prepared_heaps, PreparedHeapsFixture)
+{
+    const auto number_of_threads = SearchEngineData<MLD>::number_of_first_heap_threads.load();
+
+    std::size_t prepared_after_warmup = 0;
+    unsigned threads_during_warmup = 0;
+    runOnNewThread([&] {
+        SearchEngineData<MLD> heaps;
+        heaps.PrepareHeaps(100, 10);
+        SearchEngineData<MLD>::prepared_heaps.push_back(
+            std::make_unique<SearchEngineData<MLD>::QueryHeap>(100, 10));
+
+        const WarmupThreadScope warmup_thread;
+        heaps.InitializeOrClearFirstThreadLocalStorage(100, 10);
+        prepared_after_warmup = SearchEngineData<MLD>::prepared_heaps.size();
+        threads_during_warmup = SearchEngineData<MLD>::number_of_first_heap_threads.load();
+    });
+
+    BOOST_CHECK_EQUAL(prepared_after_warmup, 2 * number_of_threads + 1);
+    BOOST_CHECK_EQUAL(threads_during_warmup, number_of_threads);
+    BOOST_CHECK(!WarmupThreadScope::IsActive());
+}
+
+BOOST_FIXTURE_TEST_CASE(mld_warmup_workers_keep_prepared_heaps, PreparedHeapsFixture)
+{
+    const auto number_of_threads = SearchEngineData<MLD>::number_of_first_heap_threads.load();
+
+    std::size_t prepared_after_worker = 0;
+    unsigned threads_during_worker = 0;
+    runOnNewThread([&] {
+        SearchEngineData<MLD> heaps;
+        heaps.PrepareHeaps(100, 10);
+
+        const WarmupThreadScope warmup_thread;
+        const auto warmup_worker = WarmupThreadScope::IsActive();
+        runOnNewThread([&] {
+            const WarmupThreadScope warmup_scope(warmup_worker);
+            heaps.InitializeOrClearFirstThreadLocalStorage(100, 10);
+            prepared_after_worker = SearchEngineData<MLD>::prepared_heaps.size();
+            threads_during_worker = SearchEngineData<MLD>::number_of_first_heap_threads.load();
+        });
+    });
+
+    BOOST_CHECK_EQUAL(prepared_after_worker, 2 * number_of_threads);
+    BOOST_CHECK_EQUAL(threads_during_worker, number_of_threads);
+}
+
+BOOST_AUTO_TEST_CASE(warmup_scope_of_request_thread)
+{
+    bool active_in_worker = true;
+    runOnNewThread([&] {
+        const WarmupThreadScope warmup_scope(WarmupThreadScope::IsActive());
+        active_in_worker = WarmupThreadScope::IsActive();
+    });
+    BOOST_CHECK(!active_in_worker);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,50 @@
+#include "engine/datafacade/shared_blocks.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+
+BOOST_AUTO_TEST_SUITE(shared_blocks)
+
+using namespace osrm;
+using namespace osrm::engine::datafacade;
+
+namespace
+{
+std::shared_ptr<char> makeMemory(const char *content)
+{
+    std::shared_ptr<char> memory(new char[std::strlen(content)], std::default_delete<char[]>());
+    std::memcpy(memory.get(), content, std::strlen(content));
+    return memory;
+}
+}
+
+BOOST_AUTO_TEST_CASE(shareable_blocks)
+{
+    BOOST_CHECK(isShareableBlock("/common/names/values"));
+    BOOST_CHECK(isShareableBlock("/common/nbn_data/coordinates"));
+    BOOST_CHECK(!isShareableBlock("/common/properties"));
+    BOOST_CHECK(!isShareableBlock("/mld/metrics/routability/exclude/0/weights"));
+}
+
+BOOST_AUTO_TEST_CASE(identical_blocks_are_shared)
+{
+    const std::string name = "/common/names/values";
+    auto car = makeMemory("Avenue de Monte-Carlo");
+    auto foot = makeMemory("Avenue de Monte-Carlo");
+    auto bike = makeMemory("Boulevard des Moulins");
+
+    BOOST_CHECK_EQUAL(shareBlock(name, car, car.get(), 21), car);
+    BOOST_CHECK_EQUAL(shareBlock(name, foot, foot.get(), 21), car);
+    BOOST_CHECK_EQUAL(shareBlock(name, bike, bike.get(), 21), bike);
+    // the size is part of the content
+    BOOST_CHECK_EQUAL(shareBlock(name, foot, foot.get(), 20), foot);
+
+    // blocks of unloaded datasets are not shared anymore
+    const auto truck = makeMemory("Avenue de Monte-Carlo");
+    car.reset();
+    BOOST_CHECK_EQUAL(shareBlock(name, truck, truck.get(), 21), truck);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+#include "engine/snapping_cache.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(snapping_cache_test)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+PhantomNodeQuery makeQuery(const double lon, const double lat, const double radius = 10.)
+{
+    PhantomNodeQuery query;
+    query.coordinate = util::Coordinate{util::FloatLongitude{lon}, util::FloatLatitude{lat}};
+    query.radius = radius;
+    return query;
+}
+
+PhantomNodeWithDistance makePhantomNode(const double lon, const double lat)
+{
+    PhantomNode phantom_node;
+    phantom_node.location = util::Coordinate{util::FloatLongitude{lon}, util::FloatLatitude{lat}};
+    phantom_node.forward_segment_id = {1, true};
+    phantom_node.reverse_segment_id = {2, true};
+    return PhantomNodeWithDistance{phantom_node, 0.};
+}
+}
+
+BOOST_AUTO_TEST_CASE(exact_coordinates)
+{
+    SnappingCache cache(10);
+    const auto query = makeQuery(13.388860, 52.517037);
+    BOOST_CHECK(!cache.FindInRange(1, query));
+
+    cache.InsertInRange(1, query, {makePhantomNode(13.388870, 52.517037)});
+    const auto cached = cache.FindInRange(1, query);
+    BOOST_REQUIRE(cached);
+    BOOST_REQUIRE_EQUAL(cached->size(), 1);
+    BOOST_CHECK(cached->front().phantom_node.input_location == query.coordinate);
+    BOOST_CHECK_GT(cached->front().distance, 0.);
+
+    // other facades, parameters and coordinates are separate entries
+    BOOST_CHECK(!cache.FindInRange(2, query));
+    BOOST_CHECK(!cache.FindWithAlternative(1, query));
+    auto other_radius = query;
+    other_radius.radius = 20.;
+    BOOST_CHECK(!cache.FindInRange(1, other_radius));
+    auto with_bearing = query;
+    with_bearing.bearing = Bearing{90, 10};
+    BOOST_CHECK(!cache.FindInRange(1, with_bearing));
+    BOOST_CHECK(!cache.FindInRange(1, makeQuery(13.388861, 52.517037)));
+}
+
+BOOST_AUTO_TEST_CASE(quantized_coordinates)
+{
+    SnappingCache cache(10, 4);
+    const auto query = makeQuery(-13.38886, 52.51703);
+    const auto phantom_nodes =
+        std::make_pair(makePhantomNode(-13.38887, 52.51703).phantom_node,
+                       makePhantomNode(-13.38880, 52.51703).phantom_node);
+    cache.InsertWithAlternative(7, query, phantom_nodes);
+
+    // rounded down to 4 decimal places
+    const auto close_query = makeQuery(-13.38882, 52.51708);
+    const auto cached = cache.FindWithAlternative(7, close_query);
+    BOOST_REQUIRE(cached);
+    BOOST_CHECK(cached->first == phantom_nodes.first);
+    BOOST_CHECK(cached->second == phantom_nodes.second);
+    BOOST_CHECK(cached->first.input_location == close_query.coordinate);
+    BOOST_CHECK(!cache.FindWithAlternative(7, makeQuery(-13.38879, 52.51703)));
+    BOOST_CHECK(!cache.FindWithAlternative(7, makeQuery(-13.38886, 52.51710)));
+}
+
+BOOST_AUTO_TEST_CASE(snapped_distances)
+{
+    // snaps the query like the geospatial query does to a segment ending at the nearest point
+    const util::Coordinate source{util::FloatLongitude{13.3890}, util::FloatLatitude{52.5170}};
+    const util::Coordinate target{util::FloatLongitude{13.3880}, util::FloatLatitude{52.5170}};
+    const auto snap = [&](const PhantomNodeQuery &query) {
+        util::Coordinate nearest;
+        double ratio;
+        const auto distance = util::coordinate_calculation::perpendicularDistance(
+            source, target, query.coordinate, nearest, ratio);
+        auto phantom_node = makePhantomNode(0., 0.);
+        phantom_node.phantom_node.location = nearest;
+        phantom_node.phantom_node.input_location = query.coordinate;
+        phantom_node.distance = distance;
+        return phantom_node;
+    };
+
+    SnappingCache cache(10, 4);
+    // the end of the segment is about 35m away
+    const auto query = makeQuery(13.38751, 52.51713, 50.);
+    const auto missed = snap(query);
+    cache.InsertInRange(1, query, {missed});
+
+    // a hit returns what the snapper returned for the same coordinate
+    const auto hit = cache.FindInRange(1, query);
+    BOOST_REQUIRE(hit);
+    BOOST_REQUIRE_EQUAL(hit->size(), 1);
+    BOOST_CHECK(hit->front().phantom_node == missed.phantom_node);
+    BOOST_CHECK(hit->front().phantom_node.input_location == missed.phantom_node.input_location);
+    BOOST_CHECK_EQUAL(hit->front().distance, missed.distance);
+
+    // both coordinates snap to the end of the segment, so the distances agree as well
+    const auto close_query = makeQuery(13.38756, 52.51716, 50.);
+    const auto close_missed = snap(close_query);
+    BOOST_REQUIRE(close_missed.phantom_node.location == missed.phantom_node.location);
+    const auto close_hit = cache.FindInRange(1, close_query);
+    BOOST_REQUIRE(close_hit);
+    BOOST_REQUIRE_EQUAL(close_hit->size(), 1);
+    BOOST_CHECK(close_hit->front().phantom_node.input_location == close_query.coordinate);
+    BOOST_CHECK_EQUAL(close_hit->front().distance, close_missed.distance);
+}
+
+BOOST_AUTO_TEST_CASE(quantized_radius)
+{
+    SnappingCache cache(10, 4);
+    const auto query = makeQuery(13.38801, 52.51701);
+    const auto near = makePhantomNode(13.38802, 52.51701);
+    const auto behind = makePhantomNode(13.38793, 52.51701);
+    const auto ahead = makePhantomNode(13.38812, 52.51701);
+    cache.InsertInRange(1, query, {near, behind, ahead});
+
+    // 5m further east the candidate behind is more than 10m away and the one ahead is nearest
+    const auto close_query = makeQuery(13.38809, 52.51701);
+    const auto cached = cache.FindInRange(1, close_query);
+    BOOST_REQUIRE(cached);
+    BOOST_REQUIRE_EQUAL(cached->size(), 2);
+    BOOST_CHECK(cached->front().phantom_node.location == ahead.phantom_node.location);
+    BOOST_CHECK(cached->back().phantom_node.location == near.phantom_node.location);
+    BOOST_CHECK_LT(cached->front().distance, cached->back().distance);
+
+    // none of the candidates is in range, so the coordinate needs to be snapped
+    cache.InsertInRange(1, makeQuery(13.38801, 52.51705), {makePhantomNode(13.38793, 52.51705)});
+    BOOST_CHECK(!cache.FindInRange(1, makeQuery(13.38809, 52.51705)));
+
+    const auto phantom_nodes = std::make_pair(near.phantom_node, behind.phantom_node);
+    cache.InsertWithAlternative(1, query, phantom_nodes);
+    BOOST_CHECK(cache.FindWithAlternative(1, query));
+    BOOST_CHECK(!cache.FindWithAlternative(1, close_query));
+}
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+    SnappingCache cache;
+    const auto query = makeQuery(13.388860, 52.517037);
+    cache.InsertInRange(1, query, {makePhantomNode(13.388870, 52.517037)});
+    BOOST_CHECK(!cache.IsEnabled());
+    BOOST_CHECK(!cache.FindInRange(1, query));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
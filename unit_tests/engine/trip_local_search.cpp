@@ -0,0 +1,104 @@
+#include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_local_search.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_local_search_test)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::trip;
+
+namespace
+{
+// Never reaches the deadline, so the searches run until no improving move is left
+struct FrozenClock
+{
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<FrozenClock>;
+    static const constexpr bool is_steady = true;
+
+    static time_point now() { return time_point{}; }
+};
+
+// Slightly asymmetric table of random points on a grid
+util::DistTableWrapper<EdgeWeight> makeTable(const std::size_t number_of_locations)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(0, 10000);
+    std::vector<std::pair<int, int>> points;
+    for (std::size_t index = 0; index < number_of_locations; ++index)
+        points.emplace_back(distribution(generator), distribution(generator));
+
+    std::vector<EdgeWeight> table;
+    for (const auto &from : points)
+    {
+        for (const auto &to : points)
+        {
+            const auto distance = std::hypot(from.first - to.first, from.second - to.second);
+            table.push_back(static_cast<EdgeWeight>(distance * (from.first < to.first ? 1.1 : 1)));
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+
+std::int64_t getCost(const util::DistTableWrapper<EdgeWeight> &table,
+                     const std::vector<NodeID> &trip)
+{
+    return detail::GetTourCost(table, trip);
+}
+
+void checkPermutation(std::vector<NodeID> trip, const std::size_t number_of_locations)
+{
+    std::vector<NodeID> expected(number_of_locations);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::sort(trip.begin(), trip.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(trip.begin(), trip.end(), expected.begin(), expected.end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(improves_farthest_insertion)
+{
+    const std::size_t number_of_locations = 200;
+    const auto table = makeTable(number_of_locations);
+
+    const auto initial_trip = FarthestInsertionTrip(number_of_locations, table);
+    const auto trip =
+        LocalSearchTrip<FrozenClock>(initial_trip, table, std::chrono::milliseconds(1));
+
+    checkPermutation(trip, number_of_locations);
+    BOOST_CHECK_LT(getCost(table, trip), getCost(table, initial_trip));
+}
+
+BOOST_AUTO_TEST_CASE(avoids_invalid_edges)
+{
+    const std::size_t number_of_locations = 30;
+    auto table = makeTable(number_of_locations);
+
+    // only 5 -> 0 may enter location 0, like a trip with fixed start and end
+    for (NodeID from = 1; from < number_of_locations; ++from)
+        table.SetValue(from, 0, from == 5 ? 0 : INVALID_EDGE_WEIGHT);
+
+    const auto initial_trip = FarthestInsertionTrip(number_of_locations, table);
+    const auto trip =
+        LocalSearchTrip<FrozenClock>(initial_trip, table, std::chrono::milliseconds(1));
+
+    checkPermutation(trip, number_of_locations);
+    BOOST_CHECK_LE(getCost(table, trip), getCost(table, initial_trip));
+    for (std::size_t index = 0; index < trip.size(); ++index)
+    {
+        BOOST_CHECK_NE(table(trip[index], trip[(index + 1) % trip.size()]), INVALID_EDGE_WEIGHT);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
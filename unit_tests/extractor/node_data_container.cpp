@@ -0,0 +1,67 @@
+#include "extractor/node_data_container.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(node_data_container)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+NodeBasedEdgeAnnotation makeAnnotation(const NameID name_id, const ClassData classes)
+{
+    return NodeBasedEdgeAnnotation{name_id, 0, classes, TRAVEL_MODE_DRIVING, false};
+}
+}
+
+BOOST_AUTO_TEST_CASE(classes_from_annotations)
+{
+    std::vector<EdgeBasedNode> nodes = {{1, false}, {0, true}, {1, false}};
+    std::vector<NodeBasedEdgeAnnotation> annotations = {makeAnnotation(10, 1),
+                                                        makeAnnotation(20, 6)};
+    EdgeBasedNodeDataContainer container(nodes, annotations);
+
+    BOOST_REQUIRE_EQUAL(container.NumberOfNodes(), 3);
+    BOOST_CHECK_EQUAL(container.GetClassData(0), 6);
+    BOOST_CHECK_EQUAL(container.GetClassData(1), 1);
+    BOOST_CHECK_EQUAL(container.GetClassData(2), 6);
+    BOOST_CHECK_EQUAL(container.GetNameID(1), 10);
+    BOOST_CHECK(container.IsSegregated(1));
+    BOOST_CHECK(!container.IsSegregated(2));
+}
+
+BOOST_AUTO_TEST_CASE(renumber)
+{
+    std::vector<GeometryID> geometry_ids = {{0, true}, {1, false}, {2, true}};
+    std::vector<ComponentID> component_ids = {{5, false}, {6, true}, {7, false}};
+    std::vector<ClassData> classes = {1, 2, 4};
+    std::vector<EdgeBasedNode> nodes = {{0, false}, {1, true}, {2, false}};
+    std::vector<NodeBasedEdgeAnnotation> annotations = {
+        makeAnnotation(10, 1), makeAnnotation(20, 2), makeAnnotation(30, 4)};
+    EdgeBasedNodeDataContainer container(
+        geometry_ids, component_ids, classes, nodes, annotations);
+
+    // old node 0 becomes 2, 1 becomes 0 and 2 becomes 1
+    container.Renumber({2, 0, 1});
+
+    const std::vector<NodeID> old_ids = {1, 2, 0};
+    for (const NodeID node_id : {0, 1, 2})
+    {
+        const auto old_id = old_ids[node_id];
+        BOOST_CHECK_EQUAL(container.GetGeometryID(node_id).id, geometry_ids[old_id].id);
+        BOOST_CHECK_EQUAL(container.GetGeometryID(node_id).forward,
+                          geometry_ids[old_id].forward);
+        BOOST_CHECK_EQUAL(container.GetComponentID(node_id).id, component_ids[old_id].id);
+        BOOST_CHECK_EQUAL(container.GetComponentID(node_id).is_tiny,
+                          component_ids[old_id].is_tiny);
+        BOOST_CHECK_EQUAL(container.GetClassData(node_id), classes[old_id]);
+        BOOST_CHECK_EQUAL(container.GetNameID(node_id), annotations[old_id].name_id);
+        BOOST_CHECK_EQUAL(container.IsSegregated(node_id), nodes[old_id].segregated);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,11 @@
 #include "fixture.hpp"
 #include "waypoint_check.hpp"
 
+#include "engine/datafacade_provider.hpp"
+#include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/search_engine_data.hpp"
+#include "util/coordinate_calculation.hpp"
+
 #include "osrm/match_parameters.hpp"
 
 #include "osrm/coordinate.hpp"
@@ -116,4 +121,213 @@ BOOST_AUTO_TEST_CASE(test_match_split)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_match_window)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    const OSRM osrm{config};
+    config.map_matching_window = 3;
+    const OSRM window_osrm{config};
+
+    MatchParameters params;
+    params.coordinates = get_split_trace_locations();
+    params.coordinates.push_back(get_split_trace_locations().back());
+
+    json::Object result;
+    json::Object window_result;
+
+    const auto rc = osrm.Match(params, result);
+    const auto window_rc = window_osrm.Match(params, window_result);
+
+    BOOST_CHECK(rc == Status::Ok);
+    BOOST_CHECK(window_rc == Status::Ok);
+    const auto code = window_result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "Ok");
+
+    // the windows share a location and are joined into the matchings of the whole trace
+    const auto &tracepoints = result.values.at("tracepoints").get<json::Array>().values;
+    const auto &window_tracepoints =
+        window_result.values.at("tracepoints").get<json::Array>().values;
+    BOOST_CHECK_EQUAL(window_tracepoints.size(), params.coordinates.size());
+    BOOST_REQUIRE_EQUAL(window_tracepoints.size(), tracepoints.size());
+
+    const auto &matchings = result.values.at("matchings").get<json::Array>().values;
+    const auto &window_matchings = window_result.values.at("matchings").get<json::Array>().values;
+    BOOST_CHECK_EQUAL(window_matchings.size(), matchings.size());
+
+    for (const auto index : util::irange<std::size_t>(0, tracepoints.size()))
+    {
+        const auto &tracepoint = tracepoints[index];
+        const auto &window_tracepoint = window_tracepoints[index];
+        BOOST_REQUIRE_EQUAL(window_tracepoint.is<json::Null>(), tracepoint.is<json::Null>());
+        if (tracepoint.is<json::Null>())
+            continue;
+
+        BOOST_CHECK(waypoint_check(window_tracepoint));
+        const auto &object = tracepoint.get<json::Object>();
+        const auto &window_object = window_tracepoint.get<json::Object>();
+        BOOST_CHECK_EQUAL(window_object.values.at("matchings_index").get<json::Number>().value,
+                          object.values.at("matchings_index").get<json::Number>().value);
+        BOOST_CHECK_EQUAL(window_object.values.at("waypoint_index").get<json::Number>().value,
+                          object.values.at("waypoint_index").get<json::Number>().value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_match_session)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    config.max_matching_sessions = 2;
+    OSRM osrm{config};
+
+    MatchParameters params;
+    params.coordinates = get_split_trace_locations();
+
+    json::Object reference;
+    BOOST_CHECK(osrm.Match(params, reference) == Status::Ok);
+    const auto &reference_matchings = reference.values.at("matchings").get<json::Array>().values;
+
+    // the first request fills the session, the second one reuses it
+    params.session = "vehicle";
+    for (const auto iteration : {0, 1})
+    {
+        (void)iteration;
+        json::Object result;
+        BOOST_CHECK(osrm.Match(params, result) == Status::Ok);
+
+        const auto &matchings = result.values.at("matchings").get<json::Array>().values;
+        BOOST_REQUIRE_EQUAL(matchings.size(), reference_matchings.size());
+        for (std::size_t index = 0; index < matchings.size(); ++index)
+        {
+            const auto &matching = matchings[index].get<json::Object>().values;
+            const auto &reference_matching = reference_matchings[index].get<json::Object>().values;
+            BOOST_CHECK_EQUAL(matching.at("distance").get<json::Number>().value,
+                              reference_matching.at("distance").get<json::Number>().value);
+            BOOST_CHECK_EQUAL(matching.at("confidence").get<json::Number>().value,
+                              reference_matching.at("confidence").get<json::Number>().value);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_match_ch_transition_distances)
+{
+    using namespace osrm;
+    using namespace osrm::engine;
+    using namespace osrm::engine::routing_algorithms;
+
+    const ImmutableProvider<ch::Algorithm> provider{
+        storage::StorageConfig{OSRM_TEST_DATA_DIR "/ch/monaco.osrm"}};
+    const auto facade = provider.Get(api::BaseParameters{});
+    SearchEngineData<ch::Algorithm> heaps;
+
+    const auto candidates = [&](const Location location) {
+        std::vector<PhantomNode> phantoms;
+        for (const auto &candidate :
+             facade->NearestPhantomNodes(location, 10, Approach::UNRESTRICTED))
+            phantoms.push_back(candidate.phantom_node);
+        return phantoms;
+    };
+
+    // the batched search unpacks the same paths as the search per pair, also for candidates
+    // on the same segments
+    const auto locations = get_split_trace_locations();
+    const EdgeWeight weight_upper_bound = 1000 * facade->GetWeightMultiplier();
+    for (const auto source_index : util::irange<std::size_t>(0, locations.size()))
+    {
+        for (const auto target_index : util::irange<std::size_t>(0, locations.size()))
+        {
+            const auto sources = candidates(locations[source_index]);
+            const auto targets = candidates(locations[target_index]);
+            const auto distances =
+                ch::getNetworkDistances(heaps, *facade, sources, targets, weight_upper_bound);
+            BOOST_REQUIRE_EQUAL(distances.size(), sources.size() * targets.size());
+
+            heaps.InitializeOrClearFirstThreadLocalStorage(facade->GetNumberOfNodes());
+            for (const auto row : util::irange<std::size_t>(0, sources.size()))
+            {
+                for (const auto column : util::irange<std::size_t>(0, targets.size()))
+                {
+                    const auto distance = ch::getNetworkDistance(heaps,
+                                                                 *facade,
+                                                                 *heaps.forward_heap_1,
+                                                                 *heaps.reverse_heap_1,
+                                                                 sources[row],
+                                                                 targets[column],
+                                                                 weight_upper_bound);
+                    BOOST_CHECK_EQUAL(distances[row * targets.size() + column], distance);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_match_ch_transition_distances_same_segment)
+{
+    using namespace osrm;
+    using namespace osrm::engine;
+    using namespace osrm::engine::routing_algorithms;
+
+    const ImmutableProvider<ch::Algorithm> provider{
+        storage::StorageConfig{OSRM_TEST_DATA_DIR "/ch/monaco.osrm"}};
+    const auto facade = provider.Get(api::BaseParameters{});
+    SearchEngineData<ch::Algorithm> heaps;
+
+    const auto nearest = [&](const Location location) {
+        return facade->NearestPhantomNodes(location, 1, Approach::UNRESTRICTED)
+            .front()
+            .phantom_node;
+    };
+
+    // Candidates at a quarter and three quarters of a two-way segment. From the later to the
+    // earlier one the forward direction needs a loop, the reverse direction is a short path.
+    std::size_t number_of_pairs = 0;
+    for (const auto &location : get_split_trace_locations())
+    {
+        const auto phantom = nearest(location);
+        if (!phantom.IsBidirected())
+            continue;
+
+        const auto geometry_id = facade->GetGeometryIndex(phantom.forward_segment_id.id).id;
+        const auto geometry = facade->GetUncompressedForwardGeometry(geometry_id);
+        const auto from = facade->GetCoordinateOfNode(geometry(phantom.fwd_segment_position));
+        const auto to = facade->GetCoordinateOfNode(geometry(phantom.fwd_segment_position + 1));
+        using util::coordinate_calculation::interpolateLinear;
+        const auto first = nearest(interpolateLinear(0.25, from, to));
+        const auto second = nearest(interpolateLinear(0.75, from, to));
+        if (first.forward_segment_id.id != phantom.forward_segment_id.id ||
+            second.forward_segment_id.id != phantom.forward_segment_id.id ||
+            first.location == second.location)
+            continue;
+
+        const std::vector<PhantomNode> phantoms = {first, second};
+        const EdgeWeight weight_upper_bound = 1000 * facade->GetWeightMultiplier();
+        const auto distances =
+            ch::getNetworkDistances(heaps, *facade, phantoms, phantoms, weight_upper_bound);
+
+        heaps.InitializeOrClearFirstThreadLocalStorage(facade->GetNumberOfNodes());
+        for (const auto row : util::irange<std::size_t>(0, phantoms.size()))
+        {
+            for (const auto column : util::irange<std::size_t>(0, phantoms.size()))
+            {
+                const auto distance = ch::getNetworkDistance(heaps,
+                                                             *facade,
+                                                             *heaps.forward_heap_1,
+                                                             *heaps.reverse_heap_1,
+                                                             phantoms[row],
+                                                             phantoms[column],
+                                                             weight_upper_bound);
+                BOOST_CHECK_EQUAL(distances[row * phantoms.size() + column], distance);
+            }
+        }
+        ++number_of_pairs;
+    }
+    BOOST_CHECK_GT(number_of_pairs, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,7 +5,22 @@
 #include "equal_json.hpp"
 #include "fixture.hpp"
 
+#include "engine/engine.hpp"
+#include "storage/shared_monitor.hpp"
+#include "storage/storage.hpp"
+#include "util/exception.hpp"
+#include "osrm/json_container.hpp"
 #include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
 
 BOOST_AUTO_TEST_SUITE(options)
 
@@ -39,4 +54,142 @@ BOOST_AUTO_TEST_CASE(test_mld)
     OSRM osrm{config};
 }
 
+BOOST_AUTO_TEST_CASE(test_warmup)
+{
+    using namespace osrm;
+    EngineConfig config;
+    config.use_shared_memory = false;
+    config.storage_config = storage::StorageConfig(OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+    config.algorithm = EngineConfig::Algorithm::MLD;
+    config.prefault_data = true;
+
+    int num_warmups = 0;
+    config.warmup = [&](const engine::EngineInterface &engine) {
+        RouteParameters params;
+        params.coordinates.push_back(get_dummy_location());
+        params.coordinates.push_back(get_dummy_location());
+        json::Object result;
+        BOOST_CHECK(engine.Route(params, result) == Status::Ok);
+        ++num_warmups;
+    };
+    OSRM osrm{config};
+
+    BOOST_CHECK_EQUAL(num_warmups, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_warmup_shared_memory_update)
+{
+    using namespace osrm;
+    const std::string dataset_name = "library_tests_warmup";
+    const storage::StorageConfig storage_config(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+    BOOST_REQUIRE_EQUAL(storage::Storage{storage_config}.Run(-1, dataset_name, false),
+                        EXIT_SUCCESS);
+
+    // the watchdog thread warms up updates, so the results are only checked on this thread
+    std::mutex mutex;
+    std::condition_variable warmed_up;
+    int num_warmups = 0;
+    int num_failed_warmups = 0;
+    EngineConfig config;
+    config.use_shared_memory = true;
+    config.dataset_name = dataset_name;
+    config.algorithm = EngineConfig::Algorithm::CH;
+    config.warmup = [&](const engine::EngineInterface &engine) {
+        RouteParameters params;
+        params.coordinates.push_back(get_dummy_location());
+        params.coordinates.push_back(get_dummy_location());
+        json::Object result;
+        const auto rc = engine.Route(params, result);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ++num_warmups;
+        num_failed_warmups += rc == Status::Ok ? 0 : 1;
+        warmed_up.notify_all();
+    };
+    OSRM osrm{config};
+    BOOST_CHECK_EQUAL(num_warmups, 1);
+
+    // publishing the dataset again makes the watchdog warm up the new regions before they serve
+    BOOST_REQUIRE_EQUAL(storage::Storage{storage_config}.Run(-1, dataset_name, false),
+                        EXIT_SUCCESS);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        BOOST_CHECK(warmed_up.wait_for(
+            lock, std::chrono::seconds(60), [&] { return num_warmups == 2; }));
+        BOOST_CHECK_EQUAL(num_failed_warmups, 0);
+    }
+
+    RouteParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    json::Object result;
+    BOOST_CHECK(osrm.Route(params, result) == Status::Ok);
+}
+
+BOOST_AUTO_TEST_CASE(test_warmup_shared_memory_update_retried)
+{
+    using namespace osrm;
+    const std::string dataset_name = "library_tests_warmup_retry";
+    const storage::StorageConfig storage_config(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+    BOOST_REQUIRE_EQUAL(storage::Storage{storage_config}.Run(-1, dataset_name, false),
+                        EXIT_SUCCESS);
+
+    // the warm-up of the first update fails, the current dataset keeps serving
+    std::mutex mutex;
+    std::condition_variable warmed_up;
+    int num_warmups = 0;
+    EngineConfig config;
+    config.use_shared_memory = true;
+    config.dataset_name = dataset_name;
+    config.algorithm = EngineConfig::Algorithm::CH;
+    config.warmup = [&](const engine::EngineInterface &) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++num_warmups;
+        warmed_up.notify_all();
+        if (num_warmups == 2)
+            throw util::exception("warm-up failed");
+    };
+    OSRM osrm{config};
+
+    // osrm-datastore waits until the regions it replaced are detached, i.e. until the update
+    // is published
+    auto datastore_result = std::make_shared<std::atomic<int>>(EXIT_FAILURE);
+    std::thread datastore([storage_config, dataset_name, datastore_result] {
+        *datastore_result = storage::Storage{storage_config}.Run(-1, dataset_name, false);
+    });
+
+    bool retried = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        BOOST_CHECK(warmed_up.wait_for(
+            lock, std::chrono::seconds(60), [&] { return num_warmups == 2; }));
+
+        // without new data the same regions are tried again on the next notification, which
+        // is repeated in case it comes before the watchdog waits
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+        while (!retried && std::chrono::steady_clock::now() < deadline)
+        {
+            lock.unlock();
+            storage::SharedMonitor<storage::SharedRegionRegister>{}.notify_all();
+            lock.lock();
+            retried = warmed_up.wait_for(
+                lock, std::chrono::milliseconds(100), [&] { return num_warmups == 3; });
+        }
+    }
+    BOOST_CHECK(retried);
+    if (!retried)
+    {
+        datastore.detach();
+        return;
+    }
+    datastore.join();
+    BOOST_CHECK_EQUAL(*datastore_result, EXIT_SUCCESS);
+
+    RouteParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    json::Object result;
+    BOOST_CHECK(osrm.Route(params, result) == Status::Ok);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -456,4 +456,87 @@ BOOST_AUTO_TEST_CASE(test_manual_setting_of_annotations_property)
     BOOST_CHECK_EQUAL(annotations.size(), 6);
 }
 
+BOOST_AUTO_TEST_CASE(test_route_mld_unpacking_cache)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/mld/monaco.osrm"};
+    config.use_shared_memory = false;
+    config.algorithm = EngineConfig::Algorithm::MLD;
+    const OSRM uncached_osrm{config};
+    config.mld_unpacking_cache_size = 1000;
+    const OSRM cached_osrm{config};
+
+    const Locations locations = {{Longitude{7.411119}, Latitude{43.727378}},
+                                 {Longitude{7.437070}, Latitude{43.749248}},
+                                 {Longitude{7.421511}, Latitude{43.734181}},
+                                 {Longitude{7.448272}, Latitude{43.743282}},
+                                 {Longitude{7.419505}, Latitude{43.738286}}};
+
+    // the second pass unpacks the overlay arcs from the cache
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (const auto &source : locations)
+        {
+            for (const auto &target : locations)
+            {
+                RouteParameters params;
+                params.overview = RouteParameters::OverviewType::Full;
+                params.annotations = true;
+                params.coordinates = {source, target};
+
+                json::Object uncached_result;
+                json::Object cached_result;
+                const auto uncached_rc = uncached_osrm.Route(params, uncached_result);
+                const auto cached_rc = cached_osrm.Route(params, cached_result);
+                BOOST_CHECK(uncached_rc == cached_rc);
+                CHECK_EQUAL_JSON(uncached_result, cached_result);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_route_mmap_matches_loaded_data)
+{
+    using namespace osrm;
+
+    for (const auto algorithm : {EngineConfig::Algorithm::CH, EngineConfig::Algorithm::MLD})
+    {
+        EngineConfig config;
+        config.storage_config = {algorithm == EngineConfig::Algorithm::CH
+                                     ? OSRM_TEST_DATA_DIR "/ch/monaco.osrm"
+                                     : OSRM_TEST_DATA_DIR "/mld/monaco.osrm"};
+        config.use_shared_memory = false;
+        config.algorithm = algorithm;
+        const OSRM loaded_osrm{config};
+        config.use_mmap = true;
+        const OSRM mapped_osrm{config};
+
+        RouteParameters params;
+        params.steps = true;
+        params.coordinates = get_locations_in_big_component();
+
+        json::Object loaded_result;
+        json::Object mapped_result;
+        const auto loaded_rc = loaded_osrm.Route(params, loaded_result);
+        const auto mapped_rc = mapped_osrm.Route(params, mapped_result);
+        BOOST_CHECK(loaded_rc == Status::Ok);
+        BOOST_CHECK(mapped_rc == Status::Ok);
+        CHECK_EQUAL_JSON(loaded_result, mapped_result);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_route_mmap_with_shared_memory)
+{
+    using namespace osrm;
+
+    // the data can only come from one source
+    EngineConfig config;
+    config.use_shared_memory = true;
+    config.use_mmap = true;
+    BOOST_CHECK(!config.IsValid());
+    BOOST_CHECK_THROW(OSRM{config}, osrm::exception);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
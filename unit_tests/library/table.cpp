@@ -2,6 +2,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "coordinates.hpp"
+#include "equal_json.hpp"
 #include "fixture.hpp"
 #include "waypoint_check.hpp"
 
@@ -187,4 +188,68 @@ BOOST_AUTO_TEST_CASE(test_table_no_segment_for_some_coordinates)
     BOOST_CHECK_EQUAL(code, "NoSegment");
 }
 
+BOOST_AUTO_TEST_CASE(test_table_hub_labels_match_ch)
+{
+    using namespace osrm;
+
+    // without --hub-labels the labels of the dataset are ignored
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/hl/monaco.osrm"};
+    config.use_shared_memory = false;
+    const OSRM ch_osrm{config};
+    config.use_hub_labels = true;
+    const OSRM hl_osrm{config};
+
+    TableParameters params;
+    params.coordinates = {{Longitude{7.411119}, Latitude{43.727378}},
+                          {Longitude{7.437070}, Latitude{43.749248}},
+                          {Longitude{7.421511}, Latitude{43.734181}},
+                          {Longitude{7.448272}, Latitude{43.743282}},
+                          {Longitude{7.419505}, Latitude{43.738286}}};
+
+    json::Object ch_result;
+    json::Object hl_result;
+    BOOST_CHECK(ch_osrm.Table(params, ch_result) == Status::Ok);
+    BOOST_CHECK(hl_osrm.Table(params, hl_result) == Status::Ok);
+    CHECK_EQUAL_JSON(ch_result, hl_result);
+
+    // distances are not covered by the labels and still come from the graph
+    params.annotations = TableParameters::AnnotationsType::All;
+    json::Object ch_distance_result;
+    json::Object hl_distance_result;
+    BOOST_CHECK(ch_osrm.Table(params, ch_distance_result) == Status::Ok);
+    BOOST_CHECK(hl_osrm.Table(params, hl_distance_result) == Status::Ok);
+    CHECK_EQUAL_JSON(ch_distance_result, hl_distance_result);
+}
+
+BOOST_AUTO_TEST_CASE(test_table_transit_nodes_match_ch)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/tnr/monaco.osrm"};
+    config.use_shared_memory = false;
+    const OSRM ch_osrm{config};
+    config.use_transit_nodes = true;
+    const OSRM tnr_osrm{config};
+
+    // far apart and neighbouring locations to cover table lookups and local searches
+    TableParameters params;
+    params.coordinates = {{Longitude{7.411119}, Latitude{43.727378}},
+                          {Longitude{7.437070}, Latitude{43.749248}},
+                          {Longitude{7.421511}, Latitude{43.734181}},
+                          {Longitude{7.448272}, Latitude{43.743282}},
+                          {Longitude{7.419505}, Latitude{43.738286}},
+                          {Longitude{7.419732}, Latitude{43.738190}},
+                          {Longitude{7.421339}, Latitude{43.733997}}};
+
+    json::Object ch_result;
+    json::Object tnr_result;
+    const auto ch_rc = ch_osrm.Table(params, ch_result);
+    const auto tnr_rc = tnr_osrm.Table(params, tnr_result);
+    BOOST_CHECK(ch_rc == Status::Ok);
+    BOOST_CHECK(tnr_rc == Status::Ok);
+    CHECK_EQUAL_JSON(ch_result, tnr_result);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -202,8 +202,23 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
         return {};
     }
 
+    std::vector<std::vector<engine::PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<engine::PhantomNodeQuery> &queries) const override
+    {
+        return std::vector<std::vector<engine::PhantomNodeWithDistance>>(queries.size());
+    }
+
+    std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<engine::PhantomNodeQuery> &queries) const override
+    {
+        return std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>(queries.size());
+    }
+
     std::uint32_t GetCheckSum() const override { return 0; }
 
+    std::uint64_t GetGeneration() const override { return 0; }
+
     extractor::TravelMode GetTravelMode(const NodeID /* id */) const override
     {
         return extractor::TRAVEL_MODE_INACCESSIBLE;
@@ -286,6 +301,9 @@ class MockAlgorithmDataFacade<engine::datafacade::CH>
 {
   private:
     EdgeData foo;
+    contractor::UnpackedShortcutsView unpacked_shortcuts;
+    contractor::HubLabelsView hub_labels;
+    contractor::TransitNodesView transit_nodes;
 
   public:
     unsigned GetNumberOfNodes() const override { return 0; }
@@ -319,6 +337,15 @@ class MockAlgorithmDataFacade<engine::datafacade::CH>
     {
         return SPECIAL_EDGEID;
     }
+
+    const contractor::UnpackedShortcutsView &GetUnpackedShortcuts() const override
+    {
+        return unpacked_shortcuts;
+    }
+
+    const contractor::HubLabelsView &GetHubLabels() const override { return hub_labels; }
+
+    const contractor::TransitNodesView &GetTransitNodes() const override { return transit_nodes; }
 };
 
 template <typename AlgorithmT>
@@ -606,6 +606,11 @@ BOOST_AUTO_TEST_CASE(valid_match_urls)
     CHECK_EQUAL_RANGE(reference_3.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_3.approaches, result_3->approaches);
     CHECK_EQUAL_RANGE(reference_3.coordinates, result_3->coordinates);
+
+    auto result_4 = parseParameters<MatchParameters>("1,2;3,4?session=truck_42-a&timestamps=5;6");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK_EQUAL(result_4->session, "truck_42-a");
+    CHECK_EQUAL_RANGE(reference_2.timestamps, result_4->timestamps);
 }
 
 BOOST_AUTO_TEST_CASE(invalid_match_urls)
@@ -631,6 +636,7 @@ BOOST_AUTO_TEST_CASE(invalid_match_urls)
     BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?waypoints=0,4"), 19UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?waypoints=x;4"), 18UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?waypoints=0;3.5"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?session=a.b"), 17UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_nearest_urls)
@@ -0,0 +1,109 @@
+#include "server/query_replay.hpp"
+
+#include "engine/engine.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(query_replay)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+// Counts the requests of every service
+class CountingEngine final : public engine::EngineInterface
+{
+  public:
+    engine::Status Route(const engine::api::RouteParameters &params,
+                         util::json::Object &) const override
+    {
+        ++routes;
+        coordinates += params.coordinates.size();
+        return engine::Status::Ok;
+    }
+    engine::Status Table(const engine::api::TableParameters &,
+                         util::json::Object &) const override
+    {
+        ++tables;
+        return engine::Status::Error;
+    }
+    engine::Status Nearest(const engine::api::NearestParameters &,
+                           util::json::Object &) const override
+    {
+        ++nearests;
+        return engine::Status::Ok;
+    }
+    engine::Status Trip(const engine::api::TripParameters &, util::json::Object &) const override
+    {
+        return engine::Status::Ok;
+    }
+    engine::Status Match(const engine::api::MatchParameters &, util::json::Object &) const override
+    {
+        return engine::Status::Ok;
+    }
+    engine::Status Tile(const engine::api::TileParameters &, std::string &) const override
+    {
+        ++tiles;
+        return engine::Status::Ok;
+    }
+
+    mutable int routes = 0;
+    mutable int tables = 0;
+    mutable int nearests = 0;
+    mutable int tiles = 0;
+    mutable std::size_t coordinates = 0;
+};
+}
+
+BOOST_AUTO_TEST_CASE(replay_services)
+{
+    CountingEngine engine;
+    const std::vector<std::string> queries = {
+        "/route/v1/driving/13.388860,52.517037;13.397634,52.529407?overview=false",
+        "/route/v1/driving/13.388860%2C52.517037;13.397634,52.529407;13.428555,52.523219",
+        "/table/v1/driving/13.388860,52.517037;13.397634,52.529407",
+        "/nearest/v1/driving/13.388860,52.517037?number=3",
+        "/tile/v1/car/tile(1310,3166,13).mvt",
+        // unknown service, malformed coordinates and invalid options are skipped
+        "/isochrone/v1/driving/13.388860,52.517037",
+        "/route/v1/driving/13.388860;52.517037",
+        "/route/v1/driving/13.388860,52.517037",
+        "not a request"};
+
+    BOOST_CHECK_EQUAL(replayQueries(engine, queries), 5);
+    BOOST_CHECK_EQUAL(engine.routes, 2);
+    BOOST_CHECK_EQUAL(engine.coordinates, 5);
+    BOOST_CHECK_EQUAL(engine.tables, 1);
+    BOOST_CHECK_EQUAL(engine.nearests, 1);
+    BOOST_CHECK_EQUAL(engine.tiles, 1);
+}
+
+BOOST_AUTO_TEST_CASE(select_profile_queries)
+{
+    const std::vector<std::string> queries = {
+        "/route/v1/car/13.388860,52.517037;13.397634,52.529407",
+        "/route/v1/foot/13.388860,52.517037;13.397634,52.529407",
+        "/nearest/v1/bike/13.388860,52.517037",
+        "/table/v1/car/13.388860,52.517037;13.397634,52.529407",
+        "not a request"};
+    const std::vector<std::string> profiles = {"car", "foot"};
+
+    const auto car = selectProfileQueries(queries, "car", profiles);
+    BOOST_REQUIRE_EQUAL(car.size(), 2);
+    BOOST_CHECK_EQUAL(car[0], queries[0]);
+    BOOST_CHECK_EQUAL(car[1], queries[3]);
+
+    const auto foot = selectProfileQueries(queries, "foot", profiles);
+    BOOST_REQUIRE_EQUAL(foot.size(), 1);
+    BOOST_CHECK_EQUAL(foot[0], queries[1]);
+
+    // the default dataset answers all other profiles
+    const auto others = selectProfileQueries(queries, "", profiles);
+    BOOST_REQUIRE_EQUAL(others.size(), 2);
+    BOOST_CHECK_EQUAL(others[0], queries[2]);
+    BOOST_CHECK_EQUAL(others[1], queries[4]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,69 @@
+#include "server/request_handler.hpp"
+#include "server/api/parsed_url.hpp"
+#include "server/http/reply.hpp"
+#include "server/http/request.hpp"
+
+#include "util/json_container.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(request_handler)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+// Answers with the name it was created with
+class NamedServiceHandler final : public ServiceHandlerInterface
+{
+  public:
+    explicit NamedServiceHandler(std::string name) : name(std::move(name)) {}
+
+    engine::Status RunQuery(api::ParsedURL, service::BaseService::ResultT &result) override
+    {
+        result = name;
+        return engine::Status::Ok;
+    }
+
+  private:
+    const std::string name;
+};
+
+std::string handle(RequestHandler &handler, const std::string &uri, http::reply &reply)
+{
+    http::request request;
+    request.uri = uri;
+    handler.HandleRequest(request, reply);
+    return std::string(reply.content.begin(), reply.content.end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(profiles_are_routed_to_their_handler)
+{
+    RequestHandler handler;
+    handler.RegisterServiceHandler("car", std::make_unique<NamedServiceHandler>("car"));
+    handler.RegisterServiceHandler("foot", std::make_unique<NamedServiceHandler>("foot"));
+
+    http::reply reply;
+    BOOST_CHECK_EQUAL(handle(handler, "/route/v1/car/7.41,43.73;7.42,43.74", reply), "car");
+    BOOST_CHECK_EQUAL(reply.status, http::reply::ok);
+
+    reply = http::reply();
+    BOOST_CHECK_EQUAL(handle(handler, "/route/v1/foot/7.41,43.73;7.42,43.74", reply), "foot");
+
+    reply = http::reply();
+    const auto unknown = handle(handler, "/route/v1/bike/7.41,43.73;7.42,43.74", reply);
+    BOOST_CHECK_EQUAL(reply.status, http::reply::bad_request);
+    BOOST_CHECK(unknown.find("InvalidProfile") != std::string::npos);
+
+    // all other profiles are answered by the default handler
+    handler.RegisterServiceHandler(std::make_unique<NamedServiceHandler>("default"));
+    reply = http::reply();
+    BOOST_CHECK_EQUAL(handle(handler, "/route/v1/bike/7.41,43.73;7.42,43.74", reply), "default");
+    reply = http::reply();
+    BOOST_CHECK_EQUAL(handle(handler, "/route/v1/car/7.41,43.73;7.42,43.74", reply), "car");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,8 @@
 #include <boost/iterator/function_input_iterator.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
 BOOST_AUTO_TEST_SUITE(tar)
 
 using namespace osrm;
@@ -54,6 +56,19 @@ BOOST_AUTO_TEST_CASE(read_tar_file)
     BOOST_CHECK_EQUAL(std::string(result_2, 4), std::string("baz\n"));
 }
 
+BOOST_AUTO_TEST_CASE(read_missing_tar_file)
+{
+    storage::tar::FileReader reader(TEST_DATA_DIR "/tar_test.tar",
+                                    storage::tar::FileReader::HasNoFingerprint);
+
+    char result[4];
+    BOOST_CHECK_THROW(reader.ReadInto("foo_4.txt", result, 4), util::RuntimeError);
+
+    // a failed lookup does not change the position of the following reads
+    reader.ReadInto("foo_3.txt", result, 4);
+    BOOST_CHECK_EQUAL(std::string(result, 4), std::string("foo\n"));
+}
+
 BOOST_AUTO_TEST_CASE(write_tar_file)
 {
     TemporaryFile tmp{TEST_DATA_DIR "/tar_write_test.tar"};
@@ -189,6 +204,72 @@ BOOST_AUTO_TEST_CASE(continue_write_tar_file)
     CHECK_EQUAL_COLLECTIONS(result_64bit_vector, vector_64bit);
 }
 
+BOOST_AUTO_TEST_CASE(compressed_tar_file)
+{
+    TemporaryFile tmp{TEST_DATA_DIR "/tar_compressed_write_test.tar"};
+
+    std::vector<std::uint32_t> large_vector(10000);
+    for (auto index : util::irange<std::size_t>(0, large_vector.size()))
+    {
+        large_vector[index] = index % 100;
+    }
+    std::vector<std::uint32_t> small_vector = {0, 1, 2, 3};
+
+    {
+        storage::tar::FileWriter writer(tmp.path,
+                                        storage::tar::FileWriter::GenerateFingerprint,
+                                        storage::tar::FileWriter::CompressBlocks);
+        writer.WriteElementCount64("large_vector", large_vector.size());
+        writer.WriteFrom("large_vector", large_vector.data(), large_vector.size());
+        writer.WriteElementCount64("small_vector", small_vector.size());
+        writer.WriteFrom("small_vector", small_vector.data(), small_vector.size());
+    }
+
+    storage::tar::FileReader reader(tmp.path, storage::tar::FileReader::VerifyFingerprint);
+
+    std::vector<storage::tar::FileReader::FileEntry> file_list;
+    reader.List(std::back_inserter(file_list));
+    const auto large_entry =
+        std::find_if(file_list.begin(), file_list.end(), [](const auto &entry) {
+            return entry.name == "large_vector";
+        });
+    const auto small_entry =
+        std::find_if(file_list.begin(), file_list.end(), [](const auto &entry) {
+            return entry.name == "small_vector";
+        });
+    BOOST_REQUIRE(large_entry != file_list.end());
+    BOOST_REQUIRE(small_entry != file_list.end());
+    BOOST_CHECK(large_entry->compressed);
+    BOOST_CHECK_EQUAL(large_entry->size, large_vector.size() * sizeof(std::uint32_t));
+    BOOST_CHECK(!small_entry->compressed);
+    BOOST_CHECK(reader.HasCompressedFiles());
+
+    std::vector<std::uint32_t> result_large_vector(reader.ReadElementCount64("large_vector"));
+    reader.ReadInto("large_vector", result_large_vector.data(), result_large_vector.size());
+    CHECK_EQUAL_COLLECTIONS(result_large_vector, large_vector);
+
+    std::vector<std::uint32_t> streamed_large_vector;
+    reader.ReadStreaming<std::uint32_t>("large_vector", std::back_inserter(streamed_large_vector));
+    CHECK_EQUAL_COLLECTIONS(streamed_large_vector, large_vector);
+
+    std::vector<std::uint32_t> result_small_vector(reader.ReadElementCount64("small_vector"));
+    reader.ReadInto("small_vector", result_small_vector.data(), result_small_vector.size());
+    CHECK_EQUAL_COLLECTIONS(result_small_vector, small_vector);
+}
+
+BOOST_AUTO_TEST_CASE(continue_compressed_tar_file)
+{
+    TemporaryFile tmp{TEST_DATA_DIR "/tar_compressed_continue_test.tar"};
+
+    std::vector<std::uint32_t> vector = {0, 1, 2, 3};
+    storage::tar::FileWriter writer(tmp.path,
+                                    storage::tar::FileWriter::GenerateFingerprint,
+                                    storage::tar::FileWriter::CompressBlocks);
+    writer.WriteFrom("vector", vector.data(), vector.size());
+    BOOST_CHECK_THROW(writer.ContinueFrom("vector", vector.data(), vector.size()),
+                      util::exception);
+}
+
 // Boost test only supports disabling was only introduced in 1.59
 #if BOOST_VERSION >= 105900
 // This test case is disabled by default because it needs 10 GiB of storage
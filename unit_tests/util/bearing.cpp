@@ -47,6 +47,35 @@ BOOST_AUTO_TEST_CASE(bearing_range_test)
     BOOST_CHECK_EQUAL(true, bearing::CheckInBounds(1, 1, 0));
 }
 
+BOOST_AUTO_TEST_CASE(bearing_sector_test)
+{
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(0), 1u);
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(11), 1u);
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(12), 2u);
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(360), 1u);
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(359), 1u << 31);
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(-1), 1u << 31);
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(-360), 1u);
+
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(90, 180), 0xffffffffu);
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(1, -1), 0u);
+    BOOST_CHECK_EQUAL(bearing::GetSectorMask(0, 5), 1u | (1u << 31));
+
+    // every bearing in range falls into one of the sectors
+    for (const int B : {-5, 0, 5, 45, 180, 355, 400})
+    {
+        for (const int range : {0, 10, 90, 179})
+        {
+            const auto mask = bearing::GetSectorMask(B, range);
+            for (int A = -360; A <= 720; ++A)
+            {
+                if (bearing::CheckInBounds(A, B, range))
+                    BOOST_CHECK(mask & bearing::GetSectorMask(A));
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(bearing_angle_test)
 {
     BOOST_CHECK_EQUAL(bearing::angleBetween(257.78421507794314, 77.784215077943117), 0.);
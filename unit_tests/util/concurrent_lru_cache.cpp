@@ -0,0 +1,183 @@
+#include "util/concurrent_lru_cache.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(concurrent_lru_cache_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(disabled_cache)
+{
+    ConcurrentLRUCache<int, std::string> cache;
+    BOOST_CHECK(!cache.IsEnabled());
+
+    cache.Insert(1, "one");
+    BOOST_CHECK(!cache.Find(1));
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+    BOOST_CHECK_EQUAL(cache.GetHits(), 0);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(find_and_count)
+{
+    ConcurrentLRUCache<int, std::string> cache(8, 1);
+    BOOST_CHECK(cache.IsEnabled());
+
+    BOOST_CHECK(!cache.Find(1));
+    cache.Insert(1, "one");
+    cache.Insert(2, "two");
+
+    BOOST_CHECK_EQUAL(*cache.Find(1), "one");
+    BOOST_CHECK_EQUAL(*cache.Find(2), "two");
+    BOOST_CHECK(!cache.Find(3));
+
+    cache.Insert(1, "uno");
+    BOOST_CHECK_EQUAL(*cache.Find(1), "uno");
+
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+    BOOST_CHECK_EQUAL(cache.GetHits(), 3);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 2);
+
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+    BOOST_CHECK_EQUAL(cache.GetHits(), 0);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 0);
+    BOOST_CHECK(!cache.Find(1));
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    ConcurrentLRUCache<int, int> cache(3, 1);
+
+    cache.Insert(1, 10);
+    cache.Insert(2, 20);
+    cache.Insert(3, 30);
+
+    // 1 is now more recent than 2
+    BOOST_CHECK_EQUAL(*cache.Find(1), 10);
+
+    cache.Insert(4, 40);
+    BOOST_CHECK_EQUAL(cache.Size(), 3);
+    BOOST_CHECK(!cache.Find(2));
+    BOOST_CHECK_EQUAL(*cache.Find(1), 10);
+    BOOST_CHECK_EQUAL(*cache.Find(3), 30);
+    BOOST_CHECK_EQUAL(*cache.Find(4), 40);
+}
+
+BOOST_AUTO_TEST_CASE(bounded_with_shards)
+{
+    ConcurrentLRUCache<int, int> cache(64, 4);
+
+    for (int key = 0; key < 1000; ++key)
+    {
+        cache.Insert(key, key);
+    }
+
+    BOOST_CHECK_LE(cache.Size(), 64);
+}
+
+BOOST_AUTO_TEST_CASE(capacity_split_exactly)
+{
+    // 16 shards with one entry more than a multiple of them, and fewer entries than shards
+    for (const std::size_t capacity : {1, 5, 17, 100})
+    {
+        ConcurrentLRUCache<int, int> cache(capacity);
+        for (int key = 0; key < 10000; ++key)
+        {
+            cache.Insert(key, key);
+        }
+        BOOST_CHECK_EQUAL(cache.Size(), capacity);
+        BOOST_CHECK_EQUAL(cache.GetCapacity(), capacity);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_access)
+{
+    ConcurrentLRUCache<int, int> cache(128);
+
+    // Boost.Test assertions are not thread-safe, so count mismatches instead
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; ++thread)
+    {
+        threads.emplace_back([&cache, &mismatches, thread] {
+            for (int iteration = 0; iteration < 10000; ++iteration)
+            {
+                const auto key = (iteration * 7 + thread) % 256;
+                const auto value = cache.Find(key);
+                if (value)
+                {
+                    mismatches += *value != key * 2;
+                }
+                else
+                {
+                    cache.Insert(key, key * 2);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(mismatches, 0);
+    BOOST_CHECK_LE(cache.Size(), 128);
+    BOOST_CHECK_EQUAL(cache.GetHits() + cache.GetMisses(), 40000);
+}
+
+BOOST_AUTO_TEST_CASE(find_or_insert)
+{
+    ConcurrentLRUCache<int, std::string> disabled_cache;
+    BOOST_CHECK_EQUAL(disabled_cache.FindOrInsert(1, [] { return "one"; }), "one");
+    BOOST_CHECK_EQUAL(disabled_cache.Size(), 0);
+
+    ConcurrentLRUCache<int, std::string> cache(8, 1);
+    BOOST_CHECK_EQUAL(cache.FindOrInsert(1, [] { return "one"; }), "one");
+    BOOST_CHECK_EQUAL(cache.FindOrInsert(1, [] { return "other"; }), "one");
+    BOOST_CHECK_EQUAL(cache.GetHits(), 1);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_find_or_insert)
+{
+    ConcurrentLRUCache<int, std::shared_ptr<int>> cache(64, 4);
+
+    // every thread gets the value inserted by the first one for each key
+    std::vector<std::vector<std::shared_ptr<int>>> values(4);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; ++thread)
+    {
+        threads.emplace_back([&cache, &values, thread] {
+            for (int key = 0; key < 32; ++key)
+            {
+                values[thread].push_back(
+                    cache.FindOrInsert(key, [key] { return std::make_shared<int>(key); }));
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int key = 0; key < 32; ++key)
+    {
+        for (int thread = 1; thread < 4; ++thread)
+        {
+            BOOST_CHECK_EQUAL(values[thread][key], values[0][key]);
+        }
+    }
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 32);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+#include "util/rtree_distances.hpp"
+#include "util/coordinate_calculation.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(rtree_distances_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+constexpr std::int32_t MAX_COORDINATE = 180 * COORDINATE_PRECISION;
+
+Coordinate makeCoordinate(std::mt19937 &generator, const std::int32_t range)
+{
+    std::uniform_int_distribution<std::int32_t> distribution(-range, range);
+    return Coordinate{FixedLongitude{distribution(generator)},
+                      FixedLatitude{distribution(generator)}};
+}
+}
+
+BOOST_AUTO_TEST_CASE(rectangle_distances)
+{
+    std::mt19937 generator(42);
+    const auto location = makeCoordinate(generator, MAX_COORDINATE / 2);
+
+    // enough rectangles for the vectorized loop and a scalar tail
+    std::vector<RectangleInt2D> rectangles;
+    for (int index = 0; index < 23; ++index)
+    {
+        const auto first = makeCoordinate(generator, MAX_COORDINATE / 2);
+        const auto second = makeCoordinate(generator, MAX_COORDINATE / 2);
+        rectangles.emplace_back(std::min(first.lon, second.lon),
+                                std::max(first.lon, second.lon),
+                                std::min(first.lat, second.lat),
+                                std::max(first.lat, second.lat));
+    }
+    // contains the location
+    rectangles.emplace_back(location.lon, location.lon, location.lat, location.lat);
+
+    std::vector<std::uint64_t> distances(rectangles.size());
+    std::vector<std::uint64_t> scalar_distances(rectangles.size());
+    rtree_distances::getMinSquaredDistances(
+        rectangles.data(), rectangles.size(), location, distances.data());
+    rtree_distances::getMinSquaredDistancesScalar(
+        rectangles.data(), rectangles.size(), location, scalar_distances.data());
+
+    for (std::size_t index = 0; index < rectangles.size(); ++index)
+    {
+        BOOST_CHECK_EQUAL(distances[index], rectangles[index].GetMinSquaredDist(location));
+        BOOST_CHECK_EQUAL(scalar_distances[index], distances[index]);
+    }
+    BOOST_CHECK_EQUAL(distances.back(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(segment_distances)
+{
+    std::mt19937 generator(42);
+    const auto location = makeCoordinate(generator, 1000000);
+
+    std::vector<std::int32_t> source_lons, source_lats, target_lons, target_lats;
+    for (int index = 0; index < 23; ++index)
+    {
+        const auto source = makeCoordinate(generator, 1000000);
+        const auto target = makeCoordinate(generator, 1000000);
+        source_lons.push_back(static_cast<std::int32_t>(source.lon));
+        source_lats.push_back(static_cast<std::int32_t>(source.lat));
+        target_lons.push_back(static_cast<std::int32_t>(target.lon));
+        target_lats.push_back(static_cast<std::int32_t>(target.lat));
+    }
+    // a segment of length 0 and one through the location
+    source_lons.push_back(source_lons.front());
+    source_lats.push_back(source_lats.front());
+    target_lons.push_back(source_lons.front());
+    target_lats.push_back(source_lats.front());
+    source_lons.push_back(static_cast<std::int32_t>(location.lon) - 10);
+    source_lats.push_back(static_cast<std::int32_t>(location.lat) - 10);
+    target_lons.push_back(static_cast<std::int32_t>(location.lon) + 10);
+    target_lats.push_back(static_cast<std::int32_t>(location.lat) + 10);
+
+    const auto count = source_lons.size();
+    std::vector<std::uint64_t> distances(count), scalar_distances(count);
+    std::vector<std::int32_t> nearest_lons(count), nearest_lats(count);
+    std::vector<std::int32_t> scalar_nearest_lons(count), scalar_nearest_lats(count);
+    rtree_distances::getSquaredSegmentDistances(source_lons.data(),
+                                                source_lats.data(),
+                                                target_lons.data(),
+                                                target_lats.data(),
+                                                count,
+                                                location,
+                                                distances.data(),
+                                                nearest_lons.data(),
+                                                nearest_lats.data());
+    rtree_distances::getSquaredSegmentDistancesScalar(source_lons.data(),
+                                                      source_lats.data(),
+                                                      target_lons.data(),
+                                                      target_lats.data(),
+                                                      count,
+                                                      location,
+                                                      scalar_distances.data(),
+                                                      scalar_nearest_lons.data(),
+                                                      scalar_nearest_lats.data());
+
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        BOOST_CHECK_EQUAL(distances[index], scalar_distances[index]);
+        BOOST_CHECK_EQUAL(nearest_lons[index], scalar_nearest_lons[index]);
+        BOOST_CHECK_EQUAL(nearest_lats[index], scalar_nearest_lats[index]);
+
+        const Coordinate source{FixedLongitude{source_lons[index]},
+                                FixedLatitude{source_lats[index]}};
+        const Coordinate target{FixedLongitude{target_lons[index]},
+                                FixedLatitude{target_lats[index]}};
+        const Coordinate nearest{
+            coordinate_calculation::projectPointOnSegment(source, target, location).second};
+        BOOST_CHECK_LE(std::abs(nearest_lons[index] - static_cast<std::int32_t>(nearest.lon)), 1);
+        BOOST_CHECK_LE(std::abs(nearest_lats[index] - static_cast<std::int32_t>(nearest.lat)), 1);
+    }
+    BOOST_CHECK_EQUAL(distances[count - 2],
+                      coordinate_calculation::squaredEuclideanDistance(
+                          location,
+                          Coordinate{FixedLongitude{source_lons.front()},
+                                     FixedLatitude{source_lats.front()}}));
+    BOOST_CHECK_EQUAL(distances.back(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,4 +1,5 @@
 #include "util/static_rtree.hpp"
+#include "util/serialization.hpp"
 #include "extractor/edge_based_node_segment.hpp"
 #include "engine/geospatial_query.hpp"
 #include "util/coordinate.hpp"
@@ -294,6 +295,181 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", *this);
 }
 
+BOOST_FIXTURE_TEST_CASE(projected_coordinates_test, TestRandomGraphFixture_MultipleLevels)
+{
+    TemporaryFile stored_tmp;
+    TemporaryFile projected_tmp;
+    TestStaticRTree stored_rtree(edges, coords, stored_tmp.path);
+    TestStaticRTree projected_rtree(edges, coords, projected_tmp.path, {}, false);
+
+    // snapping does not depend on whether the projected coordinates of the leaves are stored
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    for (unsigned i = 0; i < 100; i++)
+    {
+        const Coordinate q{FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)}};
+        const auto stored = stored_rtree.Nearest(q, 10);
+        const auto projected = projected_rtree.Nearest(q, 10);
+        BOOST_REQUIRE_EQUAL(stored.size(), projected.size());
+        for (std::size_t j = 0; j < stored.size(); ++j)
+        {
+            BOOST_CHECK_EQUAL(stored[j].u, projected[j].u);
+            BOOST_CHECK_EQUAL(stored[j].v, projected[j].v);
+            BOOST_CHECK_EQUAL(stored[j].fwd_segment_position, projected[j].fwd_segment_position);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(leaves_in_memory_test)
+{
+    using Coord = std::pair<FloatLongitude, FloatLatitude>;
+    using Edge = std::pair<unsigned, unsigned>;
+
+    // a dense grid with about 100m long edges gives leaves that fit the 16 bit encoding, the
+    // edges between random locations all over the world need the 32 bit encoding
+    const unsigned grid_size = 30;
+    std::vector<Coord> input_coords;
+    std::vector<Edge> input_edges;
+    for (unsigned row = 0; row < grid_size; ++row)
+    {
+        for (unsigned column = 0; column < grid_size; ++column)
+        {
+            const auto node = row * grid_size + column;
+            input_coords.emplace_back(FloatLongitude{13.4 + column * 0.001},
+                                      FloatLatitude{52.5 + row * 0.001});
+            if (column + 1 < grid_size)
+                input_edges.emplace_back(node, node + 1);
+            if (row + 1 < grid_size)
+                input_edges.emplace_back(node, node + grid_size);
+        }
+    }
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_real_distribution<> lat_udist(-85., 85.);
+    std::uniform_real_distribution<> lon_udist(-180., 180.);
+    const unsigned number_of_grid_nodes = input_coords.size();
+    for (unsigned i = 0; i < 200; ++i)
+    {
+        input_coords.emplace_back(FloatLongitude{lon_udist(g)}, FloatLatitude{lat_udist(g)});
+        if (i > 0)
+            input_edges.emplace_back(number_of_grid_nodes + i - 1, number_of_grid_nodes + i);
+    }
+    GraphFixture fixture(input_coords, input_edges);
+
+    TemporaryFile objects_tmp;
+    TemporaryFile projected_tmp;
+    TemporaryFile tar_tmp;
+    {
+        TestStaticRTree rtree(fixture.edges, fixture.coords, objects_tmp.path);
+        storage::tar::FileWriter writer(tar_tmp.path,
+                                        storage::tar::FileWriter::GenerateFingerprint);
+        util::serialization::write(writer, "/common/rtree", rtree);
+    }
+    TestStaticRTree projected_rtree(fixture.edges, fixture.coords, projected_tmp.path, {}, false);
+
+    storage::tar::FileReader reader(tar_tmp.path, storage::tar::FileReader::VerifyFingerprint);
+    TestStaticRTree file_rtree(objects_tmp.path, fixture.coords);
+    util::serialization::read(reader, "/common/rtree", file_rtree);
+
+    std::vector<TestStaticRTree::TreeNode> search_tree;
+    std::vector<TestStaticRTree::TreeNodeSummary> search_tree_summaries;
+    std::vector<std::uint16_t> leaf_coordinates;
+    std::vector<std::uint64_t> leaf_coordinate_offsets;
+    std::vector<std::uint64_t> tree_level_starts;
+    storage::serialization::read(reader, "/common/rtree/search_tree", search_tree);
+    storage::serialization::read(
+        reader, "/common/rtree/search_tree_summaries", search_tree_summaries);
+    storage::serialization::read(reader, "/common/rtree/leaf_coordinates", leaf_coordinates);
+    storage::serialization::read(
+        reader, "/common/rtree/leaf_coordinate_offsets", leaf_coordinate_offsets);
+    storage::serialization::read(
+        reader, "/common/rtree/search_tree_level_starts", tree_level_starts);
+
+    // both encodings are used
+    BOOST_CHECK_GT(leaf_coordinates.size(), 4 * fixture.edges.size());
+    BOOST_CHECK_LT(leaf_coordinates.size(), 8 * fixture.edges.size());
+
+    std::vector<TestData> leaves(fixture.edges.size());
+    storage::io::FileReader leaves_reader(objects_tmp.path,
+                                          storage::io::FileReader::HasNoFingerprint);
+    BOOST_REQUIRE_EQUAL(leaves_reader.GetSize(), leaves.size() * sizeof(TestData));
+    leaves_reader.ReadInto(leaves);
+    TestStaticRTree memory_rtree(std::move(search_tree),
+                                 std::move(search_tree_summaries),
+                                 std::move(leaf_coordinates),
+                                 std::move(leaf_coordinate_offsets),
+                                 std::move(tree_level_starts),
+                                 util::vector_view<const TestData>(leaves.data(), leaves.size()),
+                                 fixture.coords);
+
+    const auto check_equal = [](const std::vector<TestData> &lhs,
+                                const std::vector<TestData> &rhs) {
+        BOOST_REQUIRE_EQUAL(lhs.size(), rhs.size());
+        for (std::size_t i = 0; i < lhs.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(lhs[i].u, rhs[i].u);
+            BOOST_CHECK_EQUAL(lhs[i].v, rhs[i].v);
+        }
+    };
+    std::uniform_real_distribution<> grid_udist(-0.005, grid_size * 0.001 + 0.005);
+    for (unsigned i = 0; i < 200; ++i)
+    {
+        // alternate between queries close to the grid and all over the world
+        const Coordinate q = i % 2 == 0 ? Coordinate{FloatLongitude{13.4 + grid_udist(g)},
+                                                     FloatLatitude{52.5 + grid_udist(g)}}
+                                        : Coordinate{FloatLongitude{lon_udist(g)},
+                                                     FloatLatitude{lat_udist(g)}};
+        const auto memory_results = memory_rtree.Nearest(q, 10);
+        check_equal(memory_results, file_rtree.Nearest(q, 10));
+        check_equal(memory_results, projected_rtree.Nearest(q, 10));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(format_version_test)
+{
+    using Coord = std::pair<FloatLongitude, FloatLatitude>;
+    using Edge = std::pair<unsigned, unsigned>;
+    GraphFixture fixture(
+        {
+            Coord{FloatLongitude{0.0}, FloatLatitude{0.0}},
+            Coord{FloatLongitude{1.0}, FloatLatitude{1.0}},
+        },
+        {Edge(0, 1)});
+
+    TemporaryFile objects_tmp;
+    TemporaryFile current_tmp;
+    TemporaryFile unversioned_tmp;
+    TemporaryFile newer_tmp;
+    {
+        TestStaticRTree rtree(fixture.edges, fixture.coords, objects_tmp.path);
+        storage::tar::FileWriter writer(current_tmp.path,
+                                        storage::tar::FileWriter::GenerateFingerprint);
+        util::serialization::write(writer, "/common/rtree", rtree);
+    }
+    {
+        // like a file written before the R-tree stored its leaf coordinates
+        storage::tar::FileWriter writer(unversioned_tmp.path,
+                                        storage::tar::FileWriter::GenerateFingerprint);
+        storage::serialization::write(
+            writer, "/common/rtree/search_tree", std::vector<TestStaticRTree::TreeNode>(1));
+    }
+    {
+        storage::tar::FileWriter writer(newer_tmp.path,
+                                        storage::tar::FileWriter::GenerateFingerprint);
+        writer.WriteElementCount64("/common/rtree/format_version", 1);
+        writer.WriteFrom("/common/rtree/format_version", RTREE_FORMAT_VERSION + 1);
+    }
+
+    const auto read = [&](const boost::filesystem::path &path) {
+        storage::tar::FileReader reader(path, storage::tar::FileReader::VerifyFingerprint);
+        TestStaticRTree file_rtree(objects_tmp.path, fixture.coords);
+        util::serialization::read(reader, "/common/rtree", file_rtree);
+    };
+    BOOST_CHECK_NO_THROW(read(current_tmp.path));
+    BOOST_CHECK_THROW(read(unversioned_tmp.path), util::exception);
+    BOOST_CHECK_THROW(read(newer_tmp.path), util::exception);
+}
+
 // Bug: If you querry a point that lies between two BBs that have a gap,
 // one BB will be pruned, even if it could contain a nearer match.
 BOOST_AUTO_TEST_CASE(regression_test)
@@ -431,6 +607,196 @@ BOOST_AUTO_TEST_CASE(bearing_tests)
     }
 }
 
+BOOST_AUTO_TEST_CASE(batch_tests)
+{
+    using Coord = std::pair<FloatLongitude, FloatLatitude>;
+    using Edge = std::pair<unsigned, unsigned>;
+
+    // grid of 20x20 nodes with horizontal and vertical edges about 1km apart
+    const unsigned grid_size = 20;
+    std::vector<Coord> grid_coords;
+    std::vector<Edge> grid_edges;
+    for (unsigned row = 0; row < grid_size; ++row)
+    {
+        for (unsigned column = 0; column < grid_size; ++column)
+        {
+            const auto node = row * grid_size + column;
+            grid_coords.emplace_back(FloatLongitude{column * 0.01}, FloatLatitude{row * 0.01});
+            if (column + 1 < grid_size)
+                grid_edges.emplace_back(node, node + 1);
+            if (row + 1 < grid_size)
+                grid_edges.emplace_back(node, node + grid_size);
+        }
+    }
+    GraphFixture fixture(grid_coords, grid_edges);
+
+    TemporaryFile tmp;
+    auto rtree = make_rtree<MiniStaticRTree>(tmp.path, fixture);
+    TestDataFacade mockfacade;
+    engine::GeospatialQuery<MiniStaticRTree, TestDataFacade> query(
+        rtree, fixture.coords, mockfacade);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_real_distribution<> coordinate_udist(-0.01, grid_size * 0.01);
+    std::uniform_int_distribution<> bearing_udist(0, 359);
+
+    std::vector<engine::PhantomNodeQuery> queries;
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        engine::PhantomNodeQuery batch_query;
+        batch_query.coordinate = Coordinate{FloatLongitude{coordinate_udist(g)},
+                                            FloatLatitude{coordinate_udist(g)}};
+        batch_query.radius = 1000.;
+        if (i % 3 == 0)
+            batch_query.bearing = engine::Bearing{static_cast<short>(bearing_udist(g)), 90};
+        queries.push_back(batch_query);
+    }
+    // repeated queries are snapped only once
+    queries.push_back(queries.front());
+    queries.push_back(queries.back());
+
+    const auto in_range = query.NearestPhantomNodesInRange(queries);
+    BOOST_REQUIRE_EQUAL(in_range.size(), queries.size());
+    for (std::size_t i = 0; i < queries.size(); ++i)
+    {
+        const auto &batch_query = queries[i];
+        const auto expected =
+            batch_query.bearing
+                ? query.NearestPhantomNodesInRange(batch_query.coordinate,
+                                                   *batch_query.radius,
+                                                   batch_query.bearing->bearing,
+                                                   batch_query.bearing->range,
+                                                   batch_query.approach)
+                : query.NearestPhantomNodesInRange(
+                      batch_query.coordinate, *batch_query.radius, batch_query.approach);
+        BOOST_REQUIRE_EQUAL(in_range[i].size(), expected.size());
+        for (std::size_t j = 0; j < expected.size(); ++j)
+        {
+            BOOST_CHECK(in_range[i][j].phantom_node == expected[j].phantom_node);
+            BOOST_CHECK_EQUAL(in_range[i][j].distance, expected[j].distance);
+        }
+    }
+
+    // without a radius the nearest segment is always found
+    for (auto &batch_query : queries)
+        batch_query.radius = boost::none;
+    const auto alternatives = query.NearestPhantomNodesWithAlternativeFromBigComponent(queries);
+    BOOST_REQUIRE_EQUAL(alternatives.size(), queries.size());
+    for (std::size_t i = 0; i < queries.size(); ++i)
+    {
+        const auto &batch_query = queries[i];
+        const auto expected =
+            batch_query.bearing
+                ? query.NearestPhantomNodeWithAlternativeFromBigComponent(
+                      batch_query.coordinate,
+                      batch_query.bearing->bearing,
+                      batch_query.bearing->range,
+                      batch_query.approach)
+                : query.NearestPhantomNodeWithAlternativeFromBigComponent(batch_query.coordinate,
+                                                                          batch_query.approach);
+        BOOST_CHECK(alternatives[i].first == expected.first);
+        BOOST_CHECK(alternatives[i].second == expected.second);
+        BOOST_CHECK(batch_query.bearing || alternatives[i].first.IsValid());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(subtree_filter_tests)
+{
+    using Coord = std::pair<FloatLongitude, FloatLatitude>;
+    using Edge = std::pair<unsigned, unsigned>;
+
+    // grid of 20x20 nodes, the nodes of the left half have class 1 and the lower half class 2
+    const unsigned grid_size = 20;
+    std::vector<Coord> grid_coords;
+    std::vector<Edge> grid_edges;
+    std::vector<std::uint8_t> node_classes;
+    for (unsigned row = 0; row < grid_size; ++row)
+    {
+        for (unsigned column = 0; column < grid_size; ++column)
+        {
+            const auto node = row * grid_size + column;
+            grid_coords.emplace_back(FloatLongitude{column * 0.01}, FloatLatitude{row * 0.01});
+            node_classes.push_back((column < grid_size / 2 ? 1 : 0) |
+                                   (row < grid_size / 2 ? 2 : 0));
+            if (column + 1 < grid_size)
+                grid_edges.emplace_back(node, node + 1);
+            if (row + 1 < grid_size)
+                grid_edges.emplace_back(node, node + grid_size);
+        }
+    }
+    GraphFixture fixture(grid_coords, grid_edges);
+
+    TemporaryFile tmp;
+    MiniStaticRTree rtree(fixture.edges, fixture.coords, tmp.path, node_classes);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_real_distribution<> coordinate_udist(-0.01, grid_size * 0.01);
+    std::uniform_int_distribution<> bearing_udist(0, 359);
+
+    std::size_t filtered_candidates = 0;
+    std::size_t pruned_candidates = 0;
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        const Coordinate input_coordinate{FloatLongitude{coordinate_udist(g)},
+                                          FloatLatitude{coordinate_udist(g)}};
+        const std::uint8_t exclude_mask = i % 4;
+        const int bearing = bearing_udist(g);
+        const int bearing_range = i % 3 == 0 ? 180 : 20;
+
+        const auto is_excluded = [&](const SegmentID segment_id) {
+            return (node_classes[segment_id.id] & exclude_mask) != 0;
+        };
+        const auto filter = [&](const MiniStaticRTree::CandidateSegment &segment) {
+            const auto &data = segment.data;
+            const auto forward_bearing = static_cast<int>(std::round(
+                coordinate_calculation::bearing(fixture.coords[data.u], fixture.coords[data.v])));
+            return std::make_pair(
+                data.forward_segment_id.enabled && !is_excluded(data.forward_segment_id) &&
+                    bearing::CheckInBounds(forward_bearing, bearing, bearing_range),
+                data.reverse_segment_id.enabled && !is_excluded(data.reverse_segment_id) &&
+                    bearing::CheckInBounds(forward_bearing + 180, bearing, bearing_range));
+        };
+        const auto terminate = [](const std::size_t num_results,
+                                  const MiniStaticRTree::CandidateSegment &) {
+            return num_results >= 5;
+        };
+        const auto bearing_sectors = bearing::GetSectorMask(bearing, bearing_range);
+        const auto subtree_filter = [&](const MiniStaticRTree::TreeNodeSummary &summary) {
+            return (summary.common_classes & exclude_mask) == 0 &&
+                   (summary.bearing_sectors & bearing_sectors) != 0;
+        };
+
+        const auto expected = rtree.Nearest(
+            input_coordinate,
+            [&](const MiniStaticRTree::CandidateSegment &segment) {
+                ++filtered_candidates;
+                return filter(segment);
+            },
+            terminate);
+        const auto results = rtree.Nearest(
+            input_coordinate,
+            subtree_filter,
+            [&](const MiniStaticRTree::CandidateSegment &segment) {
+                ++pruned_candidates;
+                return filter(segment);
+            },
+            terminate);
+
+        // segments at the same distance can be found in any order
+        BOOST_REQUIRE_EQUAL(results.size(), expected.size());
+        for (std::size_t j = 0; j < expected.size(); ++j)
+        {
+            const auto distance = coordinate_calculation::perpendicularDistance(
+                fixture.coords[results[j].u], fixture.coords[results[j].v], input_coordinate);
+            const auto expected_distance = coordinate_calculation::perpendicularDistance(
+                fixture.coords[expected[j].u], fixture.coords[expected[j].v], input_coordinate);
+            BOOST_CHECK_CLOSE(distance, expected_distance, 0.0001);
+        }
+    }
+    // the skipped subtrees contain candidates that would have been rejected
+    BOOST_CHECK_LT(pruned_candidates, filtered_candidates);
+}
+
 BOOST_AUTO_TEST_CASE(bbox_search_tests)
 {
     using Coord = std::pair<FloatLongitude, FloatLatitude>;